@@ -0,0 +1,5 @@
+#define VERSION "4.0.2+used"
+#define COMPILER "gcc (Debian 12.2.0-14+deb12u1) 12.2.0 -W -Wall -ggdb3 -DEMBEDDED -DLOGGING -DMETRICS -DKISSAT_HAS_ZLIB -DKISSAT_HAS_LZMA -DKISSAT_HAS_BZIP2"
+#define ID "4ce875d28e58da7470ea976a08b3e80b1626c8cc"
+#define BUILD "Fri Oct 16 14:48:55 UTC 2026 Linux vm 6.18.44-fc-v130 x86_64"
+#define DIR "/root/repo/build"
@@ -0,0 +1,98 @@
+#!/bin/sh
+
+# Compare the run-time of two solver binaries, for instance built before
+# and after a data structure change, on the same set of CNF files.  By
+# default all files in 'test/cnf' are solved.  Runs of both binaries are
+# interleaved to reduce the effect of frequency scaling and other noise,
+# and for each binary the best of the repeated runs is taken.
+
+usage () {
+cat <<EOF
+usage: compare-binaries.sh [ -h ] [ -r <runs> ] [ -- <options> ] <old> <new> [ <cnf> ... ]
+
+  -h            print this command line option summary
+  -r <runs>     repeat each run '<runs>' times (default '3')
+  -- <options>  pass '<options>' to both solvers (default '-q')
+EOF
+}
+
+die () {
+  echo "compare-binaries.sh: error: $*" 1>&2
+  exit 1
+}
+
+runs=3
+options="-q"
+while [ $# -gt 0 ]
+do
+  case "$1" in
+    -h) usage; exit 0;;
+    -r) shift; [ $# -gt 0 ] || die "argument to '-r' missing"; runs="$1";;
+    --) shift; [ $# -gt 0 ] || die "argument to '--' missing"; options="$1";;
+    -*) die "invalid option '$1' (try '-h')";;
+    *) break;;
+  esac
+  shift
+done
+
+[ $# -lt 2 ] && die "expected two solver binaries (try '-h')"
+old="$1"; new="$2"; shift; shift
+[ -x "$old" ] || die "can not execute '$old'"
+[ -x "$new" ] || die "can not execute '$new'"
+
+if [ $# -eq 0 ]
+then
+  cd `dirname $0`/.. || exit 1
+  set -- test/cnf/*.cnf
+fi
+
+now () {
+  date +%s.%N
+}
+
+elapsed () {
+  binary="$1"; cnf="$2"
+  start=`now`
+  "$binary" $options "$cnf" 1>/dev/null 2>&1
+  status=$?
+  end=`now`
+  case $status in
+    0|10|20) ;;
+    *) die "'$binary $options $cnf' exit code $status";;
+  esac
+  echo "$start $end" | awk '{ printf "%.6f\n", $2 - $1 }'
+}
+
+best () {
+  if [ -z "$1" ]
+  then
+    echo "$2"
+  else
+    echo "$1 $2" | awk '{ print ($2 < $1) ? $2 : $1 }'
+  fi
+}
+
+printf "%-32s %10s %10s %7s\n" "cnf" "old" "new" "ratio"
+total_old=0
+total_new=0
+for cnf in "$@"
+do
+  [ -f "$cnf" ] || die "can not find '$cnf'"
+  t_old=""
+  t_new=""
+  i=0
+  while [ $i -lt $runs ]
+  do
+    t=`elapsed "$old" "$cnf"` || exit 1
+    t_old=`best "$t_old" $t`
+    t=`elapsed "$new" "$cnf"` || exit 1
+    t_new=`best "$t_new" $t`
+    i=`expr $i + 1`
+  done
+  echo "`basename $cnf` $t_old $t_new" | \
+  awk '{ printf "%-32s %10.3f %10.3f %7.3f\n", $1, $2, $3, $2 ? $3 / $2 : 1 }'
+  total_old=`echo "$total_old $t_old" | awk '{ print $1 + $2 }'`
+  total_new=`echo "$total_new $t_new" | awk '{ print $1 + $2 }'`
+done
+echo "total $total_old $total_new" | \
+awk '{ printf "%-32s %10.3f %10.3f %7.3f\n", $1, $2, $3, $2 ? $3 / $2 : 1 }'
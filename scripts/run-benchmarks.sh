@@ -0,0 +1,366 @@
+#!/bin/sh
+
+# Run the solver on a benchmark corpus under a fixed conflict limit and
+# write a JSON report with run-time, conflicts, propagations and ticks per
+# second, the profile times of all phases and the peak resident set size.
+# The report can be compared against a previous report (the baseline) to
+# catch performance regressions after changing compiler flags or code.
+#
+# Each instance is solved several times.  The run with the median
+# process-time is reported and the difference between the slowest and
+# fastest run ('spread') is used as noise estimate.  A change in run-time
+# is only considered significant if it exceeds both the relative threshold
+# and the spread of the baseline and the current run.
+
+usage () {
+cat <<EOF
+usage: run-benchmarks.sh [ <option> ... ] [ <cnf> | <directory> ... ]
+
+where '<option>' is one of the following
+
+  -h              print this command line option summary
+  -k <kissat>     solver binary (default 'build/kissat')
+  -c <conflicts>  conflict limit for each run (default '$conflicts')
+  -r <runs>       number of runs for each instance (default '$runs')
+  -g <size>       size of generated 'genbigand' instances (default '$size')
+  -o <report>     write JSON report to '<report>' (default '$report')
+  -b <baseline>   compare report against previous JSON report '<baseline>'
+  -t <percent>    significance threshold in percent (default '$threshold')
+  -m <seconds>    ignore instances faster than this (default '$minimum')
+  -- <options>    pass '<options>' to the solver
+
+Directories are searched for '*.cnf' files (also compressed).  Without
+any '<cnf>' nor '<directory>' the corpus consists of 'test/cnf' and a
+satisfiable and an unsatisfiable 'genbigand' instance ('-g 0' disables
+the latter).  The exit code is '2' if a significant regression was found.
+EOF
+}
+
+die () {
+  echo "run-benchmarks.sh: error: $*" 1>&2
+  exit 1
+}
+
+msg () {
+  echo "[run-benchmarks] $*" 1>&2
+}
+
+root="`dirname $0`/.."
+root="`cd $root; pwd`"
+
+kissat="$root/build/kissat"
+conflicts=100000
+runs=3
+size=1e6
+report=bench.json
+baseline=""
+threshold=5
+minimum=0.1
+options=""
+
+while [ $# -gt 0 ]
+do
+  case "$1" in
+    -h) usage; exit 0;;
+    -k|-c|-r|-g|-o|-b|-t|-m|--)
+      [ $# -gt 1 ] || die "argument to '$1' missing"
+      case "$1" in
+        -k) kissat="$2";;
+        -c) conflicts="$2";;
+        -r) runs="$2";;
+        -g) size="$2";;
+        -o) report="$2";;
+        -b) baseline="$2";;
+        -t) threshold="$2";;
+        -m) minimum="$2";;
+        --) options="$2";;
+      esac
+      shift
+      ;;
+    -*) die "invalid option '$1' (try '-h')";;
+    *) break;;
+  esac
+  shift
+done
+
+[ -x "$kissat" ] || die "can not execute '$kissat'"
+[ "$runs" -gt 0 ] 2>/dev/null || die "invalid number of runs '$runs'"
+[ -z "$baseline" -o -f "$baseline" ] || die "can not find '$baseline'"
+
+tmp="/tmp/run-benchmarks-$$"
+trap "rm -rf $tmp" 0
+trap "exit 1" 1 2 3 15
+mkdir "$tmp" || die "can not create '$tmp'"
+
+#--------------------------------------------------------------------------#
+
+# Collect the corpus as list of '<name> <path>' lines in '$tmp/corpus'.
+
+add () {
+  echo "$1 $2" >> $tmp/corpus
+}
+
+add_directory () {
+  find "$1" -type f \( -name '*.cnf' -o -name '*.cnf.gz' \
+    -o -name '*.cnf.bz2' -o -name '*.cnf.xz' \) | sort | \
+  while read path
+  do
+    add "$path" "$path"
+  done
+}
+
+: > $tmp/corpus
+if [ $# -eq 0 ]
+then
+  for path in $root/test/cnf/*.cnf
+  do
+    add "test/cnf/`basename $path`" "$path"
+  done
+  if [ ! "$size" = 0 ]
+  then
+    generator=$tmp/genbigand
+    ${CC-cc} -O2 -o $generator $root/test/big/genbigand.c || \
+      die "failed to compile 'genbigand'"
+    for mode in sat unsat
+    do
+      name="genbigand-$mode-$size.cnf"
+      $generator --$mode $size > $tmp/$name || \
+        die "failed to generate '$name'"
+      add "$name" "$tmp/$name"
+    done
+  fi
+else
+  for arg in "$@"
+  do
+    case "$arg" in
+      *" "*) die "can not handle space in '$arg'";;
+    esac
+    if [ -d "$arg" ]
+    then
+      add_directory "$arg"
+    elif [ -f "$arg" ]
+    then
+      add "$arg" "$arg"
+    else
+      die "can not find '$arg'"
+    fi
+  done
+fi
+
+instances="`wc -l < $tmp/corpus`"
+[ $instances -gt 0 ] || die "empty benchmark corpus"
+
+#--------------------------------------------------------------------------#
+
+# Extract the metrics of one run from the solver output as single line.
+
+parse () {
+  awk '
+/^c ---- \[ profiling \]/ { profiling = 1; next }
+/^c ---- / { profiling = 0 }
+profiling && NF == 5 && $4 == "%" && $5 != "total" {
+  profile = profile (profile == "" ? "" : ",") $5 "=" $2
+}
+/^c conflicts:/ { conflicts = $3 }
+/^c decisions:/ { decisions = $3 }
+/^c propagations:/ { propagations = $3 }
+/^c search_ticks:/ { search_ticks = $3 }
+/^c ticks:/ { ticks = $3 }
+/^c maximum-resident-set-size:/ { rss = $3 }
+/^c process-time:/ { time = $(NF-1) }
+END {
+  if (time == "") missing = "process-time"
+  else if (conflicts == "") missing = "conflicts"
+  else if (decisions == "") missing = "decisions"
+  else if (propagations == "") missing = "propagations"
+  else if (ticks == "") missing = "ticks"
+  else if (search_ticks == "") missing = "search_ticks"
+  if (missing != "") { print missing; exit 1 }
+  if (profile == "") profile = "-"
+  printf "%s %d %d %d %d %d %d %s\n", time, conflicts, decisions,
+    propagations, ticks, search_ticks, rss, profile
+}' $1
+}
+
+# Pick the median run and print it as JSON object.
+
+summarize () {
+  awk -v name="$1" -v status="$2" '
+function rate(count, time) { return time > 0 ? count / time : 0 }
+{ line[NR] = $0; time[NR] = $1 }
+END {
+  for (i = 1; i <= NR; i++) order[i] = i
+  for (i = 2; i <= NR; i++)
+    for (j = i; j > 1 && time[order[j-1]] > time[order[j]]; j--) {
+      k = order[j]; order[j] = order[j-1]; order[j-1] = k
+    }
+  spread = time[order[NR]] - time[order[1]]
+  split (line[order[int ((NR + 1) / 2)]], m, " ")
+  gsub (/\\/, "\\\\", name); gsub (/"/, "\\\"", name)
+  printf "    { \"name\": \"%s\", \"status\": %d, ", name, status
+  printf "\"time\": %.2f, \"spread\": %.2f, ", m[1], spread
+  printf "\"conflicts\": %d, \"decisions\": %d, ", m[2], m[3]
+  printf "\"propagations\": %d, \"ticks\": %d, ", m[4], m[5]
+  printf "\"search_ticks\": %d, ", m[6]
+  printf "\"conflicts_per_second\": %.0f, ", rate(m[2], m[1])
+  printf "\"propagations_per_second\": %.0f, ", rate(m[4], m[1])
+  printf "\"ticks_per_second\": %.0f, ", rate(m[5], m[1])
+  printf "\"peak_rss\": %d, \"profile\": {", m[7]
+  if (m[8] != "-") {
+    n = split (m[8], p, ",")
+    for (i = 1; i <= n; i++) {
+      split (p[i], q, "=")
+      printf "%s \"%s\": %s", (i > 1 ? "," : ""), q[1], q[2]
+    }
+    printf " "
+  }
+  printf "} }\n"
+}' $tmp/runs
+}
+
+msg "benchmarking '$kissat' on $instances instances"
+msg "conflict limit $conflicts with $runs runs per instance"
+
+: > $tmp/instances
+while read name path
+do
+  : > $tmp/runs
+  i=0
+  while [ $i -lt $runs ]
+  do
+    "$kissat" --statistics --conflicts=$conflicts $options $path \
+      < /dev/null > $tmp/output 2>&1
+    status=$?
+    case $status in
+      0|10|20) ;;
+      *) die "'$kissat --conflicts=$conflicts $options $path' " \
+             "exit code $status";;
+    esac
+    parse $tmp/output > $tmp/run || \
+      die "metric '`cat $tmp/run`' missing in output of '$kissat'" \
+          "(configured '--quiet'?)"
+    cat $tmp/run >> $tmp/runs
+    i=`expr $i + 1`
+  done
+  summarize "$name" $status >> $tmp/instances
+  time="`tail -1 $tmp/instances | sed -e 's/.*"time": \([0-9.]*\),.*/\1/'`"
+  msg "$name $time seconds"
+done < $tmp/corpus
+
+#--------------------------------------------------------------------------#
+
+# Write the report with one instance per line (parsed below for baselines).
+
+{
+  echo "{"
+  echo "  \"version\": \"`$kissat --version`\","
+  echo "  \"id\": \"`$kissat --id`\","
+  echo "  \"compiler\": \"`$kissat --compiler | sed -e 's/\"/\\\\\"/g'`\","
+  echo "  \"date\": \"`date -u +%Y-%m-%dT%H:%M:%SZ`\","
+  echo "  \"options\": \"$options\","
+  echo "  \"conflicts\": $conflicts,"
+  echo "  \"runs\": $runs,"
+  echo "  \"instances\": ["
+  sed -e '$!s/$/,/' $tmp/instances
+  echo "  ],"
+  awk '
+function field(key,   i) {
+  i = index ($0, "\"" key "\": ")
+  return i ? substr ($0, i + length (key) + 4) + 0 : 0
+}
+function rate(count, time) { return time > 0 ? count / time : 0 }
+{
+  time += field("time"); conflicts += field("conflicts")
+  propagations += field("propagations"); ticks += field("ticks")
+  rss = field("peak_rss"); if (rss > peak) peak = rss
+}
+END {
+  printf "  \"total\": { \"time\": %.2f, \"conflicts\": %d, ", time, conflicts
+  printf "\"propagations\": %d, \"ticks\": %d, ", propagations, ticks
+  printf "\"conflicts_per_second\": %.0f, ", rate(conflicts, time)
+  printf "\"propagations_per_second\": %.0f, ", rate(propagations, time)
+  printf "\"ticks_per_second\": %.0f, ", rate(ticks, time)
+  printf "\"peak_rss\": %d }\n", peak
+}' $tmp/instances
+  echo "}"
+} > $report || die "failed to write '$report'"
+
+msg "wrote '$report'"
+
+[ -z "$baseline" ] && exit 0
+
+#--------------------------------------------------------------------------#
+
+# Compare run-times of instances and total rates against the baseline.
+
+msg "comparing '$report' against baseline '$baseline'"
+
+awk -v threshold="$threshold" -v minimum="$minimum" '
+function field(key,   i) {
+  i = index ($0, "\"" key "\": ")
+  return i ? substr ($0, i + length (key) + 4) + 0 : 0
+}
+function name(   s) {
+  s = substr ($0, index ($0, "\"name\": \"") + 9)
+  return substr (s, 1, index (s, "\", \"status\"") - 1)
+}
+function change(old, new) { return old > 0 ? 100 * (new - old) / old : 0 }
+function abs(x) { return x < 0 ? -x : x }
+function max(a, b) { return a > b ? a : b }
+function total(what, old, new, higher,   c, verdict, format) {
+  c = change(old, new)
+  verdict = ""
+  if (abs(c) > threshold)
+    verdict = ((c > 0) == higher) ? "improvement" : "regression"
+  if (verdict == "regression")
+    regressions++
+  format = (what == "time") ? "%14.2f %14.2f" : "%14.0f %14.0f"
+  printf "%-40s " format " %+7.1f%% %s\n", what, old, new, c, verdict
+}
+FNR == 1 { file++ }
+/"name": / {
+  n = name()
+  if (file == 1) {
+    old_time[n] = field("time"); old_spread[n] = field("spread")
+    next
+  }
+  if (!(n in old_time)) { missing++; next }
+  old = old_time[n]; new = field("time")
+  if (old < minimum && new < minimum) next
+  delta = new - old
+  if (abs(change(old, new)) <= threshold) next
+  if (abs(delta) <= max(old_spread[n], field("spread"))) next
+  if (!header++)
+    printf "%-40s %14s %14s %8s\n", "instance", "baseline", "current",
+      "change"
+  verdict = delta > 0 ? "regression" : "improvement"
+  if (delta > 0) regressions++
+  printf "%-40s %14.2f %14.2f %+7.1f%% %s\n", n, old, new,
+    change(old, new), verdict
+  next
+}
+/"total": / {
+  if (file == 1) {
+    t[1] = field("time"); c[1] = field("conflicts_per_second")
+    p[1] = field("propagations_per_second")
+    k[1] = field("ticks_per_second"); r[1] = field("peak_rss")
+  } else {
+    t[2] = field("time"); c[2] = field("conflicts_per_second")
+    p[2] = field("propagations_per_second")
+    k[2] = field("ticks_per_second"); r[2] = field("peak_rss")
+  }
+}
+END {
+  if (header) printf "\n"
+  printf "%-40s %14s %14s %8s\n", "total", "baseline", "current", "change"
+  total("time", t[1], t[2], 0)
+  total("conflicts per second", c[1], c[2], 1)
+  total("propagations per second", p[1], p[2], 1)
+  total("ticks per second", k[1], k[2], 1)
+  total("peak resident set size", r[1], r[2], 0)
+  if (missing)
+    printf "\n%d instances not in baseline\n", missing
+  printf "\n%d significant regressions (threshold %s%%)\n",
+    regressions, threshold
+  exit (regressions > 0) ? 2 : 0
+}' $baseline $report
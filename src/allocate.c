@@ -2,6 +2,7 @@
 #include "error.h"
 #include "internal.h"
 #include "logging.h"
+#include "require.h"
 
 #undef LOGPREFIX
 #define LOGPREFIX "ALLOCATE"
@@ -12,35 +13,105 @@
 #include <inttypes.h>
 #endif
 
+// Custom allocator set through 'kissat_set_allocator' which is shared by
+// all solvers (and their threads).  If unset 'malloc', 'calloc', 'realloc'
+// and 'free' of the C library are used.
+
+static struct {
+  void *state;
+  void *(*allocate) (void *state, size_t bytes);
+  void *(*reallocate) (void *state, void *ptr, size_t old_bytes,
+                       size_t new_bytes);
+  void (*deallocate) (void *state, void *ptr, size_t bytes);
+} allocator;
+
+void kissat_set_allocator (void *state,
+                           void *(*allocate) (void *state, size_t bytes),
+                           void *(*reallocate) (void *state, void *ptr,
+                                                size_t old_bytes,
+                                                size_t new_bytes),
+                           void (*deallocate) (void *state, void *ptr,
+                                               size_t bytes)) {
+  const bool all = allocate && reallocate && deallocate;
+  const bool none = !allocate && !reallocate && !deallocate;
+  kissat_require (all || none,
+                  "either all or none of the allocation functions "
+                  "have to be zero");
+  allocator.state = state;
+  allocator.allocate = allocate;
+  allocator.reallocate = reallocate;
+  allocator.deallocate = deallocate;
+}
+
+void *kissat_raw_malloc (size_t bytes) {
+  if (allocator.allocate)
+    return allocator.allocate (allocator.state, bytes);
+  return malloc (bytes);
+}
+
+void *kissat_raw_calloc (size_t n, size_t size) {
+  if (!allocator.allocate)
+    return calloc (n, size);
+  const size_t bytes = n * size;
+  void *res = allocator.allocate (allocator.state, bytes);
+  if (res)
+    memset (res, 0, bytes);
+  return res;
+}
+
+void *kissat_raw_realloc (void *ptr, size_t old_bytes,
+                          size_t new_bytes) {
+  if (allocator.reallocate)
+    return allocator.reallocate (allocator.state, ptr, old_bytes,
+                                 new_bytes);
+  (void) old_bytes;
+  return realloc (ptr, new_bytes);
+}
+
+void kissat_raw_free (void *ptr, size_t bytes) {
+  if (allocator.deallocate)
+    allocator.deallocate (allocator.state, ptr, bytes);
+  else
+    free (ptr);
+}
+
+// Worker threads allocate through the solver they are working for too,
+// thus the accounted bytes are updated atomically.
+
 static void inc_bytes (kissat *solver, size_t bytes) {
-#ifdef METRICS
   if (!solver)
     return;
-  ADD (allocated_current, bytes);
-  LOG5 ("allocated_current = %s",
-        FORMAT_BYTES (solver->statistics.allocated_current));
-  if (solver->statistics.allocated_current >=
-      solver->statistics.allocated_max) {
-    solver->statistics.allocated_max = solver->statistics.allocated_current;
-    LOG5 ("allocated_max = %s",
-          FORMAT_BYTES (solver->statistics.allocated_max));
-  }
-#else
-  (void) solver;
-  (void) bytes;
+  __atomic_add_fetch (&solver->allocated, bytes, __ATOMIC_RELAXED);
+#ifdef METRICS
+  statistics *const statistics = &solver->statistics;
+  const uint64_t current = __atomic_add_fetch (
+      &statistics->allocated_current, bytes, __ATOMIC_RELAXED);
+  LOG5 ("allocated_current = %s", FORMAT_BYTES (current));
+  uint64_t max = __atomic_load_n (&statistics->allocated_max,
+                                  __ATOMIC_RELAXED);
+  while (max < current)
+    if (__atomic_compare_exchange_n (&statistics->allocated_max, &max,
+                                     current, true, __ATOMIC_RELAXED,
+                                     __ATOMIC_RELAXED)) {
+      LOG5 ("allocated_max = %s", FORMAT_BYTES (current));
+      break;
+    }
 #endif
 }
 
 static void dec_bytes (kissat *solver, size_t bytes) {
-#ifdef METRICS
   if (!solver)
     return;
-  SUB (allocated_current, bytes);
+#ifndef NDEBUG
+  const uint64_t allocated =
+#endif
+      __atomic_fetch_sub (&solver->allocated, bytes, __ATOMIC_RELAXED);
+  assert (allocated >= bytes);
+#ifdef METRICS
+  __atomic_sub_fetch (&solver->statistics.allocated_current, bytes,
+                      __ATOMIC_RELAXED);
   LOG5 ("allocated_current = %s",
         FORMAT_BYTES (solver->statistics.allocated_current));
-#else
-  (void) solver;
-  (void) bytes;
 #endif
 }
 
@@ -48,7 +119,7 @@ void *kissat_malloc (kissat *solver, size_t bytes) {
   void *res;
   if (!bytes)
     return 0;
-  res = malloc (bytes);
+  res = kissat_raw_malloc (bytes);
   LOG4 ("malloc (%zu) = %p", bytes, res);
   if (!res)
     kissat_fatal ("out-of-memory allocating %zu bytes", bytes);
@@ -60,7 +131,7 @@ void kissat_free (kissat *solver, void *ptr, size_t bytes) {
   if (ptr) {
     LOG4 ("free (%p[%zu])", ptr, bytes);
     dec_bytes (solver, bytes);
-    free (ptr);
+    kissat_raw_free (ptr, bytes);
   } else
     assert (!bytes);
 }
@@ -82,7 +153,7 @@ void *kissat_nalloc (kissat *solver, size_t n, size_t size) {
   if (MAX_SIZE_T / size < n)
     kissat_fatal ("invalid 'kissat_nalloc (..., %zu, %zu)' call", n, size);
   const size_t bytes = n * size;
-  res = malloc (bytes);
+  res = kissat_raw_malloc (bytes);
   LOG4 ("nalloc (%zu, %zu) = %p", n, size, res);
   if (!res)
     kissat_fatal ("out-of-memory allocating "
@@ -98,7 +169,7 @@ void *kissat_calloc (kissat *solver, size_t n, size_t size) {
     return 0;
   if (MAX_SIZE_T / size < n)
     kissat_fatal ("invalid 'kissat_calloc (..., %zu, %zu)' call", n, size);
-  res = calloc (n, size);
+  res = kissat_raw_calloc (n, size);
   LOG4 ("calloc (%zu, %zu) = %p", n, size, res);
   const size_t bytes = n * size;
   if (!res)
@@ -132,7 +203,7 @@ void *kissat_realloc (kissat *solver, void *p, size_t old_bytes,
     kissat_begin_logging (solver, LOGPREFIX, "realloc (%p[%zu, %zu) = ", p,
                           old_bytes, new_bytes);
 #endif
-  void *res = realloc (p, new_bytes);
+  void *res = kissat_raw_realloc (p, old_bytes, new_bytes);
 #ifdef LOGGING
   if (GET_OPTION (log) > 3) {
     printf ("%p", res);
@@ -5,6 +5,15 @@
 
 struct kissat;
 
+// Allocation through the custom allocator set by 'kissat_set_allocator'
+// (or the C library) without accounting, for code without a solver.
+// Freeing and reallocating requires the size of the allocated block.
+
+void *kissat_raw_malloc (size_t bytes);
+void *kissat_raw_calloc (size_t n, size_t size);
+void *kissat_raw_realloc (void *, size_t old_bytes, size_t new_bytes);
+void kissat_raw_free (void *, size_t bytes);
+
 void *kissat_malloc (struct kissat *, size_t bytes);
 void kissat_free (struct kissat *, void *, size_t bytes);
 
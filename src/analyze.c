@@ -59,6 +59,7 @@ static bool one_literal_on_conflict_level (kissat *solver, clause *conflict,
     solver->inconsistent = true;
     LOG ("learned empty clause from conflict at conflict level zero");
     CHECK_AND_ADD_EMPTY ();
+    LRAT_CHAIN_EMPTY (conflict);
     ADD_EMPTY_TO_PROOF ();
     return false;
   }
@@ -129,27 +130,29 @@ static bool one_literal_on_conflict_level (kissat *solver, clause *conflict,
 
 static inline void mark_reason_side_literal (kissat *solver,
                                              assigned *all_assigned,
+                                             analysis *analysis,
                                              unsigned lit) {
   const unsigned idx = IDX (lit);
   const assigned *a = all_assigned + idx;
-  if (a->level && !a->analyzed)
-    kissat_push_analyzed (solver, all_assigned, idx);
+  if (a->level && !analysis[idx].analyzed)
+    kissat_push_analyzed (solver, analysis, idx);
 }
 
 static inline void analyze_reason_side_literal (kissat *solver,
                                                 size_t limit, ward *arena,
                                                 assigned *all_assigned,
+                                                analysis *analysis,
                                                 unsigned lit) {
   const unsigned idx = IDX (lit);
   const assigned *a = all_assigned + idx;
   assert (a->level);
-  assert (a->analyzed);
+  assert (analysis[idx].analyzed);
   assert (a->reason != UNIT_REASON);
   if (a->reason == DECISION_REASON)
     return;
   if (a->binary) {
     const unsigned other = a->reason;
-    mark_reason_side_literal (solver, all_assigned, other);
+    mark_reason_side_literal (solver, all_assigned, analysis, other);
   } else {
     const reference ref = a->reason;
     assert (ref < SIZE_STACK (solver->arena));
@@ -159,7 +162,7 @@ static inline void analyze_reason_side_literal (kissat *solver,
     for (all_literals_in_clause (other, c))
       if (other != not_lit) {
         assert (other != lit);
-        mark_reason_side_literal (solver, all_assigned, other);
+        mark_reason_side_literal (solver, all_assigned, analysis, other);
         if (SIZE_STACK (solver->analyzed) > limit)
           break;
       }
@@ -183,9 +186,10 @@ static void analyze_reason_side_literals (kissat *solver) {
     return;
   }
   assigned *all_assigned = solver->assigned;
+  analysis *analysis = solver->analysis;
 #ifndef NDEBUG
   for (all_stack (unsigned, lit, solver->clause))
-    assert (all_assigned[IDX (lit)].analyzed);
+    assert (analysis[IDX (lit)].analyzed);
 #endif
   LOG ("trying to bump reason side literals too");
   const size_t saved = SIZE_STACK (solver->analyzed);
@@ -193,7 +197,8 @@ static void analyze_reason_side_literals (kissat *solver) {
   LOG ("analyzed already %zu literals thus limit %zu", saved, limit);
   ward *arena = BEGIN_STACK (solver->arena);
   for (all_stack (unsigned, lit, solver->clause)) {
-    analyze_reason_side_literal (solver, limit, arena, all_assigned, lit);
+    analyze_reason_side_literal (solver, limit, arena, all_assigned,
+                                 analysis, lit);
     if (SIZE_STACK (solver->analyzed) > limit)
       break;
   }
@@ -201,7 +206,7 @@ static void analyze_reason_side_literals (kissat *solver) {
     LOG ("too many additional reason side literals");
     while (SIZE_STACK (solver->analyzed) > saved) {
       const unsigned idx = POP_STACK (solver->analyzed);
-      struct assigned *a = all_assigned + idx;
+      struct analysis *a = analysis + idx;
       LOG ("marking %s as not analyzed", LOGVAR (idx));
       assert (a->analyzed);
       a->analyzed = false;
@@ -325,10 +330,10 @@ static void reset_levels (kissat *solver) {
 
 void kissat_reset_only_analyzed_literals (kissat *solver) {
   LOG ("reset %zu analyzed variables", SIZE_STACK (solver->analyzed));
-  assigned *assigned = solver->assigned;
+  analysis *analysis = solver->analysis;
   for (all_stack (unsigned, idx, solver->analyzed)) {
     assert (idx < VARS);
-    struct assigned *a = assigned + idx;
+    struct analysis *a = analysis + idx;
     assert (!a->poisoned);
     assert (!a->removable);
     assert (!a->shrinkable);
@@ -339,13 +344,13 @@ void kissat_reset_only_analyzed_literals (kissat *solver) {
 
 static void reset_removable (kissat *solver) {
   LOG ("reset %zu removable variables", SIZE_STACK (solver->removable));
-  assigned *assigned = solver->assigned;
+  analysis *analysis = solver->analysis;
 #ifndef NDEBUG
   unsigned not_removable = 0;
 #endif
   for (all_stack (unsigned, idx, solver->removable)) {
     assert (idx < VARS);
-    struct assigned *a = assigned + idx;
+    struct analysis *a = analysis + idx;
     assert (a->removable || !not_removable++);
     a->removable = false;
   }
@@ -400,6 +405,7 @@ static void analyze_failed_literal (kissat *solver, clause *conflict) {
 
   const unsigned not_failed = NOT (failed);
   assigned *all_assigned = solver->assigned;
+  analysis *analysis = solver->analysis;
 #ifndef NDEBUG
   const value *const values = solver->values;
 #endif
@@ -421,20 +427,19 @@ static void analyze_failed_literal (kissat *solver, clause *conflict) {
       continue;
     assert (a->level == 1);
     LOG ("analyzing conflict literal %s", LOGLIT (lit));
-    kissat_push_analyzed (solver, all_assigned, idx);
+    kissat_push_analyzed (solver, analysis, idx);
     unresolved++;
   }
 
   for (;;) {
-    unsigned lit;
-    assigned *a;
+    unsigned lit, idx;
     do {
       assert (t > BEGIN_ARRAY (solver->trail));
       lit = *--t;
       assert (values[lit] > 0);
-      const unsigned idx = IDX (lit);
-      a = all_assigned + idx;
-    } while (!a->analyzed);
+      idx = IDX (lit);
+    } while (!analysis[idx].analyzed);
+    const assigned *a = all_assigned + idx;
     if (unresolved == 1) {
       unit = NOT (lit);
       LOG ("learning additional unit %s", LOGLIT (unit));
@@ -452,11 +457,10 @@ static void analyze_failed_literal (kissat *solver, clause *conflict) {
         goto DONE;
       }
       const unsigned idx = IDX (other);
-      assigned *b = all_assigned + idx;
-      assert (b->level == 1);
-      if (!b->analyzed) {
+      assert (all_assigned[idx].level == 1);
+      if (!analysis[idx].analyzed) {
         LOG ("analyzing reason literal %s", LOGLIT (other));
-        kissat_push_analyzed (solver, all_assigned, idx);
+        kissat_push_analyzed (solver, analysis, idx);
         unresolved++;
       }
     } else {
@@ -483,10 +487,10 @@ static void analyze_failed_literal (kissat *solver, clause *conflict) {
         if (!b->level)
           continue;
         assert (b->level == 1);
-        if (b->analyzed)
+        if (analysis[idx].analyzed)
           continue;
         LOG ("analyzing reason literal %s", LOGLIT (other));
-        kissat_push_analyzed (solver, all_assigned, idx);
+        kissat_push_analyzed (solver, analysis, idx);
         unresolved++;
       }
     }
@@ -498,6 +502,7 @@ static void analyze_failed_literal (kissat *solver, clause *conflict) {
 DONE:
   LOG ("learning negated failed literal %s", LOGLIT (not_failed));
   PUSH_STACK (*units, not_failed);
+  LRAT_CHAIN_FAILED (conflict, *units);
 
   if (!solver->probing)
     kissat_update_learned (solver, 0, 1);
@@ -507,8 +512,10 @@ DONE:
 
   kissat_backtrack_without_updating_phases (solver, 0);
 
-  for (all_stack (unsigned, lit, *units))
+  for (all_stack (unsigned, lit, *units)) {
+    LRAT_RESTORE_CHAIN ();
     kissat_learned_unit (solver, lit);
+  }
   CLEAR_STACK (*units);
   if (!solver->probing) {
     solver->iterating = true;
@@ -542,6 +549,7 @@ int kissat_analyze (kissat *solver, clause *conflict) {
   do {
     LOGCLS (conflict, "analyzing conflict %" PRIu64, CONFLICTS);
     unsigned conflict_level;
+    clause *otfs;
     if (one_literal_on_conflict_level (solver, conflict, &conflict_level))
       res = 1;
     else if (!conflict_level)
@@ -549,8 +557,8 @@ int kissat_analyze (kissat *solver, clause *conflict) {
     else if (conflict_level == 1) {
       analyze_failed_literal (solver, conflict);
       res = 1;
-    } else if ((conflict =
-                    kissat_deduce_first_uip_clause (solver, conflict))) {
+    } else if ((otfs = kissat_deduce_first_uip_clause (solver, conflict))) {
+      conflict = otfs;
       reset_analysis_but_not_analyzed_literals (solver);
       INC (conflicts);
       if (CONFLICTS > solver->limits.glue.conflicts)
@@ -564,6 +572,7 @@ int kissat_analyze (kissat *solver, clause *conflict) {
           kissat_shrink_clause (solver);
       }
       analyze_reason_side_literals (solver);
+      LRAT_CHAIN_CONFLICT (conflict, solver->clause);
       kissat_learn_clause (solver);
       reset_analysis_but_not_analyzed_literals (solver);
       res = 1;
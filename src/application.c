@@ -7,9 +7,11 @@
 #include "keatures.h"
 #include "krite.h"
 #include "parse.h"
+#include "portfolio.h"
 #include "print.h"
 #include "proof.h"
 #include "resources.h"
+#include "snapshot.h"
 #include "witness.h"
 
 #include <inttypes.h>
@@ -24,6 +26,10 @@ struct application {
   kissat *solver;
   const char *input_path;
   const char *output_path;
+  const char *read_snapshot;
+  const char *write_snapshot;
+  const char *checkpoint;
+  const char *resume;
 #ifndef NPROOFS
   const char *proof_path;
   file proof_file;
@@ -35,10 +41,13 @@ struct application {
   int time;
   int conflicts;
   int decisions;
+  int memory;
   strictness strict;
   bool partial;
   bool witness;
   int max_var;
+  unsigned threads;
+  ints literals;
 };
 
 static void init_app (application *application, kissat *solver) {
@@ -48,6 +57,7 @@ static void init_app (application *application, kissat *solver) {
   application->conflicts = -1;
   application->decisions = -1;
   application->strict = NORMAL_PARSING;
+  application->threads = 1;
 }
 
 static void print_common_dimacs_and_proof_usage (void) {
@@ -84,6 +94,12 @@ static void print_complete_dimacs_and_proof_usage (void) {
       "is used.  For real files the binary proof format is used unless\n");
   printf ("'--no-binary' is specified.\n");
   printf ("\n");
+#ifdef KISSAT_HAS_BUILTIN_COMPRESSION
+  printf ("Proofs written to '.bz2', '.gz', '.lzma' and '.xz' files are\n");
+  printf ("compressed in-process if the solver was configured with the\n");
+  printf ("corresponding library ('--zlib', '--lzma' or '--bzip2').\n");
+  printf ("\n");
+#endif
 #ifdef KISSAT_HAS_COMPRESSION
   printf ("Writing of compressed proof files follows the same principle\n");
   printf ("as reading compressed files. The compression format is based\n");
@@ -205,12 +221,23 @@ static void print_complete_usage (void) {
           " (ignore DIMACS header)\n");
   printf ("  --strict             stricter parsing"
           " (no empty header lines)\n");
+  printf ("  --threads=<n>        "
+          "run portfolio of '<n>' solvers sharing clauses\n");
+  printf ("  --read-snapshot=<file>  "
+          "read formula from binary snapshot\n");
+  printf ("  --write-snapshot=<file> "
+          "write binary snapshot of parsed formula\n");
+  printf ("  --checkpoint=<file>  "
+          "periodically write solver state to '<file>'\n");
+  printf ("  --resume=<file>      "
+          "resume solving from checkpoint '<file>'\n");
   printf ("  --version            print version\n");
   printf ("\n");
   printf ("The following solving limits can be enforced:\n");
   printf ("\n");
   printf ("  --conflicts=<limit>\n");
   printf ("  --decisions=<limit>\n");
+  printf ("  --memory-limit=<megabytes>\n");
   printf ("  --time=<seconds>\n");
   printf ("\n");
   printf (
@@ -381,7 +408,13 @@ static bool parse_options (application *application, int argc,
 #endif
   const char *conflicts_option = 0;
   const char *decisions_option = 0;
+  const char *memory_option = 0;
+  const char *threads_option = 0;
   const char *time_option = 0;
+  const char *read_snapshot_option = 0;
+  const char *write_snapshot_option = 0;
+  const char *checkpoint_option = 0;
+  const char *resume_option = 0;
   const char *valstr;
   for (int i = 1; i < argc; i++) {
     const char *arg = argv[i];
@@ -487,6 +520,54 @@ static bool parse_options (application *application, int argc,
         decisions_option = arg;
       } else
         ERROR ("invalid argument in '%s' (try '-h')", arg);
+    } else if ((valstr = kissat_parse_option_name (arg, "memory-limit"))) {
+      int val;
+      if (kissat_parse_option_value (valstr, &val) && val > 0) {
+        if (memory_option)
+          ERROR ("multiple '%s' and '%s'", memory_option, arg);
+        kissat_set_memory_limit (solver, val);
+        application->memory = val;
+        memory_option = arg;
+      } else
+        ERROR ("invalid argument in '%s' (try '-h')", arg);
+    } else if ((valstr = kissat_parse_option_name (arg, "threads"))) {
+      int val;
+      if (kissat_parse_option_value (valstr, &val) && val > 0) {
+        if (threads_option)
+          ERROR ("multiple '%s' and '%s'", threads_option, arg);
+        application->threads = val;
+        threads_option = arg;
+      } else
+        ERROR ("invalid argument in '%s' (try '-h')", arg);
+    } else if ((valstr = kissat_parse_option_name (arg, "read-snapshot"))) {
+      if (read_snapshot_option)
+        ERROR ("multiple '%s' and '%s'", read_snapshot_option, arg);
+      if (!*valstr || !kissat_file_readable (valstr))
+        ERROR ("can not read snapshot in '%s'", arg);
+      application->read_snapshot = valstr;
+      read_snapshot_option = arg;
+    } else if ((valstr =
+                    kissat_parse_option_name (arg, "write-snapshot"))) {
+      if (write_snapshot_option)
+        ERROR ("multiple '%s' and '%s'", write_snapshot_option, arg);
+      if (!*valstr || !kissat_file_writable (valstr))
+        ERROR ("can not write snapshot in '%s'", arg);
+      application->write_snapshot = valstr;
+      write_snapshot_option = arg;
+    } else if ((valstr = kissat_parse_option_name (arg, "checkpoint"))) {
+      if (checkpoint_option)
+        ERROR ("multiple '%s' and '%s'", checkpoint_option, arg);
+      if (!*valstr || !kissat_file_writable (valstr))
+        ERROR ("can not write checkpoint in '%s'", arg);
+      application->checkpoint = valstr;
+      checkpoint_option = arg;
+    } else if ((valstr = kissat_parse_option_name (arg, "resume"))) {
+      if (resume_option)
+        ERROR ("multiple '%s' and '%s'", resume_option, arg);
+      if (!*valstr || !kissat_file_readable (valstr))
+        ERROR ("can not read checkpoint in '%s'", arg);
+      application->resume = valstr;
+      resume_option = arg;
     } else if (!strcmp (arg, "--partial"))
       application->partial = true;
 #ifndef NPROOFS
@@ -611,6 +692,37 @@ static bool parse_options (application *application, int argc,
     ERROR ("reading apparently compressed '%s' not supported "
            "(use '-f' to force reading without decompression)",
            application->input_path);
+#endif
+  if (read_snapshot_option && application->input_path)
+    ERROR ("can not combine '%s' with reading '%s'", read_snapshot_option,
+           application->input_path);
+  if (resume_option && application->input_path)
+    ERROR ("can not combine '%s' with reading '%s'", resume_option,
+           application->input_path);
+  if (resume_option && read_snapshot_option)
+    ERROR ("can not combine '%s' and '%s'", resume_option,
+           read_snapshot_option);
+  if (resume_option && write_snapshot_option)
+    ERROR ("can not combine '%s' and '%s'", resume_option,
+           write_snapshot_option);
+  if (application->threads > 1 && resume_option)
+    ERROR ("can not combine '%s' and '%s'", threads_option, resume_option);
+  if (application->threads > 1 && checkpoint_option)
+    ERROR ("can not combine '%s' and '%s'", threads_option,
+           checkpoint_option);
+  if (read_snapshot_option && write_snapshot_option &&
+      !strcmp (application->read_snapshot, application->write_snapshot))
+    ERROR ("will not read and write snapshot '%s' at the same time",
+           application->read_snapshot);
+#ifndef NPROOFS
+  if (application->threads > 1 && application->proof_path)
+    ERROR ("can not write proof with '%s'", threads_option);
+  if (read_snapshot_option && application->proof_path)
+    ERROR ("can not write proof with '%s'", read_snapshot_option);
+  if (resume_option && application->proof_path)
+    ERROR ("can not write proof with '%s'", resume_option);
+  if (checkpoint_option && application->proof_path)
+    ERROR ("can not write proof with '%s'", checkpoint_option);
 #endif
 #if !defined(QUIET) && !defined(NOPTIONS)
   if (kissat_get_option (solver, "quiet")) {
@@ -642,7 +754,8 @@ static bool parse_input (application *application) {
   kissat_message (solver, "  %s", file.path);
   kissat_line (solver);
   const char *error = kissat_parse_dimacs (
-      solver, application->strict, &file, &lineno, &application->max_var);
+      solver, application->strict, &file, &lineno, &application->max_var,
+      application->threads > 1 ? &application->literals : 0);
   kissat_close_file (&file);
   if (error)
     ERROR ("%s:%" PRIu64 ": parse error: %s", file.path, lineno, error);
@@ -662,6 +775,61 @@ static bool parse_input (application *application) {
   return true;
 }
 
+static bool read_snapshot (application *application) {
+#ifndef QUIET
+  double entered = kissat_process_time ();
+#endif
+  kissat *solver = application->solver;
+  const char *path = application->read_snapshot;
+  kissat_section (solver, "snapshot");
+  kissat_message (solver, "reading snapshot:");
+  kissat_line (solver);
+  kissat_message (solver, "  %s", path);
+  kissat_line (solver);
+  const char *error = kissat_read_snapshot (
+      solver, path, &application->max_var,
+      application->threads > 1 ? &application->literals : 0);
+  if (error)
+    ERROR ("%s: %s", path, error);
+#ifndef QUIET
+  kissat_message (solver, "finished reading snapshot after %.2f seconds",
+                  kissat_process_time () - entered);
+#endif
+  return true;
+}
+
+static bool resume (application *application) {
+#ifndef QUIET
+  double entered = kissat_process_time ();
+#endif
+  kissat *solver = application->solver;
+  const char *path = application->resume;
+  kissat_section (solver, "resume");
+  kissat_message (solver, "resuming from checkpoint:");
+  kissat_line (solver);
+  kissat_message (solver, "  %s", path);
+  kissat_line (solver);
+  const char *error = kissat_resume (solver, path, &application->max_var);
+  if (error)
+    ERROR ("%s: %s", path, error);
+#ifndef QUIET
+  kissat_message (solver, "finished resuming after %.2f seconds",
+                  kissat_process_time () - entered);
+#endif
+  return true;
+}
+
+static bool write_snapshot (application *application) {
+  const char *path = application->write_snapshot;
+  if (!path)
+    return true;
+  kissat *solver = application->solver;
+  kissat_section (solver, "snapshot");
+  if (!kissat_write_snapshot (solver, application->max_var, path))
+    ERROR ("failed to write snapshot '%s'", path);
+  return true;
+}
+
 #ifndef NPROOFS
 
 static bool write_proof (application *application) {
@@ -681,9 +849,10 @@ static bool write_proof (application *application) {
 #ifndef QUIET
   kissat *solver = application->solver;
   kissat_section (solver, "proving");
-  kissat_message (solver, "%swriting proof to %sDRAT file:",
+  kissat_message (solver, "%swriting proof to %s%s file:",
                   file->close ? "opened and " : "",
-                  file->compressed ? "compressed " : "");
+                  file->compressed ? "compressed " : "",
+                  solver->lrat ? "LRAT" : "DRAT");
   kissat_line (solver);
   kissat_message (solver, "  %s", file->path);
 #endif
@@ -737,13 +906,14 @@ static void print_limits (application *application) {
   kissat *solver = application->solver;
   const int verbosity = kissat_verbosity (solver);
   if (verbosity < 1 && application->conflicts < 0 &&
-      application->decisions < 0)
+      application->decisions < 0 && !application->memory)
     return;
 
   kissat_section (solver, "limits");
   if (!application->time && application->conflicts < 0 &&
-      application->decisions < 0)
-    kissat_message (solver, "no time, conflict nor decision limit set");
+      application->decisions < 0 && !application->memory)
+    kissat_message (solver,
+                    "no time, conflict, decision nor memory limit set");
   else {
     if (application->time)
       kissat_message (solver, "time limit set to %d seconds",
@@ -762,6 +932,12 @@ static void print_limits (application *application) {
                       application->decisions);
     else if (verbosity > 0)
       kissat_message (solver, "no decision limit");
+
+    if (application->memory)
+      kissat_message (solver, "memory limit set to %d MB",
+                      application->memory);
+    else if (verbosity > 0)
+      kissat_message (solver, "no memory limit");
   }
 }
 
@@ -791,12 +967,25 @@ static int run_application (kissat *solver, int argc, char **argv,
   if (!write_proof (&application))
     return 1;
 #endif
-  if (!parse_input (&application)) {
+  if (application.resume            ? !resume (&application)
+      : application.read_snapshot ? !read_snapshot (&application)
+                                  : !parse_input (&application)) {
+#ifndef NPROOFS
+    close_proof (&application);
+#endif
+    RELEASE_STACK (application.literals);
+    return 1;
+  }
+  if (!write_snapshot (&application)) {
 #ifndef NPROOFS
     close_proof (&application);
 #endif
+    RELEASE_STACK (application.literals);
     return 1;
   }
+  if (application.checkpoint)
+    kissat_set_checkpoint (solver, application.checkpoint,
+                           application.max_var);
 #ifndef QUIET
 #ifndef NOPTIONS
   print_options (solver);
@@ -804,7 +993,21 @@ static int run_application (kissat *solver, int argc, char **argv,
   print_limits (&application);
   kissat_section (solver, "solving");
 #endif
-  int res = kissat_solve (solver);
+  portfolio portfolio;
+  kissat *winner = solver;
+  int res;
+  if (application.threads > 1) {
+    kissat_message (solver, "running portfolio of %u solver threads",
+                    application.threads);
+    kissat_init_portfolio (&portfolio, solver, application.threads,
+                           application.conflicts, application.decisions,
+                           application.memory);
+    res = kissat_solve_portfolio (&portfolio, application.max_var,
+                                  &application.literals);
+    winner = portfolio.winner;
+    RELEASE_STACK (application.literals);
+  } else
+    res = kissat_solve (solver);
 #ifndef NPROOFS
   close_proof (&application);
 #endif
@@ -828,12 +1031,12 @@ static int run_application (kissat *solver, int argc, char **argv,
     } else if (res == 10) {
 #ifndef NDEBUG
       if (GET_OPTION (check))
-        kissat_check_satisfying_assignment (solver);
+        kissat_check_satisfying_assignment (winner);
 #endif
       printf ("s SATISFIABLE\n");
       fflush (stdout);
       if (application.witness)
-        kissat_print_witness (solver, application.max_var,
+        kissat_print_witness (winner, application.max_var,
                               application.partial);
     } else {
       printf ("s UNKNOWN\n");
@@ -861,6 +1064,8 @@ static int run_application (kissat *solver, int argc, char **argv,
 #ifndef QUIET
   kissat_print_statistics (solver);
 #endif
+  if (application.threads > 1)
+    kissat_release_portfolio (&portfolio);
 #ifndef QUIET
   kissat_section (solver, "shutting down");
   kissat_message (solver, "exit %d", res);
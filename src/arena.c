@@ -1,6 +1,8 @@
+#include "budget.h"
 #include "error.h"
 #include "internal.h"
 #include "logging.h"
+#include "pages.h"
 #include "print.h"
 
 static void report_resized (kissat *solver, const char *mode,
@@ -41,8 +43,12 @@ reference kissat_allocate_clause (kissat *solver, size_t size) {
       if (capacity == MAX_ARENA)
         kissat_fatal ("maximum arena capacity "
                       "of 2^%u %zu-byte-words %s exhausted"
-#ifdef COMPACT
+#if defined(COMPACT)
                       " (consider a configuration without '--compact')"
+#elif !defined(DOUBLE_ARENA)
+                      " (consider configuring with '--double-arena')"
+#else
+                      " (wide clause references are not supported)"
 #endif
                       ,
                       LD_MAX_ARENA, sizeof (ward),
@@ -54,6 +60,8 @@ reference kissat_allocate_clause (kissat *solver, size_t size) {
     } while (needed > available);
     INC (arena_resized);
     INC (arena_enlarged);
+    kissat_advise_pages (solver, BEGIN_STACK (solver->arena),
+                         capacity * sizeof (ward));
     report_resized (solver, "enlarged", before);
     assert (capacity <= MAX_ARENA);
   }
@@ -78,7 +86,7 @@ void kissat_shrink_arena (kissat *solver) {
                 kissat_percent (size, capacity), FORMAT_COUNT (size),
                 (int) sizeof (ward), FORMAT_BYTES (size_bytes));
 #endif
-  if (size > capacity / 4) {
+  if (size > capacity / 4 && !kissat_memory_pressure (solver)) {
     kissat_phase (solver, "arena", GET (arena_resized),
                   "not shrinking since more than 25%% filled");
     return;
@@ -86,6 +94,8 @@ void kissat_shrink_arena (kissat *solver) {
   INC (arena_resized);
   INC (arena_shrunken);
   SHRINK_STACK (solver->arena);
+  kissat_advise_pages (solver, BEGIN_STACK (solver->arena),
+                       CAPACITY_STACK (solver->arena) * sizeof (ward));
   report_resized (solver, "shrunken", before);
 }
 
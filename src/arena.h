@@ -5,8 +5,20 @@
 #include "stack.h"
 #include "utilities.h"
 
-#ifdef COMPACT
+// Clause references are 31 bits wide and count 'ward's, the unit of
+// clause allocation in the arena.  With the default two-word unit this
+// allows arenas of 32 GB on 64-bit machines.  Configuring with
+// '--double-arena' doubles the unit and thus the maximum arena size to
+// 64 GB.  References and watches stay at 32 bits though, so this does not
+// give wide references but costs more padding between clauses instead.
+// Wide references (split watches or an indirection table) are not
+// implemented, thus formulas needing larger arenas still abort.
+// Configuring with '--compact' halves both unit and maximum arena size.
+
+#if defined(COMPACT)
 typedef word ward;
+#elif defined(DOUBLE_ARENA)
+typedef w4rd ward;
 #else
 typedef w2rd ward;
 #endif
@@ -36,8 +48,10 @@ bool kissat_clause_in_arena (const struct kissat *, const struct clause *);
 #endif
 
 static inline word kissat_align_ward (word w) {
-#ifdef COMPACT
+#if defined(COMPACT)
   return kissat_align_word (w);
+#elif defined(DOUBLE_ARENA)
+  return kissat_align_w4rd (w);
 #else
   return kissat_align_w2rd (w);
 #endif
@@ -10,19 +10,29 @@
 #define INVALID_TRAIL UINT_MAX
 
 typedef struct assigned assigned;
+typedef struct analysis analysis;
 struct clause;
 
+// Propagation only touches 'level', 'reason' and the trail position of a
+// variable, thus these are kept dense in 12 bytes.  The 'binary' flag is
+// packed into the trail position, which is always smaller than '2^31'.
+
 struct assigned {
   unsigned level;
-  unsigned trail;
+  unsigned trail : 31;
+  bool binary : 1;
+  unsigned reason;
+};
+
+// The marks used during conflict analysis, minimization and shrinking are
+// kept in a separate array.  They are always reset after analysis and thus
+// do not need to be cleared on assignment.
 
+struct analysis {
   bool analyzed : 1;
-  bool binary : 1;
   bool poisoned : 1;
   bool removable : 1;
   bool shrinkable : 1;
-
-  unsigned reason;
 };
 
 #define ASSIGNED(LIT) \
@@ -32,6 +42,9 @@ struct assigned {
 #define TRAIL(LIT) (ASSIGNED (LIT)->trail)
 #define REASON(LIT) (ASSIGNED (LIT)->reason)
 
+#define ANALYSIS(LIT) \
+  (assert (VALID_INTERNAL_LITERAL (LIT)), solver->analysis + IDX (LIT))
+
 #ifndef FAST_ASSIGN
 
 #include "reference.h"
@@ -0,0 +1,151 @@
+#include "assume.h"
+#include "analyze.h"
+#include "decide.h"
+#include "inline.h"
+#include "inlineframes.h"
+
+#define FAILED_BIT(ELIT) (1u << ((ELIT) < 0))
+
+static unsigned internal_assumption (kissat *solver, int elit) {
+  assert (VALID_EXTERNAL_LITERAL (elit));
+  const unsigned eidx = ABS (elit);
+  const import *const import = &PEEK_STACK (solver->import, eidx);
+  assert (import->imported);
+  assert (!import->eliminated);
+  unsigned ilit = import->lit;
+  if (elit < 0)
+    ilit = NOT (ilit);
+  assert (VALID_INTERNAL_LITERAL (ilit));
+  return ilit;
+}
+
+bool kissat_assuming (kissat *solver) {
+  return solver->level < SIZE_STACK (solver->assumptions);
+}
+
+static void add_failed (kissat *solver, int elit) {
+  import *import = &PEEK_STACK (solver->import, ABS (elit));
+  const unsigned bit = FAILED_BIT (elit);
+  if (import->failed & bit)
+    return;
+  import->failed |= bit;
+  PUSH_STACK (solver->failed, elit);
+  LOG ("external assumption %d failed", elit);
+}
+
+static void analyze_failed_assumption (kissat *solver, int elit,
+                                       unsigned failed) {
+  LOG ("analyzing failed assumption %s", LOGLIT (failed));
+  assert (EMPTY_STACK (solver->failed));
+  assert (EMPTY_STACK (solver->analyzed));
+  assert (VALUE (failed) < 0);
+
+  add_failed (solver, elit);
+
+  assigned *all_assigned = solver->assigned;
+  analysis *analysis = solver->analysis;
+  const unsigned failed_idx = IDX (failed);
+  if (!all_assigned[failed_idx].level) {
+    LOG ("failed assumption %s falsified at root level", LOGLIT (failed));
+    return;
+  }
+  kissat_push_analyzed (solver, analysis, failed_idx);
+
+  const unsigned *const begin =
+      BEGIN_ARRAY (solver->trail) + FRAME (1).trail;
+  const unsigned *t = END_ARRAY (solver->trail);
+
+  while (t != begin) {
+    const unsigned lit = *--t;
+    const unsigned idx = IDX (lit);
+    if (!analysis[idx].analyzed)
+      continue;
+    assigned *a = all_assigned + idx;
+    assert (a->level);
+    if (a->reason == DECISION_REASON) {
+      const int elit = kissat_export_literal (solver, lit);
+      assert (elit);
+      LOG ("assumption %s in failed core", LOGLIT (lit));
+      add_failed (solver, elit);
+    } else if (a->binary) {
+      const unsigned other = a->reason;
+      LOGBINARY (lit, other, "resolving %s reason", LOGLIT (lit));
+      const unsigned other_idx = IDX (other);
+      assigned *b = all_assigned + other_idx;
+      if (b->level && !analysis[other_idx].analyzed)
+        kissat_push_analyzed (solver, analysis, other_idx);
+    } else {
+      assert (a->reason != UNIT_REASON);
+      const reference ref = a->reason;
+      LOGREF (ref, "resolving %s reason", LOGLIT (lit));
+      clause *reason = kissat_dereference_clause (solver, ref);
+      for (all_literals_in_clause (other, reason)) {
+        const unsigned other_idx = IDX (other);
+        if (other_idx == idx)
+          continue;
+        assigned *b = all_assigned + other_idx;
+        if (b->level && !analysis[other_idx].analyzed)
+          kissat_push_analyzed (solver, analysis, other_idx);
+      }
+    }
+  }
+  kissat_reset_only_analyzed_literals (solver);
+  LOG ("found %zu failed assumptions", SIZE_STACK (solver->failed));
+}
+
+int kissat_decide_assumption (kissat *solver) {
+  assert (kissat_assuming (solver));
+  const int elit = PEEK_STACK (solver->assumptions, solver->level);
+  const unsigned lit = internal_assumption (solver, elit);
+  const value value = VALUE (lit);
+  if (value < 0) {
+    INC (assumptions_failed);
+    analyze_failed_assumption (solver, elit, lit);
+    return 20;
+  }
+  if (value > 0) {
+    solver->level++;
+    assert (solver->level != INVALID_LEVEL);
+    kissat_push_frame (solver, lit);
+    assert (solver->level < SIZE_STACK (solver->frames));
+    LOG ("pseudo decision level for satisfied assumption %s",
+         LOGLIT (lit));
+  } else {
+    INC (assumed);
+    kissat_internal_assume (solver, lit);
+  }
+  return 0;
+}
+
+void kissat_freeze_assumptions (kissat *solver) {
+  flags *all_flags = solver->flags;
+  for (all_stack (int, elit, solver->assumptions)) {
+    const unsigned lit = internal_assumption (solver, elit);
+    const unsigned idx = IDX (lit);
+    LOG ("freezing %s", LOGVAR (idx));
+    all_flags[idx].frozen = true;
+  }
+}
+
+void kissat_reset_assumptions (kissat *solver) {
+  if (EMPTY_STACK (solver->assumptions))
+    return;
+  LOG ("resetting %zu assumptions", SIZE_STACK (solver->assumptions));
+  flags *all_flags = solver->flags;
+  for (all_stack (int, elit, solver->assumptions)) {
+    const unsigned lit = internal_assumption (solver, elit);
+    all_flags[IDX (lit)].frozen = false;
+  }
+  CLEAR_STACK (solver->assumptions);
+}
+
+void kissat_reset_failed (kissat *solver) {
+  if (EMPTY_STACK (solver->failed))
+    return;
+  LOG ("resetting %zu failed assumptions", SIZE_STACK (solver->failed));
+  for (all_stack (int, elit, solver->failed)) {
+    import *import = &PEEK_STACK (solver->import, ABS (elit));
+    import->failed = 0;
+  }
+  CLEAR_STACK (solver->failed);
+}
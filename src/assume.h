@@ -0,0 +1,15 @@
+#ifndef _assume_h_INCLUDED
+#define _assume_h_INCLUDED
+
+#include <stdbool.h>
+
+struct kissat;
+
+bool kissat_assuming (struct kissat *);
+int kissat_decide_assumption (struct kissat *);
+
+void kissat_freeze_assumptions (struct kissat *);
+void kissat_reset_assumptions (struct kissat *);
+void kissat_reset_failed (struct kissat *);
+
+#endif
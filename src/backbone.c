@@ -184,15 +184,16 @@ backbone_propagate_literal (kissat *solver, const bool stop_early,
     } else {
       if (stop_early) {
 #ifndef NDEBUG
-        for (const union watch *q = p + 1; q != end_watches; q++) {
-          const union watch watch = *q++;
-          assert (!watch.type.binary);
-        }
+        for (const union watch *q = p - 1; q != end_watches;
+             q += kissat_watch_words (q))
+          assert (!q->type.binary);
 #endif
         break;
       }
 
-      p++;
+      const union watch tail = *p++;
+      if (tail.tail.ternary)
+        p++;
     }
   }
 
@@ -202,12 +203,47 @@ backbone_propagate_literal (kissat *solver, const bool stop_early,
   return 0;
 }
 
+static inline clause *
+backbone_propagate_implications (kissat *solver, unsigned_array *trail,
+                                 value *values, assigned *assigned,
+                                 unsigned lit) {
+  LOG ("backbone propagating %s", LOGLIT (lit));
+  assert (VALID_INTERNAL_LITERAL (lit));
+  assert (values[lit] > 0);
+
+  const unsigned not_lit = NOT (lit);
+  assert (values[not_lit] < 0);
+
+  const unsigned *const begin = BEGIN_IMPLICATIONS (not_lit);
+  const unsigned *const end = END_IMPLICATIONS (not_lit);
+
+  for (const unsigned *p = begin; p != end; p++) {
+    const unsigned other = *p;
+    assert (VALID_INTERNAL_LITERAL (other));
+    const value value = values[other];
+    if (value > 0)
+      continue;
+    if (value < 0) {
+      solver->ticks += 1 + kissat_cache_lines (p - begin, sizeof *p);
+      return kissat_binary_conflict (solver, not_lit, other);
+    }
+    backbone_assign (solver, trail, values, assigned, other, lit);
+    LOG ("backbone assign %s reason binary clause %s %s", LOGLIT (other),
+         LOGLIT (other), LOGLIT (not_lit));
+  }
+
+  solver->ticks += 1 + kissat_cache_lines (end - begin, sizeof *begin);
+
+  return 0;
+}
+
 static inline clause *backbone_propagate (kissat *solver,
                                           unsigned_array *trail,
                                           value *values,
                                           assigned *assigned) {
   const bool stop_early =
       solver->large_clauses_watched_after_binary_clauses;
+  const bool dense = GET_OPTION (implications);
 
   clause *conflict = 0;
   solver->ticks = 0;
@@ -215,9 +251,15 @@ static inline clause *backbone_propagate (kissat *solver,
   const watches *const watches = solver->watches;
   unsigned *propagate = solver->propagate;
 
-  while (!conflict && propagate != END_ARRAY (*trail))
-    conflict = backbone_propagate_literal (
-        solver, stop_early, watches, trail, values, assigned, *propagate++);
+  while (!conflict && propagate != END_ARRAY (*trail)) {
+    const unsigned lit = *propagate++;
+    if (dense)
+      conflict = backbone_propagate_implications (solver, trail, values,
+                                                  assigned, lit);
+    else
+      conflict = backbone_propagate_literal (solver, stop_early, watches,
+                                             trail, values, assigned, lit);
+  }
 
   assert (solver->propagate <= propagate);
   const unsigned propagated = propagate - solver->propagate;
@@ -264,9 +306,10 @@ static unsigned backbone_analyze (kissat *solver, clause *conflict) {
   assert (conflict->size == 2);
 
   assigned *const assigned = solver->assigned;
+  analysis *const analysis = solver->analysis;
 
-  kissat_push_analyzed (solver, assigned, IDX (conflict->lits[0]));
-  kissat_push_analyzed (solver, assigned, IDX (conflict->lits[1]));
+  kissat_push_analyzed (solver, analysis, IDX (conflict->lits[0]));
+  kissat_push_analyzed (solver, analysis, IDX (conflict->lits[1]));
 
   const unsigned *t = END_ARRAY (solver->trail);
 
@@ -276,20 +319,19 @@ static unsigned backbone_analyze (kissat *solver, clause *conflict) {
     unsigned lit = *--t;
 
     const unsigned lit_idx = IDX (lit);
-    const struct assigned *a = assigned + lit_idx;
-    if (!a->analyzed)
+    if (!analysis[lit_idx].analyzed)
       continue;
+    const struct assigned *a = assigned + lit_idx;
 
     LOG ("backbone analyzing %s", LOGLIT (lit));
     const unsigned reason = a->reason;
     assert (reason != UNIT_REASON);
     assert (reason != DECISION_REASON);
     const unsigned reason_idx = IDX (reason);
-    const struct assigned *b = assigned + reason_idx;
-    if (!b->analyzed) {
+    if (!analysis[reason_idx].analyzed) {
       LOG ("reason %s of %s not yet analyzed", LOGLIT (reason),
            LOGLIT (lit));
-      kissat_push_analyzed (solver, assigned, reason_idx);
+      kissat_push_analyzed (solver, analysis, reason_idx);
     } else {
       LOG ("backbone UIP %s", LOGLIT (reason));
       kissat_reset_only_analyzed_literals (solver);
@@ -585,6 +627,8 @@ void kissat_binary_clauses_backbone (kissat *solver) {
   assert (!solver->backbone_computing);
   solver->backbone_computing = true;
 #endif
+  if (GET_OPTION (implications))
+    kissat_build_implications (solver);
 #ifndef QUIET
   const unsigned failed =
 #endif
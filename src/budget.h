@@ -0,0 +1,32 @@
+#ifndef _budget_h_INCLUDED
+#define _budget_h_INCLUDED
+
+#include "internal.h"
+
+// With a memory limit set through 'kissat_set_memory_limit' the solver is
+// under memory pressure as soon as the bytes allocated through it reach
+// 'memorypressure' percent of the limit.  This includes the memory of its
+// worker threads, but not memory allocated outside of the solver, e.g.,
+// by other solvers of a portfolio, which thus split the limit.  Then
+// clause database reductions are triggered earlier and remove more
+// clauses, the whole arena is compacted and watches are defragmented.
+// Inprocessing allocating temporary data structures (preprocessing,
+// elimination, probing, local search, congruence closure and factoring)
+// is skipped at its entry point.  If the limit is still exceeded after a
+// reduction the search stops with unknown result.
+
+static inline bool kissat_memory_pressure (kissat *solver) {
+  if (!solver->limited.memory)
+    return false;
+  const uint64_t limit = solver->limits.memory;
+  const uint64_t pressure = limit / 100 * GET_OPTION (memorypressure);
+  return solver->allocated >= pressure;
+}
+
+static inline bool kissat_memory_exceeded (kissat *solver) {
+  if (!solver->limited.memory)
+    return false;
+  return solver->allocated > solver->limits.memory;
+}
+
+#endif
@@ -22,6 +22,7 @@ void kissat_print_checker_statistics (struct kissat *, bool verbose);
 #endif
 
 void kissat_add_unchecked_external (struct kissat *, size_t, const int *);
+void kissat_add_unchecked_internal (struct kissat *, size_t, unsigned *);
 
 void kissat_check_and_add_binary (struct kissat *, unsigned, unsigned);
 void kissat_check_and_add_clause (struct kissat *, struct clause *c);
@@ -46,6 +47,12 @@ void kissat_remove_checker_internal (struct kissat *, size_t,
       kissat_add_unchecked_external (solver, (SIZE), (LITS)); \
   } while (0)
 
+#define ADD_UNCHECKED_INTERNAL(SIZE, LITS) \
+  do { \
+    if (GET_OPTION (check) > 1) \
+      kissat_add_unchecked_internal (solver, (SIZE), (LITS)); \
+  } while (0)
+
 #define CHECK_AND_ADD_BINARY(A, B) \
   do { \
     if (GET_OPTION (check) > 1) \
@@ -131,6 +138,9 @@ void kissat_remove_checker_internal (struct kissat *, size_t,
 #define ADD_UNCHECKED_EXTERNAL(...) \
   do { \
   } while (0)
+#define ADD_UNCHECKED_INTERNAL(...) \
+  do { \
+  } while (0)
 #define CHECK_AND_ADD_BINARY(...) \
   do { \
   } while (0)
@@ -0,0 +1,496 @@
+#include "checkpoint.h"
+#include "allocate.h"
+#include "backtrack.h"
+#include "error.h"
+#include "inline.h"
+#include "inlineheap.h"
+#include "print.h"
+#include "require.h"
+#include "resize.h"
+#include "resources.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+// A checkpoint captures the solver at the root level between two
+// restarts.  Besides the clauses (the arena is compacted on the fly and
+// watches are rebuilt when resuming) it contains all per-variable arrays,
+// the import, export, unit, elimination and extension stacks and all the
+// scalar state listed in 'SCALARS' below, which covers statistics, limits,
+// delays, averages, the queue and the search mode.  Resuming restores
+// this state into a fresh solver and continues searching where the
+// checkpoint was taken without preprocessing or resetting limits.
+
+#define CHECKPOINT_MAGIC "kisscpt"
+#define CHECKPOINT_VERSION 2
+
+// Number of conflicts between checking the clock.
+
+#define CHECKPOINT_POLL 1000
+
+#define SCALARS \
+  SCALAR (active) \
+  SCALAR (unassigned) \
+  SCALAR (randec) \
+  SCALAR (best_assigned) \
+  SCALAR (target_assigned) \
+  SCALAR (queue) \
+  SCALAR (scinc) \
+  SCALAR (scoreshift) \
+  SCALAR (random) \
+  SCALAR (averages) \
+  SCALAR (tier1) \
+  SCALAR (tier2) \
+  SCALAR (reluctant) \
+  SCALAR (bounds) \
+  SCALAR (classification) \
+  SCALAR (delays) \
+  SCALAR (enabled) \
+  SCALAR (limits) \
+  SCALAR (last) \
+  SCALAR (walked) \
+  SCALAR (mode) \
+  SCALAR (ticks) \
+  SCALAR (sweep_incomplete) \
+  SCALAR (statistics) \
+  OPTIONS_SCALAR
+
+#ifndef NOPTIONS
+#define OPTIONS_SCALAR SCALAR (options)
+#else
+#define OPTIONS_SCALAR
+#endif
+
+#ifndef NOPTIONS
+
+// Options restored from the checkpoint except for those which only
+// control output, checking and checkpointing itself and thus are taken
+// from the resuming solver.
+
+static const char *session_options[] = {
+    "check", "checkpointint", "log", "profile", "quiet", "statistics",
+    "verbose",
+};
+
+#endif
+
+typedef struct checkpoint_header checkpoint_header;
+typedef struct reader reader;
+
+struct checkpoint_header {
+  char magic[8];
+  uint32_t version;
+  uint32_t scalar_bytes;
+  uint32_t ward_bytes;
+  uint32_t clause_bytes;
+  int32_t max_var;
+  uint32_t vars;
+};
+
+struct reader {
+  FILE *file;
+  uint64_t remaining;
+};
+
+static uint32_t scalar_bytes (kissat *solver) {
+  uint32_t res = 0;
+#define SCALAR(NAME) res += sizeof solver->NAME;
+  SCALARS
+#undef SCALAR
+  return res;
+}
+
+void kissat_set_checkpoint (kissat *solver, const char *path,
+                            int max_var) {
+  checkpoint *checkpoint = &solver->checkpoint;
+  checkpoint->path = path;
+  checkpoint->max_var = max_var;
+  checkpoint->conflicts = CONFLICTS + CHECKPOINT_POLL;
+  checkpoint->written = kissat_wall_clock_time ();
+}
+
+bool kissat_checkpointing (kissat *solver) {
+  checkpoint *checkpoint = &solver->checkpoint;
+  if (!checkpoint->path)
+    return false;
+  if (CONFLICTS < checkpoint->conflicts)
+    return false;
+  checkpoint->conflicts = CONFLICTS + CHECKPOINT_POLL;
+  if (!EMPTY_STACK (solver->assumptions))
+    return false;
+  const double elapsed = kissat_wall_clock_time () - checkpoint->written;
+  return elapsed >= GET_OPTION (checkpointint);
+}
+
+static bool write_bytes (FILE *file, const void *ptr, size_t bytes) {
+  return fwrite (ptr, 1, bytes, file) == bytes;
+}
+
+static bool write_stack (FILE *file, const void *begin, uint64_t bytes) {
+  return write_bytes (file, &bytes, sizeof bytes) &&
+         write_bytes (file, begin, bytes);
+}
+
+#define WRITE_STACK(S) \
+  write_stack (file, BEGIN_STACK (S), \
+               SIZE_STACK (S) * sizeof *BEGIN_STACK (S))
+
+static bool write_binaries (kissat *solver, FILE *file, bool count_only,
+                            uint64_t *binaries_ptr) {
+  uint64_t binaries = 0;
+  for (all_literals (lit))
+    for (all_binary_blocking_watches (watch, WATCHES (lit)))
+      if (watch.type.binary) {
+        const unsigned other = watch.binary.lit;
+        if (other < lit)
+          continue;
+        if (!count_only) {
+          const unsigned pair[2] = {lit, other};
+          if (!write_bytes (file, pair, sizeof pair))
+            return false;
+        }
+        binaries++;
+      }
+  *binaries_ptr = binaries;
+  return true;
+}
+
+static bool write_clauses (kissat *solver, FILE *file, bool count_only,
+                           uint64_t *bytes_ptr) {
+  uint64_t written = 0;
+  for (all_clauses (c))
+    if (!c->garbage) {
+      const size_t bytes = kissat_bytes_of_clause (c->size);
+      if (!count_only && !write_bytes (file, c, bytes))
+        return false;
+      written += bytes;
+    }
+  *bytes_ptr = written;
+  return true;
+}
+
+bool kissat_write_checkpoint (kissat *solver, const char *path) {
+  assert (!solver->level);
+  assert (solver->watching);
+  assert (!solver->inconsistent);
+  assert (kissat_trail_flushed (solver));
+  FILE *file = fopen (path, "wb");
+  if (!file)
+    return false;
+  checkpoint_header header;
+  memset (&header, 0, sizeof header);
+  memcpy (header.magic, CHECKPOINT_MAGIC, sizeof header.magic);
+  header.version = CHECKPOINT_VERSION;
+  header.scalar_bytes = scalar_bytes (solver);
+  header.ward_bytes = sizeof (ward);
+  header.clause_bytes = sizeof (clause);
+  header.max_var = solver->checkpoint.max_var;
+  header.vars = VARS;
+  bool ok = write_bytes (file, &header, sizeof header);
+#define SCALAR(NAME) \
+  ok = ok && write_bytes (file, &solver->NAME, sizeof solver->NAME);
+  SCALARS
+#undef SCALAR
+  const size_t vars = VARS;
+  ok = ok &&
+       write_bytes (file, solver->assigned, vars * sizeof (assigned)) &&
+       write_bytes (file, solver->flags, vars * sizeof (flags)) &&
+       write_bytes (file, solver->links, vars * sizeof (links)) &&
+       write_bytes (file, solver->values, 2 * vars * sizeof (value)) &&
+       write_bytes (file, solver->phases.best, vars * sizeof (value)) &&
+       write_bytes (file, solver->phases.saved, vars * sizeof (value)) &&
+       write_bytes (file, solver->phases.target, vars * sizeof (value));
+  for (unsigned idx = 0; ok && idx != vars; idx++) {
+    const double score = kissat_get_heap_score (SCORES, idx);
+    ok = write_bytes (file, &score, sizeof score);
+  }
+  ok = ok && WRITE_STACK (SCORES->stack) && WRITE_STACK (solver->import) &&
+       WRITE_STACK (solver->export) && WRITE_STACK (solver->units) &&
+       WRITE_STACK (solver->eliminated) && WRITE_STACK (solver->extend);
+  uint64_t binaries, bytes;
+  (void) write_binaries (solver, 0, true, &binaries);
+  ok = ok && write_bytes (file, &binaries, sizeof binaries) &&
+       write_binaries (solver, file, false, &binaries);
+  (void) write_clauses (solver, 0, true, &bytes);
+  ok = ok && write_bytes (file, &bytes, sizeof bytes) &&
+       write_clauses (solver, file, false, &bytes);
+  if (fclose (file))
+    ok = false;
+  return ok;
+}
+
+void kissat_checkpoint (kissat *solver) {
+  checkpoint *checkpoint = &solver->checkpoint;
+  assert (checkpoint->path);
+  kissat_backtrack_propagate_and_flush_trail (solver);
+  const char *path = checkpoint->path;
+  const size_t bytes = strlen (path) + 5;
+  char *tmp = kissat_malloc (solver, bytes);
+  sprintf (tmp, "%s.tmp", path);
+#ifndef QUIET
+  const double started = kissat_wall_clock_time ();
+#endif
+  if (kissat_write_checkpoint (solver, tmp) && !rename (tmp, path)) {
+    INC (checkpoints);
+    kissat_phase (solver, "checkpoint", GET (checkpoints),
+                  "wrote checkpoint after %" PRIu64 " conflicts "
+                  "in %.2f seconds",
+                  CONFLICTS, kissat_wall_clock_time () - started);
+  } else {
+    (void) remove (tmp);
+    kissat_warning (solver, "failed to write checkpoint '%s'", path);
+  }
+  kissat_free (solver, tmp, bytes);
+  checkpoint->written = kissat_wall_clock_time ();
+}
+
+static bool read_bytes (reader *reader, void *ptr, size_t bytes) {
+  if (reader->remaining < bytes)
+    return false;
+  if (fread (ptr, 1, bytes, reader->file) != bytes)
+    return false;
+  reader->remaining -= bytes;
+  return true;
+}
+
+static bool read_stack (kissat *solver, reader *reader, chars *stack,
+                        size_t element) {
+  uint64_t bytes;
+  if (!read_bytes (reader, &bytes, sizeof bytes))
+    return false;
+  if (bytes > reader->remaining || bytes % element)
+    return false;
+  assert (EMPTY_STACK (*stack));
+  while (CAPACITY_STACK (*stack) < bytes)
+    kissat_stack_enlarge (solver, stack, element);
+  if (bytes && !read_bytes (reader, BEGIN_STACK (*stack), bytes))
+    return false;
+  stack->end = stack->begin + bytes;
+  return true;
+}
+
+#define READ_STACK(S) \
+  read_stack (solver, reader, (chars *) &(S), sizeof *BEGIN_STACK (S))
+
+static const char *resume_variables (kissat *solver, reader *reader) {
+  const size_t vars = VARS;
+  if (!read_bytes (reader, solver->assigned, vars * sizeof (assigned)) ||
+      !read_bytes (reader, solver->flags, vars * sizeof (flags)) ||
+      !read_bytes (reader, solver->links, vars * sizeof (links)) ||
+      !read_bytes (reader, solver->values, 2 * vars * sizeof (value)) ||
+      !read_bytes (reader, solver->phases.best, vars * sizeof (value)) ||
+      !read_bytes (reader, solver->phases.saved, vars * sizeof (value)) ||
+      !read_bytes (reader, solver->phases.target, vars * sizeof (value)))
+    return "truncated variables in checkpoint";
+  heap *scores = SCORES;
+  for (unsigned idx = 0; idx != vars; idx++) {
+    double score;
+    if (!read_bytes (reader, &score, sizeof score))
+      return "truncated scores in checkpoint";
+    kissat_update_heap (solver, scores, idx, score);
+  }
+  unsigneds contained;
+  INIT_STACK (contained);
+  const bool ok = READ_STACK (contained);
+  const char *error = ok ? 0 : "truncated score heap in checkpoint";
+  for (all_stack (unsigned, idx, contained))
+    if (error)
+      break;
+    else if (idx >= vars || kissat_heap_contains (scores, idx))
+      error = "invalid score heap in checkpoint";
+    else
+      kissat_push_heap (solver, scores, idx);
+  RELEASE_STACK (contained);
+  return error;
+}
+
+static const char *resume_stacks (kissat *solver, reader *reader) {
+  if (!READ_STACK (solver->import) || !READ_STACK (solver->export) ||
+      !READ_STACK (solver->units) || !READ_STACK (solver->eliminated) ||
+      !READ_STACK (solver->extend))
+    return "truncated stacks in checkpoint";
+  if (SIZE_STACK (solver->export) != VARS)
+    return "invalid export map in checkpoint";
+  const size_t imported = SIZE_STACK (solver->import);
+  for (all_stack (import, import, solver->import))
+    if (!import.imported)
+      continue;
+    else if (import.eliminated) {
+      if (import.lit >= SIZE_STACK (solver->eliminated))
+        return "invalid eliminated variable in checkpoint";
+    } else if (import.lit >= LITS)
+      return "invalid imported variable in checkpoint";
+  for (all_stack (int, elit, solver->export))
+    if (elit == INT_MIN || (size_t) ABS (elit) >= imported)
+      return "invalid exported variable in checkpoint";
+  for (all_stack (extension, extension, solver->extend))
+    if ((size_t) ABS (extension.lit) >= imported)
+      return "invalid extension stack in checkpoint";
+  return 0;
+}
+
+static const char *resume_binaries (kissat *solver, reader *reader) {
+  uint64_t binaries;
+  if (!read_bytes (reader, &binaries, sizeof binaries) ||
+      binaries > reader->remaining / (2 * sizeof (unsigned)))
+    return "truncated binary clauses in checkpoint";
+  for (uint64_t i = 0; i != binaries; i++) {
+    unsigned pair[2];
+    if (!read_bytes (reader, pair, sizeof pair))
+      return "truncated binary clauses in checkpoint";
+    const unsigned a = pair[0], b = pair[1];
+    if (a >= LITS || b >= LITS || IDX (a) == IDX (b))
+      return "invalid binary clause in checkpoint";
+    ADD_UNCHECKED_INTERNAL (2, pair);
+    kissat_watch_binary (solver, a, b);
+  }
+  return 0;
+}
+
+static const char *resume_clauses (kissat *solver, reader *reader) {
+  if (!READ_STACK (solver->arena))
+    return "truncated large clauses in checkpoint";
+  if (SIZE_STACK (solver->arena) > MAX_ARENA)
+    return "checkpoint arena too large";
+  ward *const begin = BEGIN_STACK (solver->arena);
+  ward *const end = END_STACK (solver->arena);
+  for (ward *p = begin; p != end;) {
+    if ((size_t) (end - p) * sizeof (ward) < sizeof (clause))
+      return "truncated clause in checkpoint";
+    clause *c = (clause *) p;
+    const unsigned size = c->size;
+    if (size < 3)
+      return "invalid clause size in checkpoint";
+    const size_t needed = kissat_bytes_of_clause (size) / sizeof (ward);
+    if ((size_t) (end - p) < needed)
+      return "truncated clause in checkpoint";
+    for (all_literals_in_clause (lit, c))
+      if (lit >= LITS)
+        return "invalid literal in checkpoint";
+    c->reason = false;
+    c->shrunken = false;
+    const reference ref = p - begin;
+    if (!c->redundant)
+      solver->last_irredundant = ref;
+    else if (solver->first_reducible == INVALID_REF)
+      solver->first_reducible = ref;
+    ADD_UNCHECKED_INTERNAL (size, c->lits);
+    p += needed;
+  }
+  kissat_watch_large_clauses (solver);
+  return 0;
+}
+
+static const char *resume (kissat *solver, reader *reader,
+                           int *max_var_ptr) {
+  checkpoint_header header;
+  if (!read_bytes (reader, &header, sizeof header))
+    return "truncated checkpoint header";
+  if (memcmp (header.magic, CHECKPOINT_MAGIC, sizeof header.magic))
+    return "invalid checkpoint signature";
+  if (header.version != CHECKPOINT_VERSION)
+    return "unsupported checkpoint version";
+  if (header.scalar_bytes != scalar_bytes (solver) ||
+      header.ward_bytes != sizeof (ward) ||
+      header.clause_bytes != sizeof (clause))
+    return "checkpoint written by incompatible solver build";
+  if (header.max_var < 0 || header.max_var > EXTERNAL_MAX_VAR)
+    return "invalid maximum variable in checkpoint";
+  if (header.vars > INTERNAL_MAX_VAR + 1)
+    return "invalid number of variables in checkpoint";
+
+  kissat_enlarge_variables (solver, header.vars);
+#ifndef NOPTIONS
+  const options options = solver->options;
+#endif
+#ifdef METRICS
+  const uint64_t allocated_current = solver->statistics.allocated_current;
+  const uint64_t allocated_max = solver->statistics.allocated_max;
+#endif
+  const limited limited = solver->limited;
+  const uint64_t conflicts = solver->limits.conflicts - CONFLICTS;
+  const uint64_t decisions = solver->limits.decisions - DECISIONS;
+  bool ok = true;
+#define SCALAR(NAME) \
+  ok = ok && read_bytes (reader, &solver->NAME, sizeof solver->NAME);
+  SCALARS
+#undef SCALAR
+#ifdef METRICS
+  solver->statistics.allocated_current = allocated_current;
+  solver->statistics.allocated_max = allocated_max;
+  solver->statistics.arena_garbage = 0;
+#endif
+  if (!ok)
+    return "truncated state in checkpoint";
+#ifndef NOPTIONS
+  for (size_t i = 0; i != sizeof session_options / sizeof (char *); i++) {
+    const char *name = session_options[i];
+    if (kissat_options_has (name))
+      (void) kissat_options_set (&solver->options, name,
+                                 kissat_options_get (&options, name));
+  }
+#endif
+  if (limited.conflicts)
+    solver->limits.conflicts = CONFLICTS + conflicts;
+  if (limited.decisions)
+    solver->limits.decisions = DECISIONS + decisions;
+#ifndef QUIET
+  solver->mode.entered = kissat_process_time ();
+#endif
+
+  const char *error = resume_variables (solver, reader);
+  if (!error)
+    error = resume_stacks (solver, reader);
+  if (!error)
+    error = resume_binaries (solver, reader);
+  if (!error)
+    error = resume_clauses (solver, reader);
+  if (!error && reader->remaining)
+    error = "trailing data in checkpoint";
+  if (error)
+    return error;
+
+#ifndef NDEBUG
+  for (all_variables (idx)) {
+    const unsigned lit = LIT (idx);
+    const value value = VALUE (lit);
+    if (!value)
+      continue;
+    unsigned unit = value > 0 ? lit : NOT (lit);
+    ADD_UNCHECKED_INTERNAL (1, &unit);
+  }
+#endif
+  *max_var_ptr = header.max_var;
+  solver->checkpoint.resumed = true;
+  kissat_message (solver,
+                  "resumed %u variables and %" PRIu64 " clauses "
+                  "after %" PRIu64 " conflicts",
+                  header.vars, BINIRR_CLAUSES + REDUNDANT_CLAUSES,
+                  CONFLICTS);
+  return 0;
+}
+
+const char *kissat_resume (kissat *solver, const char *path,
+                           int *max_var_ptr) {
+  kissat_require (EMPTY_STACK (solver->import) && !GET (searches),
+                  "can only resume fresh solver");
+#ifndef NPROOFS
+  kissat_require (!solver->proof, "can not resume with proof");
+#endif
+  reader reader;
+  reader.file = fopen (path, "rb");
+  if (!reader.file)
+    return "can not open checkpoint";
+  const char *error = 0;
+  long size;
+  if (fseek (reader.file, 0, SEEK_END) ||
+      (size = ftell (reader.file)) < 0 || fseek (reader.file, 0, SEEK_SET))
+    error = "can not determine size of checkpoint";
+  else {
+    reader.remaining = size;
+    error = resume (solver, &reader, max_var_ptr);
+  }
+  fclose (reader.file);
+  return error;
+}
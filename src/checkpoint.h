@@ -0,0 +1,27 @@
+#ifndef _checkpoint_h_INCLUDED
+#define _checkpoint_h_INCLUDED
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct checkpoint checkpoint;
+
+struct checkpoint {
+  bool resumed;
+  int max_var;
+  const char *path;
+  uint64_t conflicts;
+  double written;
+};
+
+struct kissat;
+
+void kissat_set_checkpoint (struct kissat *, const char *path, int max_var);
+bool kissat_checkpointing (struct kissat *);
+void kissat_checkpoint (struct kissat *);
+
+bool kissat_write_checkpoint (struct kissat *, const char *path);
+const char *kissat_resume (struct kissat *, const char *path,
+                           int *max_var_ptr);
+
+#endif
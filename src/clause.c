@@ -46,6 +46,9 @@ static void init_clause (clause *res, bool redundant, unsigned glue,
   res->used = 0;
 
   res->searched = 2;
+#ifndef NPROOFS
+  res->id = 0;
+#endif
   res->size = size;
 }
 
@@ -88,7 +91,7 @@ static reference new_large_clause (kissat *solver, bool original,
   memcpy (c->lits, lits, size * sizeof (unsigned));
   LOGREF (res, "new");
   if (solver->watching)
-    kissat_watch_reference (solver, lits[0], lits[1], res);
+    kissat_watch_clause (solver, c);
   else
     kissat_connect_clause (solver, c);
   if (redundant) {
@@ -103,6 +106,7 @@ static reference new_large_clause (kissat *solver, bool original,
     CHECK_AND_ADD_CLAUSE (c);
     ADD_CLAUSE_TO_PROOF (c);
   }
+  LRAT_IDENTIFY (c);
   return res;
 }
 
@@ -7,6 +7,7 @@
 #include "utilities.h"
 
 #include <stdbool.h>
+#include <stdint.h>
 
 typedef struct clause clause;
 
@@ -31,6 +32,9 @@ struct clause {
   unsigned used : LD_MAX_USED;
 
   unsigned searched;
+#ifndef NPROOFS
+  uint64_t id;
+#endif
   unsigned size;
 
   unsigned lits[3];
@@ -14,7 +14,7 @@
 #include <string.h>
 
 static void flush_watched_clauses_by_literal (kissat *solver, unsigned lit,
-                                              bool compact,
+                                              bool compact, bool reordered,
                                               reference start) {
   assert (start != INVALID_REF);
 
@@ -61,11 +61,16 @@ static void flush_watched_clauses_by_literal (kissat *solver, unsigned lit,
     } else {
       assert (solver->watching);
       const watch tail = *p++;
+      watch third;
+      if (tail.tail.ternary)
+        third = *p++;
       if (!lit_fixed) {
-        const reference ref = tail.large.ref;
+        const reference ref = tail.tail.ref;
         if (ref < start) {
           *q++ = head;
           *q++ = tail;
+          if (tail.tail.ternary)
+            *q++ = third;
         }
       }
     }
@@ -80,6 +85,9 @@ static void flush_watched_clauses_by_literal (kissat *solver, unsigned lit,
   if (!compact)
     return;
 
+  if (reordered) // Watches are permuted after flushing all of them.
+    return;
+
   if (mlit == INVALID_LIT)
     return;
 
@@ -101,14 +109,16 @@ static void flush_watched_clauses_by_literal (kissat *solver, unsigned lit,
 }
 
 static void flush_all_watched_clauses (kissat *solver, bool compact,
-                                       reference start) {
+                                       bool reordered, reference start) {
   assert (solver->watching);
   LOG ("starting to flush watches at clause[%" REFERENCE_FORMAT "]", start);
   for (all_variables (idx)) {
     const unsigned lit = LIT (idx);
-    flush_watched_clauses_by_literal (solver, lit, compact, start);
+    flush_watched_clauses_by_literal (solver, lit, compact, reordered,
+                                      start);
     const unsigned not_lit = NOT (lit);
-    flush_watched_clauses_by_literal (solver, not_lit, compact, start);
+    flush_watched_clauses_by_literal (solver, not_lit, compact, reordered,
+                                      start);
   }
 }
 
@@ -336,9 +346,16 @@ static reference sparse_sweep_garbage_clauses (kissat *solver, bool compact,
     next = kissat_next_clause (src);
 #if !defined(NDEBUG) || defined(CHECKING_OR_PROVING)
     const unsigned old_size = src->size;
+#endif
+#ifndef NPROOFS
+    const uint64_t id = src->id;
+    clause *const moved = dst;
 #endif
     assert (SIZE_OF_CLAUSE_HEADER == sizeof (unsigned));
     *(unsigned *) dst = *(unsigned *) src;
+#ifndef NPROOFS
+    dst->id = id;
+#endif
 
     unsigned *q = dst->lits;
 
@@ -403,7 +420,7 @@ static reference sparse_sweep_garbage_clauses (kissat *solver, bool compact,
 #ifdef CHECKING_OR_PROVING
       if (checking_or_proving) {
         REMOVE_CHECKER_STACK (solver->removed);
-        DELETE_STACK_FROM_PROOF (solver->removed);
+        DELETE_IDENTIFIED_STACK_FROM_PROOF (id, solver->removed);
         CLEAR_STACK (solver->added);
         CLEAR_STACK (solver->removed);
       }
@@ -499,10 +516,13 @@ static reference sparse_sweep_garbage_clauses (kissat *solver, bool compact,
       assert (new_size < old_size);
 
       CHECK_AND_ADD_STACK (solver->added);
+      LRAT_CHAIN_SHRUNKEN (id, solver->removed);
       ADD_STACK_TO_PROOF (solver->added);
+      if (new_size > 2)
+        LRAT_IDENTIFY (moved);
 
       REMOVE_CHECKER_STACK (solver->removed);
-      DELETE_STACK_FROM_PROOF (solver->removed);
+      DELETE_IDENTIFIED_STACK_FROM_PROOF (id, solver->removed);
     }
     CLEAR_STACK (solver->added);
     CLEAR_STACK (solver->removed);
@@ -597,11 +617,7 @@ static void rewatch_clauses (kissat *solver, reference start) {
     c->searched = 2;
 
     const reference ref = (ward *) c - arena;
-    const unsigned l0 = lits[0];
-    const unsigned l1 = lits[1];
-
-    kissat_push_blocking_watch (solver, watches + l0, l1, ref);
-    kissat_push_blocking_watch (solver, watches + l1, l0, ref);
+    kissat_push_clause_watches (solver, watches, c->size, lits, ref);
   }
 }
 
@@ -612,16 +628,19 @@ void kissat_sparse_collect (kissat *solver, bool compact, reference start) {
   INC (sparse_gcs);
   REPORT (1, 'G');
   unsigned vars, mfixed;
+  bool reordered = false;
   if (compact)
-    vars = kissat_compact_literals (solver, &mfixed);
+    vars = kissat_compact_literals (solver, &mfixed, &reordered);
   else {
     vars = solver->vars;
     mfixed = INVALID_LIT;
   }
-  flush_all_watched_clauses (solver, compact, start);
+  flush_all_watched_clauses (solver, compact, reordered, start);
+  if (reordered)
+    kissat_permute_watches (solver, vars);
   reference move = sparse_sweep_garbage_clauses (solver, compact, start);
   if (compact)
-    kissat_finalize_compacting (solver, vars, mfixed);
+    kissat_finalize_compacting (solver, vars, mfixed, reordered);
   if (move != INVALID_REF)
     move_redundant_clauses_to_the_end (solver, move);
   rewatch_clauses (solver, start);
@@ -686,6 +705,9 @@ static void dense_sweep_garbage_clauses (kissat *solver) {
     assert (SIZE_OF_CLAUSE_HEADER == sizeof (unsigned));
     *(unsigned *) dst = *(unsigned *) src;
     dst->searched = src->searched;
+#ifndef NPROOFS
+    dst->id = src->id;
+#endif
     dst->size = src->size;
     dst->shrunken = false;
     memmove (dst->lits, src->lits, src->size * sizeof (unsigned));
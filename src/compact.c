@@ -1,7 +1,10 @@
 #include "compact.h"
+#include "budget.h"
 #include "inline.h"
 #include "inlineheap.h"
+#include "inlinevector.h"
 #include "print.h"
+#include "rank.h"
 #include "resize.h"
 
 #include <string.h>
@@ -16,7 +19,230 @@ static void reimport_literal (kissat *solver, unsigned eidx,
   import->lit = mlit;
 }
 
-unsigned kissat_compact_literals (kissat *solver, unsigned *mfixed_ptr) {
+// Optionally variables are renumbered during compaction in breadth-first
+// order over irredundant clauses starting from variables with few
+// occurrences (thus a variant of the Cuthill-McKee algorithm), so that
+// variables occurring together in clauses get close indices in 'values',
+// 'assigned', 'flags' and 'watches'.  As proxy for cache misses during
+// propagation we count the cache lines of 'values' and 'assigned' touched
+// by each clause, and only renumber if that reduces their number compared
+// to plain compaction, which keeps the relative order of variables.
+
+static uint64_t count_cache_lines (kissat *solver, const unsigneds *starts,
+                                   const unsigneds *variables,
+                                   const unsigned *rank) {
+  const size_t vars = solver->vars;
+  const unsigned shift = ASSUMED_LD_CACHE_LINE_BYTES;
+  const size_t values_lines = ((2 * vars) >> shift) + 1;
+  const size_t assigned_lines = ((vars * sizeof (assigned)) >> shift) + 1;
+  const size_t lines = values_lines + assigned_lines;
+  unsigned *stamps = kissat_calloc (solver, lines, sizeof *stamps);
+  const unsigned *const begin = BEGIN_STACK (*variables);
+  const size_t clauses = SIZE_STACK (*starts) - 1;
+  uint64_t res = 0;
+  for (size_t i = 0; i < clauses; i++) {
+    const unsigned stamp = i + 1;
+    const unsigned *const end = begin + PEEK_STACK (*starts, i + 1);
+    for (const unsigned *p = begin + PEEK_STACK (*starts, i); p != end;
+         p++) {
+      const size_t idx = rank[*p];
+      assert (idx < vars);
+      const size_t values_line = (2 * idx) >> shift;
+      const size_t assigned_line =
+          values_lines + ((idx * sizeof (assigned)) >> shift);
+      if (stamps[values_line] != stamp)
+        stamps[values_line] = stamp, res++;
+      if (stamps[assigned_line] != stamp)
+        stamps[assigned_line] = stamp, res++;
+    }
+  }
+  kissat_dealloc (solver, stamps, lines, sizeof *stamps);
+  return res;
+}
+
+static void push_clause_variables (kissat *solver, unsigneds *starts,
+                                   unsigneds *variables, unsigned *degrees,
+                                   size_t start) {
+  const size_t end = SIZE_STACK (*variables);
+  if (end - start < 2) {
+    RESIZE_STACK (*variables, start);
+    return;
+  }
+  PUSH_STACK (*starts, start);
+  for (size_t i = start; i < end; i++)
+    degrees[PEEK_STACK (*variables, i)]++;
+}
+
+#define RANK_DEGREE(IDX) (degrees[IDX])
+
+static unsigned *breadth_first_order (kissat *solver, unsigneds *starts,
+                                      unsigneds *variables,
+                                      unsigned *degrees) {
+  const unsigned vars = solver->vars;
+  const flags *const all_flags = solver->flags;
+  const size_t clauses = SIZE_STACK (*starts) - 1;
+  const unsigned *const begin = BEGIN_STACK (*variables);
+
+  unsigned *offsets = kissat_nalloc (solver, vars + 1, sizeof *offsets);
+  unsigneds candidates;
+  INIT_STACK (candidates);
+  unsigned offset = 0;
+  for (all_variables (idx)) {
+    offsets[idx] = offset;
+    offset += degrees[idx];
+    if (all_flags[idx].active)
+      PUSH_STACK (candidates, idx);
+  }
+  offsets[vars] = offset;
+  RADIX_STACK (unsigned, unsigned, candidates, RANK_DEGREE);
+
+  unsigned *occurrences =
+      kissat_nalloc (solver, offset, sizeof *occurrences);
+  for (all_variables (idx))
+    degrees[idx] = offsets[idx];
+  for (size_t i = 0; i < clauses; i++) {
+    const unsigned *const end = begin + PEEK_STACK (*starts, i + 1);
+    for (const unsigned *p = begin + PEEK_STACK (*starts, i); p != end;
+         p++)
+      occurrences[degrees[*p]++] = i;
+  }
+
+  unsigned *rank = kissat_nalloc (solver, vars, sizeof *rank);
+  for (all_variables (idx))
+    rank[idx] = INVALID_IDX;
+  unsigned *queue = kissat_nalloc (solver, vars, sizeof *queue);
+  bool *visited = kissat_calloc (solver, clauses, sizeof *visited);
+  unsigned head = 0, tail = 0;
+  for (all_stack (unsigned, root, candidates)) {
+    if (rank[root] != INVALID_IDX)
+      continue;
+    rank[root] = tail;
+    queue[tail++] = root;
+    while (head != tail) {
+      const unsigned idx = queue[head++];
+      const unsigned *const end = occurrences + offsets[idx + 1];
+      for (const unsigned *p = occurrences + offsets[idx]; p != end; p++) {
+        const unsigned i = *p;
+        if (visited[i])
+          continue;
+        visited[i] = true;
+        const unsigned *const end_clause =
+            begin + PEEK_STACK (*starts, i + 1);
+        for (const unsigned *q = begin + PEEK_STACK (*starts, i);
+             q != end_clause; q++) {
+          const unsigned other = *q;
+          if (rank[other] != INVALID_IDX)
+            continue;
+          rank[other] = tail;
+          queue[tail++] = other;
+        }
+      }
+    }
+  }
+  assert (tail == SIZE_STACK (candidates));
+  LOG ("ordered %u active variables breadth-first", tail);
+
+  DEALLOC (visited, clauses);
+  DEALLOC (queue, vars);
+  DEALLOC (occurrences, offset);
+  RELEASE_STACK (candidates);
+  DEALLOC (offsets, vars + 1);
+  return rank;
+}
+
+static unsigned *reorder_variables (kissat *solver) {
+  if (!GET_OPTION (compactorder))
+    return 0;
+  if (kissat_memory_pressure (solver)) {
+    kissat_extremely_verbose (solver, "not reordering variables "
+                                      "under memory pressure");
+    return 0;
+  }
+  const unsigned vars = solver->vars;
+  const flags *const all_flags = solver->flags;
+  unsigned *degrees = kissat_calloc (solver, vars, sizeof *degrees);
+  unsigneds starts, variables;
+  INIT_STACK (starts);
+  INIT_STACK (variables);
+  for (all_literals (lit)) {
+    const unsigned idx = IDX (lit);
+    if (!all_flags[idx].active)
+      continue;
+    for (all_binary_blocking_watches (watch, WATCHES (lit))) {
+      if (!watch.type.binary)
+        continue;
+      const unsigned other = watch.binary.lit;
+      if (other < lit)
+        continue;
+      const unsigned other_idx = IDX (other);
+      if (!all_flags[other_idx].active)
+        continue;
+      const size_t start = SIZE_STACK (variables);
+      PUSH_STACK (variables, idx);
+      PUSH_STACK (variables, other_idx);
+      push_clause_variables (solver, &starts, &variables, degrees, start);
+    }
+  }
+  const clause *const last_irredundant =
+      kissat_last_irredundant_clause (solver);
+  for (all_clauses (c)) {
+    if (last_irredundant && c > last_irredundant)
+      break;
+    if (c->garbage || c->redundant)
+      continue;
+    const size_t start = SIZE_STACK (variables);
+    for (all_literals_in_clause (lit, c)) {
+      const unsigned idx = IDX (lit);
+      if (all_flags[idx].active)
+        PUSH_STACK (variables, idx);
+    }
+    push_clause_variables (solver, &starts, &variables, degrees, start);
+  }
+  PUSH_STACK (starts, SIZE_STACK (variables));
+
+  unsigned *rank = 0;
+  if (SIZE_STACK (variables) < UINT_MAX)
+    rank = breadth_first_order (solver, &starts, &variables, degrees);
+  else
+    kissat_extremely_verbose (solver, "too many occurrences to reorder");
+
+  if (rank) {
+    unsigned *plain = degrees, next = 0;
+    bool fixed = false;
+    for (all_variables (idx)) {
+      const flags *const flags = all_flags + idx;
+      if (flags->active)
+        plain[idx] = next++;
+      else if (flags->fixed && !fixed)
+        fixed = true, next++;
+    }
+    const uint64_t before =
+        count_cache_lines (solver, &starts, &variables, plain);
+    const uint64_t after =
+        count_cache_lines (solver, &starts, &variables, rank);
+    kissat_phase (solver, "compact", GET (compacted),
+                  "reordering touches %.2f instead of %.2f cache lines "
+                  "per clause (%.0f%%)",
+                  kissat_average (after, SIZE_STACK (starts) - 1),
+                  kissat_average (before, SIZE_STACK (starts) - 1),
+                  kissat_percent (after, before));
+    if (after < before)
+      INC (compacted_reordered);
+    else {
+      kissat_extremely_verbose (solver, "keeping variable order");
+      DEALLOC (rank, vars);
+      rank = 0;
+    }
+  }
+
+  RELEASE_STACK (variables);
+  RELEASE_STACK (starts);
+  DEALLOC (degrees, vars);
+  return rank;
+}
+
+unsigned kissat_compact_literals (kissat *solver, unsigned *mfixed_ptr,
+                                 bool *reordered_ptr) {
   INC (compacted);
 #if !defined(QUIET) || !defined(NDEBUG)
   const unsigned active = solver->active;
@@ -32,6 +258,7 @@ unsigned kissat_compact_literals (kissat *solver, unsigned *mfixed_ptr) {
   assert (!solver->compacting);
   solver->compacting = true;
 #endif
+  unsigned *rank = reorder_variables (solver);
   unsigned mfixed = INVALID_LIT;
   unsigned vars = 0;
   for (all_variables (iidx)) {
@@ -44,7 +271,7 @@ unsigned kissat_compact_literals (kissat *solver, unsigned *mfixed_ptr) {
       const value value = kissat_fixed (solver, ilit);
       assert (value);
       if (mfixed == INVALID_LIT) {
-        mlit = mfixed = LIT (vars);
+        mlit = mfixed = LIT (rank ? solver->active : vars);
         LOG2 ("first fixed %u mapped to %u assigned to %d", ilit, mfixed,
               value);
         if (value < 0)
@@ -60,7 +287,7 @@ unsigned kissat_compact_literals (kissat *solver, unsigned *mfixed_ptr) {
       }
     } else if (flags->active) {
       assert (flags->active);
-      mlit = LIT (vars);
+      mlit = LIT (rank ? rank[iidx] : vars);
       LOG2 ("remapping %u to %u", ilit, mlit);
       vars++;
     } else {
@@ -77,7 +304,7 @@ unsigned kissat_compact_literals (kissat *solver, unsigned *mfixed_ptr) {
         LOG2 ("skipping inactive %u", ilit);
       continue;
     }
-    assert (mlit <= ilit);
+    assert (rank || mlit <= ilit);
     assert (mlit != NOT (ilit));
     if (mlit == ilit)
       continue;
@@ -88,6 +315,9 @@ unsigned kissat_compact_literals (kissat *solver, unsigned *mfixed_ptr) {
     reimport_literal (solver, eidx, mlit);
   }
   *mfixed_ptr = mfixed;
+  *reordered_ptr = (rank != 0);
+  if (rank)
+    DEALLOC (rank, solver->vars);
   LOG ("compacting to %u variables %.2f%% from %u", vars,
        kissat_percent (vars, solver->vars), solver->vars);
   assert (vars == active || vars == active + 1);
@@ -128,11 +358,78 @@ static unsigned map_idx (kissat *solver, unsigned iidx) {
     return INVALID_IDX;
   const unsigned mlit = import->lit;
   const unsigned midx = IDX (mlit);
-  assert (midx <= iidx);
+  assert (midx < solver->vars);
   return midx;
 }
 
-static void compact_queue (kissat *solver) {
+// After renumbering variables are not only moved to smaller indices and
+// thus variable and literal indexed data can not be compacted in place.
+
+static void permute_variables (kissat *solver, const unsigned *map,
+                               unsigned vars, size_t bytes, void *data) {
+  char *tmp = kissat_nalloc (solver, vars, bytes);
+  for (all_variables (iidx)) {
+    const unsigned mlit = map[LIT (iidx)];
+    if (mlit != INVALID_LIT)
+      memcpy (tmp + IDX (mlit) * bytes, (char *) data + iidx * bytes,
+              bytes);
+  }
+  memcpy (data, tmp, vars * bytes);
+  kissat_dealloc (solver, tmp, vars, bytes);
+}
+
+static void permute_literals (kissat *solver, const unsigned *map,
+                              unsigned vars, size_t bytes, void *data) {
+  char *tmp = kissat_calloc (solver, 2 * vars, bytes);
+  for (all_literals (ilit)) {
+    const unsigned mlit = map[ilit];
+    if (mlit != INVALID_LIT)
+      memcpy (tmp + mlit * bytes, (char *) data + ilit * bytes, bytes);
+  }
+  memcpy (data, tmp, 2 * vars * bytes);
+  kissat_dealloc (solver, tmp, 2 * vars, bytes);
+}
+
+static void permute_all_literals (kissat *solver, const unsigned *map,
+                                  unsigned vars) {
+  LOG ("permuting variables");
+  permute_variables (solver, map, vars, sizeof (assigned),
+                     solver->assigned);
+  permute_variables (solver, map, vars, sizeof (flags), solver->flags);
+
+  permute_variables (solver, map, vars, sizeof (value),
+                     solver->phases.best);
+  permute_variables (solver, map, vars, sizeof (value),
+                     solver->phases.saved);
+  permute_variables (solver, map, vars, sizeof (value),
+                     solver->phases.target);
+
+  permute_literals (solver, map, vars, sizeof (value), solver->values);
+}
+
+// Watches have to be permuted right after flushing them, since sweeping
+// garbage clauses already watches new binary clauses with mapped literals.
+
+void kissat_permute_watches (kissat *solver, unsigned vars) {
+  LOG ("permuting watches");
+  const unsigned lits = LITS;
+  unsigned *map = kissat_nalloc (solver, lits, sizeof *map);
+  for (unsigned ilit = 0; ilit < lits; ilit++) {
+    const unsigned mlit = kissat_map_literal (solver, ilit, true);
+    if (mlit != INVALID_LIT && kissat_fixed (solver, ilit)) {
+      assert (!SIZE_WATCHES (WATCHES (ilit)));
+      map[ilit] = INVALID_LIT;
+    } else
+      map[ilit] = mlit;
+  }
+  permute_literals (solver, map, vars, sizeof (watches), solver->watches);
+  memset (solver->watches + 2 * vars, 0,
+          (lits - 2 * vars) * sizeof (watches));
+  kissat_dealloc (solver, map, lits, sizeof *map);
+}
+
+static void compact_queue (kissat *solver, const unsigned *map,
+                           unsigned vars) {
   LOG ("compacting queue");
   links *links = solver->links, *l;
   unsigned *p = &solver->queue.first, prev = DISCONNECT;
@@ -151,6 +448,10 @@ static void compact_queue (kissat *solver) {
   }
   solver->queue.last = prev;
   *p = DISCONNECT;
+  if (map) {
+    permute_variables (solver, map, vars, sizeof *links, links);
+    return;
+  }
   for (all_variables (idx)) {
     const unsigned midx = map_idx (solver, idx);
     if (midx == INVALID_IDX)
@@ -237,20 +538,25 @@ static void compact_frames (kissat *solver) {
   }
 }
 
-static void compact_export (kissat *solver, unsigned vars) {
+static void compact_export (kissat *solver, const unsigned *map,
+                            unsigned vars) {
   LOG ("compacting export");
   const size_t size = SIZE_STACK (solver->export);
   assert (size <= UINT_MAX);
   assert (size == solver->vars);
-  for (unsigned iidx = 0; iidx < size; iidx++) {
-    const unsigned elit = PEEK_STACK (solver->export, iidx);
-    if (!elit)
-      continue;
-    const unsigned midx = map_idx (solver, iidx);
-    if (midx == INVALID_IDX)
-      continue;
-    POKE_STACK (solver->export, midx, elit);
-  }
+  if (map)
+    permute_variables (solver, map, vars, sizeof (int),
+                       BEGIN_STACK (solver->export));
+  else
+    for (unsigned iidx = 0; iidx < size; iidx++) {
+      const unsigned elit = PEEK_STACK (solver->export, iidx);
+      if (!elit)
+        continue;
+      const unsigned midx = map_idx (solver, iidx);
+      if (midx == INVALID_IDX)
+        continue;
+      POKE_STACK (solver->export, midx, elit);
+    }
   RESIZE_STACK (solver->export, vars);
   SHRINK_STACK (solver->export);
 #ifndef NDEBUG
@@ -318,13 +624,13 @@ static void compact_best_and_target_values (kissat *solver, unsigned vars) {
 }
 
 void kissat_finalize_compacting (kissat *solver, unsigned vars,
-                                 unsigned mfixed) {
+                                 unsigned mfixed, bool reordered) {
   LOG ("finalizing compacting");
   assert (vars <= solver->vars);
 #ifdef LOGGING
   assert (solver->compacting);
 #endif
-  if (vars == solver->vars) {
+  if (vars == solver->vars && !reordered) {
 #ifdef LOGGING
     solver->compacting = false;
     LOG ("number of variables does not change");
@@ -335,6 +641,8 @@ void kissat_finalize_compacting (kissat *solver, unsigned vars,
   unsigned reduced = solver->vars - vars;
   LOG ("compacted number of variables from %u to %u", solver->vars, vars);
 
+  compact_frames (solver);
+
   bool first = true;
   for (all_variables (iidx)) {
     flags *flags = FLAGS (iidx);
@@ -346,12 +654,20 @@ void kissat_finalize_compacting (kissat *solver, unsigned vars,
 
   compact_trail (solver);
 
-  for (all_variables (iidx)) {
-    const unsigned ilit = LIT (iidx);
-    const unsigned mlit = kissat_map_literal (solver, ilit, true);
-    if (mlit != INVALID_LIT && ilit != mlit)
-      compact_literal (solver, mlit, ilit);
-  }
+  unsigned *map = 0;
+  if (reordered) {
+    const unsigned lits = LITS;
+    map = kissat_nalloc (solver, lits, sizeof *map);
+    for (unsigned ilit = 0; ilit < lits; ilit++)
+      map[ilit] = kissat_map_literal (solver, ilit, true);
+    permute_all_literals (solver, map, vars);
+  } else
+    for (all_variables (iidx)) {
+      const unsigned ilit = LIT (iidx);
+      const unsigned mlit = kissat_map_literal (solver, ilit, true);
+      if (mlit != INVALID_LIT && ilit != mlit)
+        compact_literal (solver, mlit, ilit);
+    }
 
   if (mfixed != INVALID_LIT)
     compact_units (solver, mfixed);
@@ -361,13 +677,15 @@ void kissat_finalize_compacting (kissat *solver, unsigned vars,
   memset (solver->values + 2 * vars, 0, 2 * reduced * sizeof (value));
   memset (solver->watches + 2 * vars, 0, 2 * reduced * sizeof (watches));
 
-  compact_queue (solver);
+  compact_queue (solver, map, vars);
   compact_stack (solver, &solver->sweep_schedule);
   compact_scores (solver, SCORES, vars);
-  compact_frames (solver);
-  compact_export (solver, vars);
+  compact_export (solver, map, vars);
   compact_best_and_target_values (solver, vars);
 
+  if (map)
+    DEALLOC (map, LITS);
+
   solver->vars = vars;
 #ifdef LOGGING
   solver->compacting = false;
@@ -1,9 +1,13 @@
 #ifndef _compact_h_INCLUDED
 #define _compact_h_INCLUDED
 
+#include <stdbool.h>
+
 struct kissat;
 
-unsigned kissat_compact_literals (struct kissat *, unsigned *mfixed_ptr);
+unsigned kissat_compact_literals (struct kissat *, unsigned *mfixed_ptr,
+                                  bool *reordered_ptr);
+void kissat_permute_watches (struct kissat *, unsigned vars);
 void kissat_finalize_compacting (struct kissat *, unsigned vars,
-                                 unsigned mfixed);
+                                 unsigned mfixed, bool reordered);
 #endif
@@ -0,0 +1,315 @@
+#include "compress.h"
+
+#ifdef KISSAT_HAS_BUILTIN_COMPRESSION
+
+#include "allocate.h"
+
+#include <string.h>
+
+#ifdef KISSAT_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef KISSAT_HAS_LZMA
+#include <lzma.h>
+#endif
+
+#ifdef KISSAT_HAS_BZIP2
+#include <bzlib.h>
+#endif
+
+#define SIZE_OUTPUT (1u << 18)
+
+// Fast compression levels, since compression should not slow down the
+// solver (or the proof writer thread) more than writing uncompressed.
+
+#define GZIP_LEVEL 1
+#define LZMA_PRESET 1
+#define BZIP2_BLOCKS 9
+
+enum action {
+  RUN_ACTION,
+  FLUSH_ACTION,
+  FINISH_ACTION,
+};
+
+typedef enum action action;
+
+struct compressor {
+  FILE *file;
+  compression type;
+  bool failed;
+  unsigned char *output;
+  union {
+#ifdef KISSAT_HAS_ZLIB
+    z_stream gzip;
+#endif
+#ifdef KISSAT_HAS_LZMA
+    lzma_stream xz;
+#endif
+#ifdef KISSAT_HAS_BZIP2
+    bz_stream bzip2;
+#endif
+  } stream;
+};
+
+static void write_output (compressor *compressor, size_t bytes) {
+  if (!bytes || compressor->failed)
+    return;
+  if (fwrite (compressor->output, 1, bytes, compressor->file) != bytes)
+    compressor->failed = true;
+}
+
+/*------------------------------------------------------------------------*/
+
+#ifdef KISSAT_HAS_ZLIB
+
+static bool init_gzip (compressor *compressor) {
+  z_stream *z = &compressor->stream.gzip;
+  memset (z, 0, sizeof *z);
+  return deflateInit2 (z, GZIP_LEVEL, Z_DEFLATED, 15 + 16, 8,
+                       Z_DEFAULT_STRATEGY) == Z_OK;
+}
+
+static bool compress_gzip (compressor *compressor, const void *ptr,
+                           size_t bytes, action action) {
+  z_stream *z = &compressor->stream.gzip;
+  z->next_in = (unsigned char *) ptr;
+  z->avail_in = bytes;
+  const int flush = action == FINISH_ACTION  ? Z_FINISH
+                    : action == FLUSH_ACTION ? Z_SYNC_FLUSH
+                                             : Z_NO_FLUSH;
+  for (;;) {
+    z->next_out = compressor->output;
+    z->avail_out = SIZE_OUTPUT;
+    const int ret = deflate (z, flush);
+    if (ret == Z_STREAM_ERROR)
+      return false;
+    write_output (compressor, SIZE_OUTPUT - z->avail_out);
+    if (ret == Z_STREAM_END)
+      break;
+    if (z->avail_out && !z->avail_in && action != FINISH_ACTION)
+      break;
+  }
+  return true;
+}
+
+static void release_gzip (compressor *compressor) {
+  deflateEnd (&compressor->stream.gzip);
+}
+
+#endif
+
+/*------------------------------------------------------------------------*/
+
+#ifdef KISSAT_HAS_LZMA
+
+static bool init_xz (compressor *compressor) {
+  lzma_stream *s = &compressor->stream.xz;
+  const lzma_stream init = LZMA_STREAM_INIT;
+  *s = init;
+  lzma_ret ret;
+  if (compressor->type == LZMA_COMPRESSION) {
+    lzma_options_lzma options;
+    if (lzma_lzma_preset (&options, LZMA_PRESET))
+      return false;
+    // Matches the signature checked before reading '.lzma' files.
+    options.dict_size = 1u << 23;
+    ret = lzma_alone_encoder (s, &options);
+  } else
+    ret = lzma_easy_encoder (s, LZMA_PRESET, LZMA_CHECK_CRC64);
+  return ret == LZMA_OK;
+}
+
+static bool compress_xz (compressor *compressor, const void *ptr,
+                         size_t bytes, action action) {
+  lzma_stream *s = &compressor->stream.xz;
+  s->next_in = ptr;
+  s->avail_in = bytes;
+  lzma_action code;
+  if (action == FINISH_ACTION)
+    code = LZMA_FINISH;
+  else if (action == FLUSH_ACTION && compressor->type == XZ_COMPRESSION)
+    code = LZMA_SYNC_FLUSH;
+  else
+    code = LZMA_RUN;
+  if (code == LZMA_RUN && !bytes)
+    return true;
+  for (;;) {
+    s->next_out = compressor->output;
+    s->avail_out = SIZE_OUTPUT;
+    const lzma_ret ret = lzma_code (s, code);
+    if (ret != LZMA_OK && ret != LZMA_STREAM_END)
+      return false;
+    write_output (compressor, SIZE_OUTPUT - s->avail_out);
+    if (ret == LZMA_STREAM_END)
+      break;
+    if (s->avail_out && !s->avail_in && code == LZMA_RUN)
+      break;
+  }
+  return true;
+}
+
+static void release_xz (compressor *compressor) {
+  lzma_end (&compressor->stream.xz);
+}
+
+#endif
+
+/*------------------------------------------------------------------------*/
+
+#ifdef KISSAT_HAS_BZIP2
+
+static bool init_bzip2 (compressor *compressor) {
+  bz_stream *s = &compressor->stream.bzip2;
+  memset (s, 0, sizeof *s);
+  return BZ2_bzCompressInit (s, BZIP2_BLOCKS, 0, 0) == BZ_OK;
+}
+
+static bool compress_bzip2 (compressor *compressor, const void *ptr,
+                            size_t bytes, action action) {
+  bz_stream *s = &compressor->stream.bzip2;
+  s->next_in = (char *) ptr;
+  s->avail_in = bytes;
+  const int code = action == FINISH_ACTION  ? BZ_FINISH
+                   : action == FLUSH_ACTION ? BZ_FLUSH
+                                            : BZ_RUN;
+  for (;;) {
+    s->next_out = (char *) compressor->output;
+    s->avail_out = SIZE_OUTPUT;
+    const int ret = BZ2_bzCompress (s, code);
+    if (ret < 0)
+      return false;
+    write_output (compressor, SIZE_OUTPUT - s->avail_out);
+    if (ret == BZ_STREAM_END)
+      break;
+    if (code == BZ_RUN && s->avail_out && !s->avail_in)
+      break;
+    if (code == BZ_FLUSH && ret == BZ_RUN_OK)
+      break;
+  }
+  return true;
+}
+
+static void release_bzip2 (compressor *compressor) {
+  BZ2_bzCompressEnd (&compressor->stream.bzip2);
+}
+
+#endif
+
+/*------------------------------------------------------------------------*/
+
+static bool init_stream (compressor *compressor) {
+  switch (compressor->type) {
+#ifdef KISSAT_HAS_BZIP2
+  case BZIP2_COMPRESSION:
+    return init_bzip2 (compressor);
+#endif
+#ifdef KISSAT_HAS_ZLIB
+  case GZIP_COMPRESSION:
+    return init_gzip (compressor);
+#endif
+#ifdef KISSAT_HAS_LZMA
+  case LZMA_COMPRESSION:
+  case XZ_COMPRESSION:
+    return init_xz (compressor);
+#endif
+  default:
+    return false;
+  }
+}
+
+static bool compress_block (compressor *compressor, const void *ptr,
+                            size_t bytes, action action) {
+  bool res;
+  switch (compressor->type) {
+#ifdef KISSAT_HAS_BZIP2
+  case BZIP2_COMPRESSION:
+    res = compress_bzip2 (compressor, ptr, bytes, action);
+    break;
+#endif
+#ifdef KISSAT_HAS_ZLIB
+  case GZIP_COMPRESSION:
+    res = compress_gzip (compressor, ptr, bytes, action);
+    break;
+#endif
+#ifdef KISSAT_HAS_LZMA
+  case LZMA_COMPRESSION:
+  case XZ_COMPRESSION:
+    res = compress_xz (compressor, ptr, bytes, action);
+    break;
+#endif
+  default:
+    res = false;
+    break;
+  }
+  if (!res)
+    compressor->failed = true;
+  return !compressor->failed;
+}
+
+static void release_stream (compressor *compressor) {
+  switch (compressor->type) {
+#ifdef KISSAT_HAS_BZIP2
+  case BZIP2_COMPRESSION:
+    release_bzip2 (compressor);
+    break;
+#endif
+#ifdef KISSAT_HAS_ZLIB
+  case GZIP_COMPRESSION:
+    release_gzip (compressor);
+    break;
+#endif
+#ifdef KISSAT_HAS_LZMA
+  case LZMA_COMPRESSION:
+  case XZ_COMPRESSION:
+    release_xz (compressor);
+    break;
+#endif
+  default:
+    break;
+  }
+}
+
+/*------------------------------------------------------------------------*/
+
+compressor *kissat_new_compressor (FILE *file, compression type) {
+  compressor *compressor = kissat_raw_calloc (1, sizeof *compressor);
+  if (!compressor)
+    return 0;
+  compressor->file = file;
+  compressor->type = type;
+  compressor->output = kissat_raw_malloc (SIZE_OUTPUT);
+  if (!compressor->output || !init_stream (compressor)) {
+    if (compressor->output)
+      kissat_raw_free (compressor->output, SIZE_OUTPUT);
+    kissat_raw_free (compressor, sizeof *compressor);
+    return 0;
+  }
+  return compressor;
+}
+
+bool kissat_compress (compressor *compressor, const void *ptr,
+                      size_t bytes) {
+  if (!bytes)
+    return !compressor->failed;
+  return compress_block (compressor, ptr, bytes, RUN_ACTION);
+}
+
+bool kissat_flush_compressor (compressor *compressor) {
+  return compress_block (compressor, 0, 0, FLUSH_ACTION);
+}
+
+bool kissat_delete_compressor (compressor *compressor) {
+  const bool res = compress_block (compressor, 0, 0, FINISH_ACTION);
+  release_stream (compressor);
+  kissat_raw_free (compressor->output, SIZE_OUTPUT);
+  kissat_raw_free (compressor, sizeof *compressor);
+  return res;
+}
+
+#else
+
+int kissat_compress_dummy_to_avoid_warning;
+
+#endif
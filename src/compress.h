@@ -0,0 +1,39 @@
+#ifndef _compress_h_INCLUDED
+#define _compress_h_INCLUDED
+
+#include <stdbool.h>
+#include <stdio.h>
+
+// Built-in compression relies on the same libraries as decompression,
+// while 'KISSAT_HAS_COMPRESSION' in 'keatures.h' refers to compressing
+// and decompressing through 'popen' of external tools.
+
+#if defined(KISSAT_HAS_ZLIB) || defined(KISSAT_HAS_LZMA) || \
+    defined(KISSAT_HAS_BZIP2)
+#define KISSAT_HAS_BUILTIN_COMPRESSION
+#endif
+
+#ifdef KISSAT_HAS_BUILTIN_COMPRESSION
+
+enum compression {
+  BZIP2_COMPRESSION,
+  GZIP_COMPRESSION,
+  LZMA_COMPRESSION,
+  XZ_COMPRESSION,
+};
+
+typedef enum compression compression;
+typedef struct compressor compressor;
+
+// Built-in streaming compression of written files (mainly proofs).  Data
+// passed to 'kissat_compress' (through 'kissat_write') is compressed with
+// fast compression levels in the calling thread and written in blocks.
+
+compressor *kissat_new_compressor (FILE *, compression);
+bool kissat_compress (compressor *, const void *, size_t);
+bool kissat_flush_compressor (compressor *);
+bool kissat_delete_compressor (compressor *);
+
+#endif
+
+#endif
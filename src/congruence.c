@@ -1,4 +1,5 @@
 #include "congruence.h"
+#include "budget.h"
 #include "dense.h"
 #include "fifo.h"
 #include "inline.h"
@@ -12,6 +13,7 @@
 #include "report.h"
 #include "sort.h"
 #include "terminate.h"
+#include "threads.h"
 #include "trail.h"
 #include "utilities.h"
 
@@ -2333,20 +2335,70 @@ static void extract_binaries (closure *closure) {
   STOP (extractbinaries);
 }
 
+// AND and XOR gates are searched for through an extractor, which either
+// adds found gates directly (sequential extraction on the main thread) or
+// just saves them (concurrent extraction in worker threads).  Concurrent
+// extractors have their own marks and stacks and do not modify clauses.
+
+struct extractor {
+  closure *closure;
+  mark *marks;
+  unsigneds *lits;
+  unsigneds *marked;
+  unsigneds *saved;
+  bool concurrent;
+};
+
+typedef struct extractor extractor;
+
+static void init_extractor (closure *closure, extractor *extractor) {
+  kissat *const solver = closure->solver;
+  extractor->closure = closure;
+  extractor->marks = solver->marks;
+  extractor->lits = &closure->lits;
+  extractor->marked = &solver->analyzed;
+  extractor->saved = 0;
+  extractor->concurrent = false;
+}
+
+// Saved gates are recorded as '<lhs> <size> <lits>' where the literals
+// are those of the base clause (as they are expected by 'new_and_gate'
+// and 'new_xor_gate' in 'closure->lits').
+
+static bool add_extracted_gate (extractor *extractor, unsigned tag,
+                                unsigned lhs) {
+  if (!extractor->concurrent) {
+    closure *const closure = extractor->closure;
+    if (tag == AND_GATE)
+      return new_and_gate (closure, lhs);
+    assert (tag == XOR_GATE);
+    return new_xor_gate (closure, lhs);
+  }
+  kissat *const solver = extractor->closure->solver;
+  unsigneds *const saved = extractor->saved;
+  const unsigneds *const lits = extractor->lits;
+  PUSH_STACK (*saved, lhs);
+  PUSH_STACK (*saved, (unsigned) SIZE_STACK (*lits));
+  for (all_stack (unsigned, lit, *lits))
+    PUSH_STACK (*saved, lit);
+  return true;
+}
+
 #ifndef INDEX_BINARY_CLAUSES
 
-static gate *find_first_and_gate (closure *closure, unsigned lhs,
-                                  unsigneds *lits) {
+static bool find_first_and_gate (extractor *extractor, unsigned lhs) {
+  closure *const closure = extractor->closure;
   kissat *const solver = closure->solver;
   assert (!solver->watching);
-  mark *const marks = solver->marks;
+  mark *const marks = extractor->marks;
+  unsigneds *const lits = extractor->lits;
 
   const unsigned not_lhs = NOT (lhs);
   LOG ("trying to find AND gate with first LHS %s", LOGLIT (lhs));
   LOG ("negated LHS %s occurs in %u binary clauses", LOGLIT (not_lhs),
        closure->negbincount[lhs]);
 
-  unsigneds *const marked = &solver->analyzed;
+  unsigneds *const marked = extractor->marked;
   assert (EMPTY_STACK (*marked));
 
   const unsigned arity = SIZE_STACK (*lits) - 1;
@@ -2372,16 +2424,17 @@ static gate *find_first_and_gate (closure *closure, unsigned lhs,
 
   LOG ("found %zu initial LHS candidates", SIZE_STACK (*marked));
   if (matched < arity)
-    return 0;
+    return false;
 
-  return new_and_gate (closure, lhs);
+  return add_extracted_gate (extractor, AND_GATE, lhs);
 }
 
-static gate *find_remaining_and_gate (closure *closure, unsigned lhs,
-                                      unsigneds *lits) {
+static bool find_remaining_and_gate (extractor *extractor, unsigned lhs) {
+  closure *const closure = extractor->closure;
   kissat *const solver = closure->solver;
   assert (!solver->watching);
-  mark *const marks = solver->marks;
+  mark *const marks = extractor->marks;
+  unsigneds *const lits = extractor->lits;
   const unsigned not_lhs = NOT (lhs);
 
   if (marks[not_lhs] < 2) {
@@ -2417,7 +2470,7 @@ static gate *find_remaining_and_gate (closure *closure, unsigned lhs,
   }
 
   {
-    unsigneds *const marked = &solver->analyzed;
+    unsigneds *const marked = extractor->marked;
     assert (!EMPTY_STACK (*marked));
     unsigned *const begin_marked = BEGIN_STACK (*marked);
     const unsigned *const end_marked = END_STACK (*marked);
@@ -2449,9 +2502,9 @@ static gate *find_remaining_and_gate (closure *closure, unsigned lhs,
   }
 
   if (matched < arity)
-    return 0;
+    return false;
 
-  return new_and_gate (closure, lhs);
+  return add_extracted_gate (extractor, AND_GATE, lhs);
 }
 
 #endif
@@ -2470,9 +2523,18 @@ static inline bool smaller_negated_bin_count (const unsigned *negbincount,
 #define SMALLER_NEGATED_BIN_COUNT(A, B) \
   smaller_negated_bin_count (negbincount, A, B)
 
-static void sort_lits_by_negbincount (closure *closure, size_t size,
+// Concurrent extractors can not use the shared sorter stack of the solver
+// (nor profile sorting) and thus use insertion sort.  The number of LHS
+// candidates with enough negated binary occurrences is small anyhow.
+
+static void sort_lits_by_negbincount (extractor *extractor, size_t size,
                                       unsigned *lits) {
+  closure *const closure = extractor->closure;
   const unsigned *const negbincount = closure->negbincount;
+  if (extractor->concurrent) {
+    INSERTION_SORT (unsigned, size, lits, SMALLER_NEGATED_BIN_COUNT);
+    return;
+  }
   kissat *const solver = closure->solver;
   SORT (unsigned, size, lits, SMALLER_NEGATED_BIN_COUNT);
 }
@@ -2523,16 +2585,17 @@ static bool indexed_binary (closure *closure, unsigned lit,
 
 #endif
 
-static void extract_and_gates_with_base_clause (closure *closure,
+static void extract_and_gates_with_base_clause (extractor *extractor,
                                                 clause *c) {
   assert (!c->garbage);
+  closure *const closure = extractor->closure;
   kissat *const solver = closure->solver;
   assert (!solver->inconsistent);
   value *values = solver->values;
   unsigned arity_limit = MIN (GET_OPTION (congruenceandarity), MAX_ARITY);
   const unsigned size_limit = arity_limit + 1;
   const unsigned *const negbincount = closure->negbincount;
-  unsigneds *lits = &closure->lits;
+  unsigneds *lits = extractor->lits;
   unsigned size = 0, max_negbincount = 0;
   CLEAR_STACK (*lits);
   for (all_literals_in_clause (lit, c)) {
@@ -2542,7 +2605,8 @@ static void extract_and_gates_with_base_clause (closure *closure,
     if (value > 0) {
       assert (!solver->level);
       LOGCLS (c, "found satisfied %s in", LOGLIT (lit));
-      kissat_mark_clause_as_garbage (solver, c);
+      if (!extractor->concurrent)
+        kissat_mark_clause_as_garbage (solver, c);
       return;
     }
     if (++size > size_limit) {
@@ -2578,8 +2642,8 @@ static void extract_and_gates_with_base_clause (closure *closure,
                   "counted candidate arity %u AND gate base clause", arity);
   const unsigned *const end_lits = END_STACK (*lits);
 #ifndef INDEX_BINARY_CLAUSES
-  mark *const marks = solver->marks;
-  unsigneds *marked = &solver->analyzed;
+  mark *const marks = extractor->marks;
+  unsigneds *marked = extractor->marked;
   assert (EMPTY_STACK (*marked));
 #endif
   for (unsigned *p = begin_lits; p != end_lits; p++) {
@@ -2599,7 +2663,7 @@ static void extract_and_gates_with_base_clause (closure *closure,
   const size_t reduced_size = end_lits - reduced_lits;
   assert (reduced_size);
   LOGCLS (c, "trying as base arity %u AND gate", arity);
-  sort_lits_by_negbincount (closure, reduced_size, reduced_lits);
+  sort_lits_by_negbincount (extractor, reduced_size, reduced_lits);
 #ifdef LOGGING
   if (begin_lits < reduced_lits) {
     LOGCOUNTEDLITS (reduced_lits - begin_lits, begin_lits, negbincount,
@@ -2633,7 +2697,7 @@ static void extract_and_gates_with_base_clause (closure *closure,
         if (!indexed_binary (closure, not_lhs, not_rhs))
           goto CONTINUE_WITH_NEXT_LHS;
       }
-    (void) new_and_gate (closure, lhs);
+    (void) add_extracted_gate (extractor, AND_GATE, lhs);
 #ifdef LOGGING
     extracted++;
 #endif
@@ -2642,7 +2706,7 @@ static void extract_and_gates_with_base_clause (closure *closure,
     if (first) {
       first = false;
       assert (EMPTY_STACK (*marked));
-      if (find_first_and_gate (closure, lhs, lits)) {
+      if (find_first_and_gate (extractor, lhs)) {
 #ifdef LOGGING
         extracted++;
 #endif
@@ -2650,7 +2714,7 @@ static void extract_and_gates_with_base_clause (closure *closure,
     } else if (EMPTY_STACK (*marked)) {
       LOG ("early abort AND gate search");
       break;
-    } else if (find_remaining_and_gate (closure, lhs, lits)) {
+    } else if (find_remaining_and_gate (extractor, lhs)) {
 #ifdef LOGGING
       extracted++;
 #endif
@@ -2741,14 +2805,15 @@ static clause *find_indexed_large_clause (closure *closure,
 
 #else
 
-static clause *find_large_xor_side_clause (closure *closure,
-                                           unsigneds *lits) {
+static clause *find_large_xor_side_clause (extractor *extractor) {
+  closure *const closure = extractor->closure;
   kissat *const solver = closure->solver;
   assert (!solver->watching);
+  const unsigneds *const lits = extractor->lits;
   const unsigned *const largecount = closure->largecount;
   unsigned least_occurring_literal = INVALID_LIT;
   unsigned count_least_occurring = UINT_MAX;
-  mark *marks = solver->marks;
+  mark *marks = extractor->marks;
   const size_t size_lits = SIZE_STACK (*lits);
 #if defined(LOGGING) || !defined(NDEBUG)
   const unsigned arity = size_lits - 1;
@@ -2793,6 +2858,10 @@ static clause *find_large_xor_side_clause (closure *closure,
         continue;
       if (value > 0) {
         LOGCLS (c, "found satisfied %s in", LOGLIT (other));
+        if (extractor->concurrent) {
+          found = UINT_MAX;
+          break;
+        }
         kissat_mark_clause_as_garbage (solver, c);
         assert (c->garbage);
         break;
@@ -2820,9 +2889,10 @@ static clause *find_large_xor_side_clause (closure *closure,
 
 #endif
 
-static void extract_xor_gates_with_base_clause (closure *closure,
+static void extract_xor_gates_with_base_clause (extractor *extractor,
                                                 clause *c) {
   assert (!c->garbage);
+  closure *const closure = extractor->closure;
   kissat *const solver = closure->solver;
   assert (!solver->inconsistent);
   const value *const values = solver->values;
@@ -2831,7 +2901,7 @@ static void extract_xor_gates_with_base_clause (closure *closure,
       MIN (GET_OPTION (congruencexorarity), MAX_ARITY);
   const unsigned size_limit = arity_limit + 1;
   unsigned negated = 0, size = 0;
-  unsigneds *lits = &closure->lits;
+  unsigneds *lits = extractor->lits;
   CLEAR_STACK (*lits);
   bool first = true;
   for (all_literals_in_clause (lit, c)) {
@@ -2840,7 +2910,8 @@ static void extract_xor_gates_with_base_clause (closure *closure,
       continue;
     if (value > 0) {
       LOGCLS (c, "found satisfied %s in", LOGLIT (lit));
-      kissat_mark_clause_as_garbage (solver, c);
+      if (!extractor->concurrent)
+        kissat_mark_clause_as_garbage (solver, c);
       return;
     }
     if (size == size_limit) {
@@ -2911,7 +2982,7 @@ static void extract_xor_gates_with_base_clause (closure *closure,
 #ifdef INDEX_LARGE_CLAUSES
       clause *d = find_indexed_large_clause (closure, lits);
 #else
-      clause *d = find_large_xor_side_clause (closure, lits);
+      clause *d = find_large_xor_side_clause (extractor);
 #endif
       if (!d)
         return;
@@ -2939,8 +3010,7 @@ static void extract_xor_gates_with_base_clause (closure *closure,
   for (all_stack (unsigned, lhs, *lits)) {
     if (!negated)
       lhs = NOT (lhs);
-    gate *g = new_xor_gate (closure, lhs);
-    if (g)
+    if (add_extracted_gate (extractor, XOR_GATE, lhs))
       extracted++;
     if (solver->inconsistent)
       break;
@@ -3861,6 +3931,133 @@ static void extract_ite_gates_with_base_clause (closure *closure,
 
 #endif
 
+// With more than one extraction thread the AND and XOR gate base clause
+// candidates are split into consecutive slices, which are searched for
+// gates concurrently.  Only then the saved gates are added by the main
+// thread in the original order of the candidates, where hashing, matching
+// and merging happens.  As merging might assign literals, saved gates
+// with assigned literals are skipped.
+
+#define MIN_CANDIDATES_PER_EXTRACTION_THREAD 32
+
+typedef struct extraction_worker extraction_worker;
+
+struct extraction_worker {
+  extractor extractor;
+  unsigned tag;
+  const reference *begin, *end;
+  unsigneds lits, marked, saved;
+};
+
+static unsigned extraction_threads (kissat *solver, size_t candidates) {
+  unsigned res = kissat_threads (GET_OPTION (congruencethreads));
+  const size_t limit = candidates / MIN_CANDIDATES_PER_EXTRACTION_THREAD;
+  if (res > limit)
+    res = limit ? limit : 1;
+  return res;
+}
+
+static void *extraction_thread (void *ptr) {
+  extraction_worker *worker = ptr;
+  extractor *extractor = &worker->extractor;
+  kissat *const solver = extractor->closure->solver;
+  for (const reference *p = worker->begin; p != worker->end; p++) {
+    if (solver->termination.flagged)
+      break;
+    clause *const c = kissat_dereference_clause (solver, *p);
+    if (c->garbage)
+      continue;
+    if (worker->tag == AND_GATE)
+      extract_and_gates_with_base_clause (extractor, c);
+    else
+      extract_xor_gates_with_base_clause (extractor, c);
+  }
+  return 0;
+}
+
+static bool saved_gate_assigned (const value *values, unsigned size,
+                                 const unsigned *lits) {
+  for (const unsigned *p = lits, *const end = lits + size; p != end; p++)
+    if (values[*p])
+      return true;
+  return false;
+}
+
+static void add_saved_gates (closure *closure, unsigned tag,
+                             const unsigneds *saved) {
+  kissat *const solver = closure->solver;
+  const value *const values = solver->values;
+  unsigneds *const lits = &closure->lits;
+  const unsigned *p = BEGIN_STACK (*saved);
+  const unsigned *const end = END_STACK (*saved);
+  while (p != end) {
+    if (solver->inconsistent)
+      break;
+    const unsigned lhs = *p++;
+    const unsigned size = *p++;
+    const unsigned *const begin_lits = p;
+    p += size;
+    if (saved_gate_assigned (values, size, begin_lits)) {
+      LOG ("skipping saved gate with assigned literals and LHS %s",
+           LOGLIT (lhs));
+      continue;
+    }
+    CLEAR_STACK (*lits);
+    for (const unsigned *q = begin_lits; q != p; q++)
+      PUSH_STACK (*lits, *q);
+    if (tag == AND_GATE)
+      (void) new_and_gate (closure, lhs);
+    else
+      (void) new_xor_gate (closure, lhs);
+  }
+}
+
+static void extract_gates_concurrently (closure *closure, unsigned tag,
+                                        const references *candidates,
+                                        unsigned threads) {
+  kissat *const solver = closure->solver;
+  assert (threads > 1);
+  extraction_worker *workers =
+      kissat_calloc (solver, threads, sizeof *workers);
+  const size_t size = SIZE_STACK (*candidates);
+  const reference *const begin = BEGIN_STACK (*candidates);
+  for (unsigned i = 0; i < threads; i++) {
+    extraction_worker *worker = workers + i;
+    extractor *extractor = &worker->extractor;
+    extractor->closure = closure;
+    extractor->marks = kissat_calloc (solver, LITS, sizeof (mark));
+    extractor->lits = &worker->lits;
+    extractor->marked = &worker->marked;
+    extractor->saved = &worker->saved;
+    extractor->concurrent = true;
+    worker->tag = tag;
+    worker->begin = begin + (size * i) / threads;
+    worker->end = begin + (size * (i + 1)) / threads;
+  }
+  kissat_extremely_verbose (solver,
+                            "searching %zu %s gate base clauses "
+                            "with %u threads",
+                            size, tag == AND_GATE ? "AND" : "XOR",
+                            threads);
+  kissat_run_threads (solver, "gate extraction", threads,
+                      extraction_thread, workers, sizeof *workers);
+  const bool terminated = tag == AND_GATE
+                              ? TERMINATED (congruence_terminated_1)
+                              : TERMINATED (congruence_terminated_2);
+  for (unsigned i = 0; i < threads; i++) {
+    extraction_worker *worker = workers + i;
+    if (!terminated)
+      add_saved_gates (closure, tag, &worker->saved);
+    RELEASE_STACK (worker->lits);
+    RELEASE_STACK (worker->marked);
+    RELEASE_STACK (worker->saved);
+  }
+  for (unsigned i = 0; i < threads; i++)
+    kissat_dealloc (solver, workers[i].extractor.marks, LITS,
+                    sizeof (mark));
+  kissat_dealloc (solver, workers, threads, sizeof *workers);
+}
+
 static void extract_and_gates (closure *closure) {
   kissat *const solver = closure->solver;
   if (!GET_OPTION (congruenceands))
@@ -3873,18 +4070,38 @@ static void extract_and_gates (closure *closure) {
 #endif
   init_and_gate_extraction (closure);
   clause *last_irredundant = kissat_last_irredundant_clause (solver);
-  for (all_clauses (c)) {
-    if (TERMINATED (congruence_terminated_1))
-      break;
-    if (solver->inconsistent)
-      break;
-    if (last_irredundant && last_irredundant < c)
-      break;
-    if (c->redundant)
-      continue;
-    if (c->garbage)
-      continue;
-    extract_and_gates_with_base_clause (closure, c);
+  const unsigned threads = extraction_threads (solver, IRREDUNDANT_CLAUSES);
+  if (threads > 1) {
+    references candidates;
+    INIT_STACK (candidates);
+    for (all_clauses (c)) {
+      if (last_irredundant && last_irredundant < c)
+        break;
+      if (c->redundant)
+        continue;
+      if (c->garbage)
+        continue;
+      const reference ref = kissat_reference_clause (solver, c);
+      PUSH_STACK (candidates, ref);
+    }
+    extract_gates_concurrently (closure, AND_GATE, &candidates, threads);
+    RELEASE_STACK (candidates);
+  } else {
+    extractor extractor;
+    init_extractor (closure, &extractor);
+    for (all_clauses (c)) {
+      if (TERMINATED (congruence_terminated_1))
+        break;
+      if (solver->inconsistent)
+        break;
+      if (last_irredundant && last_irredundant < c)
+        break;
+      if (c->redundant)
+        continue;
+      if (c->garbage)
+        continue;
+      extract_and_gates_with_base_clause (&extractor, c);
+    }
   }
   reset_and_gate_extraction (closure);
 #ifndef QUIET
@@ -3914,15 +4131,23 @@ static void extract_xor_gates (closure *closure) {
   const uint64_t matched_before = s->congruent_matched_xors;
   const uint64_t gates_before = s->congruent_gates_xors;
 #endif
-  for (all_stack (reference, ref, candidates)) {
-    if (TERMINATED (congruence_terminated_2))
-      break;
-    if (solver->inconsistent)
-      break;
-    clause *c = kissat_dereference_clause (solver, ref);
-    if (c->garbage)
-      continue;
-    extract_xor_gates_with_base_clause (closure, c);
+  const unsigned threads =
+      extraction_threads (solver, SIZE_STACK (candidates));
+  if (threads > 1)
+    extract_gates_concurrently (closure, XOR_GATE, &candidates, threads);
+  else {
+    extractor extractor;
+    init_extractor (closure, &extractor);
+    for (all_stack (reference, ref, candidates)) {
+      if (TERMINATED (congruence_terminated_2))
+        break;
+      if (solver->inconsistent)
+        break;
+      clause *c = kissat_dereference_clause (solver, ref);
+      if (c->garbage)
+        continue;
+      extract_xor_gates_with_base_clause (&extractor, c);
+    }
   }
   reset_xor_gate_extraction (closure);
   RELEASE_STACK (candidates);
@@ -4592,6 +4817,12 @@ bool kissat_congruence (kissat *solver) {
     return false;
   if (DELAYING (congruence))
     return false;
+  if (kissat_memory_pressure (solver)) {
+    kissat_extremely_verbose (solver,
+                              "congruence closure skipped "
+                              "due to memory pressure");
+    return false;
+  }
   START (congruence);
   INC (closures);
   closure closure;
@@ -0,0 +1,428 @@
+#include "decompress.h"
+
+#ifdef KISSAT_HAS_DECOMPRESSION
+
+#include "allocate.h"
+#include "error.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifdef KISSAT_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef KISSAT_HAS_LZMA
+#include <lzma.h>
+#endif
+
+#ifdef KISSAT_HAS_BZIP2
+#include <bzlib.h>
+#endif
+
+#define SIZE_INPUT (1u << 18)
+#define SIZE_OUTPUT (1u << 20)
+
+typedef struct block block;
+
+struct block {
+  unsigned char *chars;
+  size_t size;
+  bool full;
+};
+
+struct decompressor {
+  FILE *file;
+  const char *path;
+  decompression type;
+  bool finished;
+  bool stop;
+  const char *error;
+  unsigned char *input;
+  union {
+#ifdef KISSAT_HAS_ZLIB
+    z_stream gzip;
+#endif
+#ifdef KISSAT_HAS_LZMA
+    lzma_stream xz;
+#endif
+#ifdef KISSAT_HAS_BZIP2
+    bz_stream bzip2;
+#endif
+  } stream;
+  block blocks[2];
+  unsigned consumer;
+  size_t pos;
+  pthread_t thread;
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+};
+
+static size_t read_input (decompressor *decompressor) {
+  return fread (decompressor->input, 1, SIZE_INPUT, decompressor->file);
+}
+
+// Errors can not be reported on the helper thread, which instead stops
+// decompressing and leaves the error to the reader through
+// 'kissat_decompression_error' after reaching the end of the data.
+
+static void corrupted (decompressor *decompressor, const char *what) {
+  if (!decompressor->error)
+    decompressor->error = what;
+  decompressor->finished = true;
+}
+
+/*------------------------------------------------------------------------*/
+
+#ifdef KISSAT_HAS_ZLIB
+
+static bool init_gzip (decompressor *decompressor) {
+  z_stream *z = &decompressor->stream.gzip;
+  memset (z, 0, sizeof *z);
+  return inflateInit2 (z, 15 + 32) == Z_OK;
+}
+
+static size_t decompress_gzip (decompressor *decompressor,
+                               unsigned char *out, size_t size) {
+  z_stream *z = &decompressor->stream.gzip;
+  z->next_out = out;
+  z->avail_out = size;
+  while (z->avail_out && !decompressor->finished) {
+    if (!z->avail_in) {
+      const size_t bytes = read_input (decompressor);
+      if (!bytes) {
+        corrupted (decompressor, "truncated compressed input");
+        break;
+      }
+      z->next_in = decompressor->input;
+      z->avail_in = bytes;
+    }
+    const int ret = inflate (z, Z_NO_FLUSH);
+    if (ret == Z_STREAM_END) {
+      if (!z->avail_in) {
+        const size_t bytes = read_input (decompressor);
+        if (!bytes) {
+          decompressor->finished = true;
+          break;
+        }
+        z->next_in = decompressor->input;
+        z->avail_in = bytes;
+      }
+      inflateReset (z);
+    } else if (ret != Z_OK && ret != Z_BUF_ERROR)
+      corrupted (decompressor, "invalid compressed input");
+  }
+  return size - z->avail_out;
+}
+
+static void release_gzip (decompressor *decompressor) {
+  inflateEnd (&decompressor->stream.gzip);
+}
+
+#endif
+
+/*------------------------------------------------------------------------*/
+
+#ifdef KISSAT_HAS_LZMA
+
+static bool init_xz (decompressor *decompressor) {
+  lzma_stream *s = &decompressor->stream.xz;
+  const lzma_stream init = LZMA_STREAM_INIT;
+  *s = init;
+  lzma_ret ret;
+  if (decompressor->type == LZMA_DECOMPRESSION)
+    ret = lzma_alone_decoder (s, UINT64_MAX);
+  else
+    ret = lzma_stream_decoder (s, UINT64_MAX, LZMA_CONCATENATED);
+  return ret == LZMA_OK;
+}
+
+static size_t decompress_xz (decompressor *decompressor, unsigned char *out,
+                             size_t size) {
+  lzma_stream *s = &decompressor->stream.xz;
+  s->next_out = out;
+  s->avail_out = size;
+  lzma_action action = LZMA_RUN;
+  while (s->avail_out && !decompressor->finished) {
+    if (!s->avail_in && action == LZMA_RUN) {
+      const size_t bytes = read_input (decompressor);
+      if (bytes) {
+        s->next_in = decompressor->input;
+        s->avail_in = bytes;
+      } else
+        action = LZMA_FINISH;
+    }
+    const lzma_ret ret = lzma_code (s, action);
+    if (ret == LZMA_STREAM_END)
+      decompressor->finished = true;
+    else if (ret == LZMA_BUF_ERROR)
+      corrupted (decompressor, "truncated compressed input");
+    else if (ret != LZMA_OK)
+      corrupted (decompressor, "invalid compressed input");
+  }
+  return size - s->avail_out;
+}
+
+static void release_xz (decompressor *decompressor) {
+  lzma_end (&decompressor->stream.xz);
+}
+
+#endif
+
+/*------------------------------------------------------------------------*/
+
+#ifdef KISSAT_HAS_BZIP2
+
+static bool init_bzip2 (decompressor *decompressor) {
+  bz_stream *s = &decompressor->stream.bzip2;
+  memset (s, 0, sizeof *s);
+  return BZ2_bzDecompressInit (s, 0, 0) == BZ_OK;
+}
+
+static size_t decompress_bzip2 (decompressor *decompressor,
+                                unsigned char *out, size_t size) {
+  bz_stream *s = &decompressor->stream.bzip2;
+  s->next_out = (char *) out;
+  s->avail_out = size;
+  while (s->avail_out && !decompressor->finished) {
+    if (!s->avail_in) {
+      const size_t bytes = read_input (decompressor);
+      if (!bytes) {
+        corrupted (decompressor, "truncated compressed input");
+        break;
+      }
+      s->next_in = (char *) decompressor->input;
+      s->avail_in = bytes;
+    }
+    const int ret = BZ2_bzDecompress (s);
+    if (ret == BZ_STREAM_END) {
+      if (!s->avail_in) {
+        const size_t bytes = read_input (decompressor);
+        if (!bytes) {
+          decompressor->finished = true;
+          break;
+        }
+        s->next_in = (char *) decompressor->input;
+        s->avail_in = bytes;
+      }
+      char *next_in = s->next_in;
+      const unsigned avail_in = s->avail_in;
+      char *next_out = s->next_out;
+      const unsigned avail_out = s->avail_out;
+      BZ2_bzDecompressEnd (s);
+      if (!init_bzip2 (decompressor)) {
+        corrupted (decompressor, "could not restart decompression");
+        break;
+      }
+      s->next_in = next_in;
+      s->avail_in = avail_in;
+      s->next_out = next_out;
+      s->avail_out = avail_out;
+    } else if (ret != BZ_OK)
+      corrupted (decompressor, "invalid compressed input");
+  }
+  return size - s->avail_out;
+}
+
+static void release_bzip2 (decompressor *decompressor) {
+  BZ2_bzDecompressEnd (&decompressor->stream.bzip2);
+}
+
+#endif
+
+/*------------------------------------------------------------------------*/
+
+static bool init_stream (decompressor *decompressor) {
+  switch (decompressor->type) {
+#ifdef KISSAT_HAS_BZIP2
+  case BZIP2_DECOMPRESSION:
+    return init_bzip2 (decompressor);
+#endif
+#ifdef KISSAT_HAS_ZLIB
+  case GZIP_DECOMPRESSION:
+    return init_gzip (decompressor);
+#endif
+#ifdef KISSAT_HAS_LZMA
+  case LZMA_DECOMPRESSION:
+  case XZ_DECOMPRESSION:
+    return init_xz (decompressor);
+#endif
+  default:
+    return false;
+  }
+}
+
+static size_t decompress_block (decompressor *decompressor,
+                                unsigned char *out, size_t size) {
+  if (decompressor->finished)
+    return 0;
+  switch (decompressor->type) {
+#ifdef KISSAT_HAS_BZIP2
+  case BZIP2_DECOMPRESSION:
+    return decompress_bzip2 (decompressor, out, size);
+#endif
+#ifdef KISSAT_HAS_ZLIB
+  case GZIP_DECOMPRESSION:
+    return decompress_gzip (decompressor, out, size);
+#endif
+#ifdef KISSAT_HAS_LZMA
+  case LZMA_DECOMPRESSION:
+  case XZ_DECOMPRESSION:
+    return decompress_xz (decompressor, out, size);
+#endif
+  default:
+    return 0;
+  }
+}
+
+static void release_stream (decompressor *decompressor) {
+  switch (decompressor->type) {
+#ifdef KISSAT_HAS_BZIP2
+  case BZIP2_DECOMPRESSION:
+    release_bzip2 (decompressor);
+    break;
+#endif
+#ifdef KISSAT_HAS_ZLIB
+  case GZIP_DECOMPRESSION:
+    release_gzip (decompressor);
+    break;
+#endif
+#ifdef KISSAT_HAS_LZMA
+  case LZMA_DECOMPRESSION:
+  case XZ_DECOMPRESSION:
+    release_xz (decompressor);
+    break;
+#endif
+  default:
+    break;
+  }
+}
+
+/*------------------------------------------------------------------------*/
+
+// The helper thread fills the two blocks alternately and marks the end of
+// the decompressed data by an empty full block.
+
+static void *decompress_blocks (void *ptr) {
+  decompressor *decompressor = ptr;
+  for (unsigned i = 0;; i = !i) {
+    block *block = decompressor->blocks + i;
+    pthread_mutex_lock (&decompressor->lock);
+    while (block->full && !decompressor->stop)
+      pthread_cond_wait (&decompressor->cond, &decompressor->lock);
+    const bool stop = decompressor->stop;
+    pthread_mutex_unlock (&decompressor->lock);
+    if (stop)
+      break;
+    const size_t size =
+        decompress_block (decompressor, block->chars, SIZE_OUTPUT);
+    pthread_mutex_lock (&decompressor->lock);
+    block->size = size;
+    block->full = true;
+    pthread_cond_broadcast (&decompressor->cond);
+    pthread_mutex_unlock (&decompressor->lock);
+    if (!size)
+      break;
+  }
+  return 0;
+}
+
+size_t kissat_decompress (decompressor *decompressor, void *ptr,
+                          size_t bytes) {
+  unsigned char *chars = ptr;
+  size_t res = 0;
+  while (res < bytes) {
+    block *block = decompressor->blocks + decompressor->consumer;
+    if (!decompressor->pos) {
+      pthread_mutex_lock (&decompressor->lock);
+      while (!block->full)
+        pthread_cond_wait (&decompressor->cond, &decompressor->lock);
+      pthread_mutex_unlock (&decompressor->lock);
+    }
+    if (!block->size)
+      break;
+    assert (decompressor->pos < block->size);
+    size_t available = block->size - decompressor->pos;
+    size_t needed = bytes - res;
+    const size_t n = available < needed ? available : needed;
+    memcpy (chars + res, block->chars + decompressor->pos, n);
+    decompressor->pos += n;
+    res += n;
+    if (decompressor->pos == block->size) {
+      pthread_mutex_lock (&decompressor->lock);
+      block->full = false;
+      pthread_cond_broadcast (&decompressor->cond);
+      pthread_mutex_unlock (&decompressor->lock);
+      decompressor->consumer = !decompressor->consumer;
+      decompressor->pos = 0;
+    }
+  }
+  return res;
+}
+
+const char *kissat_decompression_error (decompressor *decompressor) {
+  const block *block = decompressor->blocks + decompressor->consumer;
+  pthread_mutex_lock (&decompressor->lock);
+  const bool end = block->full && !block->size;
+  pthread_mutex_unlock (&decompressor->lock);
+  return end ? decompressor->error : 0;
+}
+
+static void free_decompressor (decompressor *decompressor) {
+  for (unsigned i = 0; i != 2; i++)
+    if (decompressor->blocks[i].chars)
+      kissat_raw_free (decompressor->blocks[i].chars, SIZE_OUTPUT);
+  if (decompressor->input)
+    kissat_raw_free (decompressor->input, SIZE_INPUT);
+  kissat_raw_free (decompressor, sizeof *decompressor);
+}
+
+decompressor *kissat_new_decompressor (FILE *file, const char *path,
+                                       decompression type) {
+  decompressor *decompressor =
+      kissat_raw_calloc (1, sizeof *decompressor);
+  if (!decompressor)
+    return 0;
+  decompressor->file = file;
+  decompressor->path = path;
+  decompressor->type = type;
+  decompressor->input = kissat_raw_malloc (SIZE_INPUT);
+  for (unsigned i = 0; i != 2; i++)
+    decompressor->blocks[i].chars = kissat_raw_malloc (SIZE_OUTPUT);
+  if (!decompressor->input || !decompressor->blocks[0].chars ||
+      !decompressor->blocks[1].chars) {
+    free_decompressor (decompressor);
+    return 0;
+  }
+  if (!init_stream (decompressor)) {
+    free_decompressor (decompressor);
+    return 0;
+  }
+  pthread_mutex_init (&decompressor->lock, 0);
+  pthread_cond_init (&decompressor->cond, 0);
+  if (pthread_create (&decompressor->thread, 0, decompress_blocks,
+                      decompressor))
+    kissat_fatal ("failed to create decompression thread");
+  return decompressor;
+}
+
+void kissat_delete_decompressor (decompressor *decompressor) {
+  pthread_mutex_lock (&decompressor->lock);
+  decompressor->stop = true;
+  pthread_cond_broadcast (&decompressor->cond);
+  pthread_mutex_unlock (&decompressor->lock);
+  if (pthread_join (decompressor->thread, 0))
+    kissat_fatal ("failed to join decompression thread");
+  pthread_cond_destroy (&decompressor->cond);
+  pthread_mutex_destroy (&decompressor->lock);
+  release_stream (decompressor);
+  free_decompressor (decompressor);
+}
+
+#else
+
+int kissat_decompress_dummy_to_avoid_warning;
+
+#endif
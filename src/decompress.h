@@ -0,0 +1,37 @@
+#ifndef _decompress_h_INCLUDED
+#define _decompress_h_INCLUDED
+
+#include <stdio.h>
+
+#if defined(KISSAT_HAS_ZLIB) || defined(KISSAT_HAS_LZMA) || \
+    defined(KISSAT_HAS_BZIP2)
+#define KISSAT_HAS_DECOMPRESSION
+#endif
+
+#ifdef KISSAT_HAS_DECOMPRESSION
+
+enum decompression {
+  BZIP2_DECOMPRESSION,
+  GZIP_DECOMPRESSION,
+  LZMA_DECOMPRESSION,
+  XZ_DECOMPRESSION,
+};
+
+typedef enum decompression decompression;
+typedef struct decompressor decompressor;
+
+// Built-in streaming decompression of compressed input files, which runs
+// on a helper thread decompressing into one of two buffers, while the
+// other one is consumed by 'kissat_decompress' (through 'kissat_read').
+// Corrupted or truncated input ends the decompressed data early and then
+// 'kissat_decompression_error' returns the reason (and zero otherwise).
+
+decompressor *kissat_new_decompressor (FILE *, const char *path,
+                                       decompression);
+size_t kissat_decompress (decompressor *, void *, size_t);
+const char *kissat_decompression_error (decompressor *);
+void kissat_delete_decompressor (decompressor *);
+
+#endif
+
+#endif
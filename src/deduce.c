@@ -37,7 +37,8 @@ bool kissat_recompute_and_promote (kissat *solver, clause *c) {
 }
 
 static inline bool analyze_literal (kissat *solver, assigned *all_assigned,
-                                    frame *frames, unsigned lit) {
+                                    analysis *analysis, frame *frames,
+                                    unsigned lit) {
   assert (VALUE (lit) < 0);
   const unsigned idx = IDX (lit);
   assigned *a = all_assigned + idx;
@@ -45,10 +46,10 @@ static inline bool analyze_literal (kissat *solver, assigned *all_assigned,
   if (!level)
     return false;
   solver->antecedent_size++;
-  if (a->analyzed)
+  if (analysis[idx].analyzed)
     return false;
   LOG ("analyzing literal %s", LOGLIT (lit));
-  kissat_push_analyzed (solver, all_assigned, idx);
+  kissat_push_analyzed (solver, analysis, idx);
   assert (level <= solver->level);
 #if defined(LOGGING) || !defined(NDEBUG)
   PUSH_STACK (solver->resolvent, lit);
@@ -56,7 +57,7 @@ static inline bool analyze_literal (kissat *solver, assigned *all_assigned,
   solver->resolvent_size++;
   if (level == solver->level)
     return true;
-  assert (a->analyzed);
+  assert (analysis[idx].analyzed);
   PUSH_STACK (solver->clause, lit);
   LOG ("learned literal %s", LOGLIT (lit));
   frame *f = frames + level;
@@ -82,12 +83,13 @@ clause *kissat_deduce_first_uip_clause (kissat *solver, clause *conflict) {
   solver->resolvent_size = 0;
   unsigned unresolved_on_current_level = 0, conflict_size = 0;
   assigned *all_assigned = solver->assigned;
+  analysis *analysis = solver->analysis;
   frame *frames = BEGIN_STACK (solver->frames);
   for (all_literals_in_clause (lit, conflict)) {
     assert (VALUE (lit) < 0);
     if (LEVEL (lit))
       conflict_size++;
-    if (analyze_literal (solver, all_assigned, frames, lit))
+    if (analyze_literal (solver, all_assigned, analysis, frames, lit))
       unresolved_on_current_level++;
   }
   assert (unresolved_on_current_level > 1);
@@ -105,7 +107,7 @@ clause *kissat_deduce_first_uip_clause (kissat *solver, clause *conflict) {
       assert (t > BEGIN_ARRAY (solver->trail));
       uip = *--t;
       a = ASSIGNED (uip);
-    } while (!a->analyzed || a->level != solver->level);
+    } while (a->level != solver->level || !ANALYSIS (uip)->analyzed);
     if (unresolved_on_current_level == 1)
       break;
     assert (a->reason != DECISION_REASON);
@@ -115,7 +117,7 @@ clause *kissat_deduce_first_uip_clause (kissat *solver, clause *conflict) {
     if (a->binary) {
       const unsigned other = a->reason;
       LOGBINARY (uip, other, "resolving %s reason", LOGLIT (uip));
-      if (analyze_literal (solver, all_assigned, frames, other))
+      if (analyze_literal (solver, all_assigned, analysis, frames, other))
         unresolved_on_current_level++;
     } else {
       const reference ref = a->reason;
@@ -123,7 +125,7 @@ clause *kissat_deduce_first_uip_clause (kissat *solver, clause *conflict) {
       clause *reason = kissat_dereference_clause (solver, ref);
       for (all_literals_in_clause (lit, reason))
         if (lit != uip &&
-            analyze_literal (solver, all_assigned, frames, lit))
+            analyze_literal (solver, all_assigned, analysis, frames, lit))
           unresolved_on_current_level++;
       mark_clause_as_used (solver, reason);
     }
@@ -146,7 +148,8 @@ clause *kissat_deduce_first_uip_clause (kissat *solver, clause *conflict) {
       assert (solver->antecedent_size && solver->resolvent_size + 1);
       clause *reason = kissat_dereference_clause (solver, a->reason);
       assert (!reason->garbage);
-      clause *res = kissat_on_the_fly_strengthen (solver, reason, uip);
+      clause *res =
+          kissat_on_the_fly_strengthen (solver, conflict, reason, uip);
       if (resolved == 1 && solver->resolvent_size < conflict_size) {
         assert (!conflict->garbage);
         assert (conflict_size > 2);
@@ -1,6 +1,7 @@
 #include "eliminate.h"
 #include "allocate.h"
 #include "backtrack.h"
+#include "budget.h"
 #include "collect.h"
 #include "dense.h"
 #include "forward.h"
@@ -12,11 +13,13 @@
 #include "report.h"
 #include "resolve.h"
 #include "terminate.h"
+#include "threads.h"
 #include "trail.h"
 #include "weaken.h"
 
 #include <inttypes.h>
 #include <math.h>
+#include <string.h>
 
 bool kissat_eliminating (kissat *solver) {
   if (!solver->enabled.eliminate)
@@ -378,6 +381,8 @@ static bool can_eliminate_variable (kissat *solver, unsigned idx) {
     return false;
   if (!flags->eliminate)
     return false;
+  if (flags->frozen)
+    return false;
 
   return true;
 }
@@ -413,6 +418,261 @@ static bool eliminate_variable (kissat *solver, unsigned idx) {
   return true;
 }
 
+// With more than one elimination thread candidates are scheduled in
+// batches.  Each batch is a set of candidates with pairwise disjoint
+// neighbourhoods (the variables occurring in their clauses), obtained
+// greedily in schedule order, i.e., the first color class of a greedy
+// coloring of the candidate interference graph.  Conflicting candidates
+// are put back into the schedule.  Then the plain resolvents of all batch
+// candidates are computed concurrently, since they only read the solver.
+// Finally they are committed on the main thread in schedule order.  As
+// long as no unit is derived committing one candidate does not change the
+// clauses of the other candidates and the result is the same as for
+// sequential elimination without gates.  Otherwise, and if gates should
+// be extracted for candidates which could not be eliminated by plain
+// resolution, we fall back to sequential elimination of the candidate.
+// The size of batches does not depend on the number of threads, which
+// thus only distribute the work and do not change the result.
+
+#define ELIMINATION_BATCH_SIZE 128
+
+typedef struct batch batch;
+typedef struct resolver resolver;
+
+struct resolver {
+  kissat *solver;
+  batch *batch;
+  value *marks;
+  unsigned id;
+};
+
+struct batch {
+  unsigned threads;
+  unsigned capacity;
+  unsigned size;
+  uint64_t tried;
+  bool *touched;
+  unsigneds neighbours;
+  unsigneds deferred;
+  resolution *resolutions;
+  resolver *resolvers;
+};
+
+static void init_batch (kissat *solver, batch *batch, unsigned threads) {
+  memset (batch, 0, sizeof *batch);
+  batch->threads = threads;
+  if (threads < 2)
+    return;
+  const unsigned capacity = ELIMINATION_BATCH_SIZE;
+  batch->capacity = capacity;
+  batch->touched = kissat_calloc (solver, VARS, sizeof *batch->touched);
+  batch->resolutions =
+      kissat_calloc (solver, capacity, sizeof *batch->resolutions);
+  batch->resolvers = kissat_nalloc (solver, threads, sizeof (resolver));
+  for (unsigned i = 0; i < threads; i++) {
+    resolver *resolver = batch->resolvers + i;
+    resolver->solver = solver;
+    resolver->batch = batch;
+    resolver->marks = kissat_calloc (solver, LITS, sizeof (value));
+    resolver->id = i;
+  }
+}
+
+static void release_batch (kissat *solver, batch *batch) {
+  const unsigned threads = batch->threads;
+  if (threads < 2)
+    return;
+  const unsigned capacity = batch->capacity;
+  for (unsigned i = 0; i < threads; i++)
+    kissat_dealloc (solver, batch->resolvers[i].marks, LITS,
+                    sizeof (value));
+  for (unsigned i = 0; i < capacity; i++)
+    kissat_release_resolution (solver, batch->resolutions + i);
+  kissat_dealloc (solver, batch->resolvers, threads, sizeof (resolver));
+  kissat_dealloc (solver, batch->resolutions, capacity,
+                  sizeof *batch->resolutions);
+  kissat_dealloc (solver, batch->touched, VARS, sizeof *batch->touched);
+  RELEASE_STACK (batch->neighbours);
+  RELEASE_STACK (batch->deferred);
+}
+
+static bool touch_neighbourhood (kissat *solver, batch *batch,
+                                 unsigned idx, bool touch) {
+  bool *const touched = batch->touched;
+  const unsigned lit = LIT (idx);
+  for (unsigned sign = 0; sign < 2; sign++) {
+    const unsigned pivot = lit + sign;
+    watches *const watches = &WATCHES (pivot);
+    for (all_binary_large_watches (watch, *watches)) {
+      if (watch.type.binary) {
+        const unsigned other = IDX (watch.binary.lit);
+        if (!touch && touched[other])
+          return false;
+        if (touch && !touched[other]) {
+          touched[other] = true;
+          PUSH_STACK (batch->neighbours, other);
+        }
+      } else {
+        const reference ref = watch.large.ref;
+        clause *const c = kissat_dereference_clause (solver, ref);
+        if (c->garbage)
+          continue;
+        for (all_literals_in_clause (other_lit, c)) {
+          const unsigned other = IDX (other_lit);
+          if (!touch && touched[other])
+            return false;
+          if (touch && !touched[other]) {
+            touched[other] = true;
+            PUSH_STACK (batch->neighbours, other);
+          }
+        }
+      }
+    }
+  }
+  if (!touch && touched[idx])
+    return false;
+  if (touch && !touched[idx]) {
+    touched[idx] = true;
+    PUSH_STACK (batch->neighbours, idx);
+  }
+  return true;
+}
+
+static void select_batch (kissat *solver, batch *batch) {
+  heap *const schedule = &solver->schedule;
+  const unsigned capacity = batch->capacity;
+  assert (EMPTY_STACK (batch->deferred));
+  assert (EMPTY_STACK (batch->neighbours));
+  batch->size = 0;
+  while (batch->size < capacity &&
+         SIZE_STACK (batch->deferred) < capacity &&
+         !kissat_empty_heap (schedule)) {
+    const unsigned idx = kissat_pop_max_heap (solver, schedule);
+    if (!can_eliminate_variable (solver, idx))
+      continue;
+    resolution *const resolution = batch->resolutions + batch->size;
+    if (!kissat_prepare_resolution (solver, idx, resolution)) {
+      LOG ("marking %s as not removed", LOGVAR (idx));
+      FLAGS (idx)->eliminate = false;
+      batch->tried++;
+      continue;
+    }
+    if (!touch_neighbourhood (solver, batch, idx, false)) {
+      LOG ("deferring elimination candidate %s", LOGVAR (idx));
+      PUSH_STACK (batch->deferred, idx);
+      continue;
+    }
+    LOG ("scheduling elimination candidate %s in batch", LOGVAR (idx));
+    (void) touch_neighbourhood (solver, batch, idx, true);
+    batch->size++;
+  }
+  for (all_stack (unsigned, idx, batch->deferred))
+    if (!kissat_heap_contains (schedule, idx))
+      kissat_push_heap (solver, schedule, idx);
+  CLEAR_STACK (batch->deferred);
+  bool *const touched = batch->touched;
+  for (all_stack (unsigned, idx, batch->neighbours))
+    touched[idx] = false;
+  CLEAR_STACK (batch->neighbours);
+}
+
+static void *resolver_thread (void *ptr) {
+  resolver *resolver = ptr;
+  batch *batch = resolver->batch;
+  const unsigned threads = batch->threads, size = batch->size;
+  for (unsigned i = resolver->id; i < size; i += threads)
+    kissat_resolve_concurrently (resolver->solver, resolver->marks,
+                                 batch->resolutions + i, true);
+  return 0;
+}
+
+static void resolve_batch_concurrently (kissat *solver, batch *batch) {
+  const unsigned threads = MIN (batch->threads, batch->size);
+  kissat_run_threads (solver, "elimination", threads, resolver_thread,
+                      batch->resolvers, sizeof *batch->resolvers);
+}
+
+static bool commit_resolution (kissat *solver, batch *batch,
+                               resolution *resolution) {
+  const unsigned idx = resolution->idx;
+  assert (can_eliminate_variable (solver, idx));
+  if (resolution->overflow) {
+    LOG ("resolving %s again since reserved resolvents overflowed",
+         LOGVAR (idx));
+    kissat_resolve_concurrently (solver, batch->resolvers->marks,
+                                 resolution, false);
+    assert (!resolution->overflow);
+  }
+  if (!resolution->feasible && GET_OPTION (extract)) {
+    LOG ("plain elimination of %s failed thus trying gates", LOGVAR (idx));
+    return eliminate_variable (solver, idx);
+  }
+  ADD (eliminate_resolutions, resolution->resolutions);
+  LOG ("marking %s as not removed", LOGVAR (idx));
+  FLAGS (idx)->eliminate = false;
+  INC (eliminate_attempted);
+  if (!resolution->feasible) {
+    LOG ("elimination of %s failed", LOGVAR (idx));
+    if (resolution->update)
+      kissat_update_variable_score (solver, idx);
+    return false;
+  }
+  LOG ("committing %zu resolvent literals of %s",
+       SIZE_STACK (resolution->resolvents), LOGVAR (idx));
+  assert (EMPTY_STACK (solver->resolvents));
+  for (all_stack (unsigned, lit, resolution->resolvents))
+    PUSH_STACK (solver->resolvents, lit);
+  connect_resolvents (solver);
+  if (!solver->inconsistent)
+    weaken_clauses (solver, resolution->lit);
+  INC (eliminated);
+  kissat_mark_eliminated_variable (solver, idx);
+  return true;
+}
+
+static unsigned eliminate_batch (kissat *solver, batch *batch) {
+  select_batch (solver, batch);
+  const unsigned size = batch->size;
+  if (!size)
+    return 0;
+  LOG ("resolving batch of %u candidates concurrently", size);
+  resolve_batch_concurrently (solver, batch);
+  const size_t units = SIZE_ARRAY (solver->trail);
+  unsigned eliminated = 0;
+  for (unsigned i = 0; i < size; i++) {
+    resolution *const resolution = batch->resolutions + i;
+    if (SIZE_ARRAY (solver->trail) == units)
+      eliminated += commit_resolution (solver, batch, resolution);
+    else {
+      const unsigned idx = resolution->idx;
+      if (!can_eliminate_variable (solver, idx))
+        continue;
+      LOG ("units derived thus eliminating %s sequentially",
+           LOGVAR (idx));
+      eliminated += eliminate_variable (solver, idx);
+    }
+    batch->tried++;
+    if (solver->inconsistent)
+      break;
+    kissat_flush_units_while_connected (solver);
+  }
+  return eliminated;
+}
+
+static bool resolution_limit_hit (kissat *solver, int round,
+                                  uint64_t resolution_limit) {
+  statistics *s = &solver->statistics;
+  if (s->eliminate_resolutions <= resolution_limit)
+    return false;
+  kissat_extremely_verbose (solver,
+                            "eliminate round %u hits "
+                            "resolution limit %" PRIu64 " at %" PRIu64
+                            " resolutions",
+                            round, resolution_limit,
+                            s->eliminate_resolutions);
+  return true;
+}
+
 static void eliminate_variables (kissat *solver) {
   kissat_very_verbose (solver,
                        "trying to eliminate variables with bound %u",
@@ -432,6 +692,13 @@ static void eliminate_variables (kissat *solver) {
 
   const bool forward = GET_OPTION (forward);
 
+  const unsigned threads = kissat_threads (GET_OPTION (eliminatethreads));
+  batch batch;
+  init_batch (solver, &batch, threads);
+  if (batch.threads > 1)
+    kissat_very_verbose (solver, "resolving with %u elimination threads",
+                         batch.threads);
+
   for (;;) {
     round++;
     LOG ("starting new elimination round %d", round);
@@ -471,16 +738,18 @@ static void eliminate_variables (kissat *solver) {
         complete = false;
         break;
       }
+      if (batch.threads > 1) {
+        if (resolution_limit_hit (solver, round, resolution_limit)) {
+          complete = false;
+          break;
+        }
+        last_round_eliminated += eliminate_batch (solver, &batch);
+        continue;
+      }
       unsigned idx = kissat_pop_max_heap (solver, &solver->schedule);
       if (!can_eliminate_variable (solver, idx))
         continue;
-      statistics *s = &solver->statistics;
-      if (s->eliminate_resolutions > resolution_limit) {
-        kissat_extremely_verbose (
-            solver,
-            "eliminate round %u hits "
-            "resolution limit %" PRIu64 " at %" PRIu64 " resolutions",
-            round, resolution_limit, s->eliminate_resolutions);
+      if (resolution_limit_hit (solver, round, resolution_limit)) {
         complete = false;
         break;
       }
@@ -528,7 +797,9 @@ static void eliminate_variables (kissat *solver) {
 
   const unsigned remain = kissat_size_heap (&solver->schedule);
   kissat_release_heap (solver, &solver->schedule);
+  release_batch (solver, &batch);
 #ifndef QUIET
+  tried += batch.tried;
   kissat_very_verbose (solver,
                        "eliminated %u variables %.0f%% of %" PRIu64 " tried"
                        " (%u remain %.0f%%)",
@@ -595,7 +866,11 @@ static void eliminate (kissat *solver) {
 int kissat_eliminate (kissat *solver) {
   assert (!solver->inconsistent);
   INC (eliminations);
-  eliminate (solver);
+  if (kissat_memory_pressure (solver))
+    kissat_extremely_verbose (solver,
+                              "elimination skipped due to memory pressure");
+  else
+    eliminate (solver);
   kissat_classify (solver);
   UPDATE_CONFLICT_LIMIT (eliminate, eliminations, NLOG2N, true);
   solver->last.ticks.eliminate = solver->statistics.search_ticks;
@@ -1,4 +1,5 @@
 #include "factor.h"
+#include "budget.h"
 #include "bump.h"
 #include "clause.h"
 #include "dense.h"
@@ -1070,6 +1071,8 @@ void kissat_factor (kissat *solver) {
     return;
   if (!GET_OPTION (factor))
     return;
+  if (GET_OPTION (incremental))
+    return;
   statistics *s = &solver->statistics;
   if (solver->limits.factor.marked >= s->literals_factor) {
     kissat_extremely_verbose (
@@ -1079,6 +1082,11 @@ void kissat_factor (kissat *solver) {
         solver->limits.factor.marked, s->literals_factor);
     return;
   }
+  if (kissat_memory_pressure (solver)) {
+    kissat_extremely_verbose (
+        solver, "factorization skipped due to memory pressure");
+    return;
+  }
   START (factor);
   INC (factorizations);
   kissat_phase (solver, "factorization", GET (factorizations),
@@ -854,6 +854,8 @@ void kissat_fast_variable_elimination (kissat *solver) {
         continue;
       if (!pivot_flags->eliminate)
         continue;
+      if (pivot_flags->frozen)
+        continue;
       const unsigned lit = LIT (pivot);
       const size_t pos = flush_occurrences (solver, lit);
       if (pos > fasteloccs)
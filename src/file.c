@@ -1,4 +1,5 @@
 #include "file.h"
+#include "allocate.h"
 #include "keatures.h"
 #include "utilities.h"
 
@@ -57,7 +58,7 @@ bool kissat_file_writable (const char *path) {
         res = 5;
       else {
         const size_t len = p - path;
-        char *dirname = malloc (len + 1);
+        char *dirname = kissat_raw_malloc (len + 1);
         if (dirname) {
           strncpy (dirname, path, len);
           dirname[len] = 0;
@@ -76,7 +77,7 @@ bool kissat_file_writable (const char *path) {
             res = 9;
           else
             res = 0;
-          free (dirname);
+          kissat_raw_free (dirname, len + 1);
         } else
           res = 10;
       }
@@ -98,7 +99,7 @@ bool kissat_find_executable (const char *name) {
   if (!environment)
     return false;
   const size_t dirs_len = strlen (environment);
-  char *dirs = malloc (dirs_len + 1);
+  char *dirs = kissat_raw_malloc (dirs_len + 1);
   if (!dirs)
     return false;
   strcpy (dirs, environment);
@@ -109,17 +110,17 @@ bool kissat_find_executable (const char *name) {
       assert (q + 1 < end);
     *q++ = 0;
     const size_t path_len = (q - dir) + name_len;
-    char *path = malloc (path_len + 1);
+    char *path = kissat_raw_malloc (path_len + 1);
     if (!path) {
-      free (dirs);
+      kissat_raw_free (dirs, dirs_len + 1);
       return false;
     }
     sprintf (path, "%s/%s", dir, name);
     assert (strlen (path) == path_len);
     res = kissat_file_readable (path);
-    free (path);
+    kissat_raw_free (path, path_len + 1);
   }
-  free (dirs);
+  kissat_raw_free (dirs, dirs_len + 1);
   return res;
 }
 
@@ -149,21 +150,22 @@ static FILE *open_pipe (const char *fmt, const char *path,
   size_t name_len = 0;
   while (fmt[name_len] && fmt[name_len] != ' ')
     name_len++;
-  char *name = malloc (name_len + 1);
+  char *name = kissat_raw_malloc (name_len + 1);
   if (!name)
     return 0;
   strncpy (name, fmt, name_len);
   name[name_len] = 0;
   bool found = kissat_find_executable (name);
-  free (name);
+  kissat_raw_free (name, name_len + 1);
   if (!found)
     return 0;
-  char *cmd = malloc (strlen (fmt) + strlen (path));
+  const size_t cmd_len = strlen (fmt) + strlen (path);
+  char *cmd = kissat_raw_malloc (cmd_len);
   if (!cmd)
     return 0;
   sprintf (cmd, fmt, path);
   FILE *res = popen (cmd, mode);
-  free (cmd);
+  kissat_raw_free (cmd, cmd_len);
   return res;
 }
 
@@ -192,6 +194,12 @@ void kissat_read_already_open_file (file *file, FILE *f, const char *path) {
   file->compressed = false;
   file->path = path;
   file->bytes = 0;
+#ifdef KISSAT_HAS_DECOMPRESSION
+  file->decompressor = 0;
+#endif
+#ifdef KISSAT_HAS_BUILTIN_COMPRESSION
+  file->compressor = 0;
+#endif
 }
 
 void kissat_write_already_open_file (file *file, FILE *f,
@@ -202,8 +210,70 @@ void kissat_write_already_open_file (file *file, FILE *f,
   file->compressed = false;
   file->path = path;
   file->bytes = 0;
+#ifdef KISSAT_HAS_DECOMPRESSION
+  file->decompressor = 0;
+#endif
+#ifdef KISSAT_HAS_BUILTIN_COMPRESSION
+  file->compressor = 0;
+#endif
+}
+
+#ifdef KISSAT_HAS_DECOMPRESSION
+
+static bool read_decompressed (file *file, const char *path,
+                               decompression type, const int *sig) {
+  if (!match_signature (path, sig))
+    return false;
+  FILE *f = fopen (path, "rb");
+  if (!f)
+    return false;
+  decompressor *decompressor = kissat_new_decompressor (f, path, type);
+  if (!decompressor) {
+    fclose (f);
+    return false;
+  }
+  file->file = f;
+  file->close = true;
+  file->reading = true;
+  file->compressed = true;
+  file->path = path;
+  file->bytes = 0;
+  file->decompressor = decompressor;
+#ifdef KISSAT_HAS_BUILTIN_COMPRESSION
+  file->compressor = 0;
+#endif
+  return true;
 }
 
+#endif
+
+#ifdef KISSAT_HAS_BUILTIN_COMPRESSION
+
+static bool write_compressed (file *file, const char *path,
+                              compression type) {
+  FILE *f = fopen (path, "wb");
+  if (!f)
+    return false;
+  compressor *compressor = kissat_new_compressor (f, type);
+  if (!compressor) {
+    fclose (f);
+    return false;
+  }
+  file->file = f;
+  file->close = true;
+  file->reading = false;
+  file->compressed = true;
+  file->path = path;
+  file->bytes = 0;
+#ifdef KISSAT_HAS_DECOMPRESSION
+  file->decompressor = 0;
+#endif
+  file->compressor = compressor;
+  return true;
+}
+
+#endif
+
 #ifndef KISSAT_HAS_COMPRESSION
 
 bool kissat_looks_like_a_compressed_file (const char *path) {
@@ -225,6 +295,28 @@ bool kissat_looks_like_a_compressed_file (const char *path) {
 #endif
 
 bool kissat_open_to_read_file (file *file, const char *path) {
+#ifdef KISSAT_HAS_BUILTIN_COMPRESSION
+  file->compressor = 0;
+#endif
+#ifdef KISSAT_HAS_DECOMPRESSION
+  file->decompressor = 0;
+#define READ_DECOMPRESSED(SUFFIX, TYPE, SIG) \
+  do { \
+    if (kissat_has_suffix (path, SUFFIX) && \
+        read_decompressed (file, path, TYPE, SIG)) \
+      return true; \
+  } while (0)
+#ifdef KISSAT_HAS_BZIP2
+  READ_DECOMPRESSED (".bz2", BZIP2_DECOMPRESSION, bz2sig);
+#endif
+#ifdef KISSAT_HAS_ZLIB
+  READ_DECOMPRESSED (".gz", GZIP_DECOMPRESSION, gzsig);
+#endif
+#ifdef KISSAT_HAS_LZMA
+  READ_DECOMPRESSED (".lzma", LZMA_DECOMPRESSION, lzmasig);
+  READ_DECOMPRESSED (".xz", XZ_DECOMPRESSION, xzsig);
+#endif
+#endif
 #ifdef KISSAT_HAS_COMPRESSION
 #define READ_PIPE(SUFFIX, CMD, SIG) \
   do { \
@@ -260,6 +352,27 @@ bool kissat_open_to_read_file (file *file, const char *path) {
 }
 
 bool kissat_open_to_write_file (file *file, const char *path) {
+#ifdef KISSAT_HAS_DECOMPRESSION
+  file->decompressor = 0;
+#endif
+#ifdef KISSAT_HAS_BUILTIN_COMPRESSION
+  file->compressor = 0;
+#define WRITE_COMPRESSED(SUFFIX, TYPE) \
+  do { \
+    if (kissat_has_suffix (path, SUFFIX)) \
+      return write_compressed (file, path, TYPE); \
+  } while (0)
+#ifdef KISSAT_HAS_BZIP2
+  WRITE_COMPRESSED (".bz2", BZIP2_COMPRESSION);
+#endif
+#ifdef KISSAT_HAS_ZLIB
+  WRITE_COMPRESSED (".gz", GZIP_COMPRESSION);
+#endif
+#ifdef KISSAT_HAS_LZMA
+  WRITE_COMPRESSED (".lzma", LZMA_COMPRESSION);
+  WRITE_COMPRESSED (".xz", XZ_COMPRESSION);
+#endif
+#endif
 #if defined(KISSAT_HAS_COMPRESSION) && !defined(SAFE)
 #define WRITE_PIPE(SUFFIX, CMD) \
   do { \
@@ -295,9 +408,41 @@ bool kissat_open_to_write_file (file *file, const char *path) {
   return true;
 }
 
+const char *kissat_file_error (file *file) {
+  assert (file);
+  assert (file->reading);
+#ifdef KISSAT_HAS_DECOMPRESSION
+  if (file->decompressor)
+    return kissat_decompression_error (file->decompressor);
+#else
+  (void) file;
+#endif
+  return 0;
+}
+
 void kissat_close_file (file *file) {
   assert (file);
   assert (file->file);
+#ifdef KISSAT_HAS_DECOMPRESSION
+  if (file->decompressor) {
+    kissat_delete_decompressor (file->decompressor);
+    file->decompressor = 0;
+    if (file->close)
+      fclose (file->file);
+    file->file = 0;
+    return;
+  }
+#endif
+#ifdef KISSAT_HAS_BUILTIN_COMPRESSION
+  if (file->compressor) {
+    kissat_delete_compressor (file->compressor);
+    file->compressor = 0;
+    if (file->close)
+      fclose (file->file);
+    file->file = 0;
+    return;
+  }
+#endif
 #ifdef KISSAT_HAS_COMPRESSION
   if (file->close && file->compressed)
     pclose (file->file);
@@ -7,6 +7,8 @@
 #include <stdio.h>
 
 #include "attribute.h"
+#include "compress.h"
+#include "decompress.h"
 #include "keatures.h"
 
 bool kissat_file_exists (const char *path);
@@ -24,6 +26,12 @@ struct file {
   bool compressed;
   const char *path;
   uint64_t bytes;
+#ifdef KISSAT_HAS_DECOMPRESSION
+  decompressor *decompressor;
+#endif
+#ifdef KISSAT_HAS_BUILTIN_COMPRESSION
+  compressor *compressor;
+#endif
 };
 
 void kissat_read_already_open_file (file *, FILE *, const char *path);
@@ -34,6 +42,11 @@ bool kissat_open_to_write_file (file *, const char *path);
 
 void kissat_close_file (file *);
 
+// Reading built-in decompressed files stops at corrupted or truncated
+// input, for which this function returns the reason after end-of-file.
+
+const char *kissat_file_error (file *);
+
 #ifndef KISSAT_HAS_COMPRESSION
 
 bool kissat_looks_like_a_compressed_file (const char *path);
@@ -60,10 +73,16 @@ static inline size_t kissat_read (file *file, void *ptr, size_t bytes) {
   assert (file);
   assert (file->file);
   assert (file->reading);
+  size_t res;
+#ifdef KISSAT_HAS_DECOMPRESSION
+  if (file->decompressor)
+    res = kissat_decompress (file->decompressor, ptr, bytes);
+  else
+#endif
 #ifdef KISSAT_HAS_UNLOCKEDIO
-  size_t res = fread_unlocked (ptr, 1, bytes, file->file);
+    res = fread_unlocked (ptr, 1, bytes, file->file);
 #else
-  size_t res = fread (ptr, 1, bytes, file->file);
+    res = fread (ptr, 1, bytes, file->file);
 #endif
   file->bytes += res;
   return res;
@@ -73,10 +92,16 @@ static inline size_t kissat_write (file *file, void *ptr, size_t bytes) {
   assert (file);
   assert (file->file);
   assert (!file->reading);
+  size_t res;
+#ifdef KISSAT_HAS_BUILTIN_COMPRESSION
+  if (file->compressor)
+    res = kissat_compress (file->compressor, ptr, bytes) ? bytes : 0;
+  else
+#endif
 #ifdef KISSAT_HAS_UNLOCKEDIO
-  size_t res = fwrite_unlocked (ptr, 1, bytes, file->file);
+    res = fwrite_unlocked (ptr, 1, bytes, file->file);
 #else
-  size_t res = fwrite (ptr, 1, bytes, file->file);
+    res = fwrite (ptr, 1, bytes, file->file);
 #endif
   file->bytes += res;
   return res;
@@ -86,10 +111,17 @@ static inline int kissat_getc (file *file) {
   assert (file);
   assert (file->file);
   assert (file->reading);
+  int res;
+#ifdef KISSAT_HAS_DECOMPRESSION
+  if (file->decompressor) {
+    unsigned char ch;
+    res = kissat_decompress (file->decompressor, &ch, 1) ? ch : EOF;
+  } else
+#endif
 #ifdef KISSAT_HAS_UNLOCKEDIO
-  int res = getc_unlocked (file->file);
+    res = getc_unlocked (file->file);
 #else
-  int res = getc (file->file);
+    res = getc (file->file);
 #endif
   if (res != EOF)
     file->bytes++;
@@ -100,10 +132,17 @@ static inline int kissat_putc (file *file, int ch) {
   assert (file);
   assert (file->file);
   assert (!file->reading);
+  int res;
+#ifdef KISSAT_HAS_BUILTIN_COMPRESSION
+  if (file->compressor) {
+    unsigned char tmp = ch;
+    res = kissat_compress (file->compressor, &tmp, 1) ? ch : EOF;
+  } else
+#endif
 #ifdef KISSAT_HAS_UNLOCKEDIO
-  int res = putc_unlocked (ch, file->file);
+    res = putc_unlocked (ch, file->file);
 #else
-  int res = putc (ch, file->file);
+    res = putc (ch, file->file);
 #endif
   if (res != EOF)
     file->bytes++;
@@ -114,6 +153,10 @@ static inline void kissat_flush (file *file) {
   assert (file);
   assert (file->file);
   assert (!file->reading);
+#ifdef KISSAT_HAS_BUILTIN_COMPRESSION
+  if (file->compressor)
+    (void) kissat_flush_compressor (file->compressor);
+#endif
 #ifdef KISSAT_HAS_UNLOCKEDIO
   fflush_unlocked (file->file);
 #else
@@ -82,6 +82,7 @@ void kissat_mark_eliminated_variable (kissat *solver, unsigned idx) {
   assert (f->active);
   assert (!f->eliminated);
   assert (!f->fixed);
+  assert (!f->frozen);
   f->eliminated = true;
   deactivate_variable (solver, f, idx);
   int elit = kissat_export_literal (solver, lit);
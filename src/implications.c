@@ -0,0 +1,41 @@
+#include "implications.h"
+#include "inlinevector.h"
+#include "internal.h"
+#include "logging.h"
+
+void kissat_build_implications (kissat *solver) {
+  assert (solver->watching);
+  sizes *const offsets = &solver->implications.offsets;
+  unsigneds *const targets = &solver->implications.targets;
+  CLEAR_STACK (*offsets);
+  CLEAR_STACK (*targets);
+  for (all_literals (lit)) {
+    PUSH_STACK (*offsets, SIZE_STACK (*targets));
+    for (all_binary_blocking_watches (watch, WATCHES (lit)))
+      if (watch.type.binary)
+        PUSH_STACK (*targets, watch.binary.lit);
+  }
+  PUSH_STACK (*offsets, SIZE_STACK (*targets));
+  assert (SIZE_STACK (*offsets) == LITS + 1);
+  LOG ("built dense implication graph with %zu edges",
+       SIZE_STACK (*targets));
+}
+
+void kissat_remove_implication (kissat *solver, unsigned lit,
+                                unsigned other) {
+  LOG ("removing implication %s -> %s", LOGLIT (NOT (lit)), LOGLIT (other));
+  unsigned *const begin = BEGIN_IMPLICATIONS (lit);
+  unsigned *const end = END_IMPLICATIONS (lit);
+  unsigned *p = begin;
+  while (assert (p != end), *p != other)
+    p++;
+  *p = INVALID_LIT;
+#ifdef NDEBUG
+  (void) end;
+#endif
+}
+
+void kissat_release_implications (kissat *solver) {
+  RELEASE_STACK (solver->implications.offsets);
+  RELEASE_STACK (solver->implications.targets);
+}
@@ -0,0 +1,41 @@
+#ifndef _implications_h_INCLUDED
+#define _implications_h_INCLUDED
+
+#include "stack.h"
+
+// Dense copy of the binary implication graph in compressed sparse row
+// format.  The other literals of the binary clauses watched by literal
+// 'LIT' are stored consecutively in 'targets' starting at 'offsets[LIT]'
+// and ending right before 'offsets[LIT+1]'.  It is built from the watches
+// at the start of the binary clause only probing algorithms (backbone
+// computation and transitive reduction), which then scan tight arrays of
+// literals instead of watch lists interleaving binary and large clause
+// watches.  Binary clauses removed afterwards are marked 'INVALID_LIT'.
+// The copy is released at the end of probing and thus neither used for
+// propagation during search nor kept up-to-date during reduction and
+// garbage collection.  Offsets are 'size_t' as the number of edges is
+// only bounded by twice the number of binary clauses.
+
+typedef struct implications implications;
+
+struct implications {
+  sizes offsets;
+  unsigneds targets;
+};
+
+#define BEGIN_IMPLICATIONS(LIT) \
+  (BEGIN_STACK (solver->implications.targets) + \
+   PEEK_STACK (solver->implications.offsets, (LIT)))
+
+#define END_IMPLICATIONS(LIT) \
+  (BEGIN_STACK (solver->implications.targets) + \
+   PEEK_STACK (solver->implications.offsets, (LIT) + 1))
+
+struct kissat;
+
+void kissat_build_implications (struct kissat *);
+void kissat_remove_implication (struct kissat *, unsigned lit,
+                                unsigned other);
+void kissat_release_implications (struct kissat *);
+
+#endif
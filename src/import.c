@@ -10,6 +10,7 @@ static void adjust_imports_for_external_literal (kissat *solver,
     import.extension = false;
     import.imported = false;
     import.eliminated = false;
+    import.failed = 0;
     PUSH_STACK (solver->import, import);
   }
 }
@@ -79,6 +80,11 @@ unsigned kissat_import_literal (kissat *solver, int elit) {
   return ilit;
 }
 
+unsigned kissat_import_original_variable (kissat *solver, unsigned eidx) {
+  assert (VALID_EXTERNAL_LITERAL ((int) eidx));
+  return import_literal (solver, eidx, false);
+}
+
 unsigned kissat_fresh_literal (kissat *solver) {
   size_t imported = SIZE_STACK (solver->import);
   assert (imported <= EXTERNAL_MAX_VAR);
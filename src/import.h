@@ -5,5 +5,6 @@ struct kissat;
 
 unsigned kissat_import_literal (struct kissat *solver, int lit);
 unsigned kissat_fresh_literal (struct kissat *solver);
+unsigned kissat_import_original_variable (struct kissat *, unsigned eidx);
 
 #endif
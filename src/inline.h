@@ -90,6 +90,38 @@ static inline void kissat_push_blocking_watch (kissat *solver,
   PUSH_WATCHES (*watches, tail);
 }
 
+static inline void kissat_push_ternary_watch (kissat *solver,
+                                              watches *watches,
+                                              unsigned blocking,
+                                              unsigned other,
+                                              reference ref) {
+  assert (solver->watching);
+  const watch head = kissat_blocking_watch (blocking);
+  PUSH_WATCHES (*watches, head);
+  const watch tail = kissat_tail_watch (ref, true);
+  PUSH_WATCHES (*watches, tail);
+  const watch third = kissat_blocking_watch (other);
+  PUSH_WATCHES (*watches, third);
+}
+
+static inline void kissat_push_clause_watches (kissat *solver,
+                                               watches *all_watches,
+                                               unsigned size,
+                                               const unsigned *lits,
+                                               reference ref) {
+  assert (size > 2);
+  const unsigned l0 = lits[0];
+  const unsigned l1 = lits[1];
+  if (size == 3 && GET_OPTION (ternary)) {
+    const unsigned l2 = lits[2];
+    kissat_push_ternary_watch (solver, all_watches + l0, l1, l2, ref);
+    kissat_push_ternary_watch (solver, all_watches + l1, l0, l2, ref);
+  } else {
+    kissat_push_blocking_watch (solver, all_watches + l0, l1, ref);
+    kissat_push_blocking_watch (solver, all_watches + l1, l0, ref);
+  }
+}
+
 static inline void kissat_watch_other (kissat *solver, unsigned lit,
                                        unsigned other) {
   LOGBINARY (lit, other, "watching %s blocking %s in", LOGLIT (lit),
@@ -139,13 +171,6 @@ kissat_disconnect_reference (kissat *solver, unsigned lit, reference ref) {
   REMOVE_WATCHES (*watches, watch);
 }
 
-static inline void kissat_watch_reference (kissat *solver, unsigned a,
-                                           unsigned b, reference ref) {
-  assert (solver->watching);
-  kissat_watch_blocking (solver, a, b, ref);
-  kissat_watch_blocking (solver, b, a, ref);
-}
-
 static inline void kissat_connect_literal (kissat *solver, unsigned lit,
                                            reference ref) {
   assert (!solver->watching);
@@ -189,9 +214,13 @@ static inline void kissat_inlined_connect_clause (kissat *solver,
 }
 
 static inline void kissat_watch_clause (kissat *solver, clause *c) {
+  assert (solver->watching);
   assert (c->searched < c->size);
   const reference ref = kissat_reference_clause (solver, c);
-  kissat_watch_reference (solver, c->lits[0], c->lits[1], ref);
+  LOGREF (ref, "watching %s and %s in", LOGLIT (c->lits[0]),
+          LOGLIT (c->lits[1]));
+  kissat_push_clause_watches (solver, solver->watches, c->size, c->lits,
+                              ref);
 }
 
 static inline int kissat_export_literal (kissat *solver, unsigned ilit) {
@@ -240,10 +269,10 @@ static inline clause *kissat_binary_conflict (kissat *solver, unsigned a,
   return res;
 }
 
-static inline void kissat_push_analyzed (kissat *solver, assigned *assigned,
+static inline void kissat_push_analyzed (kissat *solver, analysis *analysis,
                                          unsigned idx) {
   assert (idx < VARS);
-  struct assigned *a = assigned + idx;
+  struct analysis *a = analysis + idx;
   assert (!a->analyzed);
   a->analyzed = true;
   PUSH_STACK (solver->analyzed, idx);
@@ -255,19 +284,19 @@ static inline bool kissat_analyzed (kissat *solver) {
 }
 
 static inline void
-kissat_push_removable (kissat *solver, assigned *assigned, unsigned idx) {
+kissat_push_removable (kissat *solver, analysis *analysis, unsigned idx) {
   assert (idx < VARS);
-  struct assigned *a = assigned + idx;
+  struct analysis *a = analysis + idx;
   assert (!a->removable);
   a->removable = true;
   PUSH_STACK (solver->removable, idx);
   LOG2 ("%s removable", LOGVAR (idx));
 }
 
-static inline void kissat_push_poisoned (kissat *solver, assigned *assigned,
+static inline void kissat_push_poisoned (kissat *solver, analysis *analysis,
                                          unsigned idx) {
   assert (idx < VARS);
-  struct assigned *a = assigned + idx;
+  struct analysis *a = analysis + idx;
   assert (!a->poisoned);
   a->poisoned = true;
   PUSH_STACK (solver->poisoned, idx);
@@ -275,9 +304,9 @@ static inline void kissat_push_poisoned (kissat *solver, assigned *assigned,
 }
 
 static inline void
-kissat_push_shrinkable (kissat *solver, assigned *assigned, unsigned idx) {
+kissat_push_shrinkable (kissat *solver, analysis *analysis, unsigned idx) {
   assert (idx < VARS);
-  struct assigned *a = assigned + idx;
+  struct analysis *a = analysis + idx;
   assert (!a->shrinkable);
   a->shrinkable = true;
   PUSH_STACK (solver->shrinkable, idx);
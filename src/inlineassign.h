@@ -38,6 +38,7 @@ static inline void kissat_assign (kissat *solver, const bool probing,
     solver->unflushed++;
     if (reason != UNIT_REASON) {
       CHECK_AND_ADD_UNIT (lit);
+      LRAT_CHAIN_REASON (lit, binary, reason);
       ADD_UNIT_TO_PROOF (lit);
       reason = UNIT_REASON;
       binary = false;
@@ -62,13 +63,8 @@ static inline void kissat_assign (kissat *solver, const bool probing,
 
   b.level = level;
   b.trail = trail;
-
-  b.analyzed = false;
   b.binary = binary;
-  b.poisoned = false;
   b.reason = reason;
-  b.removable = false;
-  b.shrinkable = false;
 
 #ifndef FAST_ASSIGN
   assigned *assigned = solver->assigned;
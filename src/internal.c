@@ -1,4 +1,5 @@
 #include "allocate.h"
+#include "assume.h"
 #include "backtrack.h"
 #include "error.h"
 #include "import.h"
@@ -9,7 +10,10 @@
 #include "require.h"
 #include "resize.h"
 #include "resources.h"
+#include "restore.h"
 #include "search.h"
+#include "share.h"
+#include "simd.h"
 
 #include <assert.h>
 #include <inttypes.h>
@@ -82,16 +86,26 @@ void kissat_release (kissat *solver) {
   kissat_release_heap (solver, &solver->schedule);
   kissat_release_vectors (solver);
   kissat_release_phases (solver);
+  kissat_release_sharing (solver);
 
   RELEASE_STACK (solver->export);
   RELEASE_STACK (solver->import);
 
+  RELEASE_STACK (solver->assumptions);
+  RELEASE_STACK (solver->failed);
+  RELEASE_STACK (solver->reactivated);
+
   DEALLOC_VARIABLE_INDEXED (assigned);
+  DEALLOC_VARIABLE_INDEXED (analysis);
   DEALLOC_VARIABLE_INDEXED (flags);
   DEALLOC_VARIABLE_INDEXED (links);
 
   DEALLOC_LITERAL_INDEXED (marks);
-  DEALLOC_LITERAL_INDEXED (values);
+  if (solver->values) {
+    const size_t bytes = 2 * solver->size + VALUES_PADDING;
+    kissat_dealloc (solver, solver->values, bytes, sizeof (value));
+    solver->values = 0;
+  }
   DEALLOC_LITERAL_INDEXED (watches);
 
   RELEASE_STACK (solver->import);
@@ -116,6 +130,8 @@ void kissat_release (kissat *solver) {
 
   RELEASE_ARRAY (solver->trail, solver->size);
 
+  kissat_release_implications (solver);
+
   RELEASE_STACK (solver->analyzed);
   RELEASE_STACK (solver->levels);
   RELEASE_STACK (solver->minimize);
@@ -229,6 +245,16 @@ void kissat_set_conflict_limit (kissat *solver, unsigned limit) {
        limits->conflicts, limit);
 }
 
+void kissat_set_memory_limit (kissat *solver, unsigned megabytes) {
+  kissat_require_initialized (solver);
+  limits *limits = &solver->limits;
+  limited *limited = &solver->limited;
+  limited->memory = true;
+  limits->memory = (uint64_t) megabytes << 20;
+  LOG ("set memory limit to %" PRIu64 " bytes (%u MB)", limits->memory,
+       megabytes);
+}
+
 void kissat_print_statistics (kissat *solver) {
 #ifndef QUIET
   kissat_require_initialized (solver);
@@ -263,9 +289,35 @@ void kissat_print_statistics (kissat *solver) {
   (void) solver;
 }
 
+static void reset_previous_search (kissat *solver) {
+  kissat_reset_failed (solver);
+  if (solver->extended) {
+    LOG ("reset extended solution of previous search");
+    solver->extended = false;
+  }
+  if (!solver->level)
+    return;
+  if (solver->inconsistent)
+    kissat_backtrack_without_updating_phases (solver, 0);
+  else
+    kissat_backtrack_propagate_and_flush_trail (solver);
+}
+
+static void require_incremental (kissat *solver) {
+  if (!solver->solved)
+    return;
+  kissat_require (GET_OPTION (incremental),
+                  "incremental solving requires option 'incremental'");
+#ifndef NPROOFS
+  kissat_require (!solver->proof,
+                  "incremental solving not supported with proofs");
+#endif
+  reset_previous_search (solver);
+}
+
 void kissat_add (kissat *solver, int elit) {
   kissat_require_initialized (solver);
-  kissat_require (!GET (searches), "incremental solving not supported");
+  require_incremental (solver);
 #if !defined(NDEBUG) || !defined(NPROOFS) || defined(LOGGING)
   const int checking = kissat_checking (solver);
   const bool logging = kissat_logging (solver);
@@ -277,6 +329,7 @@ void kissat_add (kissat *solver, int elit) {
     if (checking || logging || proving)
       PUSH_STACK (solver->original, elit);
 #endif
+    kissat_reactivate_literal (solver, elit);
     unsigned ilit = kissat_import_literal (solver, elit);
 
     const mark mark = MARK (ilit);
@@ -323,6 +376,10 @@ void kissat_add (kissat *solver, int elit) {
     assert (esize <= UINT_MAX);
 #endif
     ADD_UNCHECKED_EXTERNAL (esize, elits);
+#ifndef NPROOFS
+    if (proving)
+      kissat_add_original_to_proof (solver, esize, elits);
+#endif
     const size_t isize = SIZE_STACK (solver->clause);
     unsigned *ilits = BEGIN_STACK (solver->clause);
     assert (isize < (unsigned) INT_MAX);
@@ -336,6 +393,14 @@ void kissat_add (kissat *solver, int elit) {
     else {
       kissat_activate_literals (solver, isize, ilits);
 
+#ifndef NPROOFS
+      if (proving && isize && solver->clause_shrink) {
+        LRAT_CHAIN_ORIGINAL (esize, elits);
+        kissat_add_lits_to_proof (solver, isize, ilits);
+        kissat_delete_external_from_proof (solver, esize, elits);
+      }
+#endif
+
       if (!isize) {
         if (solver->clause_shrink)
           LOG ("all original clause literals root level falsified");
@@ -346,6 +411,7 @@ void kissat_add (kissat *solver, int elit) {
           LOG ("thus solver becomes inconsistent");
           solver->inconsistent = true;
           CHECK_AND_ADD_EMPTY ();
+          LRAT_CHAIN_ORIGINAL (esize, elits);
           ADD_EMPTY_TO_PROOF ();
         }
       } else if (isize == 1) {
@@ -439,12 +505,6 @@ void kissat_add (kissat *solver, int elit) {
         kissat_check_and_add_internal (solver, isize, ilits);
         kissat_remove_checker_external (solver, esize, elits);
       }
-#endif
-#ifndef NPROOFS
-      if (proving) {
-        kissat_add_lits_to_proof (solver, isize, ilits);
-        kissat_delete_external_from_proof (solver, esize, elits);
-      }
 #endif
     }
 #endif
@@ -476,8 +536,44 @@ int kissat_solve (kissat *solver) {
   kissat_require_initialized (solver);
   kissat_require (EMPTY_STACK (solver->clause),
                   "incomplete clause (terminating zero not added)");
-  kissat_require (!GET (searches), "incremental solving not supported");
-  return kissat_search (solver);
+  require_incremental (solver);
+  kissat_restore_clauses (solver);
+#ifndef NPROOFS
+  if (solver->proof)
+    kissat_end_of_original_proof (solver);
+#endif
+  kissat_freeze_assumptions (solver);
+  solver->simd = GET_OPTION (simd) && kissat_simd_supported ();
+  const int res = kissat_search (solver);
+  kissat_reset_assumptions (solver);
+  solver->solved = true;
+  return res;
+}
+
+void kissat_assume (kissat *solver, int elit) {
+  kissat_require_initialized (solver);
+  kissat_require_valid_external_internal (elit);
+  kissat_require (EMPTY_STACK (solver->clause),
+                  "incomplete clause (terminating zero not added)");
+  require_incremental (solver);
+  kissat_reactivate_literal (solver, elit);
+  const unsigned ilit = kissat_import_literal (solver, elit);
+  const unsigned idx = IDX (ilit);
+  if (!FLAGS (idx)->fixed)
+    kissat_activate_literal (solver, ilit);
+  PUSH_STACK (solver->assumptions, elit);
+  LOG ("assuming external literal %d (internal %s)", elit, LOGLIT (ilit));
+}
+
+int kissat_failed (kissat *solver, int elit) {
+  kissat_require_initialized (solver);
+  kissat_require_valid_external_internal (elit);
+  const unsigned eidx = ABS (elit);
+  if (eidx >= SIZE_STACK (solver->import))
+    return 0;
+  const import *const import = &PEEK_STACK (solver->import, eidx);
+  const unsigned bit = 1u << (elit < 0);
+  return (import->failed & bit) != 0;
 }
 
 void kissat_terminate (kissat *solver) {
@@ -493,6 +589,32 @@ void kissat_set_terminate (kissat *solver, void *state,
   solver->termination.terminate = terminate;
 }
 
+void kissat_set_learn (kissat *solver, void *state, unsigned max_size,
+                       unsigned max_glue,
+                       void (*learn) (void *, unsigned, int *)) {
+  kissat_require_initialized (solver);
+  sharing *sharing = &solver->sharing;
+  sharing->learn.state = state;
+  sharing->learn.max_size = max_size;
+  sharing->learn.max_glue = max_glue;
+  sharing->learn.learn = learn;
+  LOG ("%s learn callback with maximum size %u and glue %u",
+       learn ? "set" : "reset", max_size, max_glue);
+}
+
+void kissat_set_import (kissat *solver, void *state,
+                        int *(*import) (void *, unsigned *)) {
+  kissat_require_initialized (solver);
+#ifndef NPROOFS
+  kissat_require (!solver->proof || !import,
+                  "can not import clauses while writing a proof");
+#endif
+  sharing *sharing = &solver->sharing;
+  sharing->import.state = state;
+  sharing->import.import = import;
+  LOG ("%s import callback", import ? "set" : "reset");
+}
+
 int kissat_value (kissat *solver, int elit) {
   kissat_require_initialized (solver);
   kissat_require_valid_external_internal (elit);
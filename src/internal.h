@@ -6,6 +6,7 @@
 #include "assign.h"
 #include "averages.h"
 #include "check.h"
+#include "checkpoint.h"
 #include "classify.h"
 #include "clause.h"
 #include "cover.h"
@@ -14,9 +15,11 @@
 #include "format.h"
 #include "frames.h"
 #include "heap.h"
+#include "implications.h"
 #include "kimits.h"
 #include "kissat.h"
 #include "literal.h"
+#include "lrat.h"
 #include "mode.h"
 #include "options.h"
 #include "phases.h"
@@ -26,6 +29,7 @@
 #include "random.h"
 #include "reluctant.h"
 #include "rephase.h"
+#include "share.h"
 #include "smooth.h"
 #include "stack.h"
 #include "statistics.h"
@@ -47,6 +51,7 @@ struct import {
   bool extension;
   bool imported;
   bool eliminated;
+  unsigned char failed;
 };
 
 typedef struct termination termination;
@@ -88,6 +93,8 @@ struct kissat {
 #ifndef QUIET
   bool sectioned;
 #endif
+  bool simd;
+  bool solved;
   bool stable;
 #if !defined(NDEBUG) || defined(METRICS)
   bool transitive_reducing;
@@ -99,6 +106,7 @@ struct kissat {
   bool large_clauses_watched_after_binary_clauses;
 
   termination termination;
+  sharing sharing;
 
   unsigned vars;
   unsigned size;
@@ -108,10 +116,14 @@ struct kissat {
   ints export;
   ints units;
   imports import;
+  ints assumptions;
+  ints failed;
+  unsigneds reactivated;
   extensions extend;
   unsigneds witness;
 
   assigned *assigned;
+  analysis *analysis;
   flags *flags;
 
   mark *marks;
@@ -174,6 +186,7 @@ struct kissat {
   reference first_reducible;
   reference last_irredundant;
   watches *watches;
+  implications implications;
 
   reference last_learned[4];
 
@@ -194,8 +207,10 @@ struct kissat {
   unsigned walked;
 
   mode mode;
+  checkpoint checkpoint;
 
   uint64_t ticks;
+  uint64_t allocated;
 
   format format;
   char *prefix;
@@ -239,6 +254,7 @@ struct kissat {
 
 #ifndef NPROOFS
   proof *proof;
+  lrat *lrat;
 #endif
 
   statistics statistics;
@@ -23,6 +23,7 @@ struct bounds {
 struct limits {
   uint64_t conflicts;
   uint64_t decisions;
+  uint64_t memory;
   uint64_t reports;
 
   struct {
@@ -56,6 +57,7 @@ struct limits {
 struct limited {
   bool conflicts;
   bool decisions;
+  bool memory;
 };
 
 struct enabled {
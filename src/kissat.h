@@ -1,15 +1,22 @@
 #ifndef _kissat_h_INCLUDED
 #define _kissat_h_INCLUDED
 
+#include <stddef.h>
+
 typedef struct kissat kissat;
 
-// Default (partial) IPASIR interface.
+// Default IPASIR interface.  Adding clauses and solving again after the
+// first call to 'kissat_solve' requires the 'incremental' option to be set
+// before that first call.  Assumptions only hold for the next call and
+// values of the previous model are invalidated by adding new literals.
 
 const char *kissat_signature (void);
 kissat *kissat_init (void);
 void kissat_add (kissat *solver, int lit);
+void kissat_assume (kissat *solver, int lit);
 int kissat_solve (kissat *solver);
 int kissat_value (kissat *solver, int lit);
+int kissat_failed (kissat *solver, int lit);
 void kissat_release (kissat *solver);
 
 void kissat_set_terminate (kissat *solver, void *state,
@@ -38,7 +45,35 @@ int kissat_set_configuration (kissat *solver, const char *name);
 
 void kissat_set_conflict_limit (kissat *solver, unsigned);
 void kissat_set_decision_limit (kissat *solver, unsigned);
+void kissat_set_memory_limit (kissat *solver, unsigned megabytes);
 
 void kissat_print_statistics (kissat *solver);
 
+// Custom memory allocation shared by all solvers in the process.  Beside
+// the pointer the functions receive the size of the freed or reallocated
+// memory block, which allows pool allocators and precise accounting.  The
+// functions have to be set before the first solver is initialized, either
+// all of them or none (to restore the default of the C library) and have
+// to be thread-safe if solvers run in parallel or use threads internally.
+
+void kissat_set_allocator (
+    void *state, void *(*allocate) (void *state, size_t bytes),
+    void *(*reallocate) (void *state, void *ptr, size_t old_bytes,
+                         size_t new_bytes),
+    void (*deallocate) (void *state, void *ptr, size_t bytes));
+
+// Learned clause sharing.  The 'learn' callback receives zero terminated
+// learned clauses (in external literals) with at most 'max_size' literals
+// and glue at most 'max_glue'.  At restarts the 'import' callback is asked
+// for clauses until it returns a zero pointer.  Returned clauses are zero
+// terminated, have to be implied by the formula and are skipped if they
+// contain eliminated or substituted variables.
+
+void kissat_set_learn (kissat *solver, void *state, unsigned max_size,
+                       unsigned max_glue,
+                       void (*learn) (void *state, unsigned glue,
+                                      int *clause));
+void kissat_set_import (kissat *solver, void *state,
+                        int *(*import) (void *state, unsigned *glue));
+
 #endif
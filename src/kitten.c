@@ -116,7 +116,17 @@ static inline void *kitten_calloc (size_t n, size_t size) {
 #include "internal.h"  // Also use 'kissat' statistics if embedded.
 #include "terminate.h" // For macros defining termination macro.
 
-#define KITTEN_TICKS (solver->statistics.kitten_ticks)
+// Embedded sub-solvers count into the statistics of 'kissat' unless they
+// are detached, in which case they use their own statistics (but still
+// allocate through 'kissat').
+
+#undef INC
+#undef ADD
+
+#define INC(NAME) kissat_inc_##NAME (kitten->statistics)
+#define ADD(NAME, DELTA) kissat_add_##NAME (kitten->statistics, (DELTA))
+
+#define KITTEN_TICKS (kitten->statistics->kitten_ticks)
 
 /*------------------------------------------------------------------------*/
 #endif // STAND_ALONE_KITTEN
@@ -207,6 +217,8 @@ struct kitten {
 #ifndef STAND_ALONE_KITTEN
   struct kissat *kissat;
 #define solver (kitten->kissat)
+  bool detached;
+  struct statistics *statistics;
 #endif
 
   // First zero initialized field in 'clear_kitten' is 'status'.
@@ -352,7 +364,7 @@ static inline unsigned reference_klause (kitten *kitten, const klause *c) {
 #ifdef STAND_ALONE_KITTEN
 #define logging (kitten->logging)
 #else
-#define logging GET_OPTION (log)
+#define logging (solver && GET_OPTION (log))
 #endif
 
 static void log_basic (kitten *, const char *, ...)
@@ -669,6 +681,27 @@ kitten *kitten_embedded (struct kissat *kissat) {
   kitten = &dummy;
   CALLOC (kitten, 1);
   kitten->kissat = kissat;
+  kitten->detached = false;
+  kitten->statistics = &kissat->statistics;
+  initialize_kitten (kitten);
+  return kitten;
+}
+
+kitten *kitten_detached (struct kissat *kissat,
+                         struct statistics *statistics) {
+  if (!kissat)
+    INVALID_API_USAGE ("'kissat' argument zero");
+  if (!statistics)
+    INVALID_API_USAGE ("'statistics' argument zero");
+
+  kitten *kitten;
+  struct kitten dummy;
+  dummy.kissat = kissat;
+  kitten = &dummy;
+  CALLOC (kitten, 1);
+  kitten->kissat = kissat;
+  kitten->detached = true;
+  kitten->statistics = statistics;
   initialize_kitten (kitten);
   return kitten;
 }
@@ -1494,7 +1527,8 @@ static int decide (kitten *kitten) {
   }
 
 #ifndef STAND_ALONE_KITTEN
-  if (TERMINATED (kitten_terminated_1))
+  if (kitten->detached ? (bool) solver->termination.flagged
+                       : TERMINATED (kitten_terminated_1))
     return -1;
 #endif
 
@@ -49,6 +49,14 @@ void kitten_traverse_core_clauses (kitten *, void *state,
                                                      bool learned, size_t,
                                                      const unsigned *));
 struct kissat;
+struct statistics;
 kitten *kitten_embedded (struct kissat *);
 
+// Detached sub-solvers do not count into the statistics of 'kissat' and
+// thus can be used in other threads.  They only read its termination flag,
+// allocate through it (which is thread-safe) and count into the given
+// statistics instead.
+
+kitten *kitten_detached (struct kissat *, struct statistics *);
+
 #endif
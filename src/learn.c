@@ -2,6 +2,7 @@
 #include "backtrack.h"
 #include "inline.h"
 #include "reluctant.h"
+#include "share.h"
 
 #include <inttypes.h>
 
@@ -202,6 +203,7 @@ void kissat_learn_clause (kissat *solver) {
     learn_binary (solver, not_uip);
   else
     ref = learn_reference (solver, not_uip, glue);
+  kissat_export_shared (solver, glue);
   if (GET_OPTION (eagersubsume)) {
     eagerly_subsume_last_learned (solver);
     if (ref != INVALID_REF)
@@ -0,0 +1,639 @@
+#ifndef NPROOFS
+
+#include "lrat.h"
+#include "allocate.h"
+#include "import.h"
+#include "inline.h"
+#include "print.h"
+#include "proof.h"
+
+#include <string.h>
+
+// Derived clauses have to be numbered after all original clauses, whose
+// number is only known after parsing.  Clauses derived while parsing thus
+// get provisional identifiers (with the highest bit set) and their proof
+// lines are buffered in 'pending' until the end of the original clauses.
+// Provisional identifiers stay in clause headers and the unit and binary
+// tables and are only translated while writing proof lines.
+
+#define PROVISIONAL ((uint64_t) 1 << 63)
+
+// Chains of failed literal units are saved before backtracking.  They end
+// with the unit learned just before, which is only added afterwards.
+
+#define PREVIOUS UINT64_MAX
+
+typedef struct lrat_binary lrat_binary;
+
+struct lrat_binary {
+  unsigned lits[2];
+  uint64_t id;
+};
+
+typedef STACK (uint64_t) lrat_ids;
+
+struct lrat {
+  kissat *solver;
+  struct proof *proof;
+  bool original;
+  uint64_t id;
+  uint64_t last;
+  uint64_t originals;
+  uint64_t provisional;
+  size_t size_units;
+  uint64_t *units;
+  size_t size_binaries;
+  size_t count_binaries;
+  lrat_binary *binaries;
+  unsigned size_marks;
+  bool *marks;
+  unsigneds marked;
+  unsigneds work;
+  lrat_ids chain;
+  lrat_ids saved;
+  size_t restored;
+  lrat_ids pending;
+};
+
+#undef LOGPREFIX
+#define LOGPREFIX "LRAT"
+
+// Tracing the remaining inprocessing techniques requires their own chains
+// and thus they are disabled.  This leaves conflict analysis (including
+// minimization, shrinking, on-the-fly strengthening and failed literals),
+// root-level propagation, garbage collection and vivification.
+
+static void disable_unsupported_options (kissat *solver) {
+#ifndef NOPTIONS
+  static const char *unsupported[] = {
+      "backbone", "congruence", "eliminate",  "factor",     "fastel",
+      "sweep",    "substitute", "transitive", "jumpreasons"};
+  const size_t size = sizeof unsupported / sizeof *unsupported;
+  for (size_t i = 0; i != size; i++) {
+    const char *name = unsupported[i];
+    if (kissat_options_set (&solver->options, name, 0))
+      kissat_verbose (solver, "disabled '%s' for LRAT proof", name);
+  }
+#else
+  (void) solver;
+#endif
+}
+
+lrat *kissat_new_lrat (kissat *solver, struct proof *proof) {
+  lrat *lrat = kissat_calloc (solver, 1, sizeof *lrat);
+  lrat->solver = solver;
+  lrat->proof = proof;
+  lrat->original = true;
+  disable_unsupported_options (solver);
+  LOG ("starting to trace LRAT clause identifiers and chains");
+  return lrat;
+}
+
+void kissat_release_lrat (lrat *lrat) {
+  kissat *solver = lrat->solver;
+  kissat_dealloc (solver, lrat->units, lrat->size_units,
+                  sizeof *lrat->units);
+  kissat_dealloc (solver, lrat->binaries, lrat->size_binaries,
+                  sizeof *lrat->binaries);
+  kissat_dealloc (solver, lrat->marks, lrat->size_marks, 1);
+  RELEASE_STACK (lrat->marked);
+  RELEASE_STACK (lrat->work);
+  RELEASE_STACK (lrat->chain);
+  RELEASE_STACK (lrat->saved);
+  RELEASE_STACK (lrat->pending);
+  kissat_free (solver, lrat, sizeof *lrat);
+}
+
+uint64_t kissat_lrat_last (lrat *lrat) { return lrat->last; }
+
+/*------------------------------------------------------------------------*/
+
+static unsigned external_to_unsigned (int elit) {
+  assert (elit);
+  assert (elit != INT_MIN);
+  return 2u * ABS (elit) + (elit < 0);
+}
+
+static void enlarge_units (lrat *lrat, unsigned ulit) {
+  kissat *solver = lrat->solver;
+  const size_t old_size = lrat->size_units;
+  size_t new_size = old_size ? 2 * old_size : 64;
+  while (new_size <= ulit)
+    new_size *= 2;
+  LOG ("enlarging units from %zu to %zu", old_size, new_size);
+  lrat->units = kissat_nrealloc (solver, lrat->units, old_size, new_size,
+                                 sizeof *lrat->units);
+  memset (lrat->units + old_size, 0,
+          (new_size - old_size) * sizeof *lrat->units);
+  lrat->size_units = new_size;
+}
+
+static void add_unit (lrat *lrat, int elit, uint64_t id) {
+  const unsigned ulit = external_to_unsigned (elit);
+  if (ulit >= lrat->size_units)
+    enlarge_units (lrat, ulit);
+  lrat->units[ulit] = id;
+}
+
+static uint64_t find_unit (lrat *lrat, int elit) {
+  const unsigned ulit = external_to_unsigned (elit);
+  assert (ulit < lrat->size_units);
+  const uint64_t res = lrat->units[ulit];
+  assert (res);
+  return res;
+}
+
+/*------------------------------------------------------------------------*/
+
+// Binary clauses are kept in a linear probing hash table from their sorted
+// pair of literals to their identifier.  Duplicated binary clauses each
+// get their own entry.  Deleting a binary clause without identifier removes
+// one of the matching entries.
+
+static size_t hash_binary (unsigned a, unsigned b, size_t size) {
+  assert (size);
+  assert (!(size & (size - 1)));
+  uint64_t hash = a * (uint64_t) 1111111121u + b * (uint64_t) 2654435761u;
+  hash ^= hash >> 29;
+  return hash & (size - 1);
+}
+
+static void sort_binary (int ea, int eb, unsigned *a, unsigned *b) {
+  unsigned ua = external_to_unsigned (ea);
+  unsigned ub = external_to_unsigned (eb);
+  if (ua > ub)
+    SWAP (unsigned, ua, ub);
+  *a = ua;
+  *b = ub;
+}
+
+static void insert_binary (lrat *lrat, unsigned a, unsigned b,
+                           uint64_t id) {
+  const size_t size = lrat->size_binaries;
+  lrat_binary *binaries = lrat->binaries;
+  size_t pos = hash_binary (a, b, size);
+  while (binaries[pos].id)
+    pos = (pos + 1) & (size - 1);
+  binaries[pos].lits[0] = a;
+  binaries[pos].lits[1] = b;
+  binaries[pos].id = id;
+  lrat->count_binaries++;
+}
+
+static void enlarge_binaries (lrat *lrat) {
+  kissat *solver = lrat->solver;
+  const size_t old_size = lrat->size_binaries;
+  lrat_binary *old_binaries = lrat->binaries;
+  const size_t new_size = old_size ? 2 * old_size : 1024;
+  LOG ("enlarging binary table from %zu to %zu", old_size, new_size);
+  lrat->binaries = kissat_calloc (solver, new_size, sizeof *lrat->binaries);
+  lrat->size_binaries = new_size;
+  lrat->count_binaries = 0;
+  for (size_t i = 0; i != old_size; i++) {
+    const lrat_binary *binary = old_binaries + i;
+    if (binary->id)
+      insert_binary (lrat, binary->lits[0], binary->lits[1], binary->id);
+  }
+  kissat_dealloc (solver, old_binaries, old_size, sizeof *old_binaries);
+}
+
+static void add_binary (lrat *lrat, int ea, int eb, uint64_t id) {
+  if (2 * (lrat->count_binaries + 1) > lrat->size_binaries)
+    enlarge_binaries (lrat);
+  unsigned a, b;
+  sort_binary (ea, eb, &a, &b);
+  insert_binary (lrat, a, b, id);
+}
+
+static size_t find_binary_position (lrat *lrat, int ea, int eb,
+                                    uint64_t id) {
+  const size_t size = lrat->size_binaries;
+  if (!size)
+    return size;
+  unsigned a, b;
+  sort_binary (ea, eb, &a, &b);
+  const lrat_binary *binaries = lrat->binaries;
+  size_t pos = hash_binary (a, b, size);
+  for (;;) {
+    const lrat_binary *binary = binaries + pos;
+    if (!binary->id)
+      return size;
+    if (binary->lits[0] == a && binary->lits[1] == b &&
+        (!id || binary->id == id))
+      return pos;
+    pos = (pos + 1) & (size - 1);
+  }
+}
+
+static uint64_t find_binary (lrat *lrat, int ea, int eb) {
+  const size_t pos = find_binary_position (lrat, ea, eb, 0);
+  assert (pos != lrat->size_binaries);
+  return lrat->binaries[pos].id;
+}
+
+static uint64_t remove_binary (lrat *lrat, int ea, int eb, uint64_t id) {
+  const size_t size = lrat->size_binaries;
+  size_t pos = find_binary_position (lrat, ea, eb, id);
+  if (pos == size)
+    return 0;
+  lrat_binary *binaries = lrat->binaries;
+  const uint64_t res = binaries[pos].id;
+  assert (lrat->count_binaries);
+  lrat->count_binaries--;
+  for (size_t next = (pos + 1) & (size - 1); binaries[next].id;
+       next = (next + 1) & (size - 1)) {
+    const lrat_binary *binary = binaries + next;
+    const size_t home = hash_binary (binary->lits[0], binary->lits[1], size);
+    if (((next - home) & (size - 1)) < ((next - pos) & (size - 1)))
+      continue;
+    binaries[pos] = *binary;
+    pos = next;
+  }
+  binaries[pos].id = 0;
+  return res;
+}
+
+/*------------------------------------------------------------------------*/
+
+static uint64_t translate (lrat *lrat, uint64_t id) {
+  assert (!lrat->original);
+  if (id & PROVISIONAL)
+    id = lrat->originals + (id & ~PROVISIONAL);
+  return id;
+}
+
+static void write_addition (lrat *lrat, uint64_t id, size_t size,
+                            const int *elits, size_t size_chain,
+                            uint64_t *chain) {
+  id = translate (lrat, id);
+  for (size_t i = 0; i != size_chain; i++)
+    chain[i] = translate (lrat, chain[i]);
+  kissat_write_lrat_addition (lrat->proof, id, size, elits, size_chain,
+                              chain);
+}
+
+static void write_deletion (lrat *lrat, uint64_t id) {
+  kissat_write_lrat_deletion (lrat->proof, translate (lrat, lrat->last),
+                              translate (lrat, id));
+}
+
+static void push_pending_addition (lrat *lrat, uint64_t id, size_t size,
+                                   const int *elits) {
+  kissat *solver = lrat->solver;
+  PUSH_STACK (lrat->pending, 'a');
+  PUSH_STACK (lrat->pending, id);
+  PUSH_STACK (lrat->pending, size);
+  for (size_t i = 0; i != size; i++)
+    PUSH_STACK (lrat->pending, (unsigned) elits[i]);
+  PUSH_STACK (lrat->pending, SIZE_STACK (lrat->chain));
+  for (all_stack (uint64_t, hint, lrat->chain))
+    PUSH_STACK (lrat->pending, hint);
+}
+
+static void push_pending_deletion (lrat *lrat, uint64_t id) {
+  kissat *solver = lrat->solver;
+  PUSH_STACK (lrat->pending, 'd');
+  PUSH_STACK (lrat->pending, lrat->last);
+  PUSH_STACK (lrat->pending, id);
+}
+
+static void flush_pending (lrat *lrat) {
+  kissat *solver = lrat->solver;
+  ints elits;
+  INIT_STACK (elits);
+  uint64_t *p = BEGIN_STACK (lrat->pending);
+  const uint64_t *const end = END_STACK (lrat->pending);
+  while (p != end) {
+    const uint64_t type = *p++;
+    const uint64_t id = *p++;
+    if (type == 'a') {
+      const size_t size = *p++;
+      CLEAR_STACK (elits);
+      for (size_t i = 0; i != size; i++)
+        PUSH_STACK (elits, (int) (unsigned) *p++);
+      const size_t size_chain = *p++;
+      write_addition (lrat, id, size, BEGIN_STACK (elits), size_chain, p);
+      p += size_chain;
+    } else {
+      assert (type == 'd');
+      const uint64_t deleted = *p++;
+      kissat_write_lrat_deletion (lrat->proof, translate (lrat, id),
+                                  translate (lrat, deleted));
+    }
+  }
+  RELEASE_STACK (elits);
+  RELEASE_STACK (lrat->pending);
+}
+
+/*------------------------------------------------------------------------*/
+
+static void record_clause (lrat *lrat, uint64_t id, size_t size,
+                           const int *elits) {
+  if (size == 1)
+    add_unit (lrat, elits[0], id);
+  else if (size == 2)
+    add_binary (lrat, elits[0], elits[1], id);
+  lrat->last = id;
+}
+
+void kissat_lrat_original (lrat *lrat, size_t size, const int *elits) {
+  assert (lrat->original);
+  const uint64_t id = ++lrat->originals;
+  record_clause (lrat, id, size, elits);
+}
+
+void kissat_lrat_end_of_original (lrat *lrat) {
+  if (!lrat->original)
+    return;
+  lrat->original = false;
+  lrat->id = lrat->originals + lrat->provisional;
+  flush_pending (lrat);
+}
+
+void kissat_lrat_add (lrat *lrat, size_t size, const int *elits) {
+  assert (!EMPTY_STACK (lrat->chain));
+  uint64_t id;
+  if (lrat->original) {
+    id = PROVISIONAL | ++lrat->provisional;
+    push_pending_addition (lrat, id, size, elits);
+  } else {
+    id = ++lrat->id;
+    write_addition (lrat, id, size, elits, SIZE_STACK (lrat->chain),
+                    BEGIN_STACK (lrat->chain));
+  }
+  record_clause (lrat, id, size, elits);
+  CLEAR_STACK (lrat->chain);
+}
+
+// Units are never deleted.  Deleted binary clauses are looked up if their
+// identifier is not given and otherwise a missing identifier refers to the
+// current original clause.
+
+void kissat_lrat_delete (lrat *lrat, uint64_t id, size_t size,
+                         const int *elits) {
+  if (size < 2)
+    return;
+  if (size == 2)
+    id = remove_binary (lrat, elits[0], elits[1], id);
+  else if (!id) {
+    assert (lrat->original);
+    id = lrat->originals;
+  }
+  assert (id);
+  if (lrat->original)
+    push_pending_deletion (lrat, id);
+  else
+    write_deletion (lrat, id);
+}
+
+/*------------------------------------------------------------------------*/
+
+static void init_marks (kissat *solver, lrat *lrat) {
+  assert (EMPTY_STACK (lrat->chain));
+  assert (EMPTY_STACK (lrat->marked));
+  const unsigned vars = VARS;
+  if (vars <= lrat->size_marks)
+    return;
+  kissat_dealloc (solver, lrat->marks, lrat->size_marks, 1);
+  lrat->marks = kissat_calloc (solver, vars, 1);
+  lrat->size_marks = vars;
+}
+
+static void mark_literal (kissat *solver, unsigned lit) {
+  lrat *lrat = solver->lrat;
+  const unsigned idx = IDX (lit);
+  assert (idx < lrat->size_marks);
+  assert (!lrat->marks[idx]);
+  lrat->marks[idx] = true;
+  PUSH_STACK (lrat->marked, idx);
+}
+
+static void mark_lemma (kissat *solver, size_t size,
+                        const unsigned *lemma) {
+  for (size_t i = 0; i != size; i++)
+    mark_literal (solver, lemma[i]);
+}
+
+static void unmark_literals (lrat *lrat) {
+  bool *marks = lrat->marks;
+  for (all_stack (unsigned, idx, lrat->marked))
+    marks[idx] = false;
+  CLEAR_STACK (lrat->marked);
+}
+
+static bool marked_literal (kissat *solver, unsigned lit) {
+  return solver->lrat->marks[IDX (lit)];
+}
+
+static void push_unit (kissat *solver, lrat *lrat, unsigned lit) {
+  assert (kissat_fixed (solver, lit) > 0);
+  const int elit = kissat_export_literal (solver, lit);
+  PUSH_STACK (lrat->chain, find_unit (lrat, elit));
+}
+
+static uint64_t binary_id (kissat *solver, lrat *lrat, unsigned a,
+                           unsigned b) {
+  const int ea = kissat_export_literal (solver, a);
+  const int eb = kissat_export_literal (solver, b);
+  return find_binary (lrat, ea, eb);
+}
+
+static uint64_t clause_id (kissat *solver, lrat *lrat, clause *c) {
+  if (c->size == 2)
+    return binary_id (solver, lrat, c->lits[0], c->lits[1]);
+  return c->id;
+}
+
+static uint64_t reason_id (kissat *solver, lrat *lrat, unsigned lit) {
+  const assigned *const a = ASSIGNED (lit);
+  if (a->binary)
+    return binary_id (solver, lrat, lit, a->reason);
+  clause *reason = kissat_dereference_clause (solver, a->reason);
+  return reason->id;
+}
+
+static void push_antecedents (kissat *solver, lrat *lrat, unsigned lit) {
+  const assigned *const a = ASSIGNED (lit);
+  assert (a->level);
+  assert (a->reason != DECISION_REASON);
+  assert (a->reason != UNIT_REASON);
+  unsigneds *work = &lrat->work;
+  PUSH_STACK (*work, lit);
+  PUSH_STACK (*work, INVALID_LIT);
+  if (a->binary)
+    PUSH_STACK (*work, NOT (a->reason));
+  else {
+    clause *reason = kissat_dereference_clause (solver, a->reason);
+    for (all_literals_in_clause (other, reason))
+      if (other != lit)
+        PUSH_STACK (*work, NOT (other));
+  }
+}
+
+// Adds the reasons of the literals on the work stack and recursively of
+// the literals in those reasons in topological order to the chain.  The
+// traversal stops at marked variables (the literals of the lemma) and
+// root-level literals, which contribute their unit clause.
+
+static void derive_literals (kissat *solver, lrat *lrat) {
+  unsigneds *work = &lrat->work;
+  while (!EMPTY_STACK (*work)) {
+    unsigned lit = POP_STACK (*work);
+    if (lit == INVALID_LIT) {
+      lit = POP_STACK (*work);
+      PUSH_STACK (lrat->chain, reason_id (solver, lrat, lit));
+      continue;
+    }
+    assert (VALUE (lit) > 0);
+    if (marked_literal (solver, lit))
+      continue;
+    mark_literal (solver, lit);
+    if (LEVEL (lit))
+      push_antecedents (solver, lrat, lit);
+    else
+      push_unit (solver, lrat, lit);
+  }
+}
+
+static void derive_conflict (kissat *solver, lrat *lrat, clause *conflict) {
+  for (all_literals_in_clause (lit, conflict))
+    PUSH_STACK (lrat->work, NOT (lit));
+  derive_literals (solver, lrat);
+  PUSH_STACK (lrat->chain, clause_id (solver, lrat, conflict));
+}
+
+static void derive_implied (kissat *solver, lrat *lrat, unsigned lit) {
+  push_antecedents (solver, lrat, lit);
+  derive_literals (solver, lrat);
+}
+
+void kissat_lrat_chain_conflict (kissat *solver, clause *conflict,
+                                 size_t size, const unsigned *lemma) {
+  lrat *lrat = solver->lrat;
+  init_marks (solver, lrat);
+  mark_lemma (solver, size, lemma);
+  derive_conflict (solver, lrat, conflict);
+  unmark_literals (lrat);
+}
+
+void kissat_lrat_chain_implied (kissat *solver, unsigned implied,
+                                size_t size, const unsigned *lemma) {
+  lrat *lrat = solver->lrat;
+  assert (VALUE (implied) > 0);
+  init_marks (solver, lrat);
+  mark_lemma (solver, size, lemma);
+  derive_implied (solver, lrat, implied);
+  unmark_literals (lrat);
+}
+
+// The units learned from a failed literal are the negations of the unique
+// implication points on the first decision level starting with the one
+// closest to the conflict and ending with the negated decision.  Each
+// implication point (and the decision) implies the previous one, which in
+// turn is refuted by the unit learned before.
+
+void kissat_lrat_chain_failed (kissat *solver, clause *conflict,
+                               size_t size, const unsigned *units) {
+  lrat *lrat = solver->lrat;
+  assert (EMPTY_STACK (lrat->saved));
+  for (size_t i = 0; i != size; i++) {
+    init_marks (solver, lrat);
+    mark_literal (solver, units[i]);
+    if (i) {
+      derive_implied (solver, lrat, NOT (units[i - 1]));
+      PUSH_STACK (lrat->chain, PREVIOUS);
+    } else
+      derive_conflict (solver, lrat, conflict);
+    unmark_literals (lrat);
+    for (all_stack (uint64_t, id, lrat->chain))
+      PUSH_STACK (lrat->saved, id);
+    PUSH_STACK (lrat->saved, 0);
+    CLEAR_STACK (lrat->chain);
+  }
+  lrat->restored = 0;
+}
+
+void kissat_lrat_restore_chain (kissat *solver) {
+  lrat *lrat = solver->lrat;
+  assert (EMPTY_STACK (lrat->chain));
+  assert (lrat->restored < SIZE_STACK (lrat->saved));
+  const uint64_t *p = BEGIN_STACK (lrat->saved) + lrat->restored;
+  for (uint64_t id; (id = *p++);)
+    PUSH_STACK (lrat->chain, id == PREVIOUS ? lrat->last : id);
+  lrat->restored = p - BEGIN_STACK (lrat->saved);
+  if (lrat->restored == SIZE_STACK (lrat->saved))
+    CLEAR_STACK (lrat->saved);
+}
+
+void kissat_lrat_chain_original (kissat *solver, size_t size,
+                                 const int *elits) {
+  lrat *lrat = solver->lrat;
+  init_marks (solver, lrat);
+  for (size_t i = 0; i != size; i++) {
+    const unsigned ilit = kissat_import_literal (solver, elits[i]);
+    if (kissat_fixed (solver, ilit) >= 0)
+      continue;
+    if (marked_literal (solver, ilit))
+      continue;
+    mark_literal (solver, ilit);
+    push_unit (solver, lrat, NOT (ilit));
+  }
+  unmark_literals (lrat);
+  PUSH_STACK (lrat->chain, lrat->originals);
+}
+
+void kissat_lrat_chain_reason (kissat *solver, unsigned lit, bool binary,
+                               unsigned reason) {
+  lrat *lrat = solver->lrat;
+  assert (EMPTY_STACK (lrat->chain));
+  if (binary) {
+    push_unit (solver, lrat, NOT (reason));
+    PUSH_STACK (lrat->chain, binary_id (solver, lrat, lit, reason));
+  } else {
+    clause *c = kissat_dereference_clause (solver, reason);
+    for (all_literals_in_clause (other, c))
+      if (other != lit)
+        push_unit (solver, lrat, NOT (other));
+    PUSH_STACK (lrat->chain, c->id);
+  }
+}
+
+void kissat_lrat_chain_shrunken (kissat *solver, uint64_t id, size_t size,
+                                 const unsigned *lits) {
+  lrat *lrat = solver->lrat;
+  assert (EMPTY_STACK (lrat->chain));
+  for (size_t i = 0; i != size; i++) {
+    const unsigned lit = lits[i];
+    if (kissat_fixed (solver, lit) < 0)
+      push_unit (solver, lrat, NOT (lit));
+  }
+  PUSH_STACK (lrat->chain, id);
+}
+
+// The clause 'c' without 'remove' and without root-level falsified
+// literals (except 'keep') is derived from the conflict, where 'c' is
+// either the reason of 'remove' or 'remove' is the last decision.
+
+void kissat_lrat_chain_strengthened (kissat *solver, clause *conflict,
+                                     clause *c, unsigned remove,
+                                     unsigned keep) {
+  lrat *lrat = solver->lrat;
+  assert (VALUE (remove) > 0);
+  init_marks (solver, lrat);
+  for (all_literals_in_clause (lit, c))
+    if (lit != remove && (lit == keep || kissat_fixed (solver, lit) >= 0))
+      mark_literal (solver, lit);
+  for (all_literals_in_clause (lit, c))
+    if (lit != remove && !marked_literal (solver, lit)) {
+      mark_literal (solver, lit);
+      push_unit (solver, lrat, NOT (lit));
+    }
+  PUSH_STACK (lrat->chain, c->id);
+  mark_literal (solver, remove);
+  derive_conflict (solver, lrat, conflict);
+  unmark_literals (lrat);
+}
+
+#else
+int kissat_lrat_dummy_to_avoid_warning;
+#endif
@@ -0,0 +1,165 @@
+#ifndef _lrat_h_INCLUDED
+#define _lrat_h_INCLUDED
+
+#ifndef NPROOFS
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+typedef struct lrat lrat;
+
+struct clause;
+struct kissat;
+struct proof;
+
+// The LRAT tracer assigns identifiers to proof clauses and writes their
+// antecedent chains ('hints') through 'kissat_write_lrat_addition'.  Large
+// clauses carry their identifier in the clause header, identifiers of
+// binary and unit clauses are looked up by their (external) literals.
+//
+// Before a derived clause is added to the proof its chain has to be
+// recorded by one of the 'kissat_lrat_chain_...' functions below, which
+// traverse the reasons of the current trail starting at the conflict.
+
+lrat *kissat_new_lrat (struct kissat *, struct proof *);
+void kissat_release_lrat (lrat *);
+
+void kissat_lrat_original (lrat *, size_t, const int *);
+void kissat_lrat_end_of_original (lrat *);
+
+void kissat_lrat_add (lrat *, size_t, const int *);
+void kissat_lrat_delete (lrat *, uint64_t id, size_t, const int *);
+
+uint64_t kissat_lrat_last (lrat *);
+
+void kissat_lrat_chain_conflict (struct kissat *, struct clause *conflict,
+                                 size_t, const unsigned *lemma);
+void kissat_lrat_chain_implied (struct kissat *, unsigned implied, size_t,
+                                const unsigned *lemma);
+void kissat_lrat_chain_failed (struct kissat *, struct clause *conflict,
+                               size_t, const unsigned *units);
+void kissat_lrat_chain_original (struct kissat *, size_t, const int *);
+void kissat_lrat_chain_reason (struct kissat *, unsigned lit, bool binary,
+                               unsigned reason);
+void kissat_lrat_chain_shrunken (struct kissat *, uint64_t id, size_t,
+                                 const unsigned *);
+void kissat_lrat_chain_strengthened (struct kissat *,
+                                     struct clause *conflict,
+                                     struct clause *c, unsigned remove,
+                                     unsigned keep);
+void kissat_lrat_restore_chain (struct kissat *);
+
+#define LRAT_IDENTIFY(C) \
+  do { \
+    if (solver->lrat) \
+      (C)->id = kissat_lrat_last (solver->lrat); \
+  } while (0)
+
+#define LRAT_CHAIN_CONFLICT(CONFLICT, S) \
+  do { \
+    if (solver->lrat) \
+      kissat_lrat_chain_conflict (solver, (CONFLICT), SIZE_STACK (S), \
+                                  BEGIN_STACK (S)); \
+  } while (0)
+
+#define LRAT_CHAIN_EMPTY(CONFLICT) \
+  do { \
+    if (solver->lrat) \
+      kissat_lrat_chain_conflict (solver, (CONFLICT), 0, 0); \
+  } while (0)
+
+#define LRAT_CHAIN_IMPLIED(IMPLIED, S) \
+  do { \
+    if (solver->lrat) \
+      kissat_lrat_chain_implied (solver, (IMPLIED), SIZE_STACK (S), \
+                                 BEGIN_STACK (S)); \
+  } while (0)
+
+#define LRAT_CHAIN_FAILED(CONFLICT, S) \
+  do { \
+    if (solver->lrat) \
+      kissat_lrat_chain_failed (solver, (CONFLICT), SIZE_STACK (S), \
+                                BEGIN_STACK (S)); \
+  } while (0)
+
+#define LRAT_CHAIN_ORIGINAL(SIZE, ELITS) \
+  do { \
+    if (solver->lrat) \
+      kissat_lrat_chain_original (solver, (SIZE), (ELITS)); \
+  } while (0)
+
+#define LRAT_CHAIN_REASON(LIT, BINARY, REASON) \
+  do { \
+    if (solver->lrat) \
+      kissat_lrat_chain_reason (solver, (LIT), (BINARY), (REASON)); \
+  } while (0)
+
+#define LRAT_CHAIN_SHRUNKEN(ID, S) \
+  do { \
+    if (solver->lrat) \
+      kissat_lrat_chain_shrunken (solver, (ID), SIZE_STACK (S), \
+                                  BEGIN_STACK (S)); \
+  } while (0)
+
+#define LRAT_CHAIN_SIMPLIFIED(C) \
+  do { \
+    if (solver->lrat) \
+      kissat_lrat_chain_shrunken (solver, (C)->id, (C)->size, (C)->lits); \
+  } while (0)
+
+#define LRAT_CHAIN_STRENGTHENED(CONFLICT, C, REMOVE, KEEP) \
+  do { \
+    if (solver->lrat) \
+      kissat_lrat_chain_strengthened (solver, (CONFLICT), (C), (REMOVE), \
+                                      (KEEP)); \
+  } while (0)
+
+#define LRAT_RESTORE_CHAIN() \
+  do { \
+    if (solver->lrat) \
+      kissat_lrat_restore_chain (solver); \
+  } while (0)
+
+#else
+
+#define LRAT_IDENTIFY(...) \
+  do { \
+  } while (0)
+
+#define LRAT_CHAIN_CONFLICT(CONFLICT, ...) \
+  do { \
+    (void) (CONFLICT); \
+  } while (0)
+#define LRAT_CHAIN_EMPTY(...) \
+  do { \
+  } while (0)
+#define LRAT_CHAIN_IMPLIED(...) \
+  do { \
+  } while (0)
+#define LRAT_CHAIN_FAILED(...) \
+  do { \
+  } while (0)
+#define LRAT_CHAIN_ORIGINAL(...) \
+  do { \
+  } while (0)
+#define LRAT_CHAIN_REASON(...) \
+  do { \
+  } while (0)
+#define LRAT_CHAIN_SHRUNKEN(...) \
+  do { \
+  } while (0)
+#define LRAT_CHAIN_SIMPLIFIED(...) \
+  do { \
+  } while (0)
+#define LRAT_CHAIN_STRENGTHENED(CONFLICT, ...) \
+  do { \
+    (void) (CONFLICT); \
+  } while (0)
+#define LRAT_RESTORE_CHAIN(...) \
+  do { \
+  } while (0)
+
+#endif
+
+#endif
@@ -312,6 +312,9 @@ int kissat_lucky (struct kissat *solver) {
   if (!GET_OPTION (lucky))
     return 0;
 
+  if (!EMPTY_STACK (solver->assumptions))
+    return 0;
+
   START (lucky);
   assert (!solver->level);
   assert (!solver->probing);
@@ -6,9 +6,6 @@ static inline int minimized_index (kissat *solver, bool minimizing,
                                    unsigned depth) {
 #if !defined(LOGGING) && defined(NDEBUG)
   (void) lit;
-#endif
-#ifdef NDEBUG
-  (void) idx;
 #endif
   assert (IDX (lit) == idx);
   assert (solver->assigned + idx == a);
@@ -16,7 +13,8 @@ static inline int minimized_index (kissat *solver, bool minimizing,
     LOG2 ("skipping root level literal %s", LOGLIT (lit));
     return 1;
   }
-  if (a->removable && depth) {
+  const struct analysis *m = solver->analysis + idx;
+  if (m->removable && depth) {
     LOG2 ("skipping removable literal %s", LOGLIT (lit));
     return 1;
   }
@@ -25,7 +23,7 @@ static inline int minimized_index (kissat *solver, bool minimizing,
     LOG2 ("can not remove decision literal %s", LOGLIT (lit));
     return -1;
   }
-  if (a->poisoned) {
+  if (m->poisoned) {
     LOG2 ("can not remove poisoned literal %s", LOGLIT (lit));
     return -1;
   }
@@ -82,12 +80,13 @@ static inline bool minimize_binary (kissat *solver, bool minimizing,
   unsigned *begin = BEGIN_STACK (solver->minimize) + saved;
   const unsigned *const end = END_STACK (solver->minimize);
   assert (begin <= end);
+  analysis *analysis = solver->analysis;
   if (res)
     for (const unsigned *p = begin; p != end; p++)
-      kissat_push_removable (solver, assigned, *p);
+      kissat_push_removable (solver, analysis, *p);
   else
     for (const unsigned *p = begin; p != end; p++)
-      kissat_push_poisoned (solver, assigned, *p);
+      kissat_push_poisoned (solver, analysis, *p);
   SET_END_OF_STACK (solver->minimize, begin);
   return res;
 }
@@ -126,10 +125,11 @@ static bool minimize_literal (kissat *solver, bool minimizing,
   }
   if (!depth)
     return res;
+  analysis *analysis = solver->analysis;
   if (!res)
-    kissat_push_poisoned (solver, assigned, idx);
-  else if (!a->removable)
-    kissat_push_removable (solver, assigned, idx);
+    kissat_push_poisoned (solver, analysis, idx);
+  else if (!analysis[idx].removable)
+    kissat_push_removable (solver, analysis, idx);
   return res;
 }
 
@@ -142,10 +142,10 @@ bool kissat_minimize_literal (kissat *solver, unsigned lit,
 
 void kissat_reset_poisoned (kissat *solver) {
   LOG ("reset %zu poisoned variables", SIZE_STACK (solver->poisoned));
-  assigned *assigned = solver->assigned;
+  analysis *analysis = solver->analysis;
   for (all_stack (unsigned, idx, solver->poisoned)) {
     assert (idx < VARS);
-    struct assigned *a = assigned + idx;
+    struct analysis *a = analysis + idx;
     assert (a->poisoned);
     a->poisoned = false;
   }
@@ -169,8 +169,9 @@ void kissat_minimize_clause (kissat *solver) {
   const unsigned not_uip = lits[0];
   assert (assigned[IDX (not_uip)].level == solver->level);
 #endif
+  analysis *analysis = solver->analysis;
   for (const unsigned *p = lits; p != end; p++)
-    kissat_push_removable (solver, assigned, IDX (*p));
+    kissat_push_removable (solver, analysis, IDX (*p));
 
   if (GET_OPTION (shrink) > 2) {
     STOP (minimize);
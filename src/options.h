@@ -6,6 +6,9 @@
 
 // clang-format off
 
+#define THREADS_OPTION(N, V, D) \
+  OPTION (N, V, 0, 64, D " threads (0=online cores)")
+
 #define OPTIONS \
   OPTION (ands, 1, 0, 1, "extract and eliminate and gates") \
   OPTION (backbone, 1, 0, 2, "binary clause backbone (2=eager)") \
@@ -18,16 +21,19 @@
   OPTION (bumpreasonslimit, 10, 1, INT_MAX, "relative reason literals limit") \
   OPTION (bumpreasonsrate, 10, 1, INT_MAX, "decision rate limit") \
   DBGOPT (check, 2, 0, 2, "check model (1) and derived clauses (2)") \
+  OPTION (checkpointint, 600, 1, INT_MAX, "checkpoint interval in seconds") \
   OPTION (chrono, 1, 0, 1, "allow chronological backtracking") \
   OPTION (chronolevels, 100, 0, INT_MAX, "maximum jumped over levels") \
   OPTION (compact, 1, 0, 1, "enable compacting garbage collection") \
   OPTION (compactlim, 10, 0, 100, "compact inactive limit (in percent)") \
+  OPTION (compactorder, 0, 0, 1, "renumber variables for locality in compaction") \
   OPTION (congruence, 1, 0, 1, "congruence closure on extracted gates") \
   OPTION (congruenceandarity, 1000000, 2, 50000000, "AND gate arity limit") \
   OPTION (congruenceands, 1, 0, 1, "extract AND gates for congruence closure") \
   OPTION (congruencebinaries, 1, 0, 1, "extract certain binary clauses") \
   OPTION (congruenceites, 1, 0, 1, "extract ITE gates for congruence closure") \
   OPTION (congruenceonce, 0, 0, 1, "congruence closure only initially") \
+  THREADS_OPTION (congruencethreads, 1, "gate extraction") \
   OPTION (congruencexorarity, 4, 2, 20, "congruence XOR gate arity limit") \
   OPTION (congruencexorcounts, 2, 1, INT_MAX, "XOR counting rounds") \
   OPTION (congruencexors, 1, 0, 1, "extract XOR gates for congruence closure") \
@@ -46,6 +52,7 @@
   OPTION (eliminateint, 500, 10, INT_MAX, "base elimination interval") \
   OPTION (eliminateocclim, 2e3, 0, INT_MAX, "elimination occurrence limit") \
   OPTION (eliminaterounds, 2, 1, 1e4, "elimination rounds limit") \
+  THREADS_OPTION (eliminatethreads, 1, "elimination") \
   OPTION (emafast, 33, 10, 1e6, "fast exponential moving average window") \
   OPTION (emaslow, 1e5, 100, 1e6, "slow exponential moving average window") \
   EMBOPT (embedded, 1, 0, 1, "parse and apply embedded options") \
@@ -69,22 +76,30 @@
   OPTION (forcephase, 0, 0, 1, "force initial phase") \
   OPTION (forward, 1, 0, 1, "forward subsumption in BVE") \
   OPTION (forwardeffort, 100, 0, 1e6, "effort in per mille") \
+  OPTION (hugepages, 0, 0, 1, "transparent huge pages for arena and watches") \
   OPTION (ifthenelse, 1, 0, 1, "extract and eliminate if-then-else gates") \
+  OPTION (implications, 1, 0, 1, "dense implication graph in probing") \
   OPTION (incremental, 0, 0, 1, "enable incremental solving") \
   OPTION (jumpreasons, 1, 0, 1, "jump binary reasons") \
   LOGOPT (log, 0, 0, 5, "logging level (1=on,2=more,3=check,4/5=mem)") \
+  OPTION (lrat, 0, 0, 1, "write LRAT instead of DRAT proofs") \
   OPTION (lucky, 1, 0, 1, "try some lucky assignments") \
   OPTION (luckyearly, 1, 0, 1, "lucky assignments before preprocessing") \
   OPTION (luckylate, 1, 0, 1, "lucky assignments after preprocessing") \
+  OPTION (memorypressure, 75, 1, 100, "memory limit percent for pressure") \
   OPTION (mineffort, 10, 0, INT_MAX, "minimum absolute effort in millions") \
   OPTION (minimize, 1, 0, 1, "learned clause minimization") \
   OPTION (minimizedepth, 1e3, 1, 1e6, "minimization depth") \
   OPTION (minimizeticks, 1, 0, 1, "count ticks in minimize and shrink") \
   OPTION (modeinit, 1e3, 10, 1e8, "initial focused conflicts limit") \
   OPTION (modeint, 1e3, 10, 1e8, "focused conflicts interval") \
+  OPTION (numa, 0, 0, 1, "bind arena and watches to local NUMA node") \
   OPTION (otfs, 1, 0, 1, "on-the-fly strengthening") \
+  OPTION (parsechunk, 24, 0, 30, "log2 bytes per parser thread chunk") \
+  THREADS_OPTION (parsethreads, 0, "parser") \
   OPTION (phase, 1, 0, 1, "initial decision phase") \
   OPTION (phasesaving, 1, 0, 1, "enable phase saving") \
+  OPTION (prefetch, 4, 0, 64, "prefetched large watches ahead") \
   OPTION (preprocess, 1, 0, 1, "initial preprocessing") \
   OPTION (preprocessbackbone, 1, 0, 1, "backbone preprocessing") \
   OPTION (preprocesscongruence, 1, 0, 1, "congruence preprocessing") \
@@ -98,6 +113,7 @@
   OPTION (proberounds, 2, 1, INT_MAX, "probing rounds") \
   NQTOPT (profile, 2, 0, 4, "profile level") \
   OPTION (promote, 1, 0, 1, "promote clauses") \
+  OPTION (proofthread, 0, 0, 1, "write proof in separate thread") \
   NQTOPT (quiet, 0, 0, 1, "disable all messages") \
   OPTION (randec, 1, 0, 1, "random decisions") \
   OPTION (randecfocused, 1, 0, 1, "random decisions in focused mode") \
@@ -125,7 +141,9 @@
   OPTION (restartmargin, 10, 0, 25, "fast/slow margin in percent") \
   OPTION (restartreusetrail, 1, 0, 1, "restarts tries to reuse trail") \
   OPTION (seed, 0, 0, INT_MAX, "random seed") \
+  OPTION (shareglue, 2, 0, 1e5, "glue limit of shared clauses (0=binary)") \
   OPTION (shrink, 3, 0, 3, "learned clauses (1=bin,2=lrg,3=rec)") \
+  OPTION (simd, 1, 0, 1, "vectorized literal search and break values") \
   OPTION (simplify, 1, 0, 1, "enable probing and elimination") \
   OPTION (smallclauses, 1e5, 0, INT_MAX, "small clauses limit") \
   OPTION (stable, STABLE_DEFAULT, 0, 2, "enable stable search mode") \
@@ -145,8 +163,10 @@
   OPTION (sweepmaxdepth, 3, 1, INT_MAX, "maximum environment depth") \
   OPTION (sweepmaxvars, 8192, 2, INT_MAX, "maximum environment variables") \
   OPTION (sweeprand, 0, 0, 1, "randomize sweeping environment") \
+  THREADS_OPTION (sweepthreads, 1, "sweeping") \
   OPTION (sweepvars, 256, 0, INT_MAX, "environment variables") \
   OPTION (target, TARGET_DEFAULT, 0, 2, "target phases (1=stable,2=focused)") \
+  OPTION (ternary, 1, 0, 1, "inline literals of ternary clause watches") \
   OPTION (tier1, 2, 1, 100, "learned clause tier one glue limit") \
   OPTION (tier1relative, 500, 0, 1000, "relative tier one glue limit") \
   OPTION (tier2, 6, 1, 1e3, "learned clause tier two glue limit") \
@@ -166,6 +186,7 @@
   OPTION (vivifytier3, 1, 0, 100, "relative tier3 effort") \
   OPTION (walkeffort, 50, 0, 1e6, "effort in per mille") \
   OPTION (walkinitially, 0, 0, 1, "initial local search") \
+  THREADS_OPTION (walkthreads, 1, "local search") \
   OPTION (warmup, 1, 0, 1, "initialize phases by unit propagation")
 
 // clang-format on
@@ -0,0 +1,91 @@
+#ifdef __linux__
+#define _DEFAULT_SOURCE // for 'madvise' and 'syscall'
+#endif
+
+#include "pages.h"
+#include "internal.h"
+#include "logging.h"
+
+#ifdef __linux__
+
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Advising smaller blocks does not pay off as huge pages are 2 MB large.
+
+#define MIN_ADVISED_BYTES ((size_t) 1 << 21)
+
+// Avoid depending on 'libnuma' and its header for two constants.
+
+#define KISSAT_MPOL_PREFERRED 1
+#define KISSAT_MPOL_MF_MOVE (1 << 1)
+
+#define MAX_NUMA_NODES 1024
+
+static bool advise_huge_pages (char *begin, size_t bytes) {
+#ifdef MADV_HUGEPAGE
+  return !madvise (begin, bytes, MADV_HUGEPAGE);
+#else
+  (void) begin;
+  (void) bytes;
+  return false;
+#endif
+}
+
+static bool bind_to_local_node (char *begin, size_t bytes) {
+#if defined(SYS_getcpu) && defined(SYS_mbind)
+  unsigned cpu, node;
+  if (syscall (SYS_getcpu, &cpu, &node, 0))
+    return false;
+  if (node >= MAX_NUMA_NODES)
+    return false;
+  const size_t bits = 8 * sizeof (unsigned long);
+  unsigned long mask[MAX_NUMA_NODES / (8 * sizeof (unsigned long))];
+  memset (mask, 0, sizeof mask);
+  mask[node / bits] = 1ul << (node % bits);
+  return !syscall (SYS_mbind, begin, bytes, KISSAT_MPOL_PREFERRED, mask,
+                   (unsigned long) MAX_NUMA_NODES, KISSAT_MPOL_MF_MOVE);
+#else
+  (void) begin;
+  (void) bytes;
+  return false;
+#endif
+}
+
+void kissat_advise_pages (kissat *solver, void *ptr, size_t bytes) {
+  const bool huge = GET_OPTION (hugepages);
+  const bool numa = GET_OPTION (numa);
+  if (!huge && !numa)
+    return;
+  if (bytes < MIN_ADVISED_BYTES)
+    return;
+  const uintptr_t page = sysconf (_SC_PAGESIZE);
+  const uintptr_t mask = ~(page - 1);
+  const uintptr_t begin = ((uintptr_t) ptr + page - 1) & mask;
+  const uintptr_t end = ((uintptr_t) ptr + bytes) & mask;
+  if (end <= begin)
+    return;
+  char *const aligned = (char *) begin;
+  const size_t advised = end - begin;
+  if (huge && advise_huge_pages (aligned, advised)) {
+    LOG ("advised huge pages for %zu bytes at %p", advised, ptr);
+    INC (pages_advised);
+  }
+  if (numa && bind_to_local_node (aligned, advised)) {
+    LOG ("bound %zu bytes at %p to local NUMA node", advised, ptr);
+    INC (pages_bound);
+  }
+}
+
+#else
+
+void kissat_advise_pages (kissat *solver, void *ptr, size_t bytes) {
+  (void) solver;
+  (void) ptr;
+  (void) bytes;
+}
+
+#endif
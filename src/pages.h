@@ -0,0 +1,16 @@
+#ifndef _pages_h_INCLUDED
+#define _pages_h_INCLUDED
+
+#include <stddef.h>
+
+struct kissat;
+
+// The clause arena and the watch vectors are large memory blocks which
+// are accessed randomly during propagation.  After (re)allocating them
+// this function advises the kernel to back them by transparent huge pages
+// ('--hugepages') and binds them to the NUMA node the solver is currently
+// running on ('--numa').  Both are hints and failures are ignored.
+
+void kissat_advise_pages (struct kissat *, void *, size_t bytes);
+
+#endif
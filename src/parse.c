@@ -4,9 +4,16 @@
 #include "print.h"
 #include "profile.h"
 #include "resize.h"
+#include "threads.h"
 
 #include <ctype.h>
 #include <inttypes.h>
+#include <string.h>
+
+#ifdef KISSAT_HAS_MMAP
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 #define size_buffer (1u << 20)
 
@@ -66,9 +73,377 @@ faster_is_digit (int ch)
 
 #define ISDIGIT(CH) faster_is_digit (CH)
 
+// The body of the file after the header is parsed by 'parse_body' below,
+// both sequentially from the read buffer of the file and concurrently from
+// chunks of memory mapped files.  Parsed literals are added to the solver
+// if 'add' is set and saved on the 'literals' stack if it is non-zero.
+// Instead of the number of clauses in the header 'limit' is used, which
+// for chunks is only set if a chunk has to be parsed again to produce the
+// 'too many clauses' error message at the right position.
+
+struct body
+{
+  kissat *solver;
+  read_buffer *buffer;
+  file *file;
+  const unsigned char *begin, *end;
+  strictness strict;
+  int variables;
+  uint64_t limit;
+  uint64_t parsed;
+  uint64_t lines;
+  int lit;
+  bool add;
+  bool located;
+  ints *literals;
+};
+
+typedef struct body body;
+
+static void
+init_body (body * body, kissat * solver, strictness strict, int variables,
+	   uint64_t limit, bool add, ints * literals)
+{
+  body->solver = solver;
+  body->buffer = 0;
+  body->file = 0;
+  body->begin = body->end = 0;
+  body->strict = strict;
+  body->variables = variables;
+  body->limit = limit;
+  body->parsed = body->lines = 0;
+  body->lit = 0;
+  body->add = add;
+  body->located = false;
+  body->literals = literals;
+}
+
+// Refills the read buffer (if there is one) if the end is reached.
+
+static inline int
+next_body (body * body, const unsigned char **p_ptr,
+	   const unsigned char **end_ptr, uint64_t * lines_ptr)
+{
+  const unsigned char *p = *p_ptr;
+  if (p == *end_ptr)
+    {
+      read_buffer *const buffer = body->buffer;
+      if (!buffer || !fill_buffer (buffer, body->file))
+	return EOF;
+      p = buffer->chars;
+      *end_ptr = p + buffer->end;
+    }
+  int ch = *p++;
+  *p_ptr = p;
+  if (ch == '\n')
+    *lines_ptr += 1;
+  return ch;
+}
+
+#define BNEXT() next_body (body, &p, &end, &lines)
+
+#define BODY_RETURN(STR,LOCATED) \
+do { \
+  body->parsed = parsed; \
+  body->lines = lines; \
+  body->lit = lit; \
+  body->located = LOCATED; \
+  return STR; \
+} while (0)
+
+#define BODY_ERROR(STR) BODY_RETURN (STR, false)
+
+#define BODY_NONL(STR) \
+do { \
+  if (ch == '\n') \
+    { \
+      assert (lines > 0); \
+      lines--; \
+    } \
+  BODY_RETURN (STR, true); \
+} while (0)
+
+// As in the header only errors raised through 'BODY_NONL' are located,
+// i.e., the line counted in 'lines' is the line of the error.
+
+static const char *
+parse_body (body * body)
+{
+  kissat *const solver = body->solver;
+  const unsigned char *p = body->begin;
+  const unsigned char *end = body->end;
+  const strictness strict = body->strict;
+  const int variables = body->variables;
+  const uint64_t limit = body->limit;
+  const bool add = body->add;
+  ints *const literals = body->literals;
+  uint64_t parsed = 0, lines = 0;
+  int lit = 0;
+  int ch;
+  for (;;)
+    {
+      ch = BNEXT ();
+      if (ch == ' ')
+	continue;
+      if (ch == '\t')
+	continue;
+      if (ch == '\n')
+	continue;
+      if (ch == '\r')
+	{
+	  ch = BNEXT ();
+	  if (ch != '\n')
+	    BODY_ERROR ("expected new-line after carriage-return");
+	  continue;
+	}
+      if (ch == 'c')
+	{
+	  while ((ch = BNEXT ()) != '\n')
+	    if (ch == EOF)
+	      {
+		if (strict != PEDANTIC_PARSING)
+		  break;
+		BODY_ERROR ("unexpected end-of-file in comment after header");
+	      }
+	  if (ch == EOF)
+	    break;
+	  continue;
+	}
+      if (ch == EOF)
+	break;
+      int sign;
+      if (ch == '-')
+	{
+	  ch = BNEXT ();
+	  if (ch == EOF)
+	    BODY_ERROR ("unexpected end-of-file after '-'");
+	  if (ch == '\n')
+	    BODY_NONL ("unexpected new-line after '-'");
+	  if (!ISDIGIT (ch))
+	    BODY_ERROR ("expected digit after '-'");
+	  if (ch == '0')
+	    BODY_ERROR ("expected non-zero digit after '-'");
+	  sign = -1;
+	}
+      else if (!ISDIGIT (ch))
+	BODY_ERROR ("expected digit or '-'");
+      else
+	sign = 1;
+      assert (ISDIGIT (ch));
+      int idx = ch - '0';
+      while (ISDIGIT (ch = BNEXT ()))
+	{
+	  if (EXTERNAL_MAX_VAR / 10 < idx)
+	    BODY_ERROR ("variable index too large");
+	  idx *= 10;
+	  const int digit = ch - '0';
+	  if (EXTERNAL_MAX_VAR - digit < idx)
+	    BODY_ERROR ("variable index too large");
+	  idx += digit;
+	}
+      if (ch == EOF)
+	{
+	  if (strict == PEDANTIC_PARSING)
+	    {
+	      if (idx)
+		BODY_ERROR ("unexpected end-of-file after literal");
+	      else
+		BODY_ERROR ("unexpected end-of-file after trailing zero");
+	    }
+	}
+      else if (ch == '\r')
+	{
+	  ch = BNEXT ();
+	  if (ch != '\n')
+	    BODY_ERROR ("expected new-line after carriage-return");
+	}
+      else if (ch == 'c')
+	{
+	  while ((ch = BNEXT ()) != '\n')
+	    if (ch == EOF)
+	      {
+		if (strict != PEDANTIC_PARSING)
+		  break;
+		BODY_ERROR ("unexpected end-of-file in comment after literal");
+	      }
+	}
+      else if (ch != ' ' && ch != '\t' && ch != '\n')
+	BODY_ERROR ("expected white space after literal");
+      if (strict != RELAXED_PARSING && idx > variables)
+	BODY_NONL ("maximum variable index exceeded " TRY_RELAXED_PARSING);
+      if (idx)
+	{
+	  assert (sign == 1 || sign == -1);
+	  assert (idx != INT_MIN);
+	  lit = sign * idx;
+	}
+      else
+	{
+	  if (strict != RELAXED_PARSING && parsed == limit)
+	    BODY_ERROR ("too many clauses " TRY_RELAXED_PARSING);
+	  parsed++;
+	  lit = 0;
+	}
+      if (add)
+	kissat_add (solver, lit);
+      if (literals)
+	PUSH_STACK (*literals, lit);
+    }
+  BODY_RETURN (0, false);
+}
+
+static const char *
+check_end_of_body (strictness strict, int lit, uint64_t parsed,
+		   uint64_t clauses)
+{
+  if (lit)
+    return "trailing zero missing";
+  if (strict != RELAXED_PARSING && parsed < clauses)
+    {
+      if (parsed + 1 == clauses)
+	return "one clause missing " TRY_RELAXED_PARSING;
+      return "more than one clause missing " TRY_RELAXED_PARSING;
+    }
+  return 0;
+}
+
+#ifdef KISSAT_HAS_MMAP
+
+// Large uncompressed regular files are memory mapped after the header
+// and split at line boundaries into chunks, which are tokenized by
+// parser threads in parallel.  Then the main thread adds the literals of
+// the chunks in the original order.  Thus the solver sees exactly the
+// same sequence of literals as with sequential parsing.
+
+struct chunk
+{
+  body body;
+  const char *error;
+  ints literals;
+};
+
+typedef struct chunk chunk;
+
+static void *
+parse_chunk (void *ptr)
+{
+  chunk *chunk = ptr;
+  CLEAR_STACK (chunk->literals);
+  chunk->error = parse_body (&chunk->body);
+  return 0;
+}
+
+// Returns 'false' if the file is not suitable for parallel parsing, i.e.,
+// if it is compressed, not a regular file, not large enough or can not be
+// mapped.  Otherwise the rest of the file after the header is parsed.
+
+static bool
+parse_mapped (kissat * solver, file * file, read_buffer * buffer,
+	      strictness strict, int variables, uint64_t clauses,
+	      uint64_t lineno, uint64_t * lineno_ptr, ints * literals,
+	      const char **error_ptr)
+{
+  if (file->compressed)
+    return false;
+  const unsigned threads = kissat_threads (GET_OPTION (parsethreads));
+  if (threads < 2)
+    return false;
+  const int fd = fileno (file->file);
+  struct stat buf;
+  if (fstat (fd, &buf) || !S_ISREG (buf.st_mode))
+    return false;
+  const size_t size = buf.st_size;
+  if ((off_t) size != buf.st_size)
+    return false;
+  const off_t position = ftello (file->file);
+  const size_t unread = buffer->end - buffer->pos;
+  if (position < 0 || (size_t) position < unread)
+    return false;
+  const size_t offset = position - unread;
+  const size_t chunk_bytes = (size_t) 1 << GET_OPTION (parsechunk);
+  if (size < offset || size - offset <= chunk_bytes)
+    return false;
+  void *map = mmap (0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  if (map == MAP_FAILED)
+    return false;
+  kissat_message (solver,
+		  "parsing memory mapped body of %s with %u threads",
+		  FORMAT_BYTES (size - offset), threads);
+  chunk *chunks = kissat_calloc (solver, threads, sizeof *chunks);
+  const unsigned char *const end = (unsigned char *) map + size;
+  const unsigned char *p = (unsigned char *) map + offset;
+  uint64_t parsed = 0;
+  const char *error = 0;
+  bool located = false;
+  int lit = 0;
+  while (!error && p != end)
+    {
+      unsigned used = 0;
+      while (used != threads && p != end)
+	{
+	  chunk *chunk = chunks + used++;
+	  body *body = &chunk->body;
+	  init_body (body, solver, strict, variables, UINT64_MAX, false,
+		     &chunk->literals);
+	  body->begin = p;
+	  if ((size_t) (end - p) <= chunk_bytes)
+	    p = end;
+	  else
+	    {
+	      const unsigned char *q = p + chunk_bytes - 1;
+	      const unsigned char *nl = memchr (q, '\n', end - q);
+	      p = nl ? nl + 1 : end;
+	    }
+	  body->end = p;
+	}
+      kissat_run_threads (solver, "parser", used, parse_chunk, chunks,
+			  sizeof *chunks);
+      for (unsigned i = 0; !error && i != used; i++)
+	{
+	  chunk *chunk = chunks + i;
+	  body *body = &chunk->body;
+	  assert (strict == RELAXED_PARSING || parsed <= clauses);
+	  if (strict != RELAXED_PARSING && body->parsed > clauses - parsed)
+	    {
+	      body->limit = clauses - parsed;
+	      parse_chunk (chunk);
+	      assert (chunk->error);
+	    }
+	  for (all_stack (int, other, chunk->literals))
+	    {
+	      kissat_add (solver, other);
+	      if (literals)
+		PUSH_STACK (*literals, other);
+	    }
+	  if (!EMPTY_STACK (chunk->literals))
+	    lit = TOP_STACK (chunk->literals);
+	  parsed += body->parsed;
+	  lineno += body->lines;
+	  error = chunk->error;
+	  located = body->located;
+	}
+    }
+  for (unsigned i = 0; i != threads; i++)
+    RELEASE_STACK (chunks[i].literals);
+  kissat_dealloc (solver, chunks, threads, sizeof *chunks);
+  const unsigned char *const read = (unsigned char *) map + position;
+  if (p > read)
+    file->bytes += p - read;
+  munmap (map, size);
+  if (!error)
+    error = check_end_of_body (strict, lit, parsed, clauses);
+  if (!error || located)
+    *lineno_ptr = lineno;
+  *error_ptr = error;
+  return true;
+}
+
+#endif
+
 static const char *
 parse_dimacs (kissat * solver, file * file,
-              strictness strict, uint64_t * lineno_ptr, int * max_var_ptr)
+              strictness strict, uint64_t * lineno_ptr, int * max_var_ptr,
+              ints * literals)
 {
   read_buffer buffer;
   buffer.pos = buffer.end = 0;
@@ -308,136 +683,39 @@ parse_dimacs (kissat * solver, file * file,
 		  "parsed 'p cnf %d %" PRIu64 "' header", variables, clauses);
   *max_var_ptr = variables;
   kissat_reserve (solver, variables);
-  uint64_t parsed = 0;
-  int lit = 0;
-  for (;;)
-    {
-      ch = NEXT ();
-      if (ch == ' ')
-	continue;
-      if (ch == '\t')
-	continue;
-      if (ch == '\n')
-	continue;
-      if (ch == '\r')
-	{
-	  ch = NEXT ();
-	  if (ch != '\n')
-	    return "expected new-line after carriage-return";
-	  continue;
-	}
-      if (ch == 'c')
-	{
-	  while ((ch = NEXT ()) != '\n')
-	    if (ch == EOF)
-	      {
-		if (strict != PEDANTIC_PARSING)
-		  break;
-		return "unexpected end-of-file in comment after header";
-	      }
-	  if (ch == EOF)
-	    break;
-	  continue;
-	}
-      if (ch == EOF)
-	break;
-      int sign;
-      if (ch == '-')
-	{
-	  ch = NEXT ();
-	  if (ch == EOF)
-	    return "unexpected end-of-file after '-'";
-	  if (ch == '\n')
-	    NONL ("unexpected new-line after '-'");
-	  if (!ISDIGIT (ch))
-	    return "expected digit after '-'";
-	  if (ch == '0')
-	    return "expected non-zero digit after '-'";
-	  sign = -1;
-	}
-      else if (!ISDIGIT (ch))
-	return "expected digit or '-'";
-      else
-	sign = 1;
-      assert (ISDIGIT (ch));
-      int idx = ch - '0';
-      while (ISDIGIT (ch = NEXT ()))
-	{
-	  if (EXTERNAL_MAX_VAR / 10 < idx)
-	    return "variable index too large";
-	  idx *= 10;
-	  const int digit = ch - '0';
-	  if (EXTERNAL_MAX_VAR - digit < idx)
-	    return "variable index too large";
-	  idx += digit;
-	}
-      if (ch == EOF)
-	{
-	  if (strict == PEDANTIC_PARSING)
-	    {
-	      if (idx)
-		return "unexpected end-of-file after literal";
-	      else
-		return "unexpected end-of-file after trailing zero";
-	    }
-	}
-      else if (ch == '\r')
-	{
-	  ch = NEXT ();
-	  if (ch != '\n')
-	    return "expected new-line after carriage-return";
-	}
-      else if (ch == 'c')
-	{
-	  while ((ch = NEXT ()) != '\n')
-	    if (ch == EOF)
-	      {
-		if (strict != PEDANTIC_PARSING)
-		  break;
-		return "unexpected end-of-file in comment after literal";
-	      }
-	}
-      else if (ch != ' ' && ch != '\t' && ch != '\n')
-	return "expected white space after literal";
-      if (strict != RELAXED_PARSING && idx > variables)
-	NONL ("maximum variable index exceeded " TRY_RELAXED_PARSING);
-      if (idx)
-	{
-	  assert (sign == 1 || sign == -1);
-	  assert (idx != INT_MIN);
-	  lit = sign * idx;
-	}
-      else
-	{
-	  if (strict != RELAXED_PARSING && parsed == clauses)
-	    return "too many clauses " TRY_RELAXED_PARSING;
-	  parsed++;
-	  lit = 0;
-	}
-      kissat_add (solver, lit);
-    }
-  if (lit)
-    return "trailing zero missing";
-  if (strict != RELAXED_PARSING && parsed < clauses)
-    {
-      if (parsed + 1 == clauses)
-	return "one clause missing " TRY_RELAXED_PARSING;
-      return "more than one clause missing " TRY_RELAXED_PARSING;
-    }
-
-  *lineno_ptr = lineno;
-
-  return 0;
+  const char *error;
+#ifdef KISSAT_HAS_MMAP
+  if (parse_mapped (solver, file, &buffer, strict, variables, clauses,
+		    lineno, lineno_ptr, literals, &error))
+    return error;
+#endif
+  body body;
+  init_body (&body, solver, strict, variables, clauses, true, literals);
+  body.buffer = &buffer;
+  body.file = file;
+  body.begin = buffer.chars + buffer.pos;
+  body.end = buffer.chars + buffer.end;
+  error = parse_body (&body);
+  if (!error)
+    error = check_end_of_body (strict, body.lit, body.parsed, clauses);
+  if (!error || body.located)
+    *lineno_ptr = lineno + body.lines;
+  return error;
 }
 
 const char *
 kissat_parse_dimacs (kissat * solver,
 		     strictness strict,
-		     file * file, uint64_t * lineno_ptr, int *max_var_ptr)
+		     file * file, uint64_t * lineno_ptr, int *max_var_ptr,
+		     ints * literals)
 {
   START (parse);
   const char *res;
-  res = parse_dimacs (solver, file, strict, lineno_ptr, max_var_ptr);
+  res = parse_dimacs (solver, file, strict, lineno_ptr, max_var_ptr,
+		      literals);
+  const char *error = kissat_file_error (file);
+  if (error)
+    res = error;
   if (!solver->inconsistent)
     kissat_defrag_watches (solver);
   STOP (parse);
@@ -2,6 +2,7 @@
 #define _parse_h_INCLUDED
 
 #include "file.h"
+#include "stack.h"
 
 enum strictness {
   RELAXED_PARSING = 0,
@@ -14,6 +15,7 @@ typedef enum strictness strictness;
 struct kissat;
 
 const char *kissat_parse_dimacs (struct kissat *, strictness, file *,
-                                 uint64_t *linenoptr, int *max_var_ptr);
+                                 uint64_t *linenoptr, int *max_var_ptr,
+                                 ints *literals);
 
 #endif
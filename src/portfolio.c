@@ -0,0 +1,198 @@
+#include "portfolio.h"
+#include "allocate.h"
+#include "budget.h"
+#include "error.h"
+#include "internal.h"
+#include "print.h"
+#include "share.h"
+
+#include <pthread.h>
+#include <time.h>
+
+typedef struct worker worker;
+
+struct worker {
+  portfolio *portfolio;
+  kissat *solver;
+  const ints *literals;
+  int max_var;
+  unsigned id;
+};
+
+// Cheap diversification of the additional solvers.  Beside using a
+// different random seed they cycle through the two special configurations
+// and a few options with large impact on the search.
+
+static void diversify (kissat *solver, unsigned id) {
+  kissat_set_option (solver, "seed", id);
+  switch (id % 8) {
+  case 1:
+#ifndef NOPTIONS
+    kissat_set_configuration (solver, "sat");
+#endif
+    break;
+  case 2:
+#ifndef NOPTIONS
+    kissat_set_configuration (solver, "unsat");
+#endif
+    break;
+  case 3:
+    kissat_set_option (solver, "phase", 0);
+    break;
+  case 4:
+    kissat_set_option (solver, "stable", 0);
+    break;
+  case 5:
+    kissat_set_option (solver, "walkinitially", 1);
+    break;
+  case 6:
+    kissat_set_option (solver, "chrono", 0);
+    break;
+  case 7:
+    kissat_set_option (solver, "tumble", 0);
+    break;
+  default:
+    break;
+  }
+}
+
+void kissat_init_portfolio (portfolio *portfolio, kissat *solver,
+                            unsigned size, int conflicts, int decisions,
+                            int memory) {
+  assert (size > 1);
+  unsigned share = 0;
+  if (memory > 0) {
+    share = (unsigned) memory / size;
+    if (!share)
+      share = 1;
+    kissat_message (solver,
+                    "memory limit of %d MB split into %u MB "
+                    "per solver thread",
+                    memory, share);
+  }
+  portfolio->size = size;
+  portfolio->solvers =
+      kissat_calloc (0, size, sizeof *portfolio->solvers);
+  portfolio->sharer = kissat_new_sharer (size, 1u << 12);
+  portfolio->winner = 0;
+  portfolio->running = 0;
+  portfolio->res = 0;
+  for (unsigned id = 0; id != size; id++) {
+    kissat *worker = id ? kissat_init () : solver;
+    if (id) {
+#ifndef NOPTIONS
+      worker->options = solver->options;
+#endif
+      kissat_set_option (worker, "quiet", 1);
+      kissat_set_option (worker, "log", 0);
+      diversify (worker, id);
+      if (conflicts >= 0)
+        kissat_set_conflict_limit (worker, conflicts);
+      if (decisions >= 0)
+        kissat_set_decision_limit (worker, decisions);
+    }
+    if (share)
+      kissat_set_memory_limit (worker, share);
+    kissat_connect_sharer (worker, portfolio->sharer, id);
+    portfolio->solvers[id] = worker;
+  }
+}
+
+static void terminate_others (portfolio *portfolio, kissat *solver) {
+  for (unsigned id = 0; id != portfolio->size; id++) {
+    kissat *other = portfolio->solvers[id];
+    if (other != solver)
+      kissat_terminate (other);
+  }
+}
+
+// All solvers stop on their own if they hit the conflict or decision limit
+// but only the first solver is terminated by the application, e.g., if the
+// time limit is reached, and then terminates the others.  If it stops since
+// it exceeded its share of the memory limit the others continue though.
+
+static void *solve_worker (void *ptr) {
+  worker *worker = ptr;
+  portfolio *portfolio = worker->portfolio;
+  kissat *solver = worker->solver;
+  if (worker->id) {
+    kissat_reserve (solver, worker->max_var);
+    for (all_stack (int, lit, *worker->literals))
+      kissat_add (solver, lit);
+  }
+  const int res = kissat_solve (solver);
+  if (res) {
+    kissat *expected = 0;
+    if (__atomic_compare_exchange_n (&portfolio->winner, &expected,
+                                     solver, false, __ATOMIC_ACQ_REL,
+                                     __ATOMIC_ACQUIRE)) {
+      portfolio->res = res;
+      terminate_others (portfolio, solver);
+    }
+  } else if (!worker->id && !kissat_memory_exceeded (solver))
+    terminate_others (portfolio, solver);
+  __atomic_sub_fetch (&portfolio->running, 1, __ATOMIC_RELEASE);
+  return 0;
+}
+
+// After the first solver ran out of memory, its termination flag still
+// has to be forwarded to the others which are still running.
+
+static void forward_termination (portfolio *portfolio, kissat *solver) {
+  const struct timespec delay = {0, 1000000};
+  while (__atomic_load_n (&portfolio->running, __ATOMIC_ACQUIRE)) {
+    if (solver->termination.flagged) {
+      terminate_others (portfolio, solver);
+      break;
+    }
+    nanosleep (&delay, 0);
+  }
+}
+
+int kissat_solve_portfolio (portfolio *portfolio, int max_var,
+                            const ints *literals) {
+  const unsigned size = portfolio->size;
+  kissat *solver = portfolio->solvers[0];
+  worker *workers;
+  CALLOC (workers, size);
+  pthread_t *threads;
+  CALLOC (threads, size);
+  for (unsigned id = 0; id != size; id++) {
+    worker *worker = workers + id;
+    worker->portfolio = portfolio;
+    worker->solver = portfolio->solvers[id];
+    worker->literals = literals;
+    worker->max_var = max_var;
+    worker->id = id;
+  }
+  portfolio->running = size;
+  for (unsigned id = 1; id != size; id++)
+    if (pthread_create (threads + id, 0, solve_worker, workers + id))
+      kissat_fatal ("failed to create solver thread %u", id);
+  solve_worker (workers);
+  if (!__atomic_load_n (&portfolio->winner, __ATOMIC_ACQUIRE) &&
+      kissat_memory_exceeded (solver))
+    forward_termination (portfolio, solver);
+  for (unsigned id = 1; id != size; id++)
+    if (pthread_join (threads[id], 0))
+      kissat_fatal ("failed to join solver thread %u", id);
+  DEALLOC (threads, size);
+  DEALLOC (workers, size);
+  if (!portfolio->winner)
+    portfolio->winner = solver;
+  return portfolio->res;
+}
+
+void kissat_release_portfolio (portfolio *portfolio) {
+  const unsigned size = portfolio->size;
+  for (unsigned id = 0; id != size; id++) {
+    kissat *solver = portfolio->solvers[id];
+    if (id)
+      kissat_release (solver);
+    else
+      kissat_release_sharing (solver);
+  }
+  kissat_delete_sharer (portfolio->sharer);
+  kissat_dealloc (0, portfolio->solvers, size,
+                  sizeof *portfolio->solvers);
+}
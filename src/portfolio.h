@@ -0,0 +1,33 @@
+#ifndef _portfolio_h_INCLUDED
+#define _portfolio_h_INCLUDED
+
+#include "stack.h"
+
+// A portfolio runs 'size' differently configured solvers on the same
+// formula in parallel, each in its own thread, where the first solver is
+// the one of the application.  Solvers exchange units and learned clauses
+// of small size and glue through a lock-free 'sharer' (see 'share.h').
+// A memory limit (in megabytes) is split evenly between the solvers, as
+// each solver only accounts its own allocations.  A solver exceeding its
+// share stops, while the others continue.
+
+struct kissat;
+struct sharer;
+
+typedef struct portfolio portfolio;
+
+struct portfolio {
+  unsigned size;
+  struct kissat **solvers;
+  struct sharer *sharer;
+  struct kissat *winner;
+  unsigned running;
+  int res;
+};
+
+void kissat_init_portfolio (portfolio *, struct kissat *, unsigned size,
+                            int conflicts, int decisions, int memory);
+int kissat_solve_portfolio (portfolio *, int max_var, const ints *);
+void kissat_release_portfolio (portfolio *);
+
+#endif
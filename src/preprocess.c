@@ -1,4 +1,5 @@
 #include "preprocess.h"
+#include "budget.h"
 #include "collect.h"
 #include "fastel.h"
 #include "internal.h"
@@ -14,6 +15,8 @@
 bool kissat_preprocessing (struct kissat *solver) {
   assert (!solver->level);
   assert (!solver->inconsistent);
+  if (GET (searches))
+    return false;
   if (!GET_OPTION (preprocess))
     return false;
   if (!GET_OPTION (probe))
@@ -61,6 +64,11 @@ int kissat_preprocess (struct kissat *solver) {
       break;
     if (TERMINATED (preprocess_terminated_1))
       break;
+    if (kissat_memory_pressure (solver)) {
+      kissat_extremely_verbose (
+          solver, "preprocessing stopped due to memory pressure");
+      break;
+    }
     const unsigned variables_before = solver->active;
     const uint64_t clauses_before = BINIRR_CLAUSES;
 #ifndef QUIET
@@ -1,6 +1,7 @@
 #include "probe.h"
 #include "backbone.h"
 #include "backtrack.h"
+#include "budget.h"
 #include "congruence.h"
 #include "factor.h"
 #include "internal.h"
@@ -72,7 +73,12 @@ int kissat_probe (kissat *solver) {
   INC (probings);
   assert (!solver->probing);
   solver->probing = true;
-  const unsigned max_rounds = GET_OPTION (proberounds);
+  unsigned max_rounds = GET_OPTION (proberounds);
+  if (kissat_memory_pressure (solver)) {
+    kissat_extremely_verbose (solver,
+                              "probing skipped due to memory pressure");
+    max_rounds = 0;
+  }
   for (unsigned round = 0; round != max_rounds; round++) {
     unsigned before = solver->active;
     probe (solver);
@@ -81,6 +87,7 @@ int kissat_probe (kissat *solver) {
     if (before == solver->active)
       break;
   }
+  kissat_release_implications (solver);
   kissat_classify (solver);
   UPDATE_CONFLICT_LIMIT (probe, probings, NLOGN, true);
   solver->last.ticks.probe = solver->statistics.search_ticks;
@@ -97,6 +104,7 @@ int kissat_probe_initially (kissat *solver) {
   assert (!solver->probing);
   solver->probing = true;
   probe_initially (solver);
+  kissat_release_implications (solver);
   assert (solver->probing);
   solver->probing = false;
   STOP (probe);
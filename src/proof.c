@@ -5,6 +5,8 @@
 #include "file.h"
 #include "inline.h"
 
+#include <pthread.h>
+
 #undef NDEBUG
 
 #ifndef NDEBUG
@@ -12,6 +14,7 @@
 #endif
 
 #define size_buffer (1u << 20)
+#define size_records (1u << 18)
 
 struct write_buffer {
   unsigned char chars[size_buffer];
@@ -20,11 +23,34 @@ struct write_buffer {
 
 typedef struct write_buffer write_buffer;
 
+// With 'proofthread' enabled the search thread only appends proof lines as
+// records '[type, literal, ..., 0]' of external literals to the 'filling'
+// buffer.  Whenever it is full, it is swapped with the 'draining' buffer,
+// which the writer thread encodes and writes (and thus compresses) in the
+// background.  Records might span both buffers.  Synchronization is only
+// needed once per swap of 'size_records' integers.
+
+struct writer {
+  pthread_t thread;
+  pthread_mutex_t lock;
+  pthread_cond_t cond;
+  int *filling;
+  int *draining;
+  size_t filled;
+  size_t drain;
+  bool full;
+  bool stop;
+  bool start;
+};
+
+typedef struct writer writer;
+
 struct proof {
   write_buffer buffer;
   kissat *solver;
   bool binary;
   file *file;
+  writer *writer;
   ints line;
   uint64_t added;
   uint64_t deleted;
@@ -51,6 +77,235 @@ struct proof {
   LOGINTS3 (SIZE_STACK (proof->line), BEGIN_STACK (proof->line), \
             __VA_ARGS__)
 
+static void flush_buffer (proof *proof) {
+  size_t bytes = proof->buffer.pos;
+  if (!bytes)
+    return;
+  size_t written = kissat_write (proof->file, proof->buffer.chars, bytes);
+  if (bytes != written)
+    kissat_fatal ("flushing %zu bytes in proof write-buffer failed", bytes);
+  proof->buffer.pos = 0;
+}
+
+static inline void write_char (proof *proof, unsigned char ch) {
+  write_buffer *buffer = &proof->buffer;
+  if (buffer->pos == size_buffer)
+    flush_buffer (proof);
+  buffer->chars[buffer->pos++] = ch;
+}
+
+static void write_proof_line_start (proof *proof, int type) {
+  if (type == 'a') {
+    if (proof->binary)
+      write_char (proof, 'a');
+  } else {
+    assert (type == 'd');
+    write_char (proof, 'd');
+    if (!proof->binary)
+      write_char (proof, ' ');
+  }
+}
+
+static void write_binary_unsigned (proof *proof, uint64_t x) {
+  assert (proof->binary);
+  unsigned char ch;
+  while (x & ~(uint64_t) 0x7f) {
+    ch = (x & 0x7f) | 0x80;
+    write_char (proof, ch);
+    x >>= 7;
+  }
+  write_char (proof, x);
+}
+
+static void write_binary_proof_literal (proof *proof, int elit) {
+  write_binary_unsigned (proof, 2u * ABS (elit) + (elit < 0));
+}
+
+static void write_non_binary_unsigned (proof *proof, uint64_t x) {
+  assert (!proof->binary);
+  char buffer[24];
+  char *end_of_buffer = buffer + sizeof buffer;
+  char *p = end_of_buffer;
+  do
+    *--p = '0' + (x % 10);
+  while (x /= 10);
+  while (p != end_of_buffer)
+    write_char (proof, *p++);
+  write_char (proof, ' ');
+}
+
+static void write_non_binary_proof_literal (proof *proof, int elit) {
+  assert (elit);
+  assert (elit != INT_MIN);
+  unsigned eidx;
+  if (elit < 0) {
+    write_char (proof, '-');
+    eidx = -elit;
+  } else
+    eidx = elit;
+  write_non_binary_unsigned (proof, eidx);
+}
+
+static void write_proof_literal (proof *proof, int elit) {
+  if (proof->binary)
+    write_binary_proof_literal (proof, elit);
+  else
+    write_non_binary_proof_literal (proof, elit);
+}
+
+static void write_proof_line_end (proof *proof) {
+  if (proof->binary)
+    write_char (proof, 0);
+  else {
+    write_char (proof, '0');
+    write_char (proof, '\n');
+  }
+}
+
+void kissat_write_lrat_addition (proof *proof, uint64_t id, size_t size,
+                                 const int *elits, size_t size_hints,
+                                 const uint64_t *hints) {
+  if (proof->binary) {
+    write_char (proof, 'a');
+    write_binary_unsigned (proof, 2 * id);
+    for (size_t i = 0; i != size; i++)
+      write_binary_proof_literal (proof, elits[i]);
+    write_char (proof, 0);
+    for (size_t i = 0; i != size_hints; i++)
+      write_binary_unsigned (proof, 2 * hints[i]);
+    write_char (proof, 0);
+  } else {
+    write_non_binary_unsigned (proof, id);
+    for (size_t i = 0; i != size; i++)
+      write_non_binary_proof_literal (proof, elits[i]);
+    write_char (proof, '0');
+    write_char (proof, ' ');
+    for (size_t i = 0; i != size_hints; i++)
+      write_non_binary_unsigned (proof, hints[i]);
+    write_char (proof, '0');
+    write_char (proof, '\n');
+  }
+}
+
+void kissat_write_lrat_deletion (proof *proof, uint64_t id,
+                                 uint64_t deleted) {
+  if (proof->binary) {
+    write_char (proof, 'd');
+    write_binary_unsigned (proof, 2 * deleted);
+    write_char (proof, 0);
+  } else {
+    write_non_binary_unsigned (proof, id);
+    write_char (proof, 'd');
+    write_char (proof, ' ');
+    write_non_binary_unsigned (proof, deleted);
+    write_char (proof, '0');
+    write_char (proof, '\n');
+  }
+}
+
+static void write_records (proof *proof, writer *writer) {
+  const int *const end = writer->draining + writer->drain;
+  for (const int *p = writer->draining; p != end; p++) {
+    const int record = *p;
+    if (writer->start) {
+      write_proof_line_start (proof, record);
+      writer->start = false;
+    } else if (record)
+      write_proof_literal (proof, record);
+    else {
+      write_proof_line_end (proof);
+      writer->start = true;
+    }
+  }
+}
+
+static void *write_proof_in_background (void *ptr) {
+  proof *proof = ptr;
+  writer *writer = proof->writer;
+  for (;;) {
+    pthread_mutex_lock (&writer->lock);
+    while (!writer->full && !writer->stop)
+      pthread_cond_wait (&writer->cond, &writer->lock);
+    const bool full = writer->full;
+    pthread_mutex_unlock (&writer->lock);
+    if (!full)
+      break;
+    write_records (proof, writer);
+    pthread_mutex_lock (&writer->lock);
+    writer->full = false;
+    pthread_cond_broadcast (&writer->cond);
+    pthread_mutex_unlock (&writer->lock);
+  }
+  flush_buffer (proof);
+  return 0;
+}
+
+static void start_writer (kissat *solver, proof *proof) {
+  writer *writer = kissat_calloc (solver, 1, sizeof *writer);
+  writer->filling = kissat_nalloc (solver, size_records, sizeof (int));
+  writer->draining = kissat_nalloc (solver, size_records, sizeof (int));
+  writer->start = true;
+  pthread_mutex_init (&writer->lock, 0);
+  pthread_cond_init (&writer->cond, 0);
+  proof->writer = writer;
+  if (pthread_create (&writer->thread, 0, write_proof_in_background, proof))
+    kissat_fatal ("failed to create proof writer thread");
+  LOG ("started proof writer thread");
+}
+
+static void hand_over_records (writer *writer) {
+  pthread_mutex_lock (&writer->lock);
+  while (writer->full)
+    pthread_cond_wait (&writer->cond, &writer->lock);
+  int *tmp = writer->draining;
+  writer->draining = writer->filling;
+  writer->filling = tmp;
+  writer->drain = writer->filled;
+  writer->full = true;
+  pthread_cond_broadcast (&writer->cond);
+  pthread_mutex_unlock (&writer->lock);
+  writer->filled = 0;
+}
+
+#ifndef QUIET
+
+static void wait_for_writer (writer *writer) {
+  if (writer->filled)
+    hand_over_records (writer);
+  pthread_mutex_lock (&writer->lock);
+  while (writer->full)
+    pthread_cond_wait (&writer->cond, &writer->lock);
+  pthread_mutex_unlock (&writer->lock);
+}
+
+#endif
+
+static void stop_writer (kissat *solver, proof *proof) {
+  writer *writer = proof->writer;
+  if (writer->filled)
+    hand_over_records (writer);
+  pthread_mutex_lock (&writer->lock);
+  writer->stop = true;
+  pthread_cond_broadcast (&writer->cond);
+  pthread_mutex_unlock (&writer->lock);
+  if (pthread_join (writer->thread, 0))
+    kissat_fatal ("failed to join proof writer thread");
+  assert (writer->start);
+  pthread_cond_destroy (&writer->cond);
+  pthread_mutex_destroy (&writer->lock);
+  kissat_dealloc (solver, writer->filling, size_records, sizeof (int));
+  kissat_dealloc (solver, writer->draining, size_records, sizeof (int));
+  kissat_free (solver, writer, sizeof *writer);
+  proof->writer = 0;
+  LOG ("stopped proof writer thread");
+}
+
+static inline void push_record (writer *writer, int record) {
+  if (writer->filled == size_records)
+    hand_over_records (writer);
+  writer->filling[writer->filled++] = record;
+}
+
 void kissat_init_proof (kissat *solver, file *file, bool binary) {
   assert (file);
   assert (!solver->proof);
@@ -60,22 +315,23 @@ void kissat_init_proof (kissat *solver, file *file, bool binary) {
   proof->solver = solver;
   solver->proof = proof;
   LOG ("starting to trace %s proof", binary ? "binary" : "non-binary");
-}
-
-static void flush_buffer (proof *proof) {
-  size_t bytes = proof->buffer.pos;
-  if (!bytes)
-    return;
-  size_t written = kissat_write (proof->file, proof->buffer.chars, bytes);
-  if (bytes != written)
-    kissat_fatal ("flushing %zu bytes in proof write-buffer failed", bytes);
-  proof->buffer.pos = 0;
+  if (GET_OPTION (lrat))
+    solver->lrat = kissat_new_lrat (solver, proof);
+  else if (GET_OPTION (proofthread) && !GET_OPTION (flushproof))
+    start_writer (solver, proof);
 }
 
 void kissat_release_proof (kissat *solver) {
   proof *proof = solver->proof;
   assert (proof);
   LOG ("stopping to trace proof");
+  if (solver->lrat) {
+    kissat_lrat_end_of_original (solver->lrat);
+    kissat_release_lrat (solver->lrat);
+    solver->lrat = 0;
+  }
+  if (proof->writer)
+    stop_writer (solver, proof);
   flush_buffer (proof);
   kissat_flush (proof->file);
   RELEASE_STACK (proof->line);
@@ -97,6 +353,8 @@ void kissat_release_proof (kissat *solver) {
 
 void kissat_print_proof_statistics (kissat *solver, bool verbose) {
   proof *proof = solver->proof;
+  if (proof->writer)
+    wait_for_writer (proof->writer);
   PRINT_STAT ("proof_added", proof->added, PERCENT_LINES (added), "%",
               "per line");
   PRINT_STAT ("proof_bytes", proof->file->bytes,
@@ -115,9 +373,6 @@ void kissat_print_proof_statistics (kissat *solver, bool verbose) {
 
 // clang-format off
 
-static inline void write_char (proof *, unsigned char)
-  ATTRIBUTE_ALWAYS_INLINE;
-
 static inline void import_external_proof_literal (kissat *, proof *, int)
   ATTRIBUTE_ALWAYS_INLINE;
 
@@ -127,13 +382,6 @@ import_internal_proof_literal (kissat *, proof *, unsigned)
 
 // clang-format on
 
-static inline void write_char (proof *proof, unsigned char ch) {
-  write_buffer *buffer = &proof->buffer;
-  if (buffer->pos == size_buffer)
-    flush_buffer (proof);
-  buffer->chars[buffer->pos++] = ch;
-}
-
 static inline void import_internal_proof_literal (kissat *solver,
                                                   proof *proof,
                                                   unsigned ilit) {
@@ -185,61 +433,33 @@ static void import_proof_clause (kissat *solver, proof *proof,
   import_internal_proof_literals (solver, proof, c->size, c->lits);
 }
 
-static void print_binary_proof_line (proof *proof) {
-  assert (proof->binary);
-  for (all_stack (int, elit, proof->line)) {
-    unsigned x = 2u * ABS (elit) + (elit < 0);
-    unsigned char ch;
-    while (x & ~0x7f) {
-      ch = (x & 0x7f) | 0x80;
-      write_char (proof, ch);
-      x >>= 7;
-    }
-    write_char (proof, x);
-  }
-  write_char (proof, 0);
-}
-
-static void print_non_binary_proof_line (proof *proof) {
-  assert (!proof->binary);
-  char buffer[16];
-  char *end_of_buffer = buffer + sizeof buffer;
-  *--end_of_buffer = 0;
-  for (all_stack (int, elit, proof->line)) {
-    char *p = end_of_buffer;
-    assert (!*p);
-    assert (elit);
-    assert (elit != INT_MIN);
-    unsigned eidx;
-    if (elit < 0) {
-      write_char (proof, '-');
-      eidx = -elit;
-    } else
-      eidx = elit;
-    for (unsigned tmp = eidx; tmp; tmp /= 10)
-      *--p = '0' + (tmp % 10);
-    while (p != end_of_buffer)
-      write_char (proof, *p++);
-    write_char (proof, ' ');
-  }
-  write_char (proof, '0');
-  write_char (proof, '\n');
-}
-
-static void print_proof_line (proof *proof) {
+static void print_proof_line (proof *proof, int type, uint64_t id) {
   proof->lines++;
-  if (proof->binary)
-    print_binary_proof_line (proof);
-  else
-    print_non_binary_proof_line (proof);
+  kissat *solver = proof->solver;
+  writer *writer = proof->writer;
+  if (solver->lrat) {
+    const size_t size = SIZE_STACK (proof->line);
+    const int *elits = BEGIN_STACK (proof->line);
+    if (type == 'a')
+      kissat_lrat_add (solver->lrat, size, elits);
+    else
+      kissat_lrat_delete (solver->lrat, id, size, elits);
+  } else if (writer) {
+    push_record (writer, type);
+    for (all_stack (int, elit, proof->line))
+      push_record (writer, elit);
+    push_record (writer, 0);
+  } else {
+    write_proof_line_start (proof, type);
+    for (all_stack (int, elit, proof->line))
+      write_proof_literal (proof, elit);
+    write_proof_line_end (proof);
+  }
   CLEAR_STACK (proof->line);
 #if !defined(NDEBUG) || defined(LOGGING)
   CLEAR_STACK (proof->imported);
 #endif
-#ifndef NOPTIONS
-  kissat *solver = proof->solver;
-#endif
-  if (GET_OPTION (flushproof)) {
+  if (!writer && GET_OPTION (flushproof)) {
     flush_buffer (proof);
     kissat_flush (proof->file);
   }
@@ -295,12 +515,10 @@ static void print_added_proof_line (proof *proof) {
 #ifndef NDEBUG
   check_repeated_proof_lines (proof);
 #endif
-  if (proof->binary)
-    write_char (proof, 'a');
-  print_proof_line (proof);
+  print_proof_line (proof, 'a', 0);
 }
 
-static void print_delete_proof_line (proof *proof) {
+static void print_delete_proof_line (proof *proof, uint64_t id) {
   proof->deleted++;
 #ifdef LOGGING
   struct kissat *solver = proof->solver;
@@ -308,10 +526,20 @@ static void print_delete_proof_line (proof *proof) {
     LOGIMPORTED3 ("deleted internal proof line");
   LOGLINE3 ("deleted external proof line");
 #endif
-  write_char (proof, 'd');
-  if (!proof->binary)
-    write_char (proof, ' ');
-  print_proof_line (proof);
+  print_proof_line (proof, 'd', id);
+}
+
+void kissat_add_original_to_proof (kissat *solver, size_t size,
+                                   const int *elits) {
+  assert (solver->proof);
+  if (solver->lrat)
+    kissat_lrat_original (solver->lrat, size, elits);
+}
+
+void kissat_end_of_original_proof (kissat *solver) {
+  assert (solver->proof);
+  if (solver->lrat)
+    kissat_lrat_end_of_original (solver->lrat);
 }
 
 void kissat_add_binary_to_proof (kissat *solver, unsigned a, unsigned b) {
@@ -351,7 +579,7 @@ void kissat_add_unit_to_proof (kissat *solver, unsigned ilit) {
   print_added_proof_line (proof);
 }
 
-void kissat_shrink_clause_in_proof (kissat *solver, const clause *c,
+void kissat_shrink_clause_in_proof (kissat *solver, clause *c,
                                     unsigned remove, unsigned keep) {
   proof *proof = solver->proof;
   const value *const values = solver->values;
@@ -368,7 +596,8 @@ void kissat_shrink_clause_in_proof (kissat *solver, const clause *c,
   }
   print_added_proof_line (proof);
   import_proof_clause (solver, proof, c);
-  print_delete_proof_line (proof);
+  print_delete_proof_line (proof, c->id);
+  LRAT_IDENTIFY (c);
 }
 
 void kissat_delete_binary_from_proof (kissat *solver, unsigned a,
@@ -376,14 +605,14 @@ void kissat_delete_binary_from_proof (kissat *solver, unsigned a,
   proof *proof = solver->proof;
   assert (proof);
   import_internal_proof_binary (solver, proof, a, b);
-  print_delete_proof_line (proof);
+  print_delete_proof_line (proof, 0);
 }
 
 void kissat_delete_clause_from_proof (kissat *solver, const clause *c) {
   proof *proof = solver->proof;
   assert (proof);
   import_proof_clause (solver, proof, c);
-  print_delete_proof_line (proof);
+  print_delete_proof_line (proof, c->id);
 }
 
 void kissat_delete_external_from_proof (kissat *solver, size_t size,
@@ -392,7 +621,7 @@ void kissat_delete_external_from_proof (kissat *solver, size_t size,
   assert (proof);
   LOGINTS3 (size, elits, "explicitly deleted");
   import_external_proof_literals (solver, proof, size, elits);
-  print_delete_proof_line (proof);
+  print_delete_proof_line (proof, 0);
 }
 
 void kissat_delete_internal_from_proof (kissat *solver, size_t size,
@@ -400,7 +629,16 @@ void kissat_delete_internal_from_proof (kissat *solver, size_t size,
   proof *proof = solver->proof;
   assert (proof);
   import_internal_proof_literals (solver, proof, size, ilits);
-  print_delete_proof_line (proof);
+  print_delete_proof_line (proof, 0);
+}
+
+void kissat_delete_identified_from_proof (kissat *solver, uint64_t id,
+                                          size_t size,
+                                          const unsigned *ilits) {
+  proof *proof = solver->proof;
+  assert (proof);
+  import_internal_proof_literals (solver, proof, size, ilits);
+  print_delete_proof_line (proof, id);
 }
 
 #else
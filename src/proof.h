@@ -4,6 +4,7 @@
 #ifndef NPROOFS
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 typedef struct proof proof;
@@ -18,13 +19,20 @@ void kissat_release_proof (struct kissat *);
 void kissat_print_proof_statistics (struct kissat *, bool verbose);
 #endif
 
+void kissat_add_original_to_proof (struct kissat *, size_t, const int *);
+void kissat_end_of_original_proof (struct kissat *);
+
+void kissat_write_lrat_addition (proof *, uint64_t id, size_t, const int *,
+                                 size_t, const uint64_t *hints);
+void kissat_write_lrat_deletion (proof *, uint64_t id, uint64_t deleted);
+
 void kissat_add_binary_to_proof (struct kissat *, unsigned, unsigned);
 void kissat_add_clause_to_proof (struct kissat *, const struct clause *c);
 void kissat_add_empty_to_proof (struct kissat *);
 void kissat_add_lits_to_proof (struct kissat *, size_t, const unsigned *);
 void kissat_add_unit_to_proof (struct kissat *, unsigned);
 
-void kissat_shrink_clause_in_proof (struct kissat *, const struct clause *,
+void kissat_shrink_clause_in_proof (struct kissat *, struct clause *,
                                     unsigned remove, unsigned keep);
 
 void kissat_delete_binary_from_proof (struct kissat *, unsigned, unsigned);
@@ -34,6 +42,8 @@ void kissat_delete_external_from_proof (struct kissat *, size_t,
                                         const int *);
 void kissat_delete_internal_from_proof (struct kissat *, size_t,
                                         const unsigned *);
+void kissat_delete_identified_from_proof (struct kissat *, uint64_t id,
+                                          size_t, const unsigned *);
 
 #define ADD_BINARY_TO_PROOF(A, B) \
   do { \
@@ -115,6 +125,13 @@ void kissat_delete_internal_from_proof (struct kissat *, size_t,
                                          BEGIN_STACK (S)); \
   } while (0)
 
+#define DELETE_IDENTIFIED_STACK_FROM_PROOF(ID, S) \
+  do { \
+    if (solver->proof) \
+      kissat_delete_identified_from_proof (solver, (ID), SIZE_STACK (S), \
+                                           BEGIN_STACK (S)); \
+  } while (0)
+
 #else
 
 #define ADD_BINARY_TO_PROOF(...) \
@@ -158,6 +175,9 @@ void kissat_delete_internal_from_proof (struct kissat *, size_t,
 #define DELETE_STACK_FROM_PROOF(...) \
   do { \
   } while (0)
+#define DELETE_IDENTIFIED_STACK_FROM_PROOF(...) \
+  do { \
+  } while (0)
 
 #endif
 
@@ -1,5 +1,6 @@
 #include "propbeyond.h"
 #include "fastassign.h"
+#include "simd.h"
 #include "trail.h"
 
 #define PROPAGATE_LITERAL propagate_literal_beyond_conflicts
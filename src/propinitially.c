@@ -2,6 +2,7 @@
 #include "analyze.h"
 #include "fastassign.h"
 #include "print.h"
+#include "simd.h"
 #include "trail.h"
 
 #define PROPAGATE_LITERAL initially_propagate_literal
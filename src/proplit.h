@@ -13,11 +13,17 @@ static inline void kissat_watch_large_delayed (kissat *solver,
     assert (lit < LITS);
     watches *const lit_watches = all_watches + lit;
     assert (d != end_delayed);
-    const reference ref = *d++;
+    const union watch tail = {.raw = *d++};
+    const reference ref = tail.tail.ref;
     const unsigned blocking = watch.blocking.lit;
     LOGREF3 (ref, "watching %s blocking %s in", LOGLIT (lit),
              LOGLIT (blocking));
-    kissat_push_blocking_watch (solver, lit_watches, blocking, ref);
+    if (tail.tail.ternary) {
+      assert (d != end_delayed);
+      const unsigned third = *d++;
+      kissat_push_ternary_watch (solver, lit_watches, blocking, third, ref);
+    } else
+      kissat_push_blocking_watch (solver, lit_watches, blocking, ref);
   }
   CLEAR_STACK (*delayed);
 }
@@ -31,6 +37,42 @@ kissat_delay_watching_large (kissat *solver, unsigneds *const delayed,
   PUSH_STACK (*delayed, ref);
 }
 
+static inline void
+kissat_delay_watching_ternary (kissat *solver, unsigneds *const delayed,
+                               unsigned lit, unsigned other,
+                               unsigned third, reference ref) {
+  const watch watch = kissat_blocking_watch (other);
+  const union watch tail = kissat_tail_watch (ref, true);
+  PUSH_STACK (*delayed, lit);
+  PUSH_STACK (*delayed, watch.raw);
+  PUSH_STACK (*delayed, tail.raw);
+  PUSH_STACK (*delayed, third);
+}
+
+// Find the next large watch in '[ahead,end)' and prefetch its clause
+// unless the blocking literal is true.  Returns the position after it.
+
+static inline const watch *
+kissat_prefetch_large_watch (kissat *solver, const value *const values,
+                             ward *const arena, const watch *ahead,
+                             const watch *const end) {
+  while (ahead != end) {
+    const watch head = *ahead;
+    if (head.type.binary) {
+      ahead++;
+      continue;
+    }
+    const watch tail = ahead[1];
+    ahead += kissat_watch_words (ahead);
+    if (values[head.blocking.lit] > 0)
+      continue;
+    __builtin_prefetch (arena + tail.tail.ref, 1, 0);
+    INC (prefetched);
+    break;
+  }
+  return ahead;
+}
+
 static inline clause *PROPAGATE_LITERAL (kissat *solver,
 #if defined(PROBING_PROPAGATION)
                                          const clause *const ignore,
@@ -65,18 +107,31 @@ static inline clause *PROPAGATE_LITERAL (kissat *solver,
   const unsigned idx = IDX (lit);
   struct assigned *const a = assigned + idx;
   const bool probing = solver->probing;
+  const bool simd = solver->simd;
   const unsigned level = a->level;
   clause *res = 0;
 
+  const unsigned prefetch = GET_OPTION (prefetch);
+  const watch *ahead = p;
+  for (unsigned i = 0; i != prefetch && ahead != end_watches; i++)
+    ahead = kissat_prefetch_large_watch (solver, values, arena, ahead,
+                                         end_watches);
+
   while (p != end_watches) {
     const watch head = *q++ = *p++;
     const unsigned blocking = head.blocking.lit;
     assert (VALID_INTERNAL_LITERAL (blocking));
     const value blocking_value = values[blocking];
     const bool binary = head.type.binary;
-    watch tail;
-    if (!binary)
+    watch tail, third;
+    if (!binary) {
       tail = *q++ = *p++;
+      if (tail.tail.ternary)
+        third = *q++ = *p++;
+      if (prefetch && ahead != end_watches)
+        ahead = kissat_prefetch_large_watch (solver, values, arena, ahead,
+                                             end_watches);
+    }
     if (blocking_value > 0)
       continue;
     if (binary) {
@@ -91,6 +146,69 @@ static inline clause *PROPAGATE_LITERAL (kissat *solver,
                                    blocking, not_lit);
         ticks++;
       }
+    } else if (tail.tail.ternary) {
+      INC (ternary_visits);
+      const unsigned other = third.blocking.lit;
+      assert (VALID_INTERNAL_LITERAL (other));
+      const value other_value = values[other];
+      if (other_value > 0) {
+        q[-3].blocking.lit = other;
+        q[-1].blocking.lit = blocking;
+        continue;
+      }
+      const reference ref = tail.tail.ref;
+      assert (ref < SIZE_STACK (solver->arena));
+      clause *const c = (clause *) (arena + ref);
+      INC (ternary_dereferenced);
+      ticks++;
+      if (c->garbage) {
+        q -= 3;
+        continue;
+      }
+      assert (c->size == 3);
+      unsigned *const lits = BEGIN_LITS (c);
+      assert (lits[0] == not_lit || lits[1] == not_lit);
+      const unsigned watched = lits[0] ^ lits[1] ^ not_lit;
+      const unsigned unwatched = lits[2];
+      assert (watched == blocking || watched == other);
+      assert (unwatched == blocking || unwatched == other);
+      const value unwatched_value = values[unwatched];
+      if (!unwatched_value) {
+        LOGREF3 (ref, "unwatching %s in", LOGLIT (not_lit));
+        q -= 3;
+        lits[0] = watched;
+        lits[1] = unwatched;
+        lits[2] = not_lit;
+        kissat_delay_watching_ternary (solver, delayed, unwatched, watched,
+                                       not_lit, ref);
+        ticks++;
+      } else if (blocking_value && other_value) {
+        assert (blocking_value < 0);
+        assert (other_value < 0);
+#if defined(PROBING_PROPAGATION)
+        if (c == ignore) {
+          LOGREF (ref, "conflicting but ignored");
+          continue;
+        }
+#endif
+        LOGREF (ref, "conflicting");
+        res = c;
+#ifndef CONTINUE_PROPAGATING_AFTER_CONFLICT
+        break;
+#endif
+      } else {
+        assert (unwatched_value < 0);
+        assert (!values[watched]);
+#if defined(PROBING_PROPAGATION)
+        if (c == ignore) {
+          LOGREF (ref, "forcing %s but ignored", LOGLIT (watched));
+          continue;
+        }
+#endif
+        kissat_fast_assign_reference (solver, values, assigned, watched,
+                                      ref, c);
+        ticks++;
+      }
     } else {
       const reference ref = tail.raw;
       assert (ref < SIZE_STACK (solver->arena));
@@ -115,28 +233,19 @@ static inline clause *PROPAGATE_LITERAL (kissat *solver,
       unsigned *const searched = lits + c->searched;
       assert (c->lits + 2 <= searched);
       assert (searched < end_lits);
-      unsigned *r, replacement = INVALID_LIT;
-      value replacement_value = -1;
-      for (r = searched; r != end_lits; r++) {
-        replacement = *r;
-        assert (VALID_INTERNAL_LITERAL (replacement));
-        replacement_value = values[replacement];
-        if (replacement_value >= 0)
-          break;
-      }
-      if (replacement_value < 0) {
-        for (r = lits + 2; r != searched; r++) {
-          replacement = *r;
-          assert (VALID_INTERNAL_LITERAL (replacement));
-          replacement_value = values[replacement];
-          if (replacement_value >= 0)
-            break;
-        }
+      unsigned *r =
+          kissat_find_non_false (simd, values, searched, end_lits);
+      if (r == end_lits) {
+        r = kissat_find_non_false (simd, values, lits + 2, searched);
+        if (r == searched)
+          r = 0;
       }
 
-      if (replacement_value >= 0) {
+      if (r) {
+        const unsigned replacement = *r;
+        assert (VALID_INTERNAL_LITERAL (replacement));
+        assert (values[replacement] >= 0);
         c->searched = r - lits;
-        assert (replacement != INVALID_LIT);
         LOGREF3 (ref, "unwatching %s in", LOGLIT (not_lit));
         q -= 2;
         lits[0] = other;
@@ -147,7 +256,6 @@ static inline clause *PROPAGATE_LITERAL (kissat *solver,
                                      ref);
         ticks++;
       } else if (other_value) {
-        assert (replacement_value < 0);
         assert (blocking_value < 0);
         assert (other_value < 0);
 #if defined(PROBING_PROPAGATION)
@@ -162,7 +270,6 @@ static inline clause *PROPAGATE_LITERAL (kissat *solver,
         break;
 #endif
       } else {
-        assert (replacement_value < 0);
 #if defined(PROBING_PROPAGATION)
         if (c == ignore) {
           LOGREF (ref, "forcing %s but ignored", LOGLIT (other));
@@ -197,6 +304,7 @@ static inline void kissat_update_conflicts_and_trail (kissat *solver,
       LOG (PROPAGATION_TYPE " propagation on root-level failed");
       solver->inconsistent = true;
       CHECK_AND_ADD_EMPTY ();
+      LRAT_CHAIN_EMPTY (conflict);
       ADD_EMPTY_TO_PROOF ();
     }
   } else if (flush && !solver->level && solver->unflushed)
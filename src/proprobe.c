@@ -1,5 +1,6 @@
 #include "proprobe.h"
 #include "fastassign.h"
+#include "simd.h"
 #include "trail.h"
 
 #define PROPAGATE_LITERAL probing_propagate_literal
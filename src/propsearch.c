@@ -1,6 +1,7 @@
 #include "propsearch.h"
 #include "fastassign.h"
 #include "print.h"
+#include "simd.h"
 #include "trail.h"
 
 #define PROPAGATE_LITERAL search_propagate_literal
@@ -32,11 +33,22 @@ update_search_propagation_statistics (kissat *solver,
   }
 }
 
+static inline void prefetch_watches (kissat *solver, unsigned lit) {
+  watches *const watches = &WATCHES (NOT (lit));
+  if (!kissat_empty_vector (watches))
+    __builtin_prefetch (BEGIN_WATCHES (*watches), 0, 1);
+}
+
 static clause *search_propagate (kissat *solver) {
   clause *res = 0;
   unsigned *propagate = solver->propagate;
-  while (!res && propagate != END_ARRAY (solver->trail))
-    res = search_propagate_literal (solver, *propagate++);
+  const bool prefetch = GET_OPTION (prefetch);
+  while (!res && propagate != END_ARRAY (solver->trail)) {
+    const unsigned lit = *propagate++;
+    if (prefetch && propagate != END_ARRAY (solver->trail))
+      prefetch_watches (solver, *propagate);
+    res = search_propagate_literal (solver, lit);
+  }
   solver->propagate = propagate;
   return res;
 }
@@ -1,5 +1,6 @@
 #include "reduce.h"
 #include "allocate.h"
+#include "budget.h"
 #include "collect.h"
 #include "inline.h"
 #include "print.h"
@@ -16,9 +17,14 @@ bool kissat_reducing (kissat *solver) {
     return false;
   if (!solver->statistics.clauses_redundant)
     return false;
-  if (CONFLICTS < solver->limits.reduce.conflicts)
+  if (CONFLICTS >= solver->limits.reduce.conflicts)
+    return true;
+  if (!kissat_memory_pressure (solver))
     return false;
-  return true;
+  const uint64_t delta = CONFLICTS - solver->last.conflicts.reduce;
+  if (kissat_memory_exceeded (solver))
+    return delta;
+  return delta >= (uint64_t) GET_OPTION (reduceint);
 }
 
 typedef struct reducible reducible;
@@ -107,7 +113,9 @@ static void mark_less_useful_clauses_as_garbage (kissat *solver,
   const double high = GET_OPTION (reducehigh) * 0.1;
   const double low = GET_OPTION (reducelow) * 0.1;
   double percent;
-  if (low < high) {
+  if (kissat_memory_pressure (solver))
+    percent = high;
+  else if (low < high) {
     const double delta = high - low;
     percent = high - delta / log10 (statistics->reductions + 9);
   } else
@@ -155,12 +163,20 @@ static void mark_less_useful_clauses_as_garbage (kissat *solver,
 int kissat_reduce (kissat *solver) {
   START (reduce);
   INC (reductions);
-  kissat_phase (solver, "reduce", GET (reductions),
-                "reduce limit %" PRIu64 " hit after %" PRIu64 " conflicts",
-                solver->limits.reduce.conflicts, CONFLICTS);
+  if (CONFLICTS >= solver->limits.reduce.conflicts)
+    kissat_phase (solver, "reduce", GET (reductions),
+                  "reduce limit %" PRIu64 " hit after %" PRIu64
+                  " conflicts",
+                  solver->limits.reduce.conflicts, CONFLICTS);
   kissat_compute_and_set_tier_limits (solver);
   bool compact = kissat_compacting (solver);
-  reference start = compact ? 0 : solver->first_reducible;
+  const bool pressure = kissat_memory_pressure (solver);
+  if (pressure)
+    kissat_phase (solver, "reduce", GET (reductions),
+                  "memory pressure with %s allocated (limit %s)",
+                  FORMAT_BYTES (solver->allocated),
+                  FORMAT_BYTES (solver->limits.memory));
+  reference start = compact || pressure ? 0 : solver->first_reducible;
   if (start != INVALID_REF) {
 #ifndef QUIET
     size_t arena_size = SIZE_STACK (solver->arena);
@@ -191,6 +207,8 @@ int kissat_reduce (kissat *solver) {
       assert (solver->inconsistent);
   } else
     kissat_phase (solver, "reduce", GET (reductions), "nothing to reduce");
+  if (pressure && !solver->inconsistent)
+    kissat_defrag_watches (solver);
   kissat_classify (solver);
   UPDATE_CONFLICT_LIMIT (reduce, reductions, SQRT, false);
   solver->last.conflicts.reduce = CONFLICTS;
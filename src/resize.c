@@ -40,6 +40,17 @@
 #define CREALLOC_LITERAL_INDEXED(TYPE, NAME) \
   CREALLOC_GENERIC (TYPE, NAME, 2)
 
+static void reallocate_values (kissat *solver, unsigned old_size,
+                               unsigned new_size) {
+  const size_t old_bytes = old_size ? 2 * old_size + VALUES_PADDING : 0;
+  const size_t new_bytes = 2 * new_size + VALUES_PADDING;
+  value *values = kissat_calloc (solver, new_bytes, sizeof (value));
+  if (old_size)
+    memcpy (values, solver->values, 2 * old_size * sizeof (value));
+  kissat_dealloc (solver, solver->values, old_bytes, sizeof (value));
+  solver->values = values;
+}
+
 static void reallocate_trail (kissat *solver, unsigned old_size,
                               unsigned new_size) {
   unsigned propagated = solver->propagate - BEGIN_ARRAY (solver->trail);
@@ -58,11 +69,12 @@ void kissat_increase_size (kissat *solver, unsigned new_size) {
        FORMAT_BYTES (kissat_allocated (solver)), old_size, new_size);
 #endif
   CREALLOC_VARIABLE_INDEXED (assigned, assigned);
+  CREALLOC_VARIABLE_INDEXED (analysis, analysis);
   CREALLOC_VARIABLE_INDEXED (flags, flags);
   NREALLOC_VARIABLE_INDEXED (links, links);
 
   CREALLOC_LITERAL_INDEXED (mark, marks);
-  CREALLOC_LITERAL_INDEXED (value, values);
+  reallocate_values (solver, old_size, new_size);
   CREALLOC_LITERAL_INDEXED (watches, watches);
 
   reallocate_trail (solver, old_size, new_size);
@@ -87,11 +99,15 @@ void kissat_decrease_size (kissat *solver) {
 #endif
 
   NREALLOC_VARIABLE_INDEXED (assigned, assigned);
+  NREALLOC_VARIABLE_INDEXED (analysis, analysis);
   NREALLOC_VARIABLE_INDEXED (flags, flags);
   NREALLOC_VARIABLE_INDEXED (links, links);
 
   NREALLOC_LITERAL_INDEXED (mark, marks);
-  NREALLOC_LITERAL_INDEXED (value, values);
+  solver->values = kissat_nrealloc (solver, solver->values,
+                                    2 * old_size + VALUES_PADDING,
+                                    2 * new_size + VALUES_PADDING,
+                                    sizeof (value));
   NREALLOC_LITERAL_INDEXED (watches, watches);
 
   reallocate_trail (solver, old_size, new_size);
@@ -85,13 +85,54 @@ static inline clause *watch_to_clause (kissat *solver, ward *const arena,
   return res;
 }
 
-static bool generate_resolvents (kissat *solver, unsigned lit,
-                                 statches *const watches0,
-                                 statches *const watches1,
-                                 uint64_t *const resolved_ptr,
-                                 uint64_t limit) {
+// The resolution loop is shared by sequential elimination and concurrent
+// resolution of elimination candidates (see 'eliminate.c').  Sequentially
+// satisfied antecedents are eliminated and units as well as the empty
+// clause are derived immediately.  Concurrently the solver is only read and
+// units and the empty clause are kept as resolvents until committed.  If
+// further the resolvents are 'reserved' they are not allowed to grow beyond
+// the room reserved by the main thread, and resolution stops with
+// 'overflow' set instead.
+
+typedef struct resolving resolving;
+
+struct resolving {
+  value *marks;
+  unsigneds *resolvents;
+  uint64_t limit;
+  uint64_t resolved;
+  uint64_t resolutions;
+  bool concurrent;
+  bool reserved;
+  bool overflow;
+  bool empty;
+};
+
+static inline bool push_resolvent_literal (kissat *solver,
+                                           resolving *resolving,
+                                           unsigned lit) {
+  unsigneds *const resolvents = resolving->resolvents;
+  if (FULL_STACK (*resolvents)) {
+    if (resolving->reserved) {
+      resolving->overflow = true;
+      return false;
+    }
+    ENLARGE_STACK (*resolvents);
+  }
+  *resolvents->end++ = lit;
+  return true;
+}
+
+static bool resolve_antecedents (kissat *solver, resolving *resolving,
+                                 unsigned lit, const watch *const begin0,
+                                 const watch *const end0,
+                                 const watch *const begin1,
+                                 const watch *const end1) {
+  const bool concurrent = resolving->concurrent;
   const unsigned not_lit = NOT (lit);
-  unsigned resolved = *resolved_ptr;
+  const uint64_t limit = resolving->limit;
+  uint64_t resolved = resolving->resolved;
+  uint64_t resolutions = 0;
   bool failed = false;
 
   clause tmp0, tmp1;
@@ -101,12 +142,14 @@ static bool generate_resolvents (kissat *solver, unsigned lit,
 
   ward *const arena = BEGIN_STACK (solver->arena);
   const value *const values = solver->values;
-  value *const marks = solver->marks;
+  value *const marks = resolving->marks;
+  unsigneds *const resolvents = resolving->resolvents;
 
   const unsigned clslim = GET_OPTION (eliminateclslim);
 
-  for (all_stack (watch, watch0, *watches0)) {
-    clause *const c = watch_to_clause (solver, arena, &tmp0, lit, watch0);
+  for (const watch *p = begin0; !failed && !resolving->empty && p != end0;
+       p++) {
+    clause *const c = watch_to_clause (solver, arena, &tmp0, lit, *p);
 
     if (c->garbage) {
       assert (c != &tmp0);
@@ -123,7 +166,7 @@ static bool generate_resolvents (kissat *solver, unsigned lit,
         continue;
       if (value > 0) {
         first_antecedent_satisfied = true;
-        if (c != &tmp0)
+        if (!concurrent && c != &tmp0)
           kissat_eliminate_clause (solver, c, other);
         break;
       }
@@ -139,60 +182,72 @@ static bool generate_resolvents (kissat *solver, unsigned lit,
       marks[other] = 1;
     }
 
-    for (all_stack (watch, watch1, *watches1)) {
-      clause *const d =
-          watch_to_clause (solver, arena, &tmp1, not_lit, watch1);
+    for (const watch *q = begin1; q != end1; q++) {
+      clause *const d = watch_to_clause (solver, arena, &tmp1, not_lit, *q);
 
       if (d->garbage) {
         assert (d != &tmp1);
         continue;
       }
 
-      LOGCLS (c, "first %s antecedent", LOGLIT (lit));
-      LOGCLS (d, "second %s antecedent", LOGLIT (not_lit));
+      if (!concurrent) {
+        LOGCLS (c, "first %s antecedent", LOGLIT (lit));
+        LOGCLS (d, "second %s antecedent", LOGLIT (not_lit));
+      }
 
       bool resolvent_satisfied_or_tautological = false;
-      const size_t saved = SIZE_STACK (solver->resolvents);
+      const size_t saved = SIZE_STACK (*resolvents);
 
-      INC (eliminate_resolutions);
+      resolutions++;
 
       for (all_literals_in_clause (other, d)) {
         if (other == not_lit)
           continue;
         const value value = values[other];
         if (value < 0) {
-          LOG2 ("dropping falsified literal %s", LOGLIT (other));
+          if (!concurrent)
+            LOG2 ("dropping falsified literal %s", LOGLIT (other));
           continue;
         }
         if (value > 0) {
-          if (d != &tmp1)
+          if (!concurrent && d != &tmp1)
             kissat_eliminate_clause (solver, d, other);
           resolvent_satisfied_or_tautological = true;
           break;
         }
         if (marks[other]) {
-          LOG2 ("dropping repeated %s literal", LOGLIT (other));
+          if (!concurrent)
+            LOG2 ("dropping repeated %s literal", LOGLIT (other));
           continue;
         }
         const unsigned not_other = NOT (other);
         if (marks[not_other]) {
-          LOG ("resolvent tautological on %s and %s "
-               "with second %s antecedent",
-               LOGLIT (NOT (other)), LOGLIT (other), LOGLIT (not_lit));
+          if (!concurrent)
+            LOG ("resolvent tautological on %s and %s "
+                 "with second %s antecedent",
+                 LOGLIT (not_other), LOGLIT (other), LOGLIT (not_lit));
           resolvent_satisfied_or_tautological = true;
           break;
         }
-        LOG2 ("including unassigned literal %s", LOGLIT (other));
-        PUSH_STACK (solver->resolvents, other);
+        if (!concurrent)
+          LOG2 ("including unassigned literal %s", LOGLIT (other));
+        if (!push_resolvent_literal (solver, resolving, other)) {
+          failed = true;
+          break;
+        }
       }
 
+      if (failed)
+        break;
+
       if (resolvent_satisfied_or_tautological) {
-        RESIZE_STACK (solver->resolvents, saved);
+        RESIZE_STACK (*resolvents, saved);
         continue;
       }
 
       if (++resolved > limit) {
-        LOG ("limit of %" PRIu64 " resolvent exceeded", limit);
+        if (!concurrent)
+          LOG ("limit of %" PRIu64 " resolvent exceeded", limit);
         failed = true;
         break;
       }
@@ -202,18 +257,29 @@ static bool generate_resolvents (kissat *solver, unsigned lit,
           continue;
         const value value = values[other];
         assert (value <= 0);
-        if (value < 0) {
-          LOG2 ("dropping falsified literal %s", LOGLIT (other));
+        if (value < 0)
           continue;
+        if (!push_resolvent_literal (solver, resolving, other)) {
+          failed = true;
+          break;
         }
-        PUSH_STACK (solver->resolvents, other);
       }
 
-      size_t size_resolvent = SIZE_STACK (solver->resolvents) - saved;
-      LOGLITS (size_resolvent, BEGIN_STACK (solver->resolvents) + saved,
-               "resolvent");
+      if (failed)
+        break;
+
+      const size_t size_resolvent = SIZE_STACK (*resolvents) - saved;
+      if (!concurrent)
+        LOGLITS (size_resolvent, BEGIN_STACK (*resolvents) + saved,
+                 "resolvent");
 
       if (!size_resolvent) {
+        resolving->empty = true;
+        if (concurrent) {
+          if (!push_resolvent_literal (solver, resolving, INVALID_LIT))
+            failed = true;
+          break;
+        }
         assert (!solver->inconsistent);
         solver->inconsistent = true;
         LOG ("resolved empty clause");
@@ -224,25 +290,35 @@ static bool generate_resolvents (kissat *solver, unsigned lit,
       }
 
       if (size_resolvent == 1) {
-        const unsigned unit = PEEK_STACK (solver->resolvents, saved);
-        INC (eliminate_units);
-        kissat_learned_unit (solver, unit);
-        RESIZE_STACK (solver->resolvents, saved);
+        const unsigned unit = PEEK_STACK (*resolvents, saved);
+        if (concurrent) {
+          if (!push_resolvent_literal (solver, resolving, INVALID_LIT)) {
+            failed = true;
+            break;
+          }
+        } else {
+          INC (eliminate_units);
+          kissat_learned_unit (solver, unit);
+          RESIZE_STACK (*resolvents, saved);
+        }
         if (marks[unit] <= 0)
           continue;
-        LOGCLS (c, "first antecedent becomes satisfied");
-        first_antecedent_satisfied = true;
-        (void) first_antecedent_satisfied;
+        if (!concurrent)
+          LOGCLS (c, "first antecedent becomes satisfied");
         break;
       }
 
       if (size_resolvent > clslim) {
-        LOG ("resolvent size limit exceeded");
+        if (!concurrent)
+          LOG ("resolvent size limit exceeded");
         failed = true;
         break;
       }
 
-      PUSH_STACK (solver->resolvents, INVALID_LIT);
+      if (!push_resolvent_literal (solver, resolving, INVALID_LIT)) {
+        failed = true;
+        break;
+      }
     }
 
     for (all_literals_in_clause (other, c)) {
@@ -251,57 +327,88 @@ static bool generate_resolvents (kissat *solver, unsigned lit,
       assert (marks[other] == 1);
       marks[other] = 0;
     }
-
-    if (failed)
-      break;
   }
 
-  *resolved_ptr = resolved;
+  resolving->resolved = resolved;
+  resolving->resolutions += resolutions;
 
   return !failed;
 }
 
-bool kissat_generate_resolvents (kissat *solver, unsigned idx,
-                                 unsigned *lit_ptr) {
+static bool generate_resolvents (kissat *solver, unsigned lit,
+                                 statches *const watches0,
+                                 statches *const watches1,
+                                 uint64_t *const resolved_ptr,
+                                 uint64_t limit) {
+  resolving resolving;
+  memset (&resolving, 0, sizeof resolving);
+  resolving.marks = solver->marks;
+  resolving.resolvents = &solver->resolvents;
+  resolving.limit = limit;
+  resolving.resolved = *resolved_ptr;
+  const bool res = resolve_antecedents (
+      solver, &resolving, lit, BEGIN_STACK (*watches0),
+      END_STACK (*watches0), BEGIN_STACK (*watches1),
+      END_STACK (*watches1));
+  ADD (eliminate_resolutions, resolving.resolutions);
+  *resolved_ptr = resolving.resolved;
+  return res;
+}
+
+static bool limit_resolvents (kissat *solver, unsigned idx,
+                              unsigned *lit_ptr, bool *update_ptr,
+                              uint64_t *limit_ptr, bool *pure_ptr) {
   unsigned lit = LIT (idx);
   unsigned not_lit = NOT (lit);
 
-  bool update = false;
-  bool pure = false;
-  uint64_t limit;
+  unsigned pos_count = occurrences_literal (solver, lit, update_ptr);
+  unsigned neg_count = occurrences_literal (solver, not_lit, update_ptr);
 
-  {
-    unsigned pos_count = occurrences_literal (solver, lit, &update);
-    unsigned neg_count = occurrences_literal (solver, not_lit, &update);
-
-    if (pos_count > neg_count) {
-      SWAP (unsigned, lit, not_lit);
-      SWAP (size_t, pos_count, neg_count);
-    }
+  if (pos_count > neg_count) {
+    SWAP (unsigned, lit, not_lit);
+    SWAP (size_t, pos_count, neg_count);
+  }
 
-    const unsigned occlim = GET_OPTION (eliminateocclim);
-    limit = pos_count + (uint64_t) neg_count;
+  const unsigned occlim = GET_OPTION (eliminateocclim);
+  uint64_t limit = pos_count + (uint64_t) neg_count;
 
-    if (pos_count && limit > occlim) {
-      LOG ("no elimination of variable %u "
-           "since it has %" PRIu64 " > %u occurrences",
-           idx, limit, occlim);
-      return false;
-    }
+  if (pos_count && limit > occlim) {
+    LOG ("no elimination of variable %u "
+         "since it has %" PRIu64 " > %u occurrences",
+         idx, limit, occlim);
+    return false;
+  }
 
-    if (pos_count) {
-      const uint64_t bound = solver->bounds.eliminate.additional_clauses;
-      limit += bound;
-      LOG ("trying to eliminate %s "
-           "limit %" PRIu64 " bound %" PRIu64,
-           LOGVAR (idx), limit, bound);
-    } else {
-      LOG ("eliminating pure literal %s thus its variable %u", LOGLIT (lit),
-           idx);
-      pure = true;
-    }
+  if (pos_count) {
+    const uint64_t bound = solver->bounds.eliminate.additional_clauses;
+    limit += bound;
+    LOG ("trying to eliminate %s "
+         "limit %" PRIu64 " bound %" PRIu64,
+         LOGVAR (idx), limit, bound);
+    *pure_ptr = false;
+  } else {
+    LOG ("eliminating pure literal %s thus its variable %u", LOGLIT (lit),
+         idx);
+    *pure_ptr = true;
   }
 
+  *lit_ptr = lit;
+  *limit_ptr = limit;
+
+  return true;
+}
+
+bool kissat_generate_resolvents (kissat *solver, unsigned idx,
+                                 unsigned *lit_ptr) {
+  bool update = false;
+  bool pure;
+  uint64_t limit;
+  unsigned lit;
+
+  if (!limit_resolvents (solver, idx, &lit, &update, &limit, &pure))
+    return false;
+
+  const unsigned not_lit = NOT (lit);
   *lit_ptr = lit;
 
   INC (eliminate_attempted);
@@ -368,3 +475,69 @@ bool kissat_generate_resolvents (kissat *solver, unsigned idx,
 
   return !failed;
 }
+
+// Room reserved for the resolvents of a concurrently resolved candidate,
+// measured in literals per resolvent allowed by its limit.
+
+#define RESERVED_LITERALS_PER_RESOLVENT 8
+
+bool kissat_prepare_resolution (kissat *solver, unsigned idx,
+                                resolution *resolution) {
+  bool update = false;
+  bool pure;
+  uint64_t limit = 0;
+  unsigned lit = LIT (idx);
+
+  const bool res =
+      limit_resolvents (solver, idx, &lit, &update, &limit, &pure);
+
+  resolution->idx = idx;
+  resolution->lit = lit;
+  resolution->feasible = false;
+  resolution->overflow = false;
+  resolution->update = update;
+  resolution->limit = limit;
+  resolution->resolutions = 0;
+  CLEAR_STACK (resolution->resolvents);
+  if (res)
+    RESERVE_STACK (resolution->resolvents,
+                   (limit + 1) * RESERVED_LITERALS_PER_RESOLVENT);
+
+  (void) pure;
+  return res;
+}
+
+void kissat_resolve_concurrently (kissat *solver, value *marks,
+                                  resolution *resolution, bool reserved) {
+  const unsigned lit = resolution->lit;
+  const unsigned not_lit = NOT (lit);
+
+  resolving resolving;
+  memset (&resolving, 0, sizeof resolving);
+  resolving.marks = marks;
+  resolving.resolvents = &resolution->resolvents;
+  resolving.limit = resolution->limit;
+  resolving.concurrent = true;
+  resolving.reserved = reserved;
+
+  CLEAR_STACK (resolution->resolvents);
+
+  watches *const watches0 = &WATCHES (lit);
+  watches *const watches1 = &WATCHES (not_lit);
+
+  const bool feasible = resolve_antecedents (
+      solver, &resolving, lit, BEGIN_CONST_WATCHES (*watches0),
+      END_CONST_WATCHES (*watches0), BEGIN_CONST_WATCHES (*watches1),
+      END_CONST_WATCHES (*watches1));
+
+  if (!feasible)
+    CLEAR_STACK (resolution->resolvents);
+
+  resolution->feasible = feasible;
+  resolution->overflow = resolving.overflow;
+  resolution->resolutions = resolving.resolutions;
+}
+
+void kissat_release_resolution (kissat *solver, resolution *resolution) {
+  RELEASE_STACK (resolution->resolvents);
+}
@@ -1,11 +1,45 @@
 #ifndef _resolve_h_INCLUDED
 #define _resolve_h_INCLUDED
 
+#include "stack.h"
+#include "value.h"
+
 #include <stdbool.h>
+#include <stdint.h>
 
 struct kissat;
 
 bool kissat_generate_resolvents (struct kissat *, unsigned idx,
                                  unsigned *lit_ptr);
 
+// Plain resolution (without gates) of one elimination candidate which can
+// be computed concurrently to other candidates with disjoint occurrence
+// neighbourhoods.  The preparation flushes occurrences, determines the
+// limits and reserves room for the resolvents on the main thread.  Then
+// 'kissat_resolve_concurrently' only reads the solver and writes the
+// resolvents (each terminated by 'INVALID_LIT') and the result to the
+// given resolution using its own 'marks'.  With 'reserved' set it does not
+// allocate memory, but stops with 'overflow' set if the reserved room does
+// not suffice.  Then the main thread has to resolve the candidate again
+// without 'reserved' set, which enlarges the resolvents.
+
+typedef struct resolution resolution;
+
+struct resolution {
+  unsigned idx;
+  unsigned lit;
+  bool feasible;
+  bool overflow;
+  bool update;
+  uint64_t limit;
+  uint64_t resolutions;
+  unsigneds resolvents;
+};
+
+bool kissat_prepare_resolution (struct kissat *, unsigned idx,
+                                resolution *);
+void kissat_resolve_concurrently (struct kissat *, value *marks,
+                                  resolution *, bool reserved);
+void kissat_release_resolution (struct kissat *, resolution *);
+
 #endif
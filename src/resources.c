@@ -69,6 +69,48 @@ uint64_t kissat_current_resident_set_size (void) {
 
 #endif
 
+#ifdef __linux__
+
+// Anonymous memory backed by transparent huge pages as reported by the
+// kernel, which on older kernels without 'smaps_rollup' is just zero.
+
+static uint64_t transparent_huge_pages_size (void) {
+  FILE *file = fopen ("/proc/self/smaps_rollup", "r");
+  if (!file)
+    return 0;
+  uint64_t res = 0;
+  char line[128];
+  while (fgets (line, sizeof line, file))
+    if (sscanf (line, "AnonHugePages: %" SCNu64 " kB", &res) == 1)
+      break;
+  fclose (file);
+  return res << 10;
+}
+
+#endif
+
+static void print_page_faults (kissat *solver, double t) {
+  struct rusage u;
+  if (getrusage (RUSAGE_SELF, &u))
+    return;
+  const uint64_t minor = u.ru_minflt;
+  const uint64_t major = u.ru_majflt;
+  printf ("%s"
+          "%-" SFW1 "s "
+          "%" SFW2 PRIu64 " "
+          "%" SFW34 ".0f "
+          "per second\n",
+          solver->prefix, "minor-page-faults:", minor,
+          kissat_average (minor, t));
+  printf ("%s"
+          "%-" SFW1 "s "
+          "%" SFW2 PRIu64 " "
+          "%" SFW34 ".0f "
+          "per second\n",
+          solver->prefix, "major-page-faults:", major,
+          kissat_average (major, t));
+}
+
 void kissat_print_resources (kissat *solver) {
   uint64_t rss = kissat_maximum_resident_set_size ();
   double t = kissat_time (solver);
@@ -80,6 +122,18 @@ void kissat_print_resources (kissat *solver) {
           "MB\n",
           solver->prefix, "maximum-resident-set-size:", rss, "bytes",
           rss / (double) (1 << 20));
+#ifdef __linux__
+  uint64_t huge = transparent_huge_pages_size ();
+  printf ("%s"
+          "%-" SFW1 "s "
+          "%" SFW2 PRIu64 " "
+          "%-" SFW3 "s "
+          "%" SFW4 ".0f "
+          "%%\n",
+          solver->prefix, "transparent-huge-pages:", huge, "bytes",
+          kissat_percent (huge, rss));
+#endif
+  print_page_faults (solver, t);
 #ifdef METRICS
   statistics *statistics = &solver->statistics;
   uint64_t max_allocated = statistics->allocated_max + sizeof (kissat);
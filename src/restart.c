@@ -8,6 +8,7 @@
 #include "print.h"
 #include "reluctant.h"
 #include "report.h"
+#include "share.h"
 
 #include <inttypes.h>
 
@@ -50,11 +51,11 @@ void kissat_update_focused_restart_limit (kissat *solver) {
                             limits->restart.conflicts, delta);
 }
 
-static unsigned reuse_stable_trail (kissat *solver) {
+static unsigned reuse_stable_trail (kissat *solver, unsigned res) {
   const heap *const scores = SCORES;
   const unsigned next_idx = kissat_next_decision_variable (solver);
   const double limit = kissat_get_heap_score (scores, next_idx);
-  unsigned level = solver->level, res = 0;
+  const unsigned level = solver->level;
   while (res < level) {
     frame *f = &FRAME (res + 1);
     const unsigned idx = IDX (f->decision);
@@ -66,12 +67,12 @@ static unsigned reuse_stable_trail (kissat *solver) {
   return res;
 }
 
-static unsigned reuse_focused_trail (kissat *solver) {
+static unsigned reuse_focused_trail (kissat *solver, unsigned res) {
   const links *const links = solver->links;
   const unsigned next_idx = kissat_next_decision_variable (solver);
   const unsigned limit = links[next_idx].stamp;
   LOG ("next decision variable stamp %u", limit);
-  unsigned level = solver->level, res = 0;
+  const unsigned level = solver->level;
   while (res < level) {
     frame *f = &FRAME (res + 1);
     const unsigned idx = IDX (f->decision);
@@ -85,23 +86,30 @@ static unsigned reuse_focused_trail (kissat *solver) {
 
 static unsigned reuse_trail (kissat *solver) {
   assert (solver->level);
-  assert (!EMPTY_STACK (solver->trail));
 
   if (!GET_OPTION (restartreusetrail))
     return 0;
 
+  // Assumption levels would be decided in the same way again and thus are
+  // always reused.  This also covers pseudo decision levels of satisfied
+  // assumptions, which have no literal on the trail (which might even be
+  // empty if all assumptions are satisfied at the root level).
+
+  const unsigned assumed = SIZE_STACK (solver->assumptions);
+  assert (assumed <= solver->level);
+
   unsigned res;
 
   if (solver->stable)
-    res = reuse_stable_trail (solver);
+    res = reuse_stable_trail (solver, assumed);
   else
-    res = reuse_focused_trail (solver);
+    res = reuse_focused_trail (solver, assumed);
 
   LOG ("matching trail level %u", res);
 
-  if (res) {
+  if (res > assumed) {
     INC (restarts_reused_trails);
-    ADD (restarts_reused_levels, res);
+    ADD (restarts_reused_levels, res - assumed);
     LOG ("restart reuses trail at decision level %u", res);
   } else
     LOG ("restarts does not reuse the trail");
@@ -109,7 +117,7 @@ static unsigned reuse_trail (kissat *solver) {
   return res;
 }
 
-void kissat_restart (kissat *solver) {
+int kissat_restart (kissat *solver) {
   START (restart);
   INC (restarts);
   ADD (restarts_levels, solver->level);
@@ -117,15 +125,19 @@ void kissat_restart (kissat *solver) {
     INC (stable_restarts);
   else
     INC (focused_restarts);
-  unsigned level = reuse_trail (solver);
+  const bool importing = kissat_importing_shared (solver);
+  unsigned level = importing ? 0 : reuse_trail (solver);
   kissat_extremely_verbose (solver,
                             "restarting after %" PRIu64 " conflicts"
                             " (limit %" PRIu64 ")",
                             CONFLICTS, solver->limits.restart.conflicts);
   LOG ("restarting to level %u", level);
   kissat_backtrack_in_consistent_state (solver, level);
+  if (importing)
+    kissat_import_shared (solver);
   if (!solver->stable)
     kissat_update_focused_restart_limit (solver);
   REPORT (1, 'R');
   STOP (restart);
+  return solver->inconsistent ? 20 : 0;
 }
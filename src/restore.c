@@ -0,0 +1,74 @@
+#include "restore.h"
+#include "allocate.h"
+#include "inline.h"
+#include "print.h"
+
+void kissat_reactivate_literal (kissat *solver, int elit) {
+  assert (VALID_EXTERNAL_LITERAL (elit));
+  const unsigned eidx = ABS (elit);
+  if (eidx >= SIZE_STACK (solver->import))
+    return;
+  import *import = &PEEK_STACK (solver->import, eidx);
+  if (!import->eliminated)
+    return;
+  assert (import->imported);
+  LOG ("reactivating eliminated external variable %u", eidx);
+  import->lit = 0;
+  import->imported = false;
+  import->eliminated = false;
+  PUSH_STACK (solver->reactivated, eidx);
+  INC (variables_reactivated);
+}
+
+void kissat_restore_clauses (kissat *solver) {
+  if (EMPTY_STACK (solver->reactivated))
+    return;
+  assert (!solver->level);
+  LOG ("restoring clauses of %zu reactivated variables",
+       SIZE_STACK (solver->reactivated));
+  const size_t size_import = SIZE_STACK (solver->import);
+  bool *tainted = kissat_calloc (solver, size_import, sizeof *tainted);
+  for (all_stack (unsigned, eidx, solver->reactivated))
+    tainted[eidx] = true;
+
+  const import *const imports = BEGIN_STACK (solver->import);
+  extension *const begin = BEGIN_STACK (solver->extend);
+  const extension *const end = END_STACK (solver->extend);
+  const extension *p = begin;
+  extension *q = begin;
+  size_t restored = 0;
+
+  while (p != end) {
+    const extension *const witness = p++;
+    assert (witness->blocking);
+    while (p != end && !p->blocking)
+      p++;
+    const unsigned widx = ABS (witness->lit);
+    assert (widx < size_import);
+    if (!tainted[widx]) {
+      for (const extension *r = witness; r != p; r++)
+        *q++ = *r;
+      continue;
+    }
+    for (const extension *r = witness; r != p; r++) {
+      const unsigned eidx = ABS (r->lit);
+      assert (eidx < size_import);
+      if (imports[eidx].eliminated)
+        tainted[eidx] = true;
+    }
+    LOGEXT ((size_t) (p - witness), witness, "restoring");
+    for (const extension *r = witness; r != p; r++)
+      kissat_add (solver, r->lit);
+    kissat_add (solver, 0);
+    INC (clauses_restored);
+    restored++;
+  }
+
+  SET_END_OF_STACK (solver->extend, q);
+  CLEAR_STACK (solver->reactivated);
+  kissat_free (solver, tainted, size_import * sizeof *tainted);
+
+  kissat_very_verbose (solver,
+                       "restored %zu clauses from reconstruction stack",
+                       restored);
+}
@@ -0,0 +1,9 @@
+#ifndef _restore_h_INCLUDED
+#define _restore_h_INCLUDED
+
+struct kissat;
+
+void kissat_reactivate_literal (struct kissat *, int elit);
+void kissat_restore_clauses (struct kissat *);
+
+#endif
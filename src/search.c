@@ -1,6 +1,9 @@
 #include "search.h"
 #include "analyze.h"
+#include "assume.h"
+#include "budget.h"
 #include "bump.h"
+#include "checkpoint.h"
 #include "classify.h"
 #include "decide.h"
 #include "eliminate.h"
@@ -46,29 +49,44 @@ static void start_search (kissat *solver) {
   START (search);
   INC (searches);
 
-  bool stable = (GET_OPTION (stable) == 2);
+  const bool resumed = solver->checkpoint.resumed;
+  bool stable;
+  if (resumed && GET_OPTION (stable) == 1)
+    stable = (solver->limits.mode.count & 1);
+  else
+    stable = (GET_OPTION (stable) == 2);
 
   solver->stable = stable;
   kissat_phase (solver, "search", GET (searches),
-                "initializing %s search after %" PRIu64 " conflicts",
+                "%s %s search after %" PRIu64 " conflicts",
+                (resumed ? "resuming" : "initializing"),
                 (stable ? "stable" : "focus"), CONFLICTS);
 
-  kissat_init_averages (solver, &AVERAGES);
+  if (!resumed)
+    kissat_init_averages (solver, &AVERAGES);
 
   kissat_classify (solver);
 
   if (solver->stable) {
-    kissat_init_reluctant (solver);
+    if (!resumed)
+      kissat_init_reluctant (solver);
     kissat_update_scores (solver);
-  }
+  } else if (resumed)
+    kissat_reset_search_of_queue (solver);
 
   init_tiers (solver);
 
-  kissat_init_limits (solver);
+  if (GET (searches) == 1)
+    kissat_init_limits (solver);
 
-  unsigned seed = GET_OPTION (seed);
-  solver->random = seed;
-  LOG ("initialized random number generator with seed %u", seed);
+  if (resumed) {
+    LOG ("keeping random number generator state of checkpoint");
+    solver->checkpoint.resumed = false;
+  } else {
+    unsigned seed = GET_OPTION (seed);
+    solver->random = seed;
+    LOG ("initialized random number generator with seed %u", seed);
+  }
 
 #ifndef QUIET
   limits *limits = &solver->limits;
@@ -164,6 +182,18 @@ static bool decision_limit_hit (kissat *solver) {
   return true;
 }
 
+static bool memory_limit_hit (kissat *solver) {
+  if (!kissat_memory_exceeded (solver))
+    return false;
+  if (GET_OPTION (reduce) && solver->statistics.clauses_redundant &&
+      solver->last.conflicts.reduce != CONFLICTS)
+    return false;
+  kissat_very_verbose (solver,
+                       "memory limit %s hit after %" PRIu64 " conflicts",
+                       FORMAT_BYTES (solver->limits.memory), CONFLICTS);
+  return true;
+}
+
 static bool searching (kissat *solver) {
   if (!kissat_propagated (solver))
     return true;
@@ -197,16 +227,22 @@ int kissat_search (kissat *solver) {
         res = kissat_analyze (solver, conflict);
       else if (solver->iterating)
         iterate (solver);
+      else if (kissat_assuming (solver))
+        res = kissat_decide_assumption (solver);
       else if (!solver->unassigned)
         res = 10;
       else if (TERMINATED (search_terminated_1))
         break;
+      else if (memory_limit_hit (solver))
+        break;
       else if (kissat_reducing (solver))
         res = kissat_reduce (solver);
       else if (kissat_switching_search_mode (solver))
         kissat_switch_search_mode (solver);
       else if (kissat_restarting (solver))
-        kissat_restart (solver);
+        res = kissat_restart (solver);
+      else if (kissat_checkpointing (solver))
+        kissat_checkpoint (solver);
       else if (kissat_reordering (solver))
         kissat_reorder (solver);
       else if (kissat_rephasing (solver))
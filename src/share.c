@@ -0,0 +1,372 @@
+#include "share.h"
+#include "allocate.h"
+#include "inline.h"
+#include "logging.h"
+#include "print.h"
+
+#include <inttypes.h>
+#include <string.h>
+
+#define LOAD(PTR, ORDER) __atomic_load_n ((PTR), __ATOMIC_##ORDER)
+#define STORE(PTR, VAL, ORDER) \
+  __atomic_store_n ((PTR), (VAL), __ATOMIC_##ORDER)
+#define FENCE(ORDER) __atomic_thread_fence (__ATOMIC_##ORDER)
+
+sharer *kissat_new_sharer (unsigned size, unsigned capacity) {
+  assert (size > 1);
+  assert (capacity && !(capacity & (capacity - 1)));
+  sharer *sharer = kissat_calloc (0, 1, sizeof *sharer);
+  sharer->size = size;
+  sharer->capacity = capacity;
+  sharer->channels = kissat_calloc (0, size, sizeof *sharer->channels);
+  for (unsigned i = 0; i != size; i++)
+    sharer->channels[i].slots =
+        kissat_calloc (0, capacity, sizeof (shared));
+  return sharer;
+}
+
+void kissat_delete_sharer (sharer *sharer) {
+  const unsigned size = sharer->size;
+  const unsigned capacity = sharer->capacity;
+  for (unsigned i = 0; i != size; i++)
+    kissat_dealloc (0, sharer->channels[i].slots, capacity,
+                    sizeof (shared));
+  kissat_dealloc (0, sharer->channels, size, sizeof *sharer->channels);
+  kissat_free (0, sharer, sizeof *sharer);
+}
+
+void kissat_connect_sharer (kissat *solver, sharer *sharer, unsigned id) {
+  sharing *sharing = &solver->sharing;
+  assert (!sharing->sharer);
+  assert (id < sharer->size);
+#ifndef NPROOFS
+  assert (!solver->proof);
+#endif
+  sharing->sharer = sharer;
+  sharing->id = id;
+  sharing->units = SIZE_STACK (solver->units);
+  CALLOC (sharing->read, sharer->size);
+  LOG ("connected as solver %u to %u sharing solvers", id, sharer->size);
+}
+
+void kissat_release_sharing (kissat *solver) {
+  sharing *sharing = &solver->sharing;
+  RELEASE_STACK (sharing->clause);
+  RELEASE_STACK (sharing->pending);
+  if (!sharing->sharer)
+    return;
+  DEALLOC (sharing->read, sharing->sharer->size);
+  sharing->sharer = 0;
+}
+
+static void publish (kissat *solver, unsigned size, unsigned glue,
+                     const int *elits) {
+  sharing *sharing = &solver->sharing;
+  sharer *sharer = sharing->sharer;
+  channel *channel = sharer->channels + sharing->id;
+  const uint64_t written = channel->written;
+  shared *slot = channel->slots + (written & (sharer->capacity - 1));
+  STORE (&slot->stamp, 2 * written + 1, RELAXED);
+  FENCE (RELEASE);
+  STORE (&slot->size, size, RELAXED);
+  STORE (&slot->glue, glue, RELAXED);
+  for (unsigned i = 0; i != size; i++)
+    STORE (slot->lits + i, elits[i], RELAXED);
+  STORE (&slot->stamp, 2 * written + 2, RELEASE);
+  STORE (&channel->written, written + 1, RELEASE);
+  LOGINTS (size, elits, "published glue %u", glue);
+}
+
+static bool sharing_clause (kissat *solver, unsigned size,
+                            unsigned glue) {
+  if (!solver->sharing.sharer)
+    return false;
+  if (size > MAX_SHARED_SIZE)
+    return false;
+  return size < 3 || glue <= (unsigned) GET_OPTION (shareglue);
+}
+
+static bool learning_clause (kissat *solver, unsigned size,
+                             unsigned glue) {
+  const sharing *const sharing = &solver->sharing;
+  if (!sharing->learn.learn)
+    return false;
+  if (size > sharing->learn.max_size)
+    return false;
+  return size < 2 || glue <= sharing->learn.max_glue;
+}
+
+// Exports the external literals on 'solver->sharing.clause' to the sharer
+// and to the learn callback if enabled (which expects it zero terminated).
+
+static void export_clause (kissat *solver, bool share, bool learn,
+                           unsigned glue) {
+  sharing *sharing = &solver->sharing;
+  ints *clause = &sharing->clause;
+  const unsigned size = SIZE_STACK (*clause);
+  if (share)
+    publish (solver, size, glue, BEGIN_STACK (*clause));
+  if (learn) {
+    PUSH_STACK (*clause, 0);
+    int *lits = BEGIN_STACK (*clause);
+    LOGINTS (size, lits, "learn callback glue %u", glue);
+    sharing->learn.learn (sharing->learn.state, glue, lits);
+  }
+  CLEAR_STACK (*clause);
+  INC (exported);
+  if (size == 1)
+    INC (exported_units);
+  else if (size == 2)
+    INC (exported_binaries);
+  else
+    INC (exported_clauses);
+}
+
+static void export_units (kissat *solver) {
+  sharing *sharing = &solver->sharing;
+  const bool share = sharing_clause (solver, 1, 0);
+  const bool learn = learning_clause (solver, 1, 0);
+  const int *const begin = BEGIN_STACK (solver->units);
+  const int *const end = END_STACK (solver->units);
+  const int *p = begin + sharing->units;
+  sharing->units = end - begin;
+  if (!share && !learn)
+    return;
+  while (p != end) {
+    const int elit = *p++;
+    const unsigned eidx = ABS (elit);
+    const import *const import = &PEEK_STACK (solver->import, eidx);
+    if (import->extension)
+      continue;
+    assert (EMPTY_STACK (sharing->clause));
+    PUSH_STACK (sharing->clause, elit);
+    export_clause (solver, share, learn, 0);
+  }
+}
+
+void kissat_export_shared (kissat *solver, unsigned glue) {
+  sharing *sharing = &solver->sharing;
+  if (!sharing->sharer && !sharing->learn.learn)
+    return;
+  export_units (solver);
+  const unsigned size = SIZE_STACK (solver->clause);
+  if (size < 2)
+    return;
+  const bool share = sharing_clause (solver, size, glue);
+  const bool learn = learning_clause (solver, size, glue);
+  if (!share && !learn)
+    return;
+  assert (EMPTY_STACK (sharing->clause));
+  for (all_stack (unsigned, ilit, solver->clause)) {
+    const int elit = kissat_export_literal (solver, ilit);
+    const unsigned eidx = ABS (elit);
+    if (!elit || PEEK_STACK (solver->import, eidx).extension) {
+      CLEAR_STACK (sharing->clause);
+      return;
+    }
+    PUSH_STACK (sharing->clause, elit);
+  }
+  export_clause (solver, share, learn, glue);
+}
+
+// Copies all clauses provided by the import callback to 'pending'.  Each
+// clause is stored with its glue first and zero terminated.
+
+static void poll_import (kissat *solver) {
+  sharing *sharing = &solver->sharing;
+  if (!sharing->import.import)
+    return;
+  for (;;) {
+    unsigned glue = 0;
+    const int *clause =
+        sharing->import.import (sharing->import.state, &glue);
+    if (!clause)
+      break;
+    PUSH_STACK (sharing->pending, (int) glue);
+    const int *p = clause;
+    while (*p)
+      PUSH_STACK (sharing->pending, *p++);
+    PUSH_STACK (sharing->pending, 0);
+  }
+}
+
+bool kissat_importing_shared (kissat *solver) {
+  sharing *sharing = &solver->sharing;
+  poll_import (solver);
+  if (!EMPTY_STACK (sharing->pending))
+    return true;
+  sharer *sharer = sharing->sharer;
+  if (!sharer)
+    return false;
+  const unsigned id = sharing->id;
+  for (unsigned other = 0; other != sharer->size; other++) {
+    if (other == id)
+      continue;
+    const channel *channel = sharer->channels + other;
+    if (LOAD (&channel->written, ACQUIRE) != sharing->read[other])
+      return true;
+  }
+  return false;
+}
+
+// Maps the external literals of a shared clause and simplifies it with
+// respect to root-level assigned literals.  Returns 'false' if the clause
+// can not be imported (satisfied or containing an eliminated, substituted,
+// extension or otherwise inactive variable) and otherwise leaves the
+// remaining literals on 'solver->clause'.  This simplified clause is added
+// unchecked to the checker since it is in general not implied by the
+// clauses of this solver (reverse unit propagation).
+
+static bool import_literals (kissat *solver, unsigned size,
+                             const int *elits) {
+  assert (!solver->level);
+  assert (EMPTY_STACK (solver->clause));
+  const size_t imported = SIZE_STACK (solver->import);
+  const value *const values = solver->values;
+  const flags *const flags = solver->flags;
+  value *marks = solver->marks;
+  bool res = true;
+  for (unsigned i = 0; res && i != size; i++) {
+    const int elit = elits[i];
+    const unsigned eidx = ABS (elit);
+    if (!eidx || eidx >= imported) {
+      res = false;
+      break;
+    }
+    const import *const import = &PEEK_STACK (solver->import, eidx);
+    if (!import->imported || import->eliminated || import->extension) {
+      res = false;
+      break;
+    }
+    unsigned ilit = import->lit;
+    if (elit < 0)
+      ilit = NOT (ilit);
+    const value value = values[ilit];
+    if (value > 0)
+      res = false;
+    else if (value < 0)
+      continue;
+    else if (!flags[IDX (ilit)].active)
+      res = false;
+    else if (marks[NOT (ilit)])
+      res = false;
+    else if (!marks[ilit]) {
+      marks[ilit] = 1;
+      PUSH_STACK (solver->clause, ilit);
+    }
+  }
+  for (all_stack (unsigned, ilit, solver->clause))
+    marks[ilit] = 0;
+  if (!res)
+    CLEAR_STACK (solver->clause);
+  else
+    ADD_UNCHECKED_INTERNAL (SIZE_STACK (solver->clause),
+                            BEGIN_STACK (solver->clause));
+  return res;
+}
+
+static void import_clause (kissat *solver, unsigned size, unsigned glue,
+                           const int *elits) {
+  if (!import_literals (solver, size, elits)) {
+    LOGINTS (size, elits, "skipping shared");
+    INC (imported_skipped);
+    return;
+  }
+  const unsigned *const lits = BEGIN_STACK (solver->clause);
+  const unsigned simplified = SIZE_STACK (solver->clause);
+  LOGINTS (size, elits, "importing shared glue %u", glue);
+  if (!simplified) {
+    LOG ("imported clause root-level falsified");
+    solver->inconsistent = true;
+    CHECK_AND_ADD_EMPTY ();
+    ADD_EMPTY_TO_PROOF ();
+  } else if (simplified == 1) {
+    kissat_learned_unit (solver, lits[0]);
+    INC (imported_units);
+  } else if (simplified == 2) {
+    kissat_new_binary_clause (solver, lits[0], lits[1]);
+    INC (imported_binaries);
+  } else {
+    if (!glue || glue >= simplified)
+      glue = simplified - 1;
+    const reference ref = kissat_new_redundant_clause (solver, glue);
+    clause *c = kissat_dereference_clause (solver, ref);
+    c->used = 1;
+    INC (imported_clauses);
+  }
+  INC (imported);
+  CLEAR_STACK (solver->clause);
+}
+
+static void import_pending (kissat *solver) {
+  sharing *sharing = &solver->sharing;
+  const int *p = BEGIN_STACK (sharing->pending);
+  const int *const end = END_STACK (sharing->pending);
+  while (!solver->inconsistent && p != end) {
+    const unsigned glue = *p++;
+    const int *const elits = p;
+    while (*p)
+      p++;
+    import_clause (solver, p++ - elits, glue, elits);
+  }
+  CLEAR_STACK (sharing->pending);
+}
+
+static void import_channel (kissat *solver, unsigned other) {
+  sharing *sharing = &solver->sharing;
+  sharer *sharer = sharing->sharer;
+  const uint64_t capacity = sharer->capacity;
+  channel *channel = sharer->channels + other;
+  uint64_t read = sharing->read[other];
+  const uint64_t written = LOAD (&channel->written, ACQUIRE);
+  if (written - read > capacity) {
+    const uint64_t lost = written - read - capacity;
+    LOG ("lost %" PRIu64 " overwritten shared clauses of solver %u", lost,
+         other);
+    ADD (imported_lost, lost);
+    read = written - capacity;
+  }
+  int elits[MAX_SHARED_SIZE];
+  while (!solver->inconsistent && read != written) {
+    const shared *slot = channel->slots + (read & (capacity - 1));
+    const uint64_t stamp = 2 * read + 2;
+    read++;
+    if (LOAD (&slot->stamp, ACQUIRE) != stamp) {
+      INC (imported_lost);
+      continue;
+    }
+    const unsigned size = LOAD (&slot->size, RELAXED);
+    const unsigned glue = LOAD (&slot->glue, RELAXED);
+    assert (size <= MAX_SHARED_SIZE);
+    for (unsigned i = 0; i != size; i++)
+      elits[i] = LOAD (slot->lits + i, RELAXED);
+    FENCE (ACQUIRE);
+    if (LOAD (&slot->stamp, RELAXED) != stamp) {
+      INC (imported_lost);
+      continue;
+    }
+    import_clause (solver, size, glue, elits);
+  }
+  sharing->read[other] = read;
+}
+
+void kissat_import_shared (kissat *solver) {
+  sharing *sharing = &solver->sharing;
+  assert (!solver->level);
+#ifndef QUIET
+  const uint64_t before = solver->statistics.imported;
+#endif
+  export_units (solver);
+  import_pending (solver);
+  if (sharing->sharer) {
+    const unsigned size = sharing->sharer->size;
+    for (unsigned delta = 1; !solver->inconsistent && delta != size;
+         delta++)
+      import_channel (solver, (sharing->id + delta) % size);
+  }
+  sharing->units = SIZE_STACK (solver->units);
+#ifndef QUIET
+  kissat_extremely_verbose (solver, "imported %" PRIu64 " shared clauses",
+                            solver->statistics.imported - before);
+#endif
+}
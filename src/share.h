@@ -0,0 +1,75 @@
+#ifndef _share_h_INCLUDED
+#define _share_h_INCLUDED
+
+#include "stack.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Clauses are exchanged between solvers in external literals through one
+// single-producer multiple-consumer ring buffer ('channel') per solver.
+// Slots have a fixed size which keeps the lock-free protocol simple.  A
+// slot is guarded by a sequence 'stamp' (odd while being written) and a
+// consumer which is overtaken by the producer just skips the lost slots.
+// Independently, learned clauses can be exported to and imported from the
+// outside through the 'kissat_set_learn' and 'kissat_set_import' API
+// callbacks, which are handled here too.
+
+#define MAX_SHARED_SIZE 32
+
+typedef struct shared shared;
+typedef struct channel channel;
+typedef struct sharer sharer;
+typedef struct sharing sharing;
+
+struct shared {
+  uint64_t stamp;
+  unsigned size;
+  unsigned glue;
+  int lits[MAX_SHARED_SIZE];
+};
+
+struct channel {
+  uint64_t written;
+  shared *slots;
+};
+
+struct sharer {
+  unsigned size;
+  unsigned capacity;
+  channel *channels;
+};
+
+struct sharing {
+  sharer *sharer;
+  unsigned id;
+  size_t units;
+  uint64_t *read;
+  struct {
+    void *state;
+    unsigned max_size;
+    unsigned max_glue;
+    void (*learn) (void *, unsigned, int *);
+  } learn;
+  struct {
+    void *state;
+    int *(*import) (void *, unsigned *);
+  } import;
+  ints clause;
+  ints pending;
+};
+
+struct kissat;
+
+sharer *kissat_new_sharer (unsigned size, unsigned capacity);
+void kissat_delete_sharer (sharer *);
+
+void kissat_connect_sharer (struct kissat *, sharer *, unsigned id);
+void kissat_release_sharing (struct kissat *);
+
+void kissat_export_shared (struct kissat *, unsigned glue);
+bool kissat_importing_shared (struct kissat *);
+void kissat_import_shared (struct kissat *);
+
+#endif
@@ -9,7 +9,7 @@ static void reset_shrinkable (kissat *solver) {
 #endif
   while (!EMPTY_STACK (solver->shrinkable)) {
     const unsigned idx = POP_STACK (solver->shrinkable);
-    assigned *a = solver->assigned + idx;
+    struct analysis *a = solver->analysis + idx;
     assert (a->shrinkable);
     a->shrinkable = false;
 #ifdef LOGGING
@@ -23,10 +23,10 @@ static void mark_shrinkable_as_removable (kissat *solver) {
 #ifdef LOGGING
   size_t marked = 0, reset = 0;
 #endif
-  struct assigned *assigned = solver->assigned;
+  analysis *analysis = solver->analysis;
   while (!EMPTY_STACK (solver->shrinkable)) {
     const unsigned idx = POP_STACK (solver->shrinkable);
-    struct assigned *a = assigned + idx;
+    struct analysis *a = analysis + idx;
     assert (a->shrinkable);
     a->shrinkable = false;
     assert (!a->poisoned);
@@ -35,7 +35,7 @@ static void mark_shrinkable_as_removable (kissat *solver) {
 #endif
     if (a->removable)
       continue;
-    kissat_push_removable (solver, assigned, idx);
+    kissat_push_removable (solver, analysis, idx);
 #ifdef LOGGING
     marked++;
 #endif
@@ -56,12 +56,13 @@ static inline int shrink_literal (kissat *solver, assigned *assigned,
     LOG2 ("skipping root level assigned %s", LOGLIT (lit));
     return 0;
   }
-  if (a->shrinkable) {
+  struct analysis *m = solver->analysis + idx;
+  if (m->shrinkable) {
     LOG2 ("skipping already shrinkable literal %s", LOGLIT (lit));
     return 0;
   }
   if (a->level < level) {
-    if (a->removable) {
+    if (m->removable) {
       LOG2 ("skipping removable thus shrinkable %s", LOGLIT (lit));
       return 0;
     }
@@ -76,7 +77,7 @@ static inline int shrink_literal (kissat *solver, assigned *assigned,
     return -1;
   }
   LOG2 ("marking %s as shrinkable", LOGLIT (lit));
-  a->shrinkable = true;
+  m->shrinkable = true;
   PUSH_STACK (solver->shrinkable, idx);
   return 1;
 }
@@ -126,10 +127,9 @@ static inline unsigned shrunken_block (kissat *solver, unsigned level,
          LOGLIT (not_uip));
 #endif
   const unsigned uip_idx = IDX (uip);
-  assigned *assigned = solver->assigned;
-  struct assigned *a = assigned + uip_idx;
-  if (!a->analyzed)
-    kissat_push_analyzed (solver, assigned, uip_idx);
+  analysis *analysis = solver->analysis;
+  if (!analysis[uip_idx].analyzed)
+    kissat_push_analyzed (solver, analysis, uip_idx);
 
   mark_shrinkable_as_removable (solver);
 #ifndef LOGGING
@@ -201,7 +201,7 @@ static inline unsigned shrink_along_reason (kissat *solver,
   unsigned open = 0;
   const unsigned uip_idx = IDX (uip);
   struct assigned *a = assigned + uip_idx;
-  assert (a->shrinkable);
+  assert (solver->analysis[uip_idx].shrinkable);
   assert (a->level == level);
   assert (a->reason != DECISION_REASON);
   if (a->binary) {
@@ -231,6 +231,7 @@ static inline unsigned shrink_block (kissat *solver, unsigned *begin_block,
   LOG ("maximum trail position %u on level %u", max_trail, level);
 
   assigned *assigned = solver->assigned;
+  const analysis *const analysis = solver->analysis;
 
   push_literals_of_block (solver, assigned, begin_block, end_block, level);
 
@@ -248,7 +249,7 @@ static inline unsigned shrink_block (kissat *solver, unsigned *begin_block,
     {
       do
         assert (begin_trail <= t), uip = *t--;
-      while (!assigned[IDX (uip)].shrinkable);
+      while (!analysis[IDX (uip)].shrinkable);
     }
     if (open == 1)
       break;
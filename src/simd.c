@@ -0,0 +1,129 @@
+#include "simd.h"
+
+#ifdef KISSAT_AVX2
+
+#include <immintrin.h>
+
+bool kissat_simd_supported (void) {
+  return __builtin_cpu_supports ("avx2");
+}
+
+// The gather reads four bytes starting at the value of each literal and
+// thus relies on the 'VALUES_PADDING' bytes after the last literal.  Only
+// the sign bit of the lowest byte is used, which is set for false values.
+
+__attribute__ ((target ("avx2"))) unsigned *
+kissat_avx2_find_non_false (const value *values, unsigned *begin,
+                            const unsigned *end) {
+  const int *const base = (const int *) values;
+  unsigned *p = begin;
+  while (end - p >= 8) {
+    const __m256i lits = _mm256_loadu_si256 ((const __m256i *) p);
+    const __m256i words = _mm256_i32gather_epi32 (base, lits, 1);
+    const __m256i signs = _mm256_slli_epi32 (words, 24);
+    const unsigned mask = _mm256_movemask_ps (_mm256_castsi256_ps (signs));
+    if (mask != 0xff)
+      return p + __builtin_ctz (~mask);
+    p += 8;
+  }
+  while (p != end && values[*p] < 0)
+    p++;
+  return p;
+}
+
+// Counts are gathered with four byte scale, since clause references fit
+// into 31 bits and thus are valid signed indices.
+
+__attribute__ ((target ("avx2"))) unsigned
+kissat_avx2_count_critical (const unsigned *counts, const unsigned *begin,
+                            const unsigned *end) {
+  const int *const base = (const int *) counts;
+  const __m256i ones = _mm256_set1_epi32 (1);
+  __m256i sums = _mm256_setzero_si256 ();
+  const unsigned *p = begin;
+  while (end - p >= 8) {
+    const __m256i refs = _mm256_loadu_si256 ((const __m256i *) p);
+    const __m256i words = _mm256_i32gather_epi32 (base, refs, 4);
+    const __m256i critical = _mm256_cmpeq_epi32 (words, ones);
+    sums = _mm256_sub_epi32 (sums, critical);
+    p += 8;
+  }
+  const __m128i low = _mm256_castsi256_si128 (sums);
+  const __m128i high = _mm256_extracti128_si256 (sums, 1);
+  __m128i sum = _mm_add_epi32 (low, high);
+  sum = _mm_add_epi32 (sum, _mm_shuffle_epi32 (sum, 0x4e));
+  sum = _mm_add_epi32 (sum, _mm_shuffle_epi32 (sum, 0xb1));
+  unsigned res = _mm_cvtsi128_si32 (sum);
+  while (p != end)
+    res += (counts[*p++] == 1);
+  return res;
+}
+
+#else
+
+bool kissat_simd_supported (void) { return false; }
+
+#endif
+
+#ifdef STAND_ALONE_SIMD
+
+// Micro-benchmark of the break value kernel of local search, compiled with
+// 'make simd' in the build directory.  Each round computes the break values
+// of the literals of a random clause of size four, each with a random
+// occurrence list of 32 references.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_OCCURRENCES (1u << 16)
+#define BENCH_CLAUSES (1u << 18)
+#define BENCH_ROUNDS 200000
+
+static double bench_count_critical (bool simd, const unsigned *counts,
+                                    const unsigned *refs,
+                                    unsigned *checksum) {
+  const clock_t start = clock ();
+  unsigned res = 0;
+  for (unsigned round = 0; round < BENCH_ROUNDS; round++)
+    for (unsigned i = 0; i < 4; i++) {
+      const unsigned offset = (round * 4 + i) * 32 % BENCH_OCCURRENCES;
+      const unsigned *begin = refs + offset;
+      res += kissat_count_critical (simd, counts, begin, begin + 32);
+    }
+  *checksum = res;
+  return (clock () - start) / (double) CLOCKS_PER_SEC;
+}
+
+int main (void) {
+  unsigned *counts = malloc (BENCH_CLAUSES * sizeof *counts);
+  unsigned *refs = malloc (BENCH_OCCURRENCES * sizeof *refs);
+  if (!counts || !refs) {
+    fputs ("simd: error: out-of-memory\n", stderr);
+    return 1;
+  }
+  srand (42);
+  for (unsigned i = 0; i < BENCH_CLAUSES; i++)
+    counts[i] = rand () % 4;
+  for (unsigned i = 0; i < BENCH_OCCURRENCES; i++)
+    refs[i] = rand () % BENCH_CLAUSES;
+  unsigned scalar_checksum, vector_checksum;
+  const double scalar =
+      bench_count_critical (false, counts, refs, &scalar_checksum);
+  const double vector = bench_count_critical (
+      kissat_simd_supported (), counts, refs, &vector_checksum);
+  free (counts);
+  free (refs);
+  if (scalar_checksum != vector_checksum) {
+    fprintf (stderr, "simd: error: checksum mismatch %u and %u\n",
+             scalar_checksum, vector_checksum);
+    return 1;
+  }
+  printf ("scalar break values %.0f flips per second\n",
+          scalar > 0 ? BENCH_ROUNDS / scalar : 0);
+  printf ("vectorized break values %.0f flips per second\n",
+          vector > 0 ? BENCH_ROUNDS / vector : 0);
+  return 0;
+}
+
+#endif
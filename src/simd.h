@@ -0,0 +1,70 @@
+#ifndef _simd_h_INCLUDED
+#define _simd_h_INCLUDED
+
+#include "value.h"
+
+#include <stdbool.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && \
+    !defined(NSIMD)
+#define KISSAT_AVX2
+#endif
+
+// Vectorized search is only worth it if at least this many literals
+// remain to be checked.  Shorter ranges use the scalar loop.
+
+#define SIMD_MIN_LITERALS 8
+
+#ifdef KISSAT_AVX2
+unsigned *kissat_avx2_find_non_false (const value *, unsigned *begin,
+                                      const unsigned *end);
+unsigned kissat_avx2_count_critical (const unsigned *counts,
+                                     const unsigned *begin,
+                                     const unsigned *end);
+#endif
+
+bool kissat_simd_supported (void);
+
+// Find the first literal in '[begin,end)' which is not false and return
+// 'end' if there is none.  This is the replacement literal search of
+// watched large clauses during propagation, which is vectorized with
+// AVX2 gathers of the values of eight literals if 'simd' is set.
+
+static inline unsigned *kissat_find_non_false (bool simd,
+                                               const value *values,
+                                               unsigned *begin,
+                                               const unsigned *end) {
+#ifdef KISSAT_AVX2
+  if (simd && end - begin >= SIMD_MIN_LITERALS)
+    return kissat_avx2_find_non_false (values, begin, end);
+#else
+  (void) simd;
+#endif
+  unsigned *p = begin;
+  while (p != end && values[*p] < 0)
+    p++;
+  return p;
+}
+
+// Count the references in '[begin,end)' to clauses with exactly one true
+// literal, i.e., the break value of a literal in local search, where the
+// references are the occurrences of its negation.  The vectorized version
+// gathers the counts of eight references at once.
+
+static inline unsigned kissat_count_critical (bool simd,
+                                              const unsigned *counts,
+                                              const unsigned *begin,
+                                              const unsigned *end) {
+#ifdef KISSAT_AVX2
+  if (simd && end - begin >= SIMD_MIN_LITERALS)
+    return kissat_avx2_count_critical (counts, begin, end);
+#else
+  (void) simd;
+#endif
+  unsigned res = 0;
+  for (const unsigned *p = begin; p != end; p++)
+    res += (counts[*p] == 1);
+  return res;
+}
+
+#endif
@@ -0,0 +1,470 @@
+#include "snapshot.h"
+#include "allocate.h"
+#include "check.h"
+#include "error.h"
+#include "import.h"
+#include "inline.h"
+#include "keatures.h"
+#include "pages.h"
+#include "print.h"
+#include "propsearch.h"
+#include "require.h"
+#include "resize.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef KISSAT_HAS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// A snapshot stores the irredundant formula of a solver right after
+// parsing in native layout.  The fixed size header is followed by the
+// external index of each internal variable, the root level units, the
+// binary clauses as literal pairs and finally, aligned to the size of
+// arena words, the large clauses exactly as they are stored in the arena.
+// Loading maps the file, imports the variables in the same order and
+// copies the arena in one go, thus bypassing 'kissat_add' completely.
+
+#define SNAPSHOT_MAGIC "kissnap"
+#define SNAPSHOT_VERSION 1
+#define SNAPSHOT_ENDIAN 0x01020304u
+
+typedef struct snapshot snapshot;
+typedef struct snapshot_header snapshot_header;
+
+struct snapshot_header {
+  char magic[8];
+  uint32_t version;
+  uint32_t endian;
+  uint32_t ward_bytes;
+  uint32_t clause_bytes;
+  uint32_t max_var;
+  uint32_t variables;
+  uint32_t inconsistent;
+  uint32_t units;
+  uint64_t binaries;
+  uint64_t clauses;
+  uint64_t words;
+};
+
+struct snapshot {
+  char *bytes;
+  size_t size;
+  size_t allocated;
+  bool mapped;
+};
+
+static bool write_bytes (FILE *file, const void *ptr, size_t bytes) {
+  return fwrite (ptr, 1, bytes, file) == bytes;
+}
+
+// Padding is written explicitly as zero bytes, since the arena contains
+// uninitialized bytes after the last literal of clauses, which otherwise
+// would make snapshots of the same formula differ.
+
+static bool write_padding (FILE *file, size_t bytes) {
+  static const ward zero;
+  assert (bytes < sizeof zero);
+  return write_bytes (file, &zero, bytes);
+}
+
+static bool write_units (kissat *solver, FILE *file, bool count_only,
+                         unsigned *units_ptr) {
+  const value *const values = solver->values;
+  unsigned units = 0;
+  for (all_variables (idx)) {
+    unsigned lit = LIT (idx);
+    const value value = values[lit];
+    if (!value)
+      continue;
+    if (value < 0)
+      lit = NOT (lit);
+    if (!count_only && !write_bytes (file, &lit, sizeof lit))
+      return false;
+    units++;
+  }
+  *units_ptr = units;
+  return true;
+}
+
+static bool write_binaries (kissat *solver, FILE *file, bool count_only,
+                            uint64_t *binaries_ptr) {
+  uint64_t binaries = 0;
+  for (all_literals (lit))
+    for (all_binary_blocking_watches (watch, WATCHES (lit)))
+      if (watch.type.binary) {
+        const unsigned other = watch.binary.lit;
+        if (other < lit)
+          continue;
+        if (!count_only) {
+          const unsigned pair[2] = {lit, other};
+          if (!write_bytes (file, pair, sizeof pair))
+            return false;
+        }
+        binaries++;
+      }
+  *binaries_ptr = binaries;
+  return true;
+}
+
+static bool write_clauses (kissat *solver, FILE *file, bool count_only,
+                           uint64_t *clauses_ptr, uint64_t *words_ptr) {
+  uint64_t clauses = 0, words = 0;
+  for (all_clauses (c))
+    if (!c->garbage && !c->redundant) {
+      const size_t bytes = kissat_bytes_of_clause (c->size);
+      const size_t used = (char *) END_LITS (c) - (char *) c;
+      if (!count_only && (!write_bytes (file, c, used) ||
+                          !write_padding (file, bytes - used)))
+        return false;
+      words += bytes / sizeof (ward);
+      clauses++;
+    }
+  *clauses_ptr = clauses;
+  *words_ptr = words;
+  return true;
+}
+
+static size_t padding_bytes (size_t offset) {
+  return kissat_align_ward (offset) - offset;
+}
+
+bool kissat_write_snapshot (kissat *solver, int max_var,
+                            const char *path) {
+  assert (!solver->level);
+  assert (solver->watching);
+  assert (0 <= max_var);
+  assert ((size_t) max_var + 1 >= SIZE_STACK (solver->import));
+  assert (SIZE_STACK (solver->export) == VARS);
+  FILE *file = fopen (path, "wb");
+  if (!file)
+    return false;
+  snapshot_header header;
+  memset (&header, 0, sizeof header);
+  memcpy (header.magic, SNAPSHOT_MAGIC, sizeof header.magic);
+  header.version = SNAPSHOT_VERSION;
+  header.endian = SNAPSHOT_ENDIAN;
+  header.ward_bytes = sizeof (ward);
+  header.clause_bytes = sizeof (clause);
+  header.max_var = max_var;
+  header.variables = VARS;
+  header.inconsistent = solver->inconsistent;
+  if (!solver->inconsistent) {
+    (void) write_units (solver, 0, true, &header.units);
+    (void) write_binaries (solver, 0, true, &header.binaries);
+    (void) write_clauses (solver, 0, true, &header.clauses,
+                          &header.words);
+  }
+  size_t offset = sizeof header;
+  offset += VARS * sizeof (int);
+  offset += header.units * sizeof (unsigned);
+  offset += header.binaries * 2 * sizeof (unsigned);
+  uint64_t binaries, clauses, words;
+  unsigned units;
+  bool ok = write_bytes (file, &header, sizeof header) &&
+            write_bytes (file, BEGIN_STACK (solver->export),
+                         VARS * sizeof (int));
+  if (ok && !solver->inconsistent)
+    ok = write_units (solver, file, false, &units) &&
+         write_binaries (solver, file, false, &binaries);
+  if (ok)
+    ok = write_padding (file, padding_bytes (offset));
+  if (ok && !solver->inconsistent)
+    ok = write_clauses (solver, file, false, &clauses, &words);
+  if (fclose (file))
+    ok = false;
+  if (ok)
+    kissat_message (solver,
+                    "wrote snapshot with %u variables "
+                    "%" PRIu64 " binary and %" PRIu64 " large clauses",
+                    header.variables, header.binaries, header.clauses);
+  return ok;
+}
+
+static const char *map_snapshot (kissat *solver, const char *path,
+                                 snapshot *snapshot) {
+  memset (snapshot, 0, sizeof *snapshot);
+#ifdef KISSAT_HAS_MMAP
+  const int fd = open (path, O_RDONLY);
+  if (fd < 0)
+    return "can not open snapshot";
+  struct stat buf;
+  if (!fstat (fd, &buf) && S_ISREG (buf.st_mode) && buf.st_size > 0 &&
+      (off_t) (size_t) buf.st_size == buf.st_size) {
+    const size_t size = buf.st_size;
+    void *bytes = mmap (0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (bytes != MAP_FAILED) {
+      close (fd);
+      snapshot->bytes = bytes;
+      snapshot->size = size;
+      snapshot->mapped = true;
+      return 0;
+    }
+  }
+  close (fd);
+#endif
+  FILE *file = fopen (path, "rb");
+  if (!file)
+    return "can not open snapshot";
+  size_t allocated = 1u << 16, size = 0;
+  char *bytes = kissat_malloc (solver, allocated);
+  for (;;) {
+    if (size == allocated) {
+      bytes = kissat_realloc (solver, bytes, allocated, 2 * allocated);
+      allocated *= 2;
+    }
+    const size_t bytes_read =
+        fread (bytes + size, 1, allocated - size, file);
+    if (!bytes_read)
+      break;
+    size += bytes_read;
+  }
+  const bool failed = ferror (file);
+  fclose (file);
+  snapshot->bytes = bytes;
+  snapshot->size = size;
+  snapshot->allocated = allocated;
+  return failed ? "reading snapshot failed" : 0;
+}
+
+static void unmap_snapshot (kissat *solver, snapshot *snapshot) {
+#ifdef KISSAT_HAS_MMAP
+  if (snapshot->mapped) {
+    munmap (snapshot->bytes, snapshot->size);
+    return;
+  }
+#endif
+  kissat_free (solver, snapshot->bytes, snapshot->allocated);
+}
+
+static void add_original_clause (kissat *solver, ints *literals,
+                                 size_t size, const unsigned *lits) {
+#ifndef NDEBUG
+  const bool checking = kissat_checking (solver);
+#else
+  const bool checking = false;
+#endif
+  if (!literals && !checking)
+    return;
+  for (size_t i = 0; i != size; i++) {
+    const int elit = kissat_export_literal (solver, lits[i]);
+    if (literals)
+      PUSH_STACK (*literals, elit);
+#ifndef NDEBUG
+    if (checking)
+      PUSH_STACK (solver->original, elit);
+#endif
+  }
+  if (literals)
+    PUSH_STACK (*literals, 0);
+#ifndef NDEBUG
+  if (checking) {
+    const size_t offset = solver->offset_of_last_original_clause;
+    const int *const elits = BEGIN_STACK (solver->original) + offset;
+    ADD_UNCHECKED_EXTERNAL (size, elits);
+    PUSH_STACK (solver->original, 0);
+    solver->offset_of_last_original_clause =
+        SIZE_STACK (solver->original);
+  }
+#endif
+}
+
+static void snapshot_inconsistent (kissat *solver, ints *literals) {
+  if (solver->inconsistent)
+    return;
+  LOG ("snapshot is inconsistent");
+  add_original_clause (solver, literals, 0, 0);
+  solver->inconsistent = true;
+  CHECK_AND_ADD_EMPTY ();
+}
+
+static const char *load_snapshot (kissat *solver, const snapshot *snapshot,
+                                  int *max_var_ptr, ints *literals) {
+  const char *const bytes = snapshot->bytes;
+  const size_t size = snapshot->size;
+  const snapshot_header *const header = (snapshot_header *) bytes;
+  if (size < sizeof *header)
+    return "truncated snapshot header";
+  if (memcmp (header->magic, SNAPSHOT_MAGIC, sizeof header->magic))
+    return "invalid snapshot signature";
+  if (header->endian != SNAPSHOT_ENDIAN)
+    return "snapshot written with different byte order";
+  if (header->version != SNAPSHOT_VERSION)
+    return "unsupported snapshot version";
+  if (header->ward_bytes != sizeof (ward) ||
+      header->clause_bytes != sizeof (clause))
+    return "snapshot written with incompatible clause layout";
+  if (header->max_var > EXTERNAL_MAX_VAR)
+    return "invalid maximum variable in snapshot";
+  const unsigned variables = header->variables;
+  if (variables > header->max_var)
+    return "too many variables in snapshot";
+  if (header->units > variables)
+    return "too many units in snapshot";
+
+  size_t offset = sizeof *header;
+  const int *const exports = (int *) (bytes + offset);
+  if ((size - offset) / sizeof (int) < variables)
+    return "truncated snapshot variables";
+  offset += variables * sizeof (int);
+  const unsigned *const units = (unsigned *) (bytes + offset);
+  if ((size - offset) / sizeof (unsigned) < header->units)
+    return "truncated snapshot units";
+  offset += header->units * sizeof (unsigned);
+  const unsigned *const binaries = (unsigned *) (bytes + offset);
+  if ((size - offset) / (2 * sizeof (unsigned)) < header->binaries)
+    return "truncated snapshot binary clauses";
+  offset += header->binaries * 2 * sizeof (unsigned);
+  offset = kissat_align_ward (offset);
+  if (offset > size || (size - offset) / sizeof (ward) < header->words)
+    return "truncated snapshot large clauses";
+  if (header->words > MAX_ARENA)
+    return "snapshot arena too large";
+  const char *const words = bytes + offset;
+  offset += header->words * sizeof (ward);
+  if (offset != size)
+    return "trailing data in snapshot";
+
+  *max_var_ptr = header->max_var;
+  kissat_increase_size (solver, variables);
+  for (unsigned idx = 0; idx != variables; idx++) {
+    if (exports[idx] <= 0 || (unsigned) exports[idx] > header->max_var)
+      return "invalid variable in snapshot";
+    const unsigned eidx = exports[idx];
+    if (eidx < SIZE_STACK (solver->import) &&
+        PEEK_STACK (solver->import, eidx).imported)
+      return "duplicated variable in snapshot";
+    const unsigned lit = kissat_import_original_variable (solver, eidx);
+    assert (lit == LIT (idx));
+    kissat_activate_literal (solver, lit);
+  }
+  if (header->inconsistent) {
+    snapshot_inconsistent (solver, literals);
+    return 0;
+  }
+
+  for (unsigned i = 0; i != header->units; i++) {
+    const unsigned unit = units[i];
+    if (unit >= LITS)
+      return "invalid unit in snapshot";
+    add_original_clause (solver, literals, 1, &unit);
+    const value value = VALUE (unit);
+    if (value > 0)
+      continue;
+    if (value < 0) {
+      snapshot_inconsistent (solver, literals);
+      return 0;
+    }
+    kissat_original_unit (solver, unit);
+  }
+
+  for (uint64_t i = 0; i != header->binaries; i++) {
+    const unsigned *const pair = binaries + 2 * i;
+    const unsigned a = pair[0], b = pair[1];
+    if (a >= LITS || b >= LITS)
+      return "invalid binary clause in snapshot";
+    if (a == b)
+      return "duplicated literal in snapshot binary clause";
+    if (a == NOT (b))
+      return "complementary literals in snapshot binary clause";
+    add_original_clause (solver, literals, 2, pair);
+    kissat_watch_binary (solver, a, b);
+  }
+  ADD (clauses_binary, header->binaries);
+
+  assert (EMPTY_STACK (solver->arena));
+  while (CAPACITY_STACK (solver->arena) < header->words)
+    kissat_stack_enlarge (solver, (chars *) &solver->arena, sizeof (ward));
+  kissat_advise_pages (solver, BEGIN_STACK (solver->arena),
+                       CAPACITY_STACK (solver->arena) * sizeof (ward));
+  memcpy (BEGIN_STACK (solver->arena), words,
+          header->words * sizeof (ward));
+  solver->arena.end = solver->arena.begin + header->words;
+
+  ward *const begin = BEGIN_STACK (solver->arena);
+  ward *const end = END_STACK (solver->arena);
+  mark *const marks = solver->marks;
+  reference last = INVALID_REF;
+  uint64_t clauses = 0;
+  for (ward *p = begin; p != end;) {
+    if ((size_t) (end - p) * sizeof (ward) < sizeof (clause))
+      return "truncated clause in snapshot";
+    clause *c = (clause *) p;
+    const unsigned size = c->size;
+    if (size < 3)
+      return "invalid clause size in snapshot";
+    const size_t needed = kissat_bytes_of_clause (size) / sizeof (ward);
+    if ((size_t) (end - p) < needed)
+      return "truncated clause in snapshot";
+    for (all_literals_in_clause (lit, c))
+      if (lit >= LITS)
+        return "invalid literal in snapshot";
+    const char *error = 0;
+    for (all_literals_in_clause (lit, c)) {
+      if (marks[lit]) {
+        error = "duplicated literal in snapshot clause";
+        break;
+      }
+      if (marks[NOT (lit)]) {
+        error = "complementary literals in snapshot clause";
+        break;
+      }
+      marks[lit] = 1;
+    }
+    for (all_literals_in_clause (lit, c))
+      marks[lit] = 0;
+    if (error)
+      return error;
+    c->glue = 0;
+    c->garbage = false;
+    c->quotient = false;
+    c->reason = false;
+    c->redundant = false;
+    c->shrunken = false;
+    c->subsume = false;
+    c->swept = false;
+    c->vivify = false;
+    c->used = 0;
+    c->searched = 2;
+    add_original_clause (solver, literals, size, c->lits);
+    last = p - begin;
+    p += needed;
+    clauses++;
+  }
+  if (clauses != header->clauses)
+    return "inconsistent number of large clauses in snapshot";
+  solver->last_irredundant = last;
+  ADD (clauses_irredundant, clauses);
+  ADD (clauses_original, header->binaries + clauses);
+  ADD (clauses_added, header->binaries + clauses);
+  kissat_watch_large_clauses (solver);
+
+  if (!EMPTY_ARRAY (solver->trail))
+    (void) kissat_search_propagate (solver);
+
+  kissat_message (solver,
+                  "read snapshot with %u variables "
+                  "%" PRIu64 " binary and %" PRIu64 " large clauses",
+                  variables, header->binaries, clauses);
+  return 0;
+}
+
+const char *kissat_read_snapshot (kissat *solver, const char *path,
+                                  int *max_var_ptr, ints *literals) {
+  assert (EMPTY_STACK (solver->import));
+#ifndef NPROOFS
+  kissat_require (!solver->proof, "can not read snapshot with proof");
+#endif
+  snapshot snapshot;
+  const char *error = map_snapshot (solver, path, &snapshot);
+  if (!error)
+    error = load_snapshot (solver, &snapshot, max_var_ptr, literals);
+  if (snapshot.bytes)
+    unmap_snapshot (solver, &snapshot);
+  return error;
+}
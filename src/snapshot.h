@@ -0,0 +1,15 @@
+#ifndef _snapshot_h_INCLUDED
+#define _snapshot_h_INCLUDED
+
+#include "stack.h"
+
+#include <stdbool.h>
+
+struct kissat;
+
+bool kissat_write_snapshot (struct kissat *, int max_var,
+                            const char *path);
+const char *kissat_read_snapshot (struct kissat *, const char *path,
+                                  int *max_var_ptr, ints *literals);
+
+#endif
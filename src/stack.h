@@ -51,6 +51,22 @@
     *(S).end++ = (E); \
   } while (0)
 
+// Reserves room for exactly 'N' elements (if there is less room) without
+// rounding up to a power of two, which 'SHRINK_STACK' would expect.
+
+#define RESERVE_STACK(S, N) \
+  do { \
+    const size_t TMP_N = (N); \
+    const size_t TMP_CAPACITY = CAPACITY_STACK (S); \
+    if (TMP_CAPACITY >= TMP_N) \
+      break; \
+    const size_t TMP_SIZE = SIZE_STACK (S); \
+    (S).begin = kissat_nrealloc (solver, (S).begin, TMP_CAPACITY, TMP_N, \
+                                 sizeof *(S).begin); \
+    (S).end = (S).begin + TMP_SIZE; \
+    (S).allocated = (S).begin + TMP_N; \
+  } while (0)
+
 #define BEGIN_STACK(S) (S).begin
 
 #define END_STACK(S) (S).end
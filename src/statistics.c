@@ -185,6 +185,9 @@ kissat_statistics_print (kissat * solver, bool verbose)
 #define PCNT_COLLECTIONS(NAME) \
   PERCENT (NAME, garbage_collections)
 
+#define PCNT_COMPACTED(NAME) \
+  PERCENT (NAME, compacted)
+
 #define PCNT_CONFLICTS(NAME) \
   PERCENT (NAME, conflicts)
 
@@ -224,9 +227,15 @@ kissat_statistics_print (kissat * solver, bool verbose)
 #define PCNT_ELIMINATED(NAME) \
   PERCENT (NAME, eliminated)
 
+#define PCNT_EXPORTED(NAME) \
+  PERCENT (NAME, exported)
+
 #define PCNT_EXTRACTED(NAME) \
   PERCENT (NAME, gates_extracted)
 
+#define PCNT_IMPORTED(NAME) \
+  PERCENT (NAME, imported)
+
 #define PCNT_IRREDUNDANT(NAME) \
   PERCENT (NAME, clauses_irredundant)
 
@@ -269,6 +278,10 @@ kissat_statistics_print (kissat * solver, bool verbose)
 #define PCNT_SEARCHES(NAME) \
   PERCENT (NAME, searches)
 
+#define PCNT_SHARED(NAME) \
+  kissat_percent (statistics->NAME, statistics->imported + \
+                  statistics->imported_lost + statistics->imported_skipped)
+
 #define PCNT_STRENGTHENED(NAME) \
   PERCENT (NAME, strengthened)
 
@@ -293,13 +306,11 @@ kissat_statistics_print (kissat * solver, bool verbose)
 #define PCNT_SWEEP_SOLVED(NAME) \
   PERCENT (NAME, sweep_solved)
 
-#ifndef STATISTICS
-#define PCNT_TICKS(NAME) \
-  -1
-#else
+#define PCNT_TERNARY_VISITS(NAME) \
+  PERCENT (NAME, ternary_visits)
+
 #define PCNT_TICKS(NAME) \
   PERCENT (NAME, ticks)
-#endif
 
 #define PCNT_VARIABLES(NAME) \
   kissat_percent (statistics->NAME, variables)
@@ -17,6 +17,8 @@
   METRIC (arena_garbage, 1, PCNT_RESIDENT_SET, "%", "resident set") \
   METRIC (arena_resized, 1, CONF_INT, "", "interval") \
   METRIC (arena_shrunken, 1, PCNT_ARENA_RESIZED, "%", "resize") \
+  STATISTIC (assumed, 1, PER_CONFLICT, 0, "per conflict") \
+  STATISTIC (assumptions_failed, 1, PCNT_SEARCHES, "%", "searches") \
   COUNTER (backbone_computations, 2, CONF_INT, "", "interval") \
   METRIC (backbone_implied, 1, PER_BACKBONE_UNIT, 0, "per unit") \
   METRIC (backbone_probes, 2, PER_VARIABLE, "", "per variable") \
@@ -25,6 +27,7 @@
   COUNTER (backbone_ticks, 2, PCNT_TICKS, "%", "ticks") \
   STATISTIC (backbone_units, 1, PCNT_VARIABLES, "%", "variables") \
   METRIC (best_saved, 1, CONF_INT, "", "interval") \
+  STATISTIC (checkpoints, 1, CONF_INT, "", "interval") \
   COUNTER (chronological, 1, PCNT_CONFLICTS, "%", "conflicts") \
   COUNTER (clauses_added, 2, PCNT_CLS_ADDED, "%", "added") \
   COUNTER (clauses_binary, 2, PCNT_CLS_ADDED, "%", "added") \
@@ -44,12 +47,14 @@
   STATISTIC (clauses_reduced_tier2, 1, PCNT_CLS_REDUCED, "%", "reduced") \
   STATISTIC (clauses_reduced_tier3, 1, PCNT_CLS_REDUCED, "%", "reduced") \
   COUNTER (clauses_redundant, 2, NO_SECONDARY, 0, 0) \
+  STATISTIC (clauses_restored, 1, PCNT_CLS_ADDED, "%", "added") \
   STATISTIC (clauses_unfactored, 1, PCNT_CLS_FACTORED, "%", "factored") \
   COUNTER (clauses_used, 2, PCNT_CLS_LEARNED, "%", "learned") \
   COUNTER (clauses_used_focused, 2, PCNT_CLS_USED, "%", "used") \
   COUNTER (clauses_used_stable, 2, PCNT_CLS_USED, "%", "used") \
   COUNTER (closures, 2, CONF_INT, "", "interval") \
   METRIC (compacted, 1, PCNT_REDUCTIONS, "%", "reductions") \
+  METRIC (compacted_reordered, 1, PCNT_COMPACTED, "%", "compacted") \
   COUNTER (conflicts, 0, PER_SECOND, 0, "per second") \
   COUNTER (congruent, 1, PCNT_VARIABLES, "%", "variables") \
   STATISTIC (congruent_ands, 1, PCNT_CONGRUENT, "%", "congruent") \
@@ -109,6 +114,10 @@
   COUNTER (eliminations, 2, CONF_INT, "", "interval") \
   STATISTIC (equivalences_eliminated, 1, PCNT_ELIMINATED, "%", "eliminated") \
   METRIC (equivalences_extracted, 1, PCNT_EXTRACTED, "%", "extracted") \
+  COUNTER (exported, 1, PCNT_CLS_LEARNED, "%", "learned") \
+  STATISTIC (exported_binaries, 1, PCNT_EXPORTED, "%", "exported") \
+  STATISTIC (exported_clauses, 1, PCNT_EXPORTED, "%", "exported") \
+  STATISTIC (exported_units, 1, PCNT_EXPORTED, "%", "exported") \
   METRIC (extensions, 1, PCNT_SEARCHES, "%", "searches") \
   COUNTER (factored, 1, PCNT_VARIABLES, "%", "variables") \
   COUNTER (factorizations, 2, CONF_INT, "", "interval") \
@@ -135,6 +144,12 @@
   METRIC (gates_extracted, 1, PCNT_ELIM_ATTEMPTS, "%", "attempts") \
   STATISTIC (if_then_else_eliminated, 1, PCNT_ELIMINATED, "%", "eliminated") \
   METRIC (if_then_else_extracted, 1, PCNT_EXTRACTED, "%", "extracted") \
+  COUNTER (imported, 1, PER_RESTART, 0, "per restart") \
+  STATISTIC (imported_binaries, 1, PCNT_IMPORTED, "%", "imported") \
+  STATISTIC (imported_clauses, 1, PCNT_IMPORTED, "%", "imported") \
+  COUNTER (imported_lost, 1, PCNT_SHARED, "%", "shared") \
+  COUNTER (imported_skipped, 1, PCNT_SHARED, "%", "shared") \
+  STATISTIC (imported_units, 1, PCNT_IMPORTED, "%", "imported") \
   METRIC (initial_decisions, 1, PCNT_DECISIONS, "%", "decisions") \
   COUNTER (iterations, 1, PCNT_VARIABLES, "%", "variables") \
   STATISTIC (jumped_reasons, 1, PCNT_PROPS, "%", "propagations") \
@@ -160,6 +175,9 @@
   METRIC (moved, 1, PCNT_REDUCTIONS, "%", "reductions") \
   STATISTIC (on_the_fly_strengthened, 1, PCNT_CONFLICTS, "%", "of conflicts") \
   STATISTIC (on_the_fly_subsumed, 1, PCNT_CONFLICTS, "%", "of conflicts") \
+  METRIC (pages_advised, 1, CONF_INT, "", "interval") \
+  METRIC (pages_bound, 1, CONF_INT, "", "interval") \
+  METRIC (prefetched, 1, PER_PROPAGATION, 0, "per prop") \
   METRIC (probing_propagations, 1, PCNT_PROPS, "%", "propagations") \
   COUNTER (probings, 2, CONF_INT, "", "interval") \
   COUNTER (probing_ticks, 2, PCNT_TICKS, "%", "ticks") \
@@ -227,7 +245,9 @@
   COUNTER (switched, 0, CONF_INT, "", "interval") \
   METRIC (target_decisions, 1, PCNT_DECISIONS, "%", "decisions") \
   METRIC (target_saved, 1, CONF_INT, "", "interval") \
-  STATISTIC (ticks, 2, PER_PROPAGATION, 0, "per prop") \
+  STATISTIC (ternary_dereferenced, 2, PCNT_TERNARY_VISITS, "%", "visits") \
+  STATISTIC (ternary_visits, 2, PER_PROPAGATION, 0, "per prop") \
+  COUNTER (ticks, 2, PER_PROPAGATION, 0, "per prop") \
   METRIC (transitive_probes, 2, PER_VARIABLE, "", "per variable") \
   METRIC (transitive_propagations, 2, PCNT_PROPS, "%", "propagations") \
   METRIC (transitive_reduced, 1, PCNT_CLS_ADDED, "%", "added") \
@@ -240,6 +260,7 @@
   COUNTER (variables_extension, 2, PER_VARIABLE, 0, "per variable") \
   COUNTER (variables_factor, 2, PER_VARIABLE, 0, "per variable") \
   COUNTER (variables_original, 2, PER_VARIABLE, 0, "per variable") \
+  STATISTIC (variables_reactivated, 1, PCNT_ELIMINATED, "%", "eliminated") \
   COUNTER (variables_subsume, 2, PER_VARIABLE, 0, "per variable") \
   METRIC (vectors_defrags_needed, 1, PCNT_DEFRAGS, "%", "defrags") \
   METRIC (vectors_enlarged, 2, CONF_INT, "", "interval") \
@@ -403,6 +424,20 @@ METRICS_COUNTERS_AND_STATISTICS
 #undef COUNTER
 #undef IGNORE
 
+// Adds counters collected separately (by worker threads) to 'dst'.
+
+static inline void kissat_add_statistics (statistics *dst,
+                                          const statistics *src) {
+#define COUNTER(NAME,VERBOSE,OTHER,UNITS,TYPE) \
+  dst->NAME += src->NAME;
+#define IGNORE(...)
+
+  METRICS_COUNTERS_AND_STATISTICS
+
+#undef COUNTER
+#undef IGNORE
+}
+
 // clang-format on
 /*------------------------------------------------------------------------*/
 
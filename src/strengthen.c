@@ -3,7 +3,8 @@
 #include "inline.h"
 #include "promote.h"
 
-static clause *large_on_the_fly_strengthen (kissat *solver, clause *c,
+static clause *large_on_the_fly_strengthen (kissat *solver,
+                                            clause *conflict, clause *c,
                                             unsigned lit) {
   assert (solver->antecedent_size > 3);
   LOGCLS (c,
@@ -21,6 +22,7 @@ static clause *large_on_the_fly_strengthen (kissat *solver, clause *c,
   assert (lits[1] == lit);
   const reference ref = kissat_reference_clause (solver, c);
   kissat_unwatch_blocking (solver, lit, ref);
+  LRAT_CHAIN_STRENGTHENED (conflict, c, lit, lits[0]);
   SHRINK_CLAUSE_IN_PROOF (c, lit, lits[0]);
   CHECK_SHRINK_CLAUSE (c, lit, lits[0]);
   {
@@ -80,10 +82,14 @@ static clause *large_on_the_fly_strengthen (kissat *solver, clause *c,
         continue;
       assert (p != end_of_watches);
       const watch tail = *p++;
-      if (tail.large.ref == ref)
+      if (tail.tail.ternary)
+        p++;
+      if (tail.tail.ref == ref) {
+        p -= 2 + tail.tail.ternary;
         break;
+      }
     }
-    p[-2].blocking.lit = lits[1];
+    p->blocking.lit = lits[1];
     LOGREF (ref, "updating watching %s now blocking %s in",
             LOGLIT (lits[0]), LOGLIT (lits[1]));
   }
@@ -95,7 +101,8 @@ static clause *large_on_the_fly_strengthen (kissat *solver, clause *c,
   return c;
 }
 
-static clause *binary_on_the_fly_strengthen (kissat *solver, clause *c,
+static clause *binary_on_the_fly_strengthen (kissat *solver,
+                                             clause *conflict, clause *c,
                                              unsigned lit) {
   assert (solver->antecedent_size == 3);
   LOGCLS (c,
@@ -130,26 +137,26 @@ static clause *binary_on_the_fly_strengthen (kissat *solver, clause *c,
   assert (found);
   assert (second != INVALID_LIT);
   LOGBINARY (first, second, "on-the-fly strengthened");
+  LRAT_CHAIN_STRENGTHENED (conflict, c, lit, INVALID_LIT);
   kissat_new_binary_clause (solver, first, second);
   const reference ref = kissat_reference_clause (solver, c);
   kissat_unwatch_blocking (solver, c->lits[0], ref);
   kissat_unwatch_blocking (solver, c->lits[1], ref);
   kissat_mark_clause_as_garbage (solver, c);
-  clause *conflict = kissat_binary_conflict (solver, first, second);
-  return conflict;
+  return kissat_binary_conflict (solver, first, second);
 }
 
-clause *kissat_on_the_fly_strengthen (kissat *solver, clause *c,
-                                      unsigned lit) {
+clause *kissat_on_the_fly_strengthen (kissat *solver, clause *conflict,
+                                      clause *c, unsigned lit) {
   assert (!c->garbage);
   assert (solver->antecedent_size > 2);
   if (!c->redundant)
     kissat_mark_removed_literal (solver, lit);
   clause *res;
   if (solver->antecedent_size == 3)
-    res = binary_on_the_fly_strengthen (solver, c, lit);
+    res = binary_on_the_fly_strengthen (solver, conflict, c, lit);
   else
-    res = large_on_the_fly_strengthen (solver, c, lit);
+    res = large_on_the_fly_strengthen (solver, conflict, c, lit);
   return res;
 }
 
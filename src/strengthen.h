@@ -7,6 +7,7 @@ struct clause;
 struct kissat;
 
 struct clause *kissat_on_the_fly_strengthen (struct kissat *,
+                                             struct clause *conflict,
                                              struct clause *, unsigned lit);
 
 void kissat_on_the_fly_subsume (struct kissat *, struct clause *,
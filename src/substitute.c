@@ -200,6 +200,16 @@ static void determine_representatives (kissat *solver, unsigned *repr) {
   for (all_literals (lit))
     if (repr[lit] == INVALID_LIT)
       repr[lit] = lit;
+  for (all_variables (idx)) {
+    if (!flags[idx].frozen)
+      continue;
+    const unsigned lit = LIT (idx);
+    if (repr[lit] == lit)
+      continue;
+    LOG ("keeping frozen %s as its own representative", LOGVAR (idx));
+    repr[lit] = lit;
+    repr[NOT (lit)] = NOT (lit);
+  }
 }
 
 static bool *add_representative_equivalences (kissat *solver,
@@ -300,8 +310,12 @@ static void substitute_binaries (kissat *solver, unsigned *repr) {
     const watch *const end = END_WATCHES (*watches), *p = q;
     while (p != end) {
       const watch src = *p++;
-      if (!src.type.binary)
+      if (!src.type.binary) {
+        const watch tail = *p++;
+        if (tail.tail.ternary)
+          p++;
         continue;
+      }
       const unsigned other = src.binary.lit;
       const unsigned repr_other = repr[other];
       LOGBINARY (lit, other, "substituting");
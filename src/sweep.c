@@ -11,12 +11,16 @@
 #include "rank.h"
 #include "report.h"
 #include "terminate.h"
+#include "threads.h"
 
 #include <inttypes.h>
 #include <string.h>
 
 struct sweeper {
   kissat *solver;
+  kitten *kitten;
+  statistics *statistics;
+  bool worker;
   unsigned *depths;
   unsigned *reprs;
   unsigned *next, *prev;
@@ -28,7 +32,9 @@ struct sweeper {
   unsigneds clause;
   unsigneds backbone;
   unsigneds partition;
+  unsigneds refined;
   unsigneds core[2];
+  unsigneds results;
   struct {
     uint64_t ticks;
     unsigned clauses, depth, vars;
@@ -37,34 +43,47 @@ struct sweeper {
 
 typedef struct sweeper sweeper;
 
+// Sweeping workers run concurrently to the main thread and thus use their
+// own statistics.  They allocate their stacks through the solver though,
+// which accounts allocated bytes atomically.
+
+#define SWEEP_INC(NAME) kissat_inc_##NAME (sweeper->statistics)
+#define SWEEP_ADD(NAME, N) kissat_add_##NAME (sweeper->statistics, (N))
+
+#define SWEEP_TERMINATED(BIT) \
+  (sweeper->worker ? (bool) solver->termination.flagged : TERMINATED (BIT))
+
 static int sweep_solve (sweeper *sweeper) {
-  kissat *solver = sweeper->solver;
-  kitten *kitten = solver->kitten;
+  kitten *kitten = sweeper->kitten;
   kitten_randomize_phases (kitten);
-  INC (sweep_solved);
+  SWEEP_INC (sweep_solved);
   int res = kitten_solve (kitten);
   if (res == 10)
-    INC (sweep_sat);
+    SWEEP_INC (sweep_sat);
   if (res == 20)
-    INC (sweep_unsat);
+    SWEEP_INC (sweep_unsat);
   return res;
 }
 
 static void set_kitten_ticks_limit (sweeper *sweeper) {
   uint64_t remaining = 0;
+#ifdef LOGGING
   kissat *solver = sweeper->solver;
-  if (solver->statistics.kitten_ticks < sweeper->limit.ticks)
-    remaining = sweeper->limit.ticks - solver->statistics.kitten_ticks;
+#endif
+  if (sweeper->statistics->kitten_ticks < sweeper->limit.ticks)
+    remaining = sweeper->limit.ticks - sweeper->statistics->kitten_ticks;
   LOG ("'kitten_ticks' remaining %" PRIu64, remaining);
-  kitten_set_ticks_limit (solver->kitten, remaining);
+  kitten_set_ticks_limit (sweeper->kitten, remaining);
 }
 
 static bool kitten_ticks_limit_hit (sweeper *sweeper, const char *when) {
+#ifdef LOGGING
   kissat *solver = sweeper->solver;
-  if (solver->statistics.kitten_ticks >= sweeper->limit.ticks) {
+#endif
+  if (sweeper->statistics->kitten_ticks >= sweeper->limit.ticks) {
     LOG ("'kitten_ticks' limit of %" PRIu64 " ticks hit after %" PRIu64
          " ticks during %s",
-         sweeper->limit.ticks, solver->statistics.kitten_ticks, when);
+         sweeper->limit.ticks, sweeper->statistics->kitten_ticks, when);
     return true;
   }
 #ifndef LOGGING
@@ -75,6 +94,8 @@ static bool kitten_ticks_limit_hit (sweeper *sweeper, const char *when) {
 
 static void init_sweeper (kissat *solver, sweeper *sweeper) {
   sweeper->solver = solver;
+  sweeper->statistics = &solver->statistics;
+  sweeper->worker = false;
   sweeper->encoded = 0;
   CALLOC (sweeper->depths, VARS);
   NALLOC (sweeper->reprs, LITS);
@@ -96,11 +117,13 @@ static void init_sweeper (kissat *solver, sweeper *sweeper) {
   INIT_STACK (sweeper->clause);
   INIT_STACK (sweeper->backbone);
   INIT_STACK (sweeper->partition);
+  INIT_STACK (sweeper->refined);
   INIT_STACK (sweeper->core[0]);
   INIT_STACK (sweeper->core[1]);
+  INIT_STACK (sweeper->results);
   assert (!solver->kitten);
-  solver->kitten = kitten_embedded (solver);
-  kitten_track_antecedents (solver->kitten);
+  solver->kitten = sweeper->kitten = kitten_embedded (solver);
+  kitten_track_antecedents (sweeper->kitten);
   kissat_enter_dense_mode (solver, 0);
   kissat_connect_irredundant_large_clauses (solver);
 
@@ -166,30 +189,41 @@ static unsigned release_sweeper (sweeper *sweeper) {
   RELEASE_STACK (sweeper->clause);
   RELEASE_STACK (sweeper->backbone);
   RELEASE_STACK (sweeper->partition);
+  RELEASE_STACK (sweeper->refined);
   RELEASE_STACK (sweeper->core[0]);
   RELEASE_STACK (sweeper->core[1]);
+  RELEASE_STACK (sweeper->results);
   kitten_release (solver->kitten);
   solver->kitten = 0;
   kissat_resume_sparse_mode (solver, false, 0);
   return merged;
 }
 
-static void clear_sweeper (sweeper *sweeper) {
+static void unmark_environment (sweeper *sweeper) {
   kissat *solver = sweeper->solver;
-  LOG ("clearing sweeping environment");
-  kitten_clear (solver->kitten);
-  kitten_track_antecedents (solver->kitten);
   for (all_stack (unsigned, idx, sweeper->vars)) {
     assert (sweeper->depths[idx]);
     sweeper->depths[idx] = 0;
   }
-  CLEAR_STACK (sweeper->vars);
   for (all_stack (reference, ref, sweeper->refs)) {
     clause *c = kissat_dereference_clause (solver, ref);
     assert (c->swept);
     c->swept = false;
   }
   CLEAR_STACK (sweeper->refs);
+}
+
+static void clear_sweeper (sweeper *sweeper) {
+#ifdef LOGGING
+  kissat *solver = sweeper->solver;
+#endif
+  LOG ("clearing sweeping environment");
+  kitten_clear (sweeper->kitten);
+  kitten_track_antecedents (sweeper->kitten);
+  if (!sweeper->worker)
+    unmark_environment (sweeper);
+  assert (EMPTY_STACK (sweeper->refs));
+  CLEAR_STACK (sweeper->vars);
   CLEAR_STACK (sweeper->backbone);
   CLEAR_STACK (sweeper->partition);
   sweeper->encoded = 0;
@@ -240,11 +274,10 @@ static void add_literal_to_environment (sweeper *sweeper, unsigned depth,
 }
 
 static void sweep_clause (sweeper *sweeper, unsigned depth) {
-  kissat *solver = sweeper->solver;
   assert (SIZE_STACK (sweeper->clause) > 1);
   for (all_stack (unsigned, lit, sweeper->clause))
     add_literal_to_environment (sweeper, depth, lit);
-  kitten_clause (solver->kitten, SIZE_STACK (sweeper->clause),
+  kitten_clause (sweeper->kitten, SIZE_STACK (sweeper->clause),
                  BEGIN_STACK (sweeper->clause));
   CLEAR_STACK (sweeper->clause);
   sweeper->encoded++;
@@ -423,13 +456,15 @@ static void add_core (sweeper *sweeper, unsigned core_idx) {
 }
 
 static void save_core (sweeper *sweeper, unsigned core) {
+#ifdef LOGGING
   kissat *solver = sweeper->solver;
+#endif
   LOG ("saving extracted core[%u] lemmas", core);
   assert (core == 0 || core == 1);
   assert (EMPTY_STACK (sweeper->core[core]));
   sweeper->save = core;
-  kitten_compute_clausal_core (solver->kitten, 0);
-  kitten_traverse_core_clauses (solver->kitten, sweeper, save_core_clause);
+  kitten_compute_clausal_core (sweeper->kitten, 0);
+  kitten_traverse_core_clauses (sweeper->kitten, sweeper, save_core_clause);
 }
 
 static void clear_core (sweeper *sweeper, unsigned core_idx) {
@@ -463,6 +498,25 @@ static void save_add_clear_core (sweeper *sweeper) {
   clear_core (sweeper, 0);
 }
 
+// Workers do not add units and equivalences (nor their core lemmas) but
+// save them as results '<lit> <other> <size> <core[0]> <size> <core[1]>'
+// to be committed by the main thread.  The 'other' literal is invalid
+// for units (and the empty clause in which case also 'lit' is invalid).
+
+static void save_result (sweeper *sweeper, unsigned lit, unsigned other) {
+  kissat *solver = sweeper->solver;
+  assert (sweeper->worker);
+  PUSH_STACK (sweeper->results, lit);
+  PUSH_STACK (sweeper->results, other);
+  for (unsigned i = 0; i < 2; i++) {
+    unsigneds *core = sweeper->core + i;
+    PUSH_STACK (sweeper->results, (unsigned) SIZE_STACK (*core));
+    for (all_stack (unsigned, lit, *core))
+      PUSH_STACK (sweeper->results, lit);
+    CLEAR_STACK (*core);
+  }
+}
+
 #define LOGBACKBONE(MESSAGE) \
   LOGLITSET (SIZE_STACK (sweeper->backbone), \
              BEGIN_STACK (sweeper->backbone), MESSAGE)
@@ -479,7 +533,7 @@ static void init_backbone_and_partition (sweeper *sweeper) {
       continue;
     const unsigned lit = LIT (idx);
     const unsigned not_lit = NOT (lit);
-    const signed char tmp = kitten_value (solver->kitten, lit);
+    const signed char tmp = kitten_value (sweeper->kitten, lit);
     const unsigned candidate = (tmp < 0) ? not_lit : lit;
     LOG ("sweeping candidate %s", LOGLIT (candidate));
     PUSH_STACK (sweeper->backbone, candidate);
@@ -493,6 +547,11 @@ static void init_backbone_and_partition (sweeper *sweeper) {
 
 static void sweep_empty_clause (sweeper *sweeper) {
   assert (!sweeper->solver->inconsistent);
+  if (sweeper->worker) {
+    save_core (sweeper, 0);
+    save_result (sweeper, INVALID_LIT, INVALID_LIT);
+    return;
+  }
   save_add_clear_core (sweeper);
   assert (sweeper->solver->inconsistent);
 }
@@ -500,10 +559,10 @@ static void sweep_empty_clause (sweeper *sweeper) {
 static void sweep_refine_partition (sweeper *sweeper) {
   kissat *solver = sweeper->solver;
   LOG ("refining partition");
-  kitten *kitten = solver->kitten;
+  kitten *kitten = sweeper->kitten;
   unsigneds old_partition = sweeper->partition;
-  unsigneds new_partition;
-  INIT_STACK (new_partition);
+  unsigneds new_partition = sweeper->refined;
+  assert (EMPTY_STACK (new_partition));
   const value *const values = solver->values;
   const unsigned *const old_begin = BEGIN_STACK (old_partition);
   const unsigned *const old_end = END_STACK (old_partition);
@@ -514,7 +573,7 @@ static void sweep_refine_partition (sweeper *sweeper) {
   for (const unsigned *p = old_begin, *q; p != old_end; p = q + 1) {
     unsigned assigned_true = 0, other;
     for (q = p; (other = *q) != INVALID_LIT; q++) {
-      if (sweep_repr (sweeper, other) != other)
+      if (sweeper->reprs[other] != other)
         continue;
       if (values[other])
         continue;
@@ -550,7 +609,7 @@ static void sweep_refine_partition (sweeper *sweeper) {
 
     unsigned assigned_false = 0;
     for (q = p; (other = *q) != INVALID_LIT; q++) {
-      if (sweep_repr (sweeper, other) != other)
+      if (sweeper->reprs[other] != other)
         continue;
       if (values[other])
         continue;
@@ -579,7 +638,8 @@ static void sweep_refine_partition (sweeper *sweeper) {
 #endif
     }
   }
-  RELEASE_STACK (old_partition);
+  CLEAR_STACK (old_partition);
+  sweeper->refined = old_partition;
   sweeper->partition = new_partition;
   LOG ("refined %u classes into %u", old_classes, new_classes);
   LOGPARTITION ("refined equivalence candidates");
@@ -591,7 +651,7 @@ static void sweep_refine_backbone (sweeper *sweeper) {
   const unsigned *const end = END_STACK (sweeper->backbone);
   unsigned *q = BEGIN_STACK (sweeper->backbone);
   const value *const values = solver->values;
-  kitten *kitten = solver->kitten;
+  kitten *kitten = sweeper->kitten;
   for (const unsigned *p = q; p != end; p++) {
     const unsigned lit = *p;
     if (values[lit])
@@ -626,7 +686,7 @@ static void flip_backbone_literals (struct sweeper *sweeper) {
   if (!max_rounds)
     return;
   assert (!EMPTY_STACK (sweeper->backbone));
-  struct kitten *kitten = solver->kitten;
+  struct kitten *kitten = sweeper->kitten;
   if (kitten_status (kitten) != 10)
     return;
 #ifdef LOGGING
@@ -640,13 +700,13 @@ static void flip_backbone_literals (struct sweeper *sweeper) {
     const unsigned *const end = END_STACK (sweeper->backbone), *p = q;
     while (p != end) {
       const unsigned lit = *p++;
-      INC (sweep_flip_backbone);
+      SWEEP_INC (sweep_flip_backbone);
       if (kitten_flip_literal (kitten, lit)) {
         LOG ("flipping backbone candidate %s succeeded", LOGLIT (lit));
 #ifdef LOGGING
         total_flipped++;
 #endif
-        INC (sweep_flipped_backbone);
+        SWEEP_INC (sweep_flipped_backbone);
         flipped++;
       } else {
         LOG ("flipping backbone candidate %s failed", LOGLIT (lit));
@@ -656,9 +716,9 @@ static void flip_backbone_literals (struct sweeper *sweeper) {
     SET_END_OF_STACK (sweeper->backbone, q);
     LOG ("flipped %u backbone candidates in round %u", flipped, round);
 
-    if (TERMINATED (sweep_terminated_1))
+    if (SWEEP_TERMINATED (sweep_terminated_1))
       break;
-    if (solver->statistics.kitten_ticks > sweeper->limit.ticks)
+    if (sweeper->statistics->kitten_ticks > sweeper->limit.ticks)
       break;
   } while (flipped && round < max_rounds);
   LOG ("flipped %u backbone candidates in total in %u rounds",
@@ -666,20 +726,22 @@ static void flip_backbone_literals (struct sweeper *sweeper) {
 }
 
 static bool sweep_backbone_candidate (sweeper *sweeper, unsigned lit) {
+#if !defined(NDEBUG) || defined(LOGGING)
   kissat *solver = sweeper->solver;
+#endif
   LOG ("trying backbone candidate %s", LOGLIT (lit));
-  kitten *kitten = solver->kitten;
+  kitten *kitten = sweeper->kitten;
   signed char value = kitten_fixed (kitten, lit);
   if (value) {
-    INC (sweep_fixed_backbone);
+    SWEEP_INC (sweep_fixed_backbone);
     LOG ("literal %s already fixed", LOGLIT (lit));
     assert (value > 0);
     return false;
   }
 
-  INC (sweep_flip_backbone);
+  SWEEP_INC (sweep_flip_backbone);
   if (kitten_status (kitten) == 10 && kitten_flip_literal (kitten, lit)) {
-    INC (sweep_flipped_backbone);
+    SWEEP_INC (sweep_flipped_backbone);
     LOG ("flipping %s succeeded", LOGLIT (lit));
     LOGBACKBONE ("refined backbone candidates");
     return false;
@@ -687,24 +749,28 @@ static bool sweep_backbone_candidate (sweeper *sweeper, unsigned lit) {
 
   LOG ("flipping %s failed", LOGLIT (lit));
   const unsigned not_lit = NOT (lit);
-  INC (sweep_solved_backbone);
+  SWEEP_INC (sweep_solved_backbone);
   kitten_assume (kitten, not_lit);
   int res = sweep_solve (sweeper);
   if (res == 10) {
     LOG ("sweeping backbone candidate %s failed", LOGLIT (lit));
     sweep_refine (sweeper);
-    INC (sweep_sat_backbone);
+    SWEEP_INC (sweep_sat_backbone);
     return false;
   }
 
   if (res == 20) {
     LOG ("sweep unit %s", LOGLIT (lit));
-    save_add_clear_core (sweeper);
-    INC (sweep_unsat_backbone);
+    if (sweeper->worker) {
+      save_core (sweeper, 0);
+      save_result (sweeper, lit, INVALID_LIT);
+    } else
+      save_add_clear_core (sweeper);
+    SWEEP_INC (sweep_unsat_backbone);
     return true;
   }
 
-  INC (sweep_unknown_backbone);
+  SWEEP_INC (sweep_unknown_backbone);
 
   LOG ("sweeping backbone candidate %s failed", LOGLIT (lit));
   return false;
@@ -1045,7 +1111,7 @@ static void substitute_connected_clauses (sweeper *sweeper, unsigned lit,
 
 static void sweep_remove (sweeper *sweeper, unsigned lit) {
   kissat *solver = sweeper->solver;
-  assert (sweeper->reprs[lit] != lit);
+  assert (sweeper->worker || sweeper->reprs[lit] != lit);
   unsigneds *partition = &sweeper->partition;
   unsigned *const begin_partition = BEGIN_STACK (*partition), *p;
   const unsigned *const end_partition = END_STACK (*partition);
@@ -1083,7 +1149,7 @@ static void flip_partition_literals (struct sweeper *sweeper) {
   if (!max_rounds)
     return;
   assert (!EMPTY_STACK (sweeper->partition));
-  struct kitten *kitten = solver->kitten;
+  struct kitten *kitten = sweeper->kitten;
   if (kitten_status (kitten) != 10)
     return;
 #ifdef LOGGING
@@ -1126,23 +1192,66 @@ static void flip_partition_literals (struct sweeper *sweeper) {
     SET_END_OF_STACK (sweeper->partition, dst);
     LOG ("flipped %u equivalence candidates in round %u", flipped, round);
 
-    if (TERMINATED (sweep_terminated_2))
+    if (SWEEP_TERMINATED (sweep_terminated_2))
       break;
-    if (solver->statistics.kitten_ticks > sweeper->limit.ticks)
+    if (sweeper->statistics->kitten_ticks > sweeper->limit.ticks)
       break;
   } while (flipped && round < max_rounds);
   LOG ("flipped %u equivalence candidates in total in %u rounds",
        total_flipped, round);
 }
 
+// Adds the equivalence with its saved cores and substitutes the literal
+// with the larger index, which is returned.
+
+static unsigned add_equivalence (sweeper *sweeper, unsigned lit,
+                                 unsigned other) {
+  kissat *solver = sweeper->solver;
+  const unsigned not_other = NOT (other);
+  const unsigned not_lit = NOT (lit);
+
+  LOG ("sweep equivalence %s = %s", LOGLIT (lit), LOGLIT (other));
+  INC (sweep_equivalences);
+
+  add_core (sweeper, 0);
+  add_binary (solver, lit, not_other);
+  clear_core (sweeper, 0);
+
+  add_core (sweeper, 1);
+  add_binary (solver, not_lit, other);
+  clear_core (sweeper, 1);
+
+  unsigned repr, removed;
+  if (lit < other) {
+    repr = sweeper->reprs[other] = lit;
+    sweeper->reprs[not_other] = not_lit;
+    substitute_connected_clauses (sweeper, other, lit);
+    substitute_connected_clauses (sweeper, not_other, not_lit);
+    removed = other;
+  } else {
+    repr = sweeper->reprs[lit] = other;
+    sweeper->reprs[not_lit] = not_other;
+    substitute_connected_clauses (sweeper, lit, other);
+    substitute_connected_clauses (sweeper, not_lit, not_other);
+    removed = lit;
+  }
+
+  const unsigned repr_idx = IDX (repr);
+  schedule_inner (sweeper, repr_idx);
+
+  return removed;
+}
+
 static bool sweep_equivalence_candidates (sweeper *sweeper, unsigned lit,
                                           unsigned other) {
+#if !defined(NDEBUG) || defined(LOGGING)
   kissat *solver = sweeper->solver;
+#endif
   LOG ("trying equivalence candidates %s = %s", LOGLIT (lit),
        LOGLIT (other));
   const unsigned not_other = NOT (other);
   const unsigned not_lit = NOT (lit);
-  kitten *kitten = solver->kitten;
+  kitten *kitten = sweeper->kitten;
   const unsigned *const begin = BEGIN_STACK (sweeper->partition);
   unsigned *const end = END_STACK (sweeper->partition);
   assert (begin + 3 <= end);
@@ -1151,8 +1260,8 @@ static bool sweep_equivalence_candidates (sweeper *sweeper, unsigned lit,
   const unsigned third = (end - begin == 3) ? INVALID_LIT : end[-4];
   const int status = kitten_status (kitten);
   if (status == 10 && kitten_flip_literal (kitten, lit)) {
-    INC (sweep_flip_equivalences);
-    INC (sweep_flipped_equivalences);
+    SWEEP_INC (sweep_flip_equivalences);
+    SWEEP_INC (sweep_flipped_equivalences);
     LOG ("flipping %s succeeded", LOGLIT (lit));
     if (third == INVALID_LIT) {
       LOG ("squashing equivalence class of %s", LOGLIT (lit));
@@ -1167,8 +1276,8 @@ static bool sweep_equivalence_candidates (sweeper *sweeper, unsigned lit,
     LOGPARTITION ("refined equivalence candidates");
     return false;
   } else if (status == 10 && kitten_flip_literal (kitten, other)) {
-    ADD (sweep_flip_equivalences, 2);
-    INC (sweep_flipped_equivalences);
+    SWEEP_ADD (sweep_flip_equivalences, 2);
+    SWEEP_INC (sweep_flipped_equivalences);
     LOG ("flipping %s succeeded", LOGLIT (other));
     if (third == INVALID_LIT) {
       LOG ("squashing equivalence class of %s", LOGLIT (lit));
@@ -1183,19 +1292,19 @@ static bool sweep_equivalence_candidates (sweeper *sweeper, unsigned lit,
     return false;
   }
   if (status == 10)
-    ADD (sweep_flip_equivalences, 2);
+    SWEEP_ADD (sweep_flip_equivalences, 2);
   LOG ("flipping %s and %s both failed", LOGLIT (lit), LOGLIT (other));
   kitten_assume (kitten, not_lit);
   kitten_assume (kitten, other);
-  INC (sweep_solved_equivalences);
+  SWEEP_INC (sweep_solved_equivalences);
   int res = sweep_solve (sweeper);
   if (res == 10) {
-    INC (sweep_sat_equivalences);
+    SWEEP_INC (sweep_sat_equivalences);
     LOG ("first sweeping implication %s -> %s failed", LOGLIT (other),
          LOGLIT (lit));
     sweep_refine (sweeper);
   } else if (!res) {
-    INC (sweep_unknown_equivalences);
+    SWEEP_INC (sweep_unknown_equivalences);
     LOG ("first sweeping implication %s -> %s hit ticks limit",
          LOGLIT (other), LOGLIT (lit));
   }
@@ -1203,7 +1312,7 @@ static bool sweep_equivalence_candidates (sweeper *sweeper, unsigned lit,
   if (res != 20)
     return false;
 
-  INC (sweep_unsat_equivalences);
+  SWEEP_INC (sweep_unsat_equivalences);
   LOG ("first sweeping implication %s -> %s succeeded", LOGLIT (other),
        LOGLIT (lit));
 
@@ -1212,14 +1321,14 @@ static bool sweep_equivalence_candidates (sweeper *sweeper, unsigned lit,
   kitten_assume (kitten, lit);
   kitten_assume (kitten, not_other);
   res = sweep_solve (sweeper);
-  INC (sweep_solved_equivalences);
+  SWEEP_INC (sweep_solved_equivalences);
   if (res == 10) {
-    INC (sweep_sat_equivalences);
+    SWEEP_INC (sweep_sat_equivalences);
     LOG ("second sweeping implication %s <- %s failed", LOGLIT (other),
          LOGLIT (lit));
     sweep_refine (sweeper);
   } else if (!res) {
-    INC (sweep_unknown_equivalences);
+    SWEEP_INC (sweep_unknown_equivalences);
     LOG ("second sweeping implication %s <- %s hit ticks limit",
          LOGLIT (other), LOGLIT (lit));
   }
@@ -1229,60 +1338,33 @@ static bool sweep_equivalence_candidates (sweeper *sweeper, unsigned lit,
     return false;
   }
 
-  INC (sweep_unsat_equivalences);
+  SWEEP_INC (sweep_unsat_equivalences);
   LOG ("second sweeping implication %s <- %s succeeded too", LOGLIT (other),
        LOGLIT (lit));
 
   save_core (sweeper, 1);
 
-  LOG ("sweep equivalence %s = %s", LOGLIT (lit), LOGLIT (other));
-  INC (sweep_equivalences);
-
-  add_core (sweeper, 0);
-  add_binary (solver, lit, not_other);
-  clear_core (sweeper, 0);
-
-  add_core (sweeper, 1);
-  add_binary (solver, not_lit, other);
-  clear_core (sweeper, 1);
-
-  unsigned repr;
-  if (lit < other) {
-    repr = sweeper->reprs[other] = lit;
-    sweeper->reprs[not_other] = not_lit;
-    substitute_connected_clauses (sweeper, other, lit);
-    substitute_connected_clauses (sweeper, not_other, not_lit);
-    sweep_remove (sweeper, other);
-  } else {
-    repr = sweeper->reprs[lit] = other;
-    sweeper->reprs[not_lit] = not_other;
-    substitute_connected_clauses (sweeper, lit, other);
-    substitute_connected_clauses (sweeper, not_lit, not_other);
-    sweep_remove (sweeper, lit);
-  }
-
-  const unsigned repr_idx = IDX (repr);
-  schedule_inner (sweeper, repr_idx);
+  if (sweeper->worker) {
+    LOG ("saving sweep equivalence %s = %s", LOGLIT (lit), LOGLIT (other));
+    save_result (sweeper, lit, other);
+    sweep_remove (sweeper, lit < other ? other : lit);
+  } else
+    sweep_remove (sweeper, add_equivalence (sweeper, lit, other));
 
   return true;
 }
 
-static const char *sweep_variable (sweeper *sweeper, unsigned idx) {
+static bool sweep_environment (sweeper *sweeper, unsigned idx) {
   kissat *solver = sweeper->solver;
   assert (!solver->inconsistent);
-  if (!ACTIVE (idx))
-    return "inactive variable";
   const unsigned start = LIT (idx);
-  if (sweeper->reprs[start] != start)
-    return "non-representative variable";
+  assert (sweeper->reprs[start] == start);
   assert (EMPTY_STACK (sweeper->vars));
   assert (EMPTY_STACK (sweeper->refs));
   assert (EMPTY_STACK (sweeper->backbone));
   assert (EMPTY_STACK (sweeper->partition));
   assert (!sweeper->encoded);
 
-  INC (sweep_variables);
-
   LOG ("sweeping %s", LOGVAR (idx));
   assert (!VALUE (start));
   LOG ("starting sweeping[0]");
@@ -1292,7 +1374,6 @@ static const char *sweep_variable (sweeper *sweeper, unsigned idx) {
 
   bool limit_reached = false;
   size_t expand = 0, next = 1;
-  bool success = false;
   unsigned depth = 1;
 
   while (!limit_reached) {
@@ -1357,27 +1438,46 @@ static const char *sweep_variable (sweeper *sweeper, unsigned idx) {
                             kissat_export_literal (solver, LIT (idx)),
                             SIZE_STACK (sweeper->vars), sweeper->encoded,
                             depth);
+  return limit_reached;
+}
+
+#define START_SWEEP(NAME) \
+  do { \
+    if (!sweeper->worker) \
+      START (NAME); \
+  } while (0)
+
+#define STOP_SWEEP(NAME) \
+  do { \
+    if (!sweeper->worker) \
+      STOP (NAME); \
+  } while (0)
+
+static bool sweep_backbone_and_partition (sweeper *sweeper, unsigned idx,
+                                          bool *limit_reached_ptr) {
+  kissat *solver = sweeper->solver;
+  bool success = false;
   int res = sweep_solve (sweeper);
   LOG ("sub-solver returns '%d'", res);
   if (res == 10) {
     init_backbone_and_partition (sweeper);
 #ifndef QUIET
-    uint64_t units = solver->statistics.sweep_units;
-    uint64_t solved = solver->statistics.sweep_solved;
+    uint64_t units = sweeper->statistics->sweep_units;
+    uint64_t solved = sweeper->statistics->sweep_solved;
 #endif
-    START (sweepbackbone);
+    START_SWEEP (sweepbackbone);
     while (!EMPTY_STACK (sweeper->backbone)) {
-      if (solver->inconsistent || TERMINATED (sweep_terminated_3) ||
+      if (solver->inconsistent || SWEEP_TERMINATED (sweep_terminated_3) ||
           kitten_ticks_limit_hit (sweeper, "backbone refinement")) {
-        limit_reached = true;
+        *limit_reached_ptr = true;
       STOP_SWEEP_BACKBONE:
-        STOP (sweepbackbone);
-        goto DONE;
+        STOP_SWEEP (sweepbackbone);
+        return success;
       }
       flip_backbone_literals (sweeper);
-      if (TERMINATED (sweep_terminated_4) ||
+      if (SWEEP_TERMINATED (sweep_terminated_4) ||
           kitten_ticks_limit_hit (sweeper, "backbone refinement")) {
-        limit_reached = true;
+        *limit_reached_ptr = true;
         goto STOP_SWEEP_BACKBONE;
       }
       if (EMPTY_STACK (sweeper->backbone))
@@ -1388,34 +1488,35 @@ static const char *sweep_variable (sweeper *sweeper, unsigned idx) {
       if (sweep_backbone_candidate (sweeper, lit))
         success = true;
     }
-    STOP (sweepbackbone);
+    STOP_SWEEP (sweepbackbone);
 #ifndef QUIET
-    units = solver->statistics.sweep_units - units;
-    solved = solver->statistics.sweep_solved - solved;
-    kissat_extremely_verbose (
-        solver,
-        "complete swept variable %d backbone with %" PRIu64
-        " units in %" PRIu64 " solver calls",
-        kissat_export_literal (solver, LIT (idx)), units, solved);
+    units = sweeper->statistics->sweep_units - units;
+    solved = sweeper->statistics->sweep_solved - solved;
+    if (!sweeper->worker)
+      kissat_extremely_verbose (
+          solver,
+          "complete swept variable %d backbone with %" PRIu64
+          " units in %" PRIu64 " solver calls",
+          kissat_export_literal (solver, LIT (idx)), units, solved);
 #endif
     assert (EMPTY_STACK (sweeper->backbone));
 #ifndef QUIET
-    uint64_t equivalences = solver->statistics.sweep_equivalences;
-    solved = solver->statistics.sweep_solved;
+    uint64_t equivalences = sweeper->statistics->sweep_equivalences;
+    solved = sweeper->statistics->sweep_solved;
 #endif
-    START (sweepequivalences);
+    START_SWEEP (sweepequivalences);
     while (!EMPTY_STACK (sweeper->partition)) {
-      if (solver->inconsistent || TERMINATED (sweep_terminated_5) ||
+      if (solver->inconsistent || SWEEP_TERMINATED (sweep_terminated_5) ||
           kitten_ticks_limit_hit (sweeper, "partition refinement")) {
-        limit_reached = true;
+        *limit_reached_ptr = true;
       STOP_SWEEP_EQUIVALENCES:
-        STOP (sweepequivalences);
-        goto DONE;
+        STOP_SWEEP (sweepequivalences);
+        return success;
       }
       flip_partition_literals (sweeper);
-      if (TERMINATED (sweep_terminated_6) ||
+      if (SWEEP_TERMINATED (sweep_terminated_6) ||
           kitten_ticks_limit_hit (sweeper, "backbone refinement")) {
-        limit_reached = true;
+        *limit_reached_ptr = true;
         goto STOP_SWEEP_EQUIVALENCES;
       }
       if (EMPTY_STACK (sweeper->partition))
@@ -1430,11 +1531,11 @@ static const char *sweep_variable (sweeper *sweeper, unsigned idx) {
       } else
         CLEAR_STACK (sweeper->partition);
     }
-    STOP (sweepequivalences);
+    STOP_SWEEP (sweepequivalences);
 #ifndef QUIET
-    equivalences = solver->statistics.sweep_equivalences - equivalences;
-    solved = solver->statistics.sweep_solved - solved;
-    if (equivalences)
+    equivalences = sweeper->statistics->sweep_equivalences - equivalences;
+    solved = sweeper->statistics->sweep_solved - solved;
+    if (equivalences && !sweeper->worker)
       kissat_extremely_verbose (
           solver,
           "complete swept variable %d partition with %" PRIu64
@@ -1443,13 +1544,13 @@ static const char *sweep_variable (sweeper *sweeper, unsigned idx) {
 #endif
   } else if (res == 20)
     sweep_empty_clause (sweeper);
+#if defined(QUIET) && !defined(LOGGING)
+  (void) idx;
+#endif
+  return success;
+}
 
-DONE:
-  clear_sweeper (sweeper);
-
-  if (!solver->inconsistent && !kissat_propagated (solver))
-    (void) kissat_dense_propagate (solver);
-
+static const char *sweep_result (bool success, bool limit_reached) {
   if (success && limit_reached)
     return "successfully despite reaching limit";
   if (!success && !limit_reached)
@@ -1460,6 +1561,206 @@ DONE:
   return "unsuccessfully and reached limit";
 }
 
+static const char *sweep_variable (sweeper *sweeper, unsigned idx) {
+  kissat *solver = sweeper->solver;
+  assert (!solver->inconsistent);
+  if (!ACTIVE (idx))
+    return "inactive variable";
+  const unsigned start = LIT (idx);
+  if (sweeper->reprs[start] != start)
+    return "non-representative variable";
+
+  INC (sweep_variables);
+
+  bool limit_reached = sweep_environment (sweeper, idx);
+  const bool success =
+      sweep_backbone_and_partition (sweeper, idx, &limit_reached);
+
+  clear_sweeper (sweeper);
+
+  if (!solver->inconsistent && !kissat_propagated (solver))
+    (void) kissat_dense_propagate (solver);
+
+  return sweep_result (success, limit_reached);
+}
+
+// With more than one sweeping thread, up to that many scheduled variables
+// are swept concurrently in rounds.  Their environments are still
+// extracted by the main thread, but into separate detached sub-solvers of
+// workers, which then refine backbones and equivalences independently.
+// Variables occurring in an environment of the current round are
+// deferred to the next round.  At the end of a round the found units and
+// equivalences (with the cores justifying them) are committed by the main
+// thread in schedule order, where equivalences between literals which are
+// no longer active representatives are dropped.
+
+typedef struct sweep_worker sweep_worker;
+
+struct sweep_worker {
+  sweeper sweeper;
+  statistics statistics;
+  unsigned idx;
+  bool success;
+  bool limit_reached;
+};
+
+static void init_sweep_worker (sweeper *sweeper, sweep_worker *worker) {
+  kissat *solver = sweeper->solver;
+  struct sweeper *helper = &worker->sweeper;
+  *helper = *sweeper;
+  memset (&worker->statistics, 0, sizeof worker->statistics);
+  helper->statistics = &worker->statistics;
+  helper->worker = true;
+  helper->encoded = 0;
+  INIT_STACK (helper->vars);
+  INIT_STACK (helper->refs);
+  INIT_STACK (helper->clause);
+  INIT_STACK (helper->backbone);
+  INIT_STACK (helper->partition);
+  INIT_STACK (helper->refined);
+  INIT_STACK (helper->core[0]);
+  INIT_STACK (helper->core[1]);
+  INIT_STACK (helper->results);
+  helper->kitten = kitten_detached (solver, &worker->statistics);
+  kitten_track_antecedents (helper->kitten);
+}
+
+static void release_sweep_worker (sweep_worker *worker) {
+  sweeper *sweeper = &worker->sweeper;
+  kissat *solver = sweeper->solver;
+  RELEASE_STACK (sweeper->vars);
+  RELEASE_STACK (sweeper->refs);
+  RELEASE_STACK (sweeper->clause);
+  RELEASE_STACK (sweeper->backbone);
+  RELEASE_STACK (sweeper->partition);
+  RELEASE_STACK (sweeper->refined);
+  RELEASE_STACK (sweeper->core[0]);
+  RELEASE_STACK (sweeper->core[1]);
+  RELEASE_STACK (sweeper->results);
+  kitten_release (sweeper->kitten);
+}
+
+static void *sweep_worker_thread (void *ptr) {
+  sweep_worker *worker = ptr;
+  worker->success = sweep_backbone_and_partition (
+      &worker->sweeper, worker->idx, &worker->limit_reached);
+  return 0;
+}
+
+static bool mergeable_equivalence (sweeper *sweeper, unsigned lit,
+                                   unsigned other) {
+  kissat *solver = sweeper->solver;
+  if (!ACTIVE (IDX (lit)) || !ACTIVE (IDX (other)))
+    return false;
+  if (VALUE (lit) || VALUE (other))
+    return false;
+  if (sweeper->reprs[lit] != lit || sweeper->reprs[other] != other)
+    return false;
+  return true;
+}
+
+static void commit_results (sweeper *sweeper, struct sweeper *helper) {
+  kissat *solver = sweeper->solver;
+  const unsigned *p = BEGIN_STACK (helper->results);
+  const unsigned *const end = END_STACK (helper->results);
+  while (p != end) {
+    const unsigned lit = *p++;
+    const unsigned other = *p++;
+    for (unsigned i = 0; i < 2; i++) {
+      unsigneds *core = sweeper->core + i;
+      assert (EMPTY_STACK (*core));
+      const unsigned *const end_core = p + *p + 1;
+      while (++p != end_core)
+        PUSH_STACK (*core, *p);
+    }
+    if (solver->inconsistent)
+      LOG ("skipping sweeping result since inconsistent");
+    else if (other == INVALID_LIT) {
+      LOG ("committing sweep unit %s",
+           lit == INVALID_LIT ? "<empty>" : LOGLIT (lit));
+      add_core (sweeper, 0);
+      clear_core (sweeper, 0);
+    } else if (mergeable_equivalence (sweeper, lit, other))
+      (void) add_equivalence (sweeper, lit, other);
+    else
+      LOG ("skipping stale sweep equivalence %s = %s", LOGLIT (lit),
+           LOGLIT (other));
+    CLEAR_STACK (sweeper->core[0]);
+    CLEAR_STACK (sweeper->core[1]);
+  }
+  CLEAR_STACK (helper->results);
+}
+
+static unsigned sweep_round (sweeper *sweeper, sweep_worker *workers,
+                             unsigned threads, bool *covered,
+                             unsigneds *deferred) {
+  kissat *solver = sweeper->solver;
+  uint64_t budget = sweeper->limit.ticks - solver->statistics.kitten_ticks;
+  if (budget != UINT64_MAX)
+    budget = budget / threads + 1;
+
+  unsigned jobs = 0;
+  while (jobs < threads) {
+    const unsigned idx = next_scheduled (sweeper);
+    if (idx == INVALID_IDX)
+      break;
+    const unsigned lit = LIT (idx);
+    if (!ACTIVE (idx) || sweeper->reprs[lit] != lit) {
+      FLAGS (idx)->sweep = false;
+      continue;
+    }
+    if (covered[idx]) {
+      LOG ("deferring %s occurring in environment", LOGVAR (idx));
+      PUSH_STACK (*deferred, idx);
+      continue;
+    }
+    FLAGS (idx)->sweep = false;
+    sweep_worker *worker = workers + jobs++;
+    struct sweeper *helper = &worker->sweeper;
+    worker->idx = idx;
+    worker->success = false;
+    helper->limit.ticks = budget;
+    set_kitten_ticks_limit (helper);
+    INC (sweep_variables);
+    worker->limit_reached = sweep_environment (helper, idx);
+    unmark_environment (helper);
+    for (all_stack (unsigned, other, helper->vars))
+      covered[other] = true;
+  }
+
+  const unsigned *const begin_deferred = BEGIN_STACK (*deferred);
+  for (const unsigned *p = END_STACK (*deferred); p != begin_deferred;)
+    schedule_inner (sweeper, *--p);
+  CLEAR_STACK (*deferred);
+
+  if (!jobs)
+    return 0;
+
+  for (unsigned i = 0; i < jobs; i++)
+    for (all_stack (unsigned, idx, workers[i].sweeper.vars))
+      covered[idx] = false;
+
+  kissat_run_threads (solver, "sweeping", jobs, sweep_worker_thread,
+                      workers, sizeof *workers);
+
+  for (unsigned i = 0; i < jobs; i++) {
+    sweep_worker *worker = workers + i;
+    struct sweeper *helper = &worker->sweeper;
+    commit_results (sweeper, helper);
+    clear_sweeper (helper);
+    kissat_add_statistics (&solver->statistics, &worker->statistics);
+    memset (&worker->statistics, 0, sizeof worker->statistics);
+    if (!solver->inconsistent && !kissat_propagated (solver))
+      (void) kissat_dense_propagate (solver);
+    kissat_extremely_verbose (
+        solver, "swept external variable %d concurrently %s",
+        kissat_export_literal (solver, LIT (worker->idx)),
+        sweep_result (worker->success, worker->limit_reached));
+  }
+
+  return jobs;
+}
+
 typedef struct sweep_candidate sweep_candidate;
 
 struct sweep_candidate {
@@ -1664,6 +1965,18 @@ bool kissat_sweep (kissat *solver) {
   sweeper sweeper;
   init_sweeper (solver, &sweeper);
   const unsigned scheduled = schedule_sweeping (&sweeper);
+  const unsigned threads = kissat_threads (GET_OPTION (sweepthreads));
+  sweep_worker *workers = 0;
+  bool *covered = 0;
+  unsigneds deferred;
+  INIT_STACK (deferred);
+  if (threads > 1) {
+    workers = kissat_calloc (solver, threads, sizeof *workers);
+    for (unsigned i = 0; i < threads; i++)
+      init_sweep_worker (&sweeper, workers + i);
+    covered = kissat_calloc (solver, VARS, sizeof *covered);
+    kissat_extremely_verbose (solver, "sweeping with %u threads", threads);
+  }
   uint64_t swept = 0, limit = 10;
   for (;;) {
     if (solver->inconsistent)
@@ -1672,18 +1985,27 @@ bool kissat_sweep (kissat *solver) {
       break;
     if (solver->statistics.kitten_ticks > sweeper.limit.ticks)
       break;
-    unsigned idx = next_scheduled (&sweeper);
-    if (idx == INVALID_IDX)
-      break;
-    FLAGS (idx)->sweep = false;
+    if (threads > 1) {
+      const unsigned jobs =
+          sweep_round (&sweeper, workers, threads, covered, &deferred);
+      if (!jobs)
+        break;
+      swept += jobs;
+    } else {
+      unsigned idx = next_scheduled (&sweeper);
+      if (idx == INVALID_IDX)
+        break;
+      FLAGS (idx)->sweep = false;
 #ifndef QUIET
-    const char *res =
+      const char *res =
 #endif
-        sweep_variable (&sweeper, idx);
-    kissat_extremely_verbose (
-        solver, "swept[%" PRIu64 "] external variable %d %s", swept,
-        kissat_export_literal (solver, LIT (idx)), res);
-    if (++swept == limit) {
+          sweep_variable (&sweeper, idx);
+      kissat_extremely_verbose (
+          solver, "swept[%" PRIu64 "] external variable %d %s", swept,
+          kissat_export_literal (solver, LIT (idx)), res);
+      swept++;
+    }
+    if (swept >= limit) {
       kissat_very_verbose (solver,
                            "found %" PRIu64 " equivalences and %" PRIu64
                            " units after sweeping %" PRIu64 " variables ",
@@ -1692,6 +2014,13 @@ bool kissat_sweep (kissat *solver) {
       limit *= 10;
     }
   }
+  if (threads > 1) {
+    for (unsigned i = 0; i < threads; i++)
+      release_sweep_worker (workers + i);
+    kissat_dealloc (solver, workers, threads, sizeof *workers);
+    kissat_dealloc (solver, covered, VARS, sizeof *covered);
+  }
+  RELEASE_STACK (deferred);
   kissat_very_verbose (solver, "swept %" PRIu64 " variables", swept);
   equivalences = statistics->sweep_equivalences - equivalences,
   units = solver->statistics.sweep_units - units;
@@ -0,0 +1,34 @@
+#include "threads.h"
+#include "allocate.h"
+#include "error.h"
+
+#include <pthread.h>
+#include <unistd.h>
+
+unsigned kissat_threads (unsigned option) {
+  if (option)
+    return option;
+  const long cores = sysconf (_SC_NPROCESSORS_ONLN);
+  if (cores <= 1)
+    return 1;
+  if (cores >= MAX_AUTOMATIC_THREADS)
+    return MAX_AUTOMATIC_THREADS;
+  return cores;
+}
+
+void kissat_run_threads (struct kissat *solver, const char *name,
+                         unsigned threads, void *(*worker) (void *),
+                         void *workers, size_t bytes) {
+  if (!threads)
+    return;
+  char *const begin = workers;
+  pthread_t *ids = kissat_nalloc (solver, threads, sizeof *ids);
+  for (unsigned i = 1; i < threads; i++)
+    if (pthread_create (ids + i, 0, worker, begin + i * bytes))
+      kissat_fatal ("failed to create %s thread %u", name, i);
+  (void) worker (begin);
+  for (unsigned i = 1; i < threads; i++)
+    if (pthread_join (ids[i], 0))
+      kissat_fatal ("failed to join %s thread %u", name, i);
+  kissat_dealloc (solver, ids, threads, sizeof *ids);
+}
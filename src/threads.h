@@ -0,0 +1,35 @@
+#ifndef _threads_h_INCLUDED
+#define _threads_h_INCLUDED
+
+#include <stdbool.h>
+#include <stddef.h>
+
+struct kissat;
+
+// Local search, elimination, sweeping, congruence closure and parsing can
+// run workers in threads.  Their number is given by an option, where zero
+// means one thread per online core, but at most 'MAX_AUTOMATIC_THREADS'.
+
+#define MAX_AUTOMATIC_THREADS 16
+
+unsigned kissat_threads (unsigned option);
+
+// Runs 'worker' on the first 'threads' elements of the array 'workers' of
+// elements with 'bytes' bytes.  The first is run in the calling thread and
+// the others in their own threads, which are all joined before returning.
+
+void kissat_run_threads (struct kissat *, const char *name,
+                         unsigned threads, void *(*worker) (void *),
+                         void *workers, size_t bytes);
+
+// Flag shared between threads for stopping them early.
+
+static inline bool kissat_stopped (bool *flag) {
+  return __atomic_load_n (flag, __ATOMIC_RELAXED);
+}
+
+static inline void kissat_set_stopped (bool *flag) {
+  __atomic_store_n (flag, true, __ATOMIC_RELAXED);
+}
+
+#endif
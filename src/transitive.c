@@ -62,6 +62,8 @@ static void prioritize_binaries (kissat *solver) {
       const watch tail = *p++;
       PUSH_STACK (large, head);
       PUSH_STACK (large, tail);
+      if (tail.tail.ternary)
+        PUSH_STACK (large, *p++);
       q--;
     }
     const watch *const end_large = END_STACK (large);
@@ -192,7 +194,9 @@ static bool transitive_reduce (kissat *solver, unsigned src, uint64_t limit,
     for (const watch *p = begin_src; p != end_src; p++) {
       const watch src_watch = *q++ = *p;
       if (!src_watch.type.binary) {
-        *q++ = *++p;
+        const watch tail = *q++ = *++p;
+        if (tail.tail.ternary)
+          *q++ = *++p;
         continue;
       }
       if (src_watch.binary.lit == ILLEGAL_LIT)
@@ -217,6 +221,121 @@ static bool transitive_reduce (kissat *solver, unsigned src, uint64_t limit,
   return res;
 }
 
+static bool transitive_reduce_implications (kissat *solver, unsigned src,
+                                            uint64_t limit,
+                                            uint64_t *reduced_ptr,
+                                            unsigned *units) {
+  bool res = false;
+  assert (!VALUE (src));
+  LOG ("transitive reduce %s", LOGLIT (src));
+  unsigned *const begin_src = BEGIN_IMPLICATIONS (src);
+  const unsigned *const end_src = END_IMPLICATIONS (src);
+  const unsigned src_ticks =
+      1 + kissat_cache_lines (end_src - begin_src, sizeof (unsigned));
+  ADD (transitive_ticks, src_ticks);
+  ADD (probing_ticks, src_ticks);
+  ADD (ticks, src_ticks);
+  INC (transitive_probes);
+  const unsigned not_src = NOT (src);
+  bool failed = false;
+  for (unsigned *p = begin_src; p != end_src; p++) {
+    const unsigned dst = *p;
+    if (dst == INVALID_LIT)
+      continue;
+    if (dst < src)
+      continue;
+    if (VALUE (dst))
+      continue;
+    assert (kissat_propagated (solver));
+    unsigned *saved = solver->propagate;
+    assert (!solver->level);
+    solver->level = 1;
+    transitive_assign (solver, not_src);
+    bool transitive = false;
+    unsigned inner_ticks = 0;
+    unsigned *propagate = solver->propagate;
+    while (!transitive && !failed &&
+           propagate != END_ARRAY (solver->trail)) {
+      const unsigned lit = *propagate++;
+      LOG ("transitive propagate %s", LOGLIT (lit));
+      assert (VALUE (lit) > 0);
+      const unsigned not_lit = NOT (lit);
+      const unsigned *const begin_lit = BEGIN_IMPLICATIONS (not_lit);
+      const unsigned *const end_lit = END_IMPLICATIONS (not_lit);
+      inner_ticks +=
+          1 + kissat_cache_lines (end_lit - begin_lit, sizeof (unsigned));
+      for (const unsigned *q = begin_lit; q != end_lit; q++) {
+        if (p == q)
+          continue;
+        const unsigned other = *q;
+        if (other == INVALID_LIT)
+          continue;
+        if (other == dst) {
+          transitive = true;
+          break;
+        }
+        const value value = VALUE (other);
+        if (value < 0) {
+          LOG ("both %s and %s reachable from %s", LOGLIT (NOT (other)),
+               LOGLIT (other), LOGLIT (src));
+          failed = true;
+          break;
+        }
+        if (!value)
+          transitive_assign (solver, other);
+      }
+    }
+
+    assert (solver->probing);
+
+    assert (solver->propagate <= propagate);
+    const unsigned propagated = propagate - solver->propagate;
+
+    ADD (transitive_propagations, propagated);
+    ADD (probing_propagations, propagated);
+    ADD (propagations, propagated);
+
+    ADD (transitive_ticks, inner_ticks);
+    ADD (probing_ticks, inner_ticks);
+    ADD (ticks, inner_ticks);
+
+    transitive_backtrack (solver, saved);
+
+    if (transitive) {
+      LOGBINARY (src, dst, "transitive reduce");
+      INC (transitive_reduced);
+      REMOVE_WATCHES (WATCHES (src), kissat_binary_watch (dst));
+      REMOVE_WATCHES (WATCHES (dst), kissat_binary_watch (src));
+      kissat_delete_binary (solver, src, dst);
+      kissat_remove_implication (solver, dst, src);
+      *p = INVALID_LIT;
+      *reduced_ptr += 1;
+      res = true;
+    }
+
+    if (failed)
+      break;
+    if (solver->statistics.transitive_ticks > limit)
+      break;
+    if (TERMINATED (transitive_terminated_1))
+      break;
+  }
+
+  if (failed) {
+    LOG ("transitive failed literal %s", LOGLIT (not_src));
+    INC (transitive_units);
+    *units += 1;
+    res = true;
+
+    kissat_learned_unit (solver, src);
+
+    assert (!solver->level);
+    (void) kissat_probing_propagate (solver, 0, true);
+  }
+
+  return res;
+}
+
 static inline bool less_stable_transitive (kissat *solver,
                                            const flags *const flags,
                                            const heap *scores, unsigned a,
@@ -312,7 +431,11 @@ void kissat_transitive_reduction (kissat *solver) {
   assert (!solver->transitive_reducing);
   solver->transitive_reducing = true;
 #endif
+  const bool dense = GET_OPTION (implications);
+  // Binary watches first, so removing them never matches a ternary tail.
   prioritize_binaries (solver);
+  if (dense)
+    kissat_build_implications (solver);
   bool success = false;
   uint64_t reduced = 0;
   unsigned units = 0;
@@ -342,7 +465,14 @@ void kissat_transitive_reduction (kissat *solver) {
 #ifndef QUIET
       probed++;
 #endif
-      if (transitive_reduce (solver, lit, limit, &reduced, &units))
+      bool reduced_lit;
+      if (dense)
+        reduced_lit = transitive_reduce_implications (solver, lit, limit,
+                                                      &reduced, &units);
+      else
+        reduced_lit =
+            transitive_reduce (solver, lit, limit, &reduced, &units);
+      if (reduced_lit)
         success = true;
       if (solver->inconsistent)
         terminate = true;
@@ -8,9 +8,11 @@
 
 typedef uintptr_t word;
 typedef uintptr_t w2rd[2];
+typedef uintptr_t w4rd[4];
 
 #define WORD_ALIGNMENT_MASK (sizeof (word) - 1)
 #define W2RD_ALIGNMENT_MASK (sizeof (w2rd) - 1)
+#define W4RD_ALIGNMENT_MASK (sizeof (w4rd) - 1)
 
 #define WORD_FORMAT PRIuPTR
 
@@ -63,6 +65,13 @@ static inline word kissat_align_w2rd (word w) {
   return res;
 }
 
+static inline word kissat_align_w4rd (word w) {
+  word res = w;
+  if (res & W4RD_ALIGNMENT_MASK)
+    res = 1 + (res | W4RD_ALIGNMENT_MASK);
+  return res;
+}
+
 bool kissat_has_suffix (const char *str, const char *suffix);
 
 static inline bool kissat_is_power_of_two (uint64_t w) {
@@ -4,6 +4,12 @@
 typedef signed char value;
 typedef signed char mark;
 
+// The literal values are allocated with a few bytes of slack after the
+// last literal, such that vectorized code can read four bytes starting
+// at the value of any literal ('kissat_find_non_false' in 'simd.h').
+
+#define VALUES_PADDING 3
+
 #define VALUE(LIT) (solver->values[assert ((LIT) < LITS), (LIT)])
 
 #define MARK(LIT) (solver->marks[assert ((LIT) < LITS), (LIT)])
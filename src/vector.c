@@ -3,6 +3,7 @@
 #include "error.h"
 #include "inlinevector.h"
 #include "logging.h"
+#include "pages.h"
 #include "print.h"
 #include "rank.h"
 
@@ -77,6 +78,8 @@ unsigned *kissat_enlarge_vector (kissat *solver, vector *vector) {
 
     if (enlarged) {
       INC (vectors_enlarged);
+      kissat_advise_pages (solver, BEGIN_STACK (*stack),
+                           capacity * sizeof (unsigned));
 #if !defined(QUIET) || !defined(COMPACT)
       unsigned *new_begin_stack = BEGIN_STACK (*stack);
       const ptrdiff_t moved =
@@ -221,6 +224,8 @@ void kissat_defrag_vectors (kissat *solver, size_t size_unsorted,
   assert (old_begin_stack == BEGIN_STACK (*stack));
 #endif
   SHRINK_STACK (*stack);
+  kissat_advise_pages (solver, BEGIN_STACK (*stack),
+                       CAPACITY_STACK (*stack) * sizeof (unsigned));
 #ifndef COMPACT
   unsigned *new_begin_stack = BEGIN_STACK (*stack);
   const ptrdiff_t moved =
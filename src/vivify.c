@@ -82,6 +82,7 @@ static bool simplify_vivification_candidate (kissat *solver,
     const unsigned first = PEEK_STACK (solver->clause, 0);
     const unsigned second = PEEK_STACK (solver->clause, 1);
     LOGBINARY (first, second, "vivification shrunken candidate");
+    LRAT_CHAIN_SIMPLIFIED (c);
     kissat_new_binary_clause (solver, first, second);
     kissat_mark_clause_as_garbage (solver, c);
     return true;
@@ -90,10 +91,12 @@ static bool simplify_vivification_candidate (kissat *solver,
   assert (2 < non_false);
 
   CHECK_AND_ADD_STACK (solver->clause);
+  LRAT_CHAIN_SIMPLIFIED (c);
   ADD_STACK_TO_PROOF (solver->clause);
 
   REMOVE_CHECKER_CLAUSE (c);
   DELETE_CLAUSE_FROM_PROOF (c);
+  LRAT_IDENTIFY (c);
 
   const unsigned old_size = c->size;
   unsigned new_size = 0, *lits = c->lits;
@@ -478,8 +481,8 @@ static void vivify_deduce (vivifier *vivifier, clause *candidate,
   if (implied != INVALID_LIT) {
     unsigned not_implied = NOT (implied);
     LOG ("vivify analyzing %s", LOGLIT (not_implied));
-    assigned *const a = ASSIGNED (not_implied);
-    assert (a->level);
+    assert (LEVEL (not_implied));
+    struct analysis *const a = ANALYSIS (not_implied);
     assert (!a->analyzed);
     a->analyzed = true;
     PUSH_STACK (solver->analyzed, not_implied);
@@ -497,8 +500,8 @@ static void vivify_deduce (vivifier *vivifier, clause *candidate,
         continue;
       LOG ("vivify analyzing %s", LOGLIT (other));
       assert (!value);
-      assigned *const a = ASSIGNED (other);
-      assert (a->level);
+      assert (LEVEL (other));
+      struct analysis *const a = ANALYSIS (other);
       assert (!a->analyzed);
       a->analyzed = true;
       PUSH_STACK (solver->analyzed, other);
@@ -524,7 +527,7 @@ static void vivify_deduce (vivifier *vivifier, clause *candidate,
     analyzed++;
     assigned *a = ASSIGNED (lit);
     assert (a->level);
-    assert (a->analyzed);
+    assert (ANALYSIS (lit)->analyzed);
     if (a->reason == DECISION_REASON) {
       LOG ("vivify analyzing decision %s", LOGLIT (not_lit));
       PUSH_STACK (solver->clause, not_lit);
@@ -537,8 +540,8 @@ static void vivify_deduce (vivifier *vivifier, clause *candidate,
         return;
       }
       assert (VALUE (other) < 0);
-      assigned *b = ASSIGNED (other);
-      assert (b->level);
+      assert (LEVEL (other));
+      struct analysis *b = ANALYSIS (other);
       if (b->analyzed)
         continue;
       LOGBINARY (lit, other, "vivify analyzing %s reason", LOGLIT (lit));
@@ -559,9 +562,9 @@ static void vivify_deduce (vivifier *vivifier, clause *candidate,
           continue;
         assert (other != not_lit);
         assert (VALUE (other) < 0);
-        assigned *b = ASSIGNED (other);
-        if (!b->level)
+        if (!LEVEL (other))
           continue;
+        struct analysis *b = ANALYSIS (other);
         if (b->analyzed)
           continue;
         b->analyzed = true;
@@ -588,10 +591,10 @@ static void vivify_deduce (vivifier *vivifier, clause *candidate,
 static void reset_vivify_analyzed (vivifier *vivifier) {
   kissat *solver = vivifier->solver;
   LOG ("reset vivification conflict analysis");
-  struct assigned *assigned = solver->assigned;
+  struct analysis *analysis = solver->analysis;
   for (all_stack (unsigned, lit, solver->analyzed)) {
     const unsigned idx = IDX (lit);
-    struct assigned *a = assigned + idx;
+    struct analysis *a = analysis + idx;
     a->analyzed = false;
   }
   CLEAR_STACK (solver->analyzed);
@@ -627,7 +630,7 @@ static bool vivify_shrinkable (kissat *solver, unsigneds *sorted,
       const unsigned idx = IDX (lit);
       const struct assigned *const a = assigned + idx;
       assert (a->level);
-      if (!a->analyzed) {
+      if (!solver->analysis[idx].analyzed) {
         LOG ("vivification non-analyzed %s thus shrinking", LOGLIT (lit));
         return true;
       }
@@ -709,8 +712,8 @@ static void vivify_watch_clause (kissat *solver, clause *c) {
   const reference ref = kissat_reference_clause (solver, c);
   swap_first_literal_with_best_watch (solver, lits, size);
   swap_first_literal_with_best_watch (solver, lits + 1, size - 1);
-  kissat_watch_blocking (solver, lits[0], lits[1], ref);
-  kissat_watch_blocking (solver, lits[1], lits[0], ref);
+  LOGREF (ref, "watching %s and %s in", LOGLIT (lits[0]), LOGLIT (lits[1]));
+  kissat_push_clause_watches (solver, solver->watches, size, lits, ref);
 }
 
 static void vivify_learn_large (kissat *solver, clause *c,
@@ -723,6 +726,7 @@ static void vivify_learn_large (kissat *solver, clause *c,
 
   REMOVE_CHECKER_CLAUSE (c);
   DELETE_CLAUSE_FROM_PROOF (c);
+  LRAT_IDENTIFY (c);
 
   vivify_unwatch_clause (solver, c);
 
@@ -766,7 +770,12 @@ static void vivify_learn_large (kissat *solver, clause *c,
   vivify_watch_clause (solver, c);
 }
 
-static void vivify_learn (kissat *solver, clause *c, unsigned implied) {
+static void vivify_learn (kissat *solver, clause *c, clause *conflict,
+                          unsigned implied) {
+  if (implied == INVALID_LIT)
+    LRAT_CHAIN_CONFLICT (conflict ? conflict : c, solver->clause);
+  else
+    LRAT_CHAIN_IMPLIED (implied, solver->clause);
   size_t size = SIZE_STACK (solver->clause);
   if (size == 1)
     vivify_learn_unit (solver, c);
@@ -1166,7 +1175,7 @@ EXIT_ASSUMPTION_LOOP:;
       res = true;
     }
   } else if (vivify_shrinkable (solver, sorted, conflict)) {
-    vivify_learn (solver, candidate, implied);
+    vivify_learn (solver, candidate, conflict, implied);
     INC (vivified_shrunken);
     if (candidate->redundant)
       INC (vivified_shrunkred);
@@ -1207,6 +1216,7 @@ EXIT_ASSUMPTION_LOOP:;
     conflict = kissat_probing_propagate (solver, candidate, true);
     if (conflict) {
       LOG ("vivification instantiation succeeded");
+      LRAT_CHAIN_STRENGTHENED (conflict, candidate, lit, INVALID_LIT);
       vivify_strengthen_after_instantiation (solver, candidate, lit);
       INC (vivified_instantiated);
       if (candidate->redundant)
@@ -1,5 +1,6 @@
 #include "walk.h"
 #include "allocate.h"
+#include "budget.h"
 #include "decide.h"
 #include "dense.h"
 #include "inline.h"
@@ -7,13 +8,15 @@
 #include "print.h"
 #include "rephase.h"
 #include "report.h"
+#include "resources.h"
+#include "simd.h"
 #include "terminate.h"
+#include "threads.h"
 #include "warmup.h"
 
 #include <string.h>
 
 typedef struct tagged tagged;
-typedef struct counter counter;
 typedef struct walker walker;
 
 #define LD_MAX_WALK_REF 31
@@ -30,36 +33,55 @@ static inline tagged make_tagged (bool binary, unsigned ref) {
   return res;
 }
 
-struct counter {
-  unsigned count;
-  unsigned pos;
-};
-
 // clang-format off
 typedef STACK (double) doubles;
 // clang-format on
 
 #define INVALID_BEST_TRAIL_POS UINT_MAX
 
+// With 'walkthreads' larger than one several walkers search in parallel.
+// They share the (read-only) watches, clause references and binary
+// clauses of the first walker but have their own assignment, counters,
+// score table and random number generator.  Helper walkers run in their
+// own thread and must neither allocate memory through the solver nor
+// update its statistics.  Thus their stacks are reserved in advance and
+// steps and flips are only counted locally and added after joining.
+
+// The occurrence lists of literals are flattened into one array of
+// counter references, indexed by 'offsets', and the counters are split
+// into separate arrays of 'counts' and 'positions' (on the unsatisfied
+// stack).  Thus break values can be computed by gathering the counts of
+// eight occurrences at once with AVX2 (if 'simd' is enabled), and the
+// make and break loops run over contiguous memory.  As break values are
+// computed without touching more than one cache line of occurrences per
+// eight references, they are only charged one step per such vector.
+
 struct walker {
   kissat *solver;
 
+  unsigned id;
   unsigned best_trail_pos;
   unsigned clauses;
   unsigned current;
   unsigned exponents;
   unsigned initial;
+  unsigned largest;
   unsigned minimum;
   unsigned offset;
 
   generator random;
 
-  counter *counters;
+  unsigned *counts;
+  unsigned *positions;
+  size_t *offsets;
+  unsigned *occurrences;
   litpairs *binaries;
   tagged *refs;
   double *table;
 
-  value *original_values;
+  bool simd;
+
+  value *values;
   value *best_values;
 
   doubles scores;
@@ -69,10 +91,14 @@ struct walker {
   double size;
   double epsilon;
 
+  bool *stop;
+
   uint64_t limit;
   uint64_t flipped;
-#ifndef QUIET
+  uint64_t flips;
   uint64_t start;
+  uint64_t steps;
+#ifndef QUIET
   struct {
     uint64_t flipped;
     unsigned minimum;
@@ -99,36 +125,38 @@ static const unsigned *dereference_literals (kissat *solver, walker *walker,
   return lits;
 }
 
-static void push_unsat (kissat *solver, walker *walker, counter *counters,
+static void push_unsat (kissat *solver, walker *walker,
                         unsigned counter_ref) {
   assert (counter_ref < walker->clauses);
-  counter *counter = counters + counter_ref;
   assert (SIZE_STACK (walker->unsat) <= UINT_MAX);
-  counter->pos = SIZE_STACK (walker->unsat);
+  const unsigned pos = SIZE_STACK (walker->unsat);
+  walker->positions[counter_ref] = pos;
   PUSH_STACK (walker->unsat, counter_ref);
 #ifdef LOGGING
   unsigned size;
   const unsigned *const lits =
       dereference_literals (solver, walker, counter_ref, &size);
-  LOGLITS (size, lits, "pushed unsatisfied[%u]", counter->pos);
+  LOGLITS (size, lits, "pushed unsatisfied[%u]", pos);
+#else
+  (void) solver;
 #endif
 }
 
-static bool pop_unsat (kissat *solver, walker *walker, counter *counters,
-                       unsigned counter_ref, unsigned pos) {
+static bool pop_unsat (kissat *solver, walker *walker, unsigned counter_ref,
+                       unsigned pos) {
   assert (walker->current);
   assert (counter_ref < walker->clauses);
-  assert (counters[counter_ref].pos == pos);
+  unsigned *const positions = walker->positions;
+  assert (positions[counter_ref] == pos);
   assert (walker->current == SIZE_STACK (walker->unsat));
   const unsigned other_counter_ref = POP_STACK (walker->unsat);
   walker->current--;
   bool res = false;
   if (counter_ref != other_counter_ref) {
     assert (other_counter_ref < walker->clauses);
-    counter *other_counter = counters + other_counter_ref;
-    assert (other_counter->pos == walker->current);
-    assert (pos < other_counter->pos);
-    other_counter->pos = pos;
+    assert (positions[other_counter_ref] == walker->current);
+    assert (pos < positions[other_counter_ref]);
+    positions[other_counter_ref] = pos;
     POKE_STACK (walker->unsat, pos, other_counter_ref);
     res = true;
   }
@@ -164,7 +192,8 @@ static double fit_cbval (double size) {
 static void init_score_table (walker *walker) {
   kissat *solver = walker->solver;
 
-  const double cb = (GET (walks) & 1) ? fit_cbval (walker->size) : 2.0;
+  const uint64_t walks = GET (walks) + walker->id;
+  const double cb = (walks & 1) ? fit_cbval (walker->size) : 2.0;
   const double base = 1 / cb;
 
   double next;
@@ -183,6 +212,9 @@ static void init_score_table (walker *walker) {
   walker->exponents = exponents;
   walker->epsilon = epsilon;
 
+  if (walker->id)
+    return;
+
   kissat_phase (solver, "walk", GET (walks),
                 "CB %.2f with inverse %.2f as base", cb, base);
   kissat_phase (solver, "walk", GET (walks), "table size %u and epsilon %g",
@@ -197,7 +229,7 @@ static void import_decision_phases (walker *walker) {
   kissat *solver = walker->solver;
   INC (walk_decisions);
   const flags *const flags = solver->flags;
-  value *values = solver->values;
+  value *values = walker->values;
   walker->best_values = kissat_calloc (solver, VARS, 1);
   value *best_values = walker->best_values;
 #ifndef QUIET
@@ -225,10 +257,10 @@ static void import_decision_phases (walker *walker) {
 
 static unsigned connect_binary_counters (walker *walker) {
   kissat *solver = walker->solver;
-  value *values = solver->values;
+  value *values = walker->values;
   tagged *refs = walker->refs;
   watches *all_watches = solver->watches;
-  counter *counters = walker->counters;
+  unsigned *counts = walker->counts;
 
   assert (SIZE_STACK (*walker->binaries) <= UINT_MAX);
   const unsigned size = SIZE_STACK (*walker->binaries);
@@ -251,10 +283,9 @@ static unsigned connect_binary_counters (walker *walker) {
     kissat_push_large_watch (solver, first_watches, counter_ref);
     kissat_push_large_watch (solver, second_watches, counter_ref);
     const unsigned count = (first_value > 0) + (second_value > 0);
-    counter *counter = counters + counter_ref;
-    counter->count = count;
+    counts[counter_ref] = count;
     if (!count) {
-      push_unsat (solver, walker, counters, counter_ref);
+      push_unsat (solver, walker, counter_ref);
       unsat++;
     }
     counter_ref++;
@@ -272,10 +303,10 @@ static unsigned connect_binary_counters (walker *walker) {
 static void connect_large_counters (walker *walker, unsigned counter_ref) {
   kissat *solver = walker->solver;
   assert (!solver->level);
-  const value *const original_values = walker->original_values;
-  const value *const local_search_values = solver->values;
+  const value *const original_values = solver->values;
+  const value *const local_search_values = walker->values;
   ward *const arena = BEGIN_STACK (solver->arena);
-  counter *counters = walker->counters;
+  unsigned *counts = walker->counts;
   tagged *refs = walker->refs;
 
   unsigned unsat = 0;
@@ -322,11 +353,12 @@ static void connect_large_counters (walker *walker, unsigned counter_ref) {
       if (value > 0)
         count++;
     }
-    counter *counter = walker->counters + counter_ref;
-    counter->count = count;
+    counts[counter_ref] = count;
+    if (size > walker->largest)
+      walker->largest = size;
 
     if (!count) {
-      push_unsat (solver, walker, counters, counter_ref);
+      push_unsat (solver, walker, counter_ref);
       unsat++;
     }
     counter_ref++;
@@ -367,6 +399,36 @@ static void report_minimum (const char *type, kissat *solver,
   } while (0)
 #endif
 
+// Moves the counter references from the (large) watches into the flat
+// occurrence array and flushes the watches.
+
+static void flatten_occurrences (walker *walker) {
+  kissat *solver = walker->solver;
+  size_t *offsets = kissat_nalloc (solver, LITS + 1, sizeof *offsets);
+  size_t occurrences = 0;
+  for (all_literals (lit)) {
+    offsets[lit] = occurrences;
+    occurrences += SIZE_WATCHES (WATCHES (lit));
+  }
+  offsets[LITS] = occurrences;
+  unsigned *refs = kissat_nalloc (solver, occurrences, sizeof *refs);
+  unsigned *q = refs;
+  for (all_literals (lit)) {
+    watches *watches = &WATCHES (lit);
+    for (all_binary_large_watches (watch, *watches)) {
+      assert (!watch.type.binary);
+      *q++ = watch.large.ref;
+    }
+  }
+  assert (q == refs + occurrences);
+  kissat_flush_large_connected (solver);
+  walker->offsets = offsets;
+  walker->occurrences = refs;
+  kissat_phase (solver, "walk", GET (walks),
+                "flattened %zu occurrences of %u literals", occurrences,
+                LITS);
+}
+
 static void init_walker (kissat *solver, walker *walker,
                          litpairs *binaries) {
   uint64_t clauses = BINIRR_CLAUSES;
@@ -377,19 +439,23 @@ static void init_walker (kissat *solver, walker *walker,
   walker->solver = solver;
   walker->clauses = clauses;
   walker->binaries = binaries;
+  walker->largest = 2;
   walker->random = solver->random ^ solver->statistics.walks;
+  walker->simd = solver->simd;
 
-  walker->original_values = solver->values;
-  solver->values = kissat_calloc (solver, LITS, 1);
+  walker->values = kissat_calloc (solver, LITS, 1);
 
   import_decision_phases (walker);
 
-  walker->counters = kissat_malloc (solver, clauses * sizeof (counter));
+  walker->counts = kissat_nalloc (solver, clauses, sizeof (unsigned));
+  walker->positions = kissat_nalloc (solver, clauses, sizeof (unsigned));
   walker->refs = kissat_malloc (solver, clauses * sizeof (tagged));
+  RESERVE_STACK (walker->unsat, clauses);
 
   assert (!walker->size);
   const unsigned counter_ref = connect_binary_counters (walker);
   connect_large_counters (walker, counter_ref);
+  flatten_occurrences (walker);
 
   walker->current = walker->initial = currently_unsatified (walker);
 
@@ -413,48 +479,82 @@ static void init_walker_limit (kissat *solver, walker *walker) {
   SET_EFFORT_LIMIT (limit, walk, walk_steps);
   walker->limit = limit;
   walker->flipped = 0;
+  walker->flips = 0;
+  walker->start = walker->steps = solver->statistics.walk_steps;
 #ifndef QUIET
-  walker->start = solver->statistics.walk_steps;
   walker->report.minimum = UINT_MAX;
   walker->report.flipped = 0;
 #endif
 }
 
+static void init_helper_walker (kissat *solver, walker *walker,
+                                const struct walker *first, unsigned id) {
+  assert (id);
+  *walker = *first;
+  walker->id = id;
+  walker->random ^= (uint64_t) id << 32;
+  kissat_next_random64 (&walker->random);
+
+  walker->values = kissat_malloc (solver, LITS);
+  memcpy (walker->values, first->values, LITS);
+  walker->best_values = kissat_malloc (solver, VARS);
+  memcpy (walker->best_values, first->best_values, VARS);
+
+  const unsigned clauses = walker->clauses;
+  const size_t bytes = clauses * sizeof (unsigned);
+  walker->counts = kissat_nalloc (solver, clauses, sizeof (unsigned));
+  memcpy (walker->counts, first->counts, bytes);
+  walker->positions = kissat_nalloc (solver, clauses, sizeof (unsigned));
+  memcpy (walker->positions, first->positions, bytes);
+
+  INIT_STACK (walker->unsat);
+  INIT_STACK (walker->scores);
+  INIT_STACK (walker->trail);
+  RESERVE_STACK (walker->unsat, clauses);
+  const size_t unsat = SIZE_STACK (first->unsat);
+  memcpy (walker->unsat.begin, first->unsat.begin,
+          unsat * sizeof (unsigned));
+  walker->unsat.end += unsat;
+  RESERVE_STACK (walker->scores, walker->largest);
+  RESERVE_STACK (walker->trail, VARS / 4 + 1);
+
+  init_score_table (walker);
+}
+
 static void release_walker (walker *walker) {
   kissat *solver = walker->solver;
   kissat_dealloc (solver, walker->table, walker->exponents,
                   sizeof (double));
   unsigned clauses = walker->clauses;
-  kissat_dealloc (solver, walker->refs, clauses, sizeof (tagged));
-  kissat_dealloc (solver, walker->counters, clauses, sizeof (counter));
+  if (!walker->id) {
+    kissat_dealloc (solver, walker->refs, clauses, sizeof (tagged));
+    kissat_dealloc (solver, walker->occurrences, walker->offsets[LITS],
+                    sizeof (unsigned));
+    kissat_dealloc (solver, walker->offsets, LITS + 1, sizeof (size_t));
+  }
+  kissat_dealloc (solver, walker->counts, clauses, sizeof (unsigned));
+  kissat_dealloc (solver, walker->positions, clauses, sizeof (unsigned));
   RELEASE_STACK (walker->unsat);
   RELEASE_STACK (walker->scores);
   RELEASE_STACK (walker->trail);
-  kissat_free (solver, solver->values, LITS);
+  kissat_free (solver, walker->values, LITS);
   kissat_free (solver, walker->best_values, VARS);
-  RELEASE_STACK (walker->unsat);
-  solver->values = walker->original_values;
 }
 
 static unsigned break_value (kissat *solver, walker *walker, value *values,
                              unsigned lit) {
   assert (values[lit] < 0);
   const unsigned not_lit = NOT (lit);
-  watches *watches = &WATCHES (not_lit);
-  unsigned steps = 1;
-  unsigned res = 0;
-  for (all_binary_large_watches (watch, *watches)) {
-    steps++;
-    assert (!watch.type.binary);
-    reference counter_ref = watch.large.ref;
-    assert (counter_ref < walker->clauses);
-    counter *counter = walker->counters + counter_ref;
-    res += (counter->count == 1);
-  }
-  ADD (walk_steps, steps);
+  const size_t *const offsets = walker->offsets;
+  const unsigned *const begin = walker->occurrences + offsets[not_lit];
+  const unsigned *const end = walker->occurrences + offsets[not_lit + 1];
+  const unsigned res =
+      kissat_count_critical (walker->simd, walker->counts, begin, end);
+  walker->steps += 1 + (end - begin);
 #ifdef NDEBUG
   (void) values;
 #endif
+  (void) solver;
   return res;
 }
 
@@ -476,7 +576,7 @@ static unsigned pick_literal (kissat *solver, walker *walker) {
   LOGLITS (size, lits, "picked unsatisfied[%u]", pos);
   assert (EMPTY_STACK (walker->scores));
 
-  value *values = solver->values;
+  value *values = walker->values;
 
   double sum = 0;
   unsigned picked_lit = INVALID_LIT;
@@ -545,27 +645,45 @@ static void break_clauses (kissat *solver, walker *walker,
   LOG ("breaking one-satisfied clauses containing negated flipped literal "
        "%s",
        LOGLIT (not_flipped));
-  watches *watches = &WATCHES (not_flipped);
-  counter *counters = walker->counters;
-  unsigned steps = 1;
-  for (all_binary_large_watches (watch, *watches)) {
-    steps++;
-    assert (!watch.type.binary);
-    const unsigned counter_ref = watch.large.ref;
+  const size_t *const offsets = walker->offsets;
+  const unsigned *const begin = walker->occurrences + offsets[not_flipped];
+  const unsigned *const end =
+      walker->occurrences + offsets[not_flipped + 1];
+  unsigned *const counts = walker->counts;
+  unsigned *const positions = walker->positions;
+  // All clauses with 'not_flipped' were satisfied and thus are not on the
+  // unsatisfied stack, which has room for all clauses.  Therefore we can
+  // unconditionally write each clause reference to the end of the stack
+  // and only keep it if its count dropped to zero (without branching).
+  unsigned *const unsat = BEGIN_STACK (walker->unsat);
+  unsigned *q = END_STACK (walker->unsat);
+  for (const unsigned *p = begin; p != end; p++) {
+    const unsigned counter_ref = *p;
     assert (counter_ref < walker->clauses);
-    counter *counter = counters + counter_ref;
-    assert (counter->count);
-    if (--counter->count)
-      continue;
-    push_unsat (solver, walker, counters, counter_ref);
+    assert (counts[counter_ref]);
+    const unsigned count = --counts[counter_ref];
+    assert (q < walker->unsat.allocated);
+    positions[counter_ref] = q - unsat;
+    *q = counter_ref;
+    q += !count;
+  }
 #ifdef LOGGING
+  for (const unsigned *p = END_STACK (walker->unsat); p != q; p++) {
+    unsigned size;
+    const unsigned *const lits =
+        dereference_literals (solver, walker, *p, &size);
+    LOGLITS (size, lits, "pushed unsatisfied[%zu]", (size_t) (p - unsat));
     broken++;
-#endif
   }
+#else
+  (void) solver;
+#endif
+  walker->unsat.end = q;
+  const unsigned steps = 1 + (end - begin);
   LOG ("broken %u one-satisfied clauses containing "
        "negated flipped literal %s",
        broken, LOGLIT (not_flipped));
-  ADD (walk_steps, steps);
+  walker->steps += steps;
 #ifdef NDEBUG
   (void) values;
 #endif
@@ -576,22 +694,23 @@ static void make_clauses (kissat *solver, walker *walker,
   assert (values[flipped] > 0);
   LOG ("making unsatisfied clauses containing flipped literal %s",
        LOGLIT (flipped));
-  watches *watches = &WATCHES (flipped);
-  counter *counters = walker->counters;
+  const size_t *const offsets = walker->offsets;
+  const unsigned *const begin = walker->occurrences + offsets[flipped];
+  const unsigned *const end = walker->occurrences + offsets[flipped + 1];
+  unsigned *const counts = walker->counts;
   unsigned steps = 1;
 #ifdef LOGGING
   unsigned made = 0;
 #endif
-  for (all_binary_large_watches (watch, *watches)) {
+  for (const unsigned *p = begin; p != end; p++) {
     steps++;
-    assert (!watch.type.binary);
-    const unsigned counter_ref = watch.large.ref;
+    const unsigned counter_ref = *p;
     assert (counter_ref < walker->clauses);
-    counter *counter = counters + counter_ref;
-    assert (counter->count < UINT_MAX);
-    if (counter->count++)
+    assert (counts[counter_ref] < UINT_MAX);
+    if (counts[counter_ref]++)
       continue;
-    if (pop_unsat (solver, walker, counters, counter_ref, counter->pos))
+    const unsigned pos = walker->positions[counter_ref];
+    if (pop_unsat (solver, walker, counter_ref, pos))
       steps++;
 #ifdef LOGGING
     made++;
@@ -599,7 +718,7 @@ static void make_clauses (kissat *solver, walker *walker,
   }
   LOG ("made %u unsatisfied clauses containing flipped literal %s", made,
        LOGLIT (flipped));
-  ADD (walk_steps, steps);
+  walker->steps += steps;
 #ifdef NDEBUG
   (void) values;
 #endif
@@ -609,7 +728,7 @@ static void save_all_values (kissat *solver, walker *walker) {
   assert (EMPTY_STACK (walker->trail));
   assert (walker->best_trail_pos == INVALID_BEST_TRAIL_POS);
   LOG ("copying all values as best phases since trail is invalid");
-  const value *const current_values = solver->values;
+  const value *const current_values = walker->values;
   value *best_values = walker->best_values;
   for (all_variables (idx)) {
     const unsigned lit = LIT (idx);
@@ -697,7 +816,7 @@ static void push_flipped (kissat *solver, walker *walker,
 
 static void flip_literal (kissat *solver, walker *walker, unsigned flip) {
   LOG ("flipping literal %s", LOGLIT (flip));
-  value *values = solver->values;
+  value *values = walker->values;
   const value value = values[flip];
   assert (value < 0);
   values[flip] = -value;
@@ -711,7 +830,7 @@ static void update_best (kissat *solver, walker *walker) {
   assert (walker->current < walker->minimum);
   walker->minimum = walker->current;
 #ifndef QUIET
-  int verbosity = kissat_verbosity (solver);
+  int verbosity = walker->id ? 0 : kissat_verbosity (solver);
   bool report = (verbosity > 2);
   if (verbosity == 2) {
     if (walker->flipped / 2 >= walker->report.flipped)
@@ -738,41 +857,65 @@ static void update_best (kissat *solver, walker *walker) {
 
 static void local_search_step (kissat *solver, walker *walker) {
   assert (walker->current);
-  INC (flipped);
+  walker->flips++;
   assert (walker->flipped < UINT64_MAX);
   walker->flipped++;
   LOG ("starting local search flip %" PRIu64 " with %u unsatisfied clauses",
-       GET (flipped), walker->current);
+       walker->flips, walker->current);
   unsigned lit = pick_literal (solver, walker);
   flip_literal (solver, walker, lit);
   push_flipped (solver, walker, lit);
   if (walker->current < walker->minimum)
     update_best (solver, walker);
   LOG ("ending local search step %" PRIu64 " with %u unsatisfied clauses",
-       GET (flipped), walker->current);
+       walker->flips, walker->current);
+}
+
+// Only the first walker (running in the main thread) reports termination.
+// Helper walkers just poll the termination flag of the solver and all
+// walkers stop as soon as one of them found a model.
+
+static bool walker_terminated (walker *walker) {
+  kissat *solver = walker->solver;
+  if (kissat_stopped (walker->stop))
+    return true;
+  if (walker->id)
+    return solver->termination.flagged;
+  if (!TERMINATED (walk_terminated_1))
+    return false;
+  kissat_set_stopped (walker->stop);
+  return true;
 }
 
 static void local_search_round (walker *walker) {
   kissat *solver = walker->solver;
 #ifndef QUIET
   const unsigned before = walker->minimum;
+  const double started = kissat_wall_clock_time ();
 #endif
-  statistics *statistics = &solver->statistics;
-  while (walker->minimum && walker->limit > statistics->walk_steps) {
-    if (TERMINATED (walk_terminated_1))
+  while (walker->minimum && walker->limit > walker->steps) {
+    if (walker_terminated (walker))
       break;
     local_search_step (solver, walker);
   }
+  if (!walker->minimum)
+    kissat_set_stopped (walker->stop);
 #ifndef QUIET
+  if (walker->id)
+    return;
   report_minimum ("last", solver, walker);
-  assert (statistics->walk_steps >= walker->start);
-  const uint64_t steps = statistics->walk_steps - walker->start;
+  assert (walker->steps >= walker->start);
+  const uint64_t steps = walker->steps - walker->start;
   // clang-format off
   kissat_very_verbose (solver,
     "walking ends with %u unsatisfied clauses", walker->current);
   kissat_very_verbose (solver,
     "flipping %" PRIu64 " literals took %" PRIu64 " steps (%.2f per flipped)",
     walker->flipped, steps, kissat_average (steps, walker->flipped));
+  const double time = kissat_wall_clock_time () - started;
+  kissat_very_verbose (solver,
+    "%" PRIu64 " flips in %.2f seconds (%.0f flips per second)",
+    walker->flips, time, kissat_average (walker->flips, time));
   // clang-format on
   const unsigned after = walker->minimum;
   kissat_phase (
@@ -883,23 +1026,72 @@ static void check_walk (kissat *solver, unsigned expected) {
 
 #endif
 
+static void *walker_thread (void *ptr) {
+  local_search_round (ptr);
+  return 0;
+}
+
+// Runs all walkers, the first in the calling thread, and returns the one
+// with the smallest minimum (preferring smaller identifiers on ties).
+
+static walker *parallel_local_search (kissat *solver, walker *walkers,
+                                      unsigned threads) {
+  kissat_run_threads (solver, "walker", threads, walker_thread, walkers,
+                      sizeof *walkers);
+  walker *best = walkers;
+  for (unsigned i = 0; i < threads; i++) {
+    walker *walker = walkers + i;
+    if (i)
+      kissat_phase (solver, "walk", GET (walks),
+                    "walker %u minimum %u after %" PRIu64 " flips", i,
+                    walker->minimum, walker->flipped);
+    if (walker->minimum < best->minimum)
+      best = walker;
+  }
+  if (best != walkers)
+    kissat_phase (solver, "walk", GET (walks),
+                  "walker %u found best minimum %u", best->id,
+                  best->minimum);
+  return best;
+}
+
 static void walking_phase (kissat *solver) {
   INC (walks);
   litpairs irredundant;
   INIT_STACK (irredundant);
   kissat_enter_dense_mode (solver, &irredundant);
-  walker walker;
-  init_walker (solver, &walker, &irredundant);
-  init_walker_limit (solver, &walker);
-  local_search_round (&walker);
+  const unsigned threads = kissat_threads (GET_OPTION (walkthreads));
+  walker *walkers = kissat_nalloc (solver, threads, sizeof *walkers);
+  bool stop = false;
+  init_walker (solver, walkers, &irredundant);
+  init_walker_limit (solver, walkers);
+  walkers->stop = &stop;
+  for (unsigned i = 1; i < threads; i++)
+    init_helper_walker (solver, walkers + i, walkers, i);
+  walker *best;
+  if (threads > 1) {
+    kissat_phase (solver, "walk", GET (walks),
+                  "running %u walkers in parallel", threads);
+    best = parallel_local_search (solver, walkers, threads);
+  } else {
+    local_search_round (walkers);
+    best = walkers;
+  }
+  for (unsigned i = 0; i < threads; i++) {
+    walker *walker = walkers + i;
+    ADD (walk_steps, walker->steps - walker->start);
+    ADD (flipped, walker->flips);
+  }
 #ifdef CHECK_WALK
   bool improved =
 #endif
-      save_final_minimum (&walker);
+      save_final_minimum (best);
 #ifdef CHECK_WALK
-  unsigned expected = walker.minimum;
+  unsigned expected = best->minimum;
 #endif
-  release_walker (&walker);
+  for (unsigned i = 0; i < threads; i++)
+    release_walker (walkers + i);
+  kissat_dealloc (solver, walkers, threads, sizeof *walkers);
   kissat_resume_sparse_mode (solver, false, &irredundant);
   RELEASE_STACK (irredundant);
 #if CHECK_WALK
@@ -957,6 +1149,12 @@ void kissat_walk (kissat *solver) {
     return;
   }
 
+  if (kissat_memory_pressure (solver)) {
+    kissat_extremely_verbose (solver,
+                              "walking skipped due to memory pressure");
+    return;
+  }
+
   if (GET_OPTION (warmup))
     kissat_warmup (solver);
 
@@ -15,7 +15,9 @@ void kissat_remove_binary_watch (kissat *solver, watches *watches,
   while (p != end) {
     const watch watch = *q++ = *p++;
     if (!watch.type.binary) {
-      *q++ = *p++;
+      const union watch tail = *q++ = *p++;
+      if (tail.tail.ternary)
+        *q++ = *p++;
       continue;
     }
     const unsigned other = watch.binary.lit;
@@ -48,33 +50,33 @@ void kissat_remove_blocking_watch (kissat *solver, watches *watches,
   watch *const end = END_WATCHES (*watches);
   watch *q = begin;
   watch const *p = q;
-#ifndef NDEBUG
-  bool found = false;
-#endif
+  unsigned removed = 0;
   while (p != end) {
     const watch head = *q++ = *p++;
     if (head.type.binary)
       continue;
     const watch tail = *q++ = *p++;
-    if (tail.raw != ref)
+    const unsigned words = 2 + tail.tail.ternary;
+    if (tail.tail.ternary)
+      *q++ = *p++;
+    if (tail.tail.ref != ref)
       continue;
-#ifndef NDEBUG
-    assert (!found);
-    found = true;
-#endif
-    q -= 2;
+    assert (!removed);
+    removed = words;
+    q -= words;
   }
-  assert (found);
+  assert (removed);
 #ifdef COMPACT
-  watches->size -= 2;
+  watches->size -= removed;
 #else
-  assert (begin + 2 <= end);
-  watches->end -= 2;
+  assert (begin + removed <= end);
+  watches->end -= removed;
 #endif
   const watch empty = {.raw = INVALID_VECTOR_ELEMENT};
-  end[-2] = end[-1] = empty;
-  assert (solver->vectors.usable < MAX_SECTOR - 2);
-  solver->vectors.usable += 2;
+  for (watch *e = end - removed; e != end; e++)
+    *e = empty;
+  assert (solver->vectors.usable < MAX_SECTOR - removed);
+  solver->vectors.usable += removed;
   kissat_check_vectors (solver);
 }
 
@@ -118,9 +120,12 @@ void kissat_flush_large_watches (kissat *solver) {
     const watch *const end = END_WATCHES (*lit_watches), *p = q;
     while (p != end) {
       const watch watch = *q++ = *p++;
-      if (!watch.type.binary)
-        p++, q--;
-      else {
+      if (!watch.type.binary) {
+        const union watch tail = *p++;
+        if (tail.tail.ternary)
+          p++;
+        q--;
+      } else {
         const unsigned other = watch.binary.lit;
         if (marks[other]) {
           if (lit < other) {
@@ -158,11 +163,7 @@ void kissat_watch_large_clauses (kissat *solver) {
     c->searched = 2;
 
     const reference ref = (ward *) c - arena;
-    const unsigned l0 = lits[0];
-    const unsigned l1 = lits[1];
-
-    kissat_push_blocking_watch (solver, watches + l0, l1, ref);
-    kissat_push_blocking_watch (solver, watches + l1, l0, ref);
+    kissat_push_clause_watches (solver, watches, c->size, lits, ref);
   }
 }
 
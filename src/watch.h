@@ -14,6 +14,7 @@ typedef struct binary_tagged_literal watch_type;
 typedef struct binary_tagged_literal binary_watch;
 typedef struct binary_tagged_literal blocking_watch;
 typedef struct binary_tagged_reference large_watch;
+typedef struct ternary_tagged_reference tail_watch;
 
 struct binary_tagged_literal {
 #ifdef KISSAT_IS_BIG_ENDIAN
@@ -35,11 +36,28 @@ struct binary_tagged_reference {
 #endif
 };
 
+// While watching clauses the reference following a blocking literal is
+// tagged if the clause has exactly three literals.  Then a third word
+// follows which holds the remaining literal of the clause, such that the
+// blocking and that third literal are the two other literals.  Their order
+// is irrelevant and they do not determine which literals are watched.
+
+struct ternary_tagged_reference {
+#ifdef KISSAT_IS_BIG_ENDIAN
+  bool ternary : 1;
+  unsigned ref : 31;
+#else
+  unsigned ref : 31;
+  bool ternary : 1;
+#endif
+};
+
 union watch {
   watch_type type;
   binary_watch binary;
   blocking_watch blocking;
   large_watch large;
+  tail_watch tail;
   unsigned raw;
 };
 
@@ -97,6 +115,17 @@ static inline watch kissat_blocking_watch (unsigned lit) {
   return res;
 }
 
+static inline watch kissat_tail_watch (reference ref, bool ternary) {
+  watch res;
+  res.tail.ref = ref;
+  res.tail.ternary = ternary;
+  return res;
+}
+
+static inline unsigned kissat_watch_words (const watch *watch) {
+  return watch->type.binary ? 1 : 2 + watch[1].tail.ternary;
+}
+
 #define EMPTY_WATCHES(W) kissat_empty_vector (&W)
 #define SIZE_WATCHES(W) kissat_size_vector (&W)
 
@@ -141,16 +170,16 @@ static inline watch kissat_blocking_watch (unsigned lit) {
       *const WATCH##_END = END_WATCHES (WATCHES); \
   WATCH##_PTR != WATCH##_END && \
       ((WATCH = *WATCH##_PTR), \
-       (REF = WATCH.type.binary ? INVALID_REF : WATCH##_PTR[1].large.ref), \
+       (REF = WATCH.type.binary ? INVALID_REF : WATCH##_PTR[1].tail.ref), \
        true); \
-  WATCH##_PTR += 1u + !WATCH.type.binary
+  WATCH##_PTR += kissat_watch_words (WATCH##_PTR)
 
 #define all_binary_blocking_watches(WATCH, WATCHES) \
   watch WATCH, \
       *WATCH##_PTR = (assert (solver->watching), BEGIN_WATCHES (WATCHES)), \
       *const WATCH##_END = END_WATCHES (WATCHES); \
   WATCH##_PTR != WATCH##_END && ((WATCH = *WATCH##_PTR), true); \
-  WATCH##_PTR += 1u + !WATCH.type.binary
+  WATCH##_PTR += kissat_watch_words (WATCH##_PTR)
 
 #define all_binary_large_watches(WATCH, WATCHES) \
   watch WATCH, \
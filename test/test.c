@@ -450,6 +450,7 @@ int main (int argc, char **argv) {
   SCHEDULE (vector);
   SCHEDULE (rank);
   SCHEDULE (sort);
+  SCHEDULE (simd);
   SCHEDULE (bump);
   SCHEDULE (options);
   SCHEDULE (config);
@@ -457,6 +458,8 @@ int main (int argc, char **argv) {
   SCHEDULE (add);
   SCHEDULE (file);
   SCHEDULE (parse);
+  SCHEDULE (snapshot);
+  SCHEDULE (checkpoint);
   SCHEDULE (usage);
   SCHEDULE (main);
   SCHEDULE (collect);
@@ -464,10 +467,13 @@ int main (int argc, char **argv) {
   SCHEDULE (solve);
   SCHEDULE (coverage);
   SCHEDULE (terminate);
+  SCHEDULE (share);
+  SCHEDULE (incremental);
+  SCHEDULE (threads);
 
 #ifndef NPROOFS
-  if (tissat_found_drabt || tissat_found_drat_trim)
-    SCHEDULE (prove);
+  SCHEDULE (prove);
+  SCHEDULE (lrat);
 #endif
 
 #ifndef NDEBUG
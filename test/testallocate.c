@@ -1,5 +1,6 @@
 #include "../src/allocate.h"
 #include "../src/error.h"
+#include "../src/file.h"
 
 #include <string.h>
 
@@ -45,6 +46,117 @@ static void test_allocate_coverage (void) {
   assert (!p);
 }
 
+// Custom allocator prepending the size of each block in a header, which
+// allows to check that the solver passes the right sizes when freeing.
+
+struct custom {
+  size_t allocated, current, max;
+};
+
+#define HEADER 16
+
+static void *custom_allocate (void *state, size_t bytes) {
+  struct custom *custom = state;
+  char *res = malloc (HEADER + bytes);
+  if (!res)
+    return 0;
+  *(size_t *) res = bytes;
+  custom->allocated++;
+  custom->current += bytes;
+  if (custom->current > custom->max)
+    custom->max = custom->current;
+  return res + HEADER;
+}
+
+static void custom_deallocate (void *state, void *ptr, size_t bytes) {
+  struct custom *custom = state;
+  char *block = (char *) ptr - HEADER;
+  if (*(size_t *) block != bytes)
+    FATAL ("freeing %zu bytes of block of size %zu", bytes,
+           *(size_t *) block);
+  assert (custom->current >= bytes);
+  custom->current -= bytes;
+  free (block);
+}
+
+static void *custom_reallocate (void *state, void *ptr, size_t old_bytes,
+                                size_t new_bytes) {
+  if (!ptr) {
+    assert (!old_bytes);
+    return custom_allocate (state, new_bytes);
+  }
+  void *res = custom_allocate (state, new_bytes);
+  if (res) {
+    memcpy (res, ptr, old_bytes < new_bytes ? old_bytes : new_bytes);
+    custom_deallocate (state, ptr, old_bytes);
+  }
+  return res;
+}
+
+static void test_allocate_custom (void) {
+  struct custom custom;
+  memset (&custom, 0, sizeof custom);
+  kissat_set_allocator (&custom, custom_allocate, custom_reallocate,
+                        custom_deallocate);
+  kissat *solver = kissat_init ();
+  const int holes = 5, pigeons = holes + 1;
+  for (int p = 0; p < pigeons; p++) {
+    for (int h = 1; h <= holes; h++)
+      kissat_add (solver, p * holes + h);
+    kissat_add (solver, 0);
+  }
+  for (int h = 1; h <= holes; h++)
+    for (int p = 0; p < pigeons; p++)
+      for (int q = p + 1; q < pigeons; q++) {
+        kissat_add (solver, -(p * holes + h));
+        kissat_add (solver, -(q * holes + h));
+        kissat_add (solver, 0);
+      }
+  const int res = kissat_solve (solver);
+  kissat_release (solver);
+  kissat_set_allocator (0, 0, 0, 0);
+  if (res != 20)
+    FATAL ("expected '20' but got '%d'", res);
+  if (custom.current)
+    FATAL ("custom allocator leaked %zu bytes", custom.current);
+  if (!custom.allocated)
+    FATAL ("custom allocator not used");
+  printf ("custom allocator: %zu allocations, maximum %zu bytes\n",
+          custom.allocated, custom.max);
+}
+
+// Reading compressed files and searching executables allocates memory
+// without a solver, which has to go through the custom allocator too.
+
+static void test_allocate_custom_file (void) {
+  struct custom custom;
+  memset (&custom, 0, sizeof custom);
+  kissat_set_allocator (&custom, custom_allocate, custom_reallocate,
+                        custom_deallocate);
+  (void) kissat_find_executable ("sh");
+  const size_t searched = custom.allocated;
+#ifdef KISSAT_HAS_ZLIB
+  const char *path = "../test/file/2.gz";
+  file file;
+  if (!kissat_open_to_read_file (&file, path))
+    FATAL ("failed to open '%s' for reading", path);
+  while (kissat_getc (&file) != EOF)
+    ;
+  kissat_close_file (&file);
+#endif
+  kissat_set_allocator (0, 0, 0, 0);
+  if (custom.current)
+    FATAL ("custom allocator leaked %zu bytes", custom.current);
+  if (!searched)
+    FATAL ("custom allocator not used for searching executables");
+#ifdef KISSAT_HAS_ZLIB
+  if (custom.allocated == searched)
+    FATAL ("custom allocator not used for decompression");
+#endif
+  printf ("custom allocator: %zu allocations, maximum %zu bytes\n",
+          custom.allocated, custom.max);
+}
+
 #ifndef ASAN
 
 #include <setjmp.h>
@@ -92,6 +204,9 @@ static void test_allocate_error (void) {
 void tissat_schedule_allocate (void) {
   SCHEDULE_FUNCTION (test_allocate_basic);
   SCHEDULE_FUNCTION (test_allocate_coverage);
+  SCHEDULE_FUNCTION (test_allocate_custom);
+  if (tissat_found_test_directory)
+    SCHEDULE_FUNCTION (test_allocate_custom_file);
 #ifndef ASAN
   SCHEDULE_FUNCTION (test_allocate_error);
 #endif
@@ -36,7 +36,7 @@ static void test_arena_realloc (void) {
   printf ("before allocating arena %s\n", formatted);
 #endif
   const unsigned bytes = (1u << 22);
-  const unsigned size = bytes / 4 - 3;
+  const unsigned size = (bytes - sizeof (clause)) / sizeof (unsigned) + 3;
   const unsigned n = tissat_big ? (1u << 8) : (1u << 3);
   for (unsigned i = 0; i < n; i++) {
     reference ref = kissat_allocate_clause (solver, size);
@@ -122,7 +122,9 @@ static void test_arena_fatal (void) {
                       FORMAT_BYTES (capacity * sizeof (ward)));
       assert (capacity == MAX_ARENA);
       assert (size + 1 == MAX_ARENA);
-      kissat_allocate_clause (solver, 3);
+      // Needs at least two arena words even with '--double-arena'.
+      const size_t ward_bytes = sizeof (ward);
+      kissat_allocate_clause (solver, 3 + ward_bytes / sizeof (unsigned));
     }
     kissat_call_function_instead_of_abort (0);
     FATAL ("long jump not taken");
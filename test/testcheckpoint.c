@@ -0,0 +1,139 @@
+#include "../src/backtrack.h"
+#include "../src/checkpoint.h"
+#include "../src/file.h"
+#include "../src/parse.h"
+
+#include "test.h"
+#include "testcnfs.h"
+
+#define CONFLICTS_PER_ROUND 20
+#define MAX_ROUNDS 1000
+
+static kissat *parse_solver (const char *cnf, int *max_var_ptr,
+                             ints *literals) {
+  kissat *solver = kissat_init ();
+  tissat_init_solver (solver);
+  file file;
+  if (!kissat_open_to_read_file (&file, cnf))
+    FATAL ("could not open '%s' for reading", cnf);
+  uint64_t lineno;
+  const char *error = kissat_parse_dimacs (solver, NORMAL_PARSING, &file,
+                                           &lineno, max_var_ptr, literals);
+  kissat_close_file (&file);
+  if (error)
+    FATAL ("unexpected parse error in '%s': %s", cnf, error);
+  return solver;
+}
+
+static void write_checkpoint (kissat *solver, const char *path,
+                              int max_var) {
+  kissat_backtrack_propagate_and_flush_trail (solver);
+  kissat_set_checkpoint (solver, path, max_var);
+  if (!kissat_write_checkpoint (solver, path))
+    FATAL ("could not write checkpoint '%s'", path);
+}
+
+static void check_model (kissat *solver, ints *literals) {
+  bool satisfied = false;
+  for (all_stack (int, lit, *literals))
+    if (!lit) {
+      if (!satisfied)
+        FATAL ("resumed model does not satisfy clause");
+      satisfied = false;
+    } else if (kissat_value (solver, lit) == lit)
+      satisfied = true;
+}
+
+static void test_checkpoint_rounds (int expected, const char *cnf,
+                                    const char *name) {
+  char path[64];
+  sprintf (path, "%s.checkpoint", name);
+  ints literals;
+  INIT_STACK (literals);
+  int max_var;
+  kissat *original = parse_solver (cnf, &max_var, &literals);
+  kissat *solver = parse_solver (cnf, &max_var, 0);
+  unsigned rounds = 0;
+  int res;
+  for (;;) {
+    kissat_set_conflict_limit (solver, CONFLICTS_PER_ROUND);
+    res = kissat_solve (solver);
+    if (res || solver->inconsistent || ++rounds == MAX_ROUNDS)
+      break;
+    write_checkpoint (solver, path, max_var);
+    kissat_release (solver);
+    solver = kissat_init ();
+    tissat_init_solver (solver);
+    int resumed_max_var;
+    const char *error = kissat_resume (solver, path, &resumed_max_var);
+    if (error)
+      FATAL ("unexpected error resuming '%s': %s", path, error);
+    if (resumed_max_var != max_var)
+      FATAL ("checkpoint '%s' maximum variable %d instead of %d", path,
+             resumed_max_var, max_var);
+  }
+  if (res != expected)
+    FATAL ("solving '%s' with %u checkpoints returned '%d' "
+           "but expected '%d'",
+           cnf, rounds, res, expected);
+  if (res == 10)
+    check_model (solver, &literals);
+  kissat_release (solver);
+  solver = original;
+  RELEASE_STACK (literals);
+  kissat_release (solver);
+  tissat_verbose ("solved '%s' with %u checkpoints and result '%d'", cnf,
+                  rounds, res);
+}
+
+static void test_checkpoint_resume (void) {
+#define CNF(EXPECTED, NAME, BIG) \
+  if (!BIG) \
+    test_checkpoint_rounds (EXPECTED, "../test/cnf/" #NAME ".cnf", #NAME);
+  CNFS
+#undef CNF
+}
+
+static void expect_resume_error (const char *path) {
+  kissat *solver = kissat_init ();
+  tissat_init_solver (solver);
+  int max_var;
+  const char *error = kissat_resume (solver, path, &max_var);
+  if (!error)
+    FATAL ("resuming invalid checkpoint '%s' succeeded", path);
+  tissat_verbose ("resuming '%s' failed as expected: %s", path, error);
+  kissat_release (solver);
+}
+
+static void test_checkpoint_invalid (void) {
+  const char *complete = "checkpoint.complete";
+  const char *truncated = "checkpoint.truncated";
+  int max_var;
+  kissat *solver = parse_solver ("../test/cnf/prime65537.cnf", &max_var, 0);
+  kissat_set_conflict_limit (solver, CONFLICTS_PER_ROUND);
+  if (kissat_solve (solver))
+    FATAL ("unexpected result solving 'prime65537.cnf' with limit");
+  write_checkpoint (solver, complete, max_var);
+  kissat_release (solver);
+  FILE *src = fopen (complete, "rb");
+  FILE *dst = fopen (truncated, "wb");
+  if (!src || !dst)
+    FATAL ("could not copy '%s' to '%s'", complete, truncated);
+  fseek (src, 0, SEEK_END);
+  const long size = ftell (src);
+  rewind (src);
+  for (long i = 0; i + 1 < size; i++)
+    fputc (fgetc (src), dst);
+  fclose (src);
+  fclose (dst);
+  expect_resume_error (truncated);
+  expect_resume_error ("../test/cnf/add8.cnf");
+  expect_resume_error ("../test/file/non-existing");
+}
+
+void tissat_schedule_checkpoint (void) {
+  if (!tissat_found_test_directory)
+    return;
+  SCHEDULE_FUNCTION (test_checkpoint_resume);
+  SCHEDULE_FUNCTION (test_checkpoint_invalid);
+}
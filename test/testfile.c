@@ -146,6 +146,125 @@ static void test_file_read_compressed (void) {
 
 #endif
 
+#ifdef KISSAT_HAS_DECOMPRESSION
+
+static void test_file_read_decompressed (void) {
+  const size_t expected_bytes = kissat_file_size ("../test/file/0");
+#define READ_DECOMPRESSED(PATH) \
+  do { \
+    file file; \
+    if (!kissat_open_to_read_file (&file, PATH)) \
+      FATAL ("failed to open compressed '%s' for reading", PATH); \
+    if (!file.decompressor) \
+      FATAL ("no built-in decompressor for '%s'", PATH); \
+    char buffer[7]; \
+    size_t bytes; \
+    while ((bytes = kissat_read (&file, buffer, sizeof buffer))) \
+      ; \
+    if (kissat_getc (&file) != EOF) \
+      FATAL ("expected end-of-file reading '%s'", PATH); \
+    printf ("closing '%s' after reading '%" PRIu64 "' bytes\n", PATH, \
+            file.bytes); \
+    kissat_close_file (&file); \
+    if (file.bytes != expected_bytes) \
+      FATAL ("read '%" PRIu64 "' bytes but expected '%zu'", file.bytes, \
+             expected_bytes); \
+  } while (0)
+#ifdef KISSAT_HAS_BZIP2
+  READ_DECOMPRESSED ("../test/file/1.bz2");
+#endif
+#ifdef KISSAT_HAS_ZLIB
+  READ_DECOMPRESSED ("../test/file/2.gz");
+#endif
+#ifdef KISSAT_HAS_LZMA
+  READ_DECOMPRESSED ("../test/file/3.lzma");
+  READ_DECOMPRESSED ("../test/file/5.xz");
+#endif
+#undef READ_DECOMPRESSED
+}
+
+static void test_file_read_truncated (void) {
+#define READ_TRUNCATED(PATH) \
+  do { \
+    file file; \
+    if (!kissat_open_to_read_file (&file, PATH)) \
+      FATAL ("failed to open compressed '%s' for reading", PATH); \
+    if (!file.decompressor) \
+      FATAL ("no built-in decompressor for '%s'", PATH); \
+    if (kissat_file_error (&file)) \
+      FATAL ("unexpected error before reading '%s'", PATH); \
+    while (kissat_getc (&file) != EOF) \
+      ; \
+    const char *error = kissat_file_error (&file); \
+    if (!error) \
+      FATAL ("expected error after reading '%s'", PATH); \
+    printf ("reading '%s' failed with '%s' as expected\n", PATH, error); \
+    kissat_close_file (&file); \
+  } while (0)
+#ifdef KISSAT_HAS_BZIP2
+  READ_TRUNCATED ("../test/file/truncated.bz2");
+#endif
+#ifdef KISSAT_HAS_ZLIB
+  READ_TRUNCATED ("../test/file/truncated.gz");
+#endif
+#ifdef KISSAT_HAS_LZMA
+  READ_TRUNCATED ("../test/file/truncated.xz");
+#endif
+#undef READ_TRUNCATED
+}
+
+static void test_file_write_compressed (void) {
+  const char *original = "../test/file/0";
+  FILE *input = fopen (original, "rb");
+  if (!input)
+    FATAL ("failed to open '%s' for reading", original);
+  char expected[1 << 12];
+  const size_t expected_bytes = fread (expected, 1, sizeof expected, input);
+  fclose (input);
+  if (!expected_bytes || expected_bytes == sizeof expected)
+    FATAL ("unexpected size of '%s'", original);
+#define WRITE_COMPRESSED(PATH) \
+  do { \
+    file file; \
+    if (!kissat_open_to_write_file (&file, PATH)) \
+      FATAL ("failed to open compressed '%s' for writing", PATH); \
+    if (!file.compressor) \
+      FATAL ("no built-in compressor for '%s'", PATH); \
+    const size_t half = expected_bytes / 2; \
+    if (kissat_write (&file, expected, half) != half) \
+      FATAL ("failed to write first half of '%s'", PATH); \
+    kissat_flush (&file); \
+    for (size_t i = half; i != expected_bytes; i++) \
+      kissat_putc (&file, expected[i]); \
+    kissat_close_file (&file); \
+    if (!kissat_open_to_read_file (&file, PATH)) \
+      FATAL ("failed to open compressed '%s' for reading", PATH); \
+    if (!file.decompressor) \
+      FATAL ("no built-in decompressor for '%s'", PATH); \
+    for (size_t i = 0; i != expected_bytes; i++) \
+      if (kissat_getc (&file) != (unsigned char) expected[i]) \
+        FATAL ("character %zu in '%s' differs", i, PATH); \
+    if (kissat_getc (&file) != EOF) \
+      FATAL ("expected end-of-file reading '%s'", PATH); \
+    kissat_close_file (&file); \
+    printf ("wrote and read back '%zu' bytes of '%s'\n", expected_bytes, \
+            PATH); \
+  } while (0)
+#ifdef KISSAT_HAS_BZIP2
+  WRITE_COMPRESSED ("written.bz2");
+#endif
+#ifdef KISSAT_HAS_ZLIB
+  WRITE_COMPRESSED ("written.gz");
+#endif
+#ifdef KISSAT_HAS_LZMA
+  WRITE_COMPRESSED ("written.lzma");
+  WRITE_COMPRESSED ("written.xz");
+#endif
+#undef WRITE_COMPRESSED
+}
+
+#endif
+
 static void test_file_read_uncompressed (void) {
   const size_t expected_bytes = kissat_file_size ("../test/file/0");
 #define READ_UNCOMPRESSED(EXPECTED, PATH) \
@@ -235,6 +354,14 @@ void tissat_schedule_file (void) {
     SCHEDULE_FUNCTION (test_file_writable);
   if (tissat_found_test_directory)
     SCHEDULE_FUNCTION (test_file_read_uncompressed);
+#ifdef KISSAT_HAS_DECOMPRESSION
+  if (tissat_found_test_directory)
+    SCHEDULE_FUNCTION (test_file_read_decompressed);
+  if (tissat_found_test_directory)
+    SCHEDULE_FUNCTION (test_file_read_truncated);
+  if (tissat_found_test_directory)
+    SCHEDULE_FUNCTION (test_file_write_compressed);
+#endif
 #ifdef KISSAT_COMPRESSED
   SCHEDULE_FUNCTION (test_file_write_and_read_compressed);
   if (tissat_found_test_directory)
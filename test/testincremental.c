@@ -0,0 +1,171 @@
+#include "../src/parse.h"
+
+#include <inttypes.h>
+
+#include "test.h"
+
+static kissat *new_incremental_solver (void) {
+  kissat *solver = kissat_init ();
+  tissat_init_solver (solver);
+  kissat_set_option (solver, "incremental", 1);
+  return solver;
+}
+
+static void solve_and_check (kissat *solver, int expected) {
+  const int res = kissat_solve (solver);
+  if (res != expected)
+    FATAL ("solver returned '%d' but expected '%d'", res, expected);
+}
+
+#define CLAUSE(...) \
+  do { \
+    const int lits[] = {__VA_ARGS__, 0}; \
+    for (const int *p = lits; *p; p++) \
+      kissat_add (solver, *p); \
+    kissat_add (solver, 0); \
+  } while (0)
+
+static void test_incremental_assumptions (void) {
+  kissat *solver = new_incremental_solver ();
+  CLAUSE (-1, 2);
+  CLAUSE (-2, 3);
+  CLAUSE (4, 5);
+  kissat_assume (solver, 1);
+  kissat_assume (solver, 4);
+  kissat_assume (solver, -3);
+  solve_and_check (solver, 20);
+  if (!kissat_failed (solver, 1))
+    FATAL ("assumption '1' not in failed core");
+  if (!kissat_failed (solver, -3))
+    FATAL ("assumption '-3' not in failed core");
+  if (kissat_failed (solver, 4))
+    FATAL ("unnecessary assumption '4' in failed core");
+  solve_and_check (solver, 10);
+  if (kissat_failed (solver, 1))
+    FATAL ("failed assumption '1' not reset");
+  kissat_assume (solver, -4);
+  solve_and_check (solver, 10);
+  if (kissat_value (solver, 5) != 5)
+    FATAL ("assumption '-4' does not force '5'");
+  CLAUSE (-3);
+  CLAUSE (-5);
+  solve_and_check (solver, 10);
+  if (kissat_value (solver, 1) != -1)
+    FATAL ("unit '-3' does not force '-1'");
+  kissat_assume (solver, -4);
+  solve_and_check (solver, 20);
+  if (!kissat_failed (solver, -4))
+    FATAL ("assumption '-4' not in failed core");
+  CLAUSE (-4);
+  solve_and_check (solver, 20);
+  kissat_release (solver);
+}
+
+static void test_incremental_after_lucky (void) {
+  kissat *solver = new_incremental_solver ();
+  CLAUSE (1, 2);
+  CLAUSE (3, 4);
+  CLAUSE (1, -3, 4);
+  solve_and_check (solver, 10);
+  if (solver->statistics.searches)
+    FATAL ("first call not decided by lucky");
+  CLAUSE (-1);
+  CLAUSE (-2, 5);
+  kissat_assume (solver, -5);
+  solve_and_check (solver, 20);
+  if (!kissat_failed (solver, -5))
+    FATAL ("assumption '-5' not in failed core");
+  kissat_assume (solver, 3);
+  solve_and_check (solver, 10);
+  if (kissat_value (solver, 1) != -1)
+    FATAL ("unit '-1' not satisfied");
+  if (kissat_value (solver, 5) != 5)
+    FATAL ("unit '-1' does not force '5'");
+  if (kissat_value (solver, 4) != 4)
+    FATAL ("assumption '3' does not force '4'");
+  kissat_release (solver);
+}
+
+static void add_pigeon_hole (kissat *solver, int holes, int pigeons) {
+#define HOLE(P, H) (1 + (P) * holes + (H))
+  for (int p = 0; p < pigeons; p++) {
+    for (int h = 0; h < holes; h++)
+      kissat_add (solver, HOLE (p, h));
+    kissat_add (solver, 0);
+  }
+  for (int h = 0; h < holes; h++)
+    for (int p = 0; p < pigeons; p++)
+      for (int q = p + 1; q < pigeons; q++)
+        CLAUSE (-HOLE (p, h), -HOLE (q, h));
+#undef HOLE
+}
+
+static void test_incremental_satisfied_assumptions (void) {
+  for (int pigeons = 8; pigeons <= 9; pigeons++) {
+    kissat *solver = new_incremental_solver ();
+    kissat_set_option (solver, "lucky", 0);
+    kissat_set_option (solver, "restartint", 1);
+    add_pigeon_hole (solver, 8, pigeons);
+    const int unit = 8 * pigeons + 1;
+    CLAUSE (unit);
+    CLAUSE (unit + 1, unit + 2);
+    CLAUSE (-unit, unit + 2);
+    kissat_assume (solver, unit);
+    kissat_assume (solver, unit + 2);
+    const int expected = pigeons == 8 ? 10 : 20;
+    solve_and_check (solver, expected);
+    if (solver->statistics.restarts < 10)
+      FATAL ("expected at least 10 restarts but got %" PRIu64,
+             solver->statistics.restarts);
+    if (kissat_failed (solver, unit) || kissat_failed (solver, unit + 2))
+      FATAL ("satisfied assumption in failed core");
+    if (expected == 10) {
+      kissat_assume (solver, -unit);
+      solve_and_check (solver, 20);
+      if (!kissat_failed (solver, -unit))
+        FATAL ("assumption '%d' not in failed core", -unit);
+    }
+    kissat_release (solver);
+  }
+}
+
+static void test_incremental_block_factorization (void) {
+  const char *cnf = "../test/cnf/prime841.cnf";
+  kissat *solver = new_incremental_solver ();
+  file file;
+  if (!kissat_open_to_read_file (&file, cnf))
+    FATAL ("could not read '%s'", cnf);
+  uint64_t lineno;
+  int max_var;
+  const char *error = kissat_parse_dimacs (solver, RELAXED_PARSING, &file,
+                                           &lineno, &max_var, 0);
+  if (error)
+    FATAL ("unexpected parse error: %s", error);
+  kissat_close_file (&file);
+  int *model = malloc ((max_var + 1) * sizeof *model);
+  if (!model)
+    FATAL ("out-of-memory allocating model");
+  unsigned solutions = 0;
+  while (kissat_solve (solver) == 10) {
+    if (++solutions > 1)
+      FATAL ("more than one factorization found");
+    for (int idx = 1; idx <= max_var; idx++)
+      model[idx] = kissat_value (solver, idx);
+    for (int idx = 1; idx <= max_var; idx++)
+      if (model[idx])
+        kissat_add (solver, -model[idx]);
+    kissat_add (solver, 0);
+  }
+  kissat_release (solver);
+  free (model);
+  if (solutions != 1)
+    FATAL ("found %u instead of one factorization", solutions);
+}
+
+void tissat_schedule_incremental (void) {
+  SCHEDULE_FUNCTION (test_incremental_assumptions);
+  SCHEDULE_FUNCTION (test_incremental_after_lucky);
+  SCHEDULE_FUNCTION (test_incremental_satisfied_assumptions);
+  if (tissat_found_test_directory)
+    SCHEDULE_FUNCTION (test_incremental_block_factorization);
+}
@@ -0,0 +1,390 @@
+#ifndef NPROOFS
+
+#include "../src/file.h"
+#include "../src/parse.h"
+#include "../src/proof.h"
+
+#include "test.h"
+#include "testcnfs.h"
+
+#include <ctype.h>
+#include <inttypes.h>
+#include <stdlib.h>
+
+// A simple forward LRAT checker, following the specification of the
+// format, to validate identifiers and hints produced by the tracer.
+
+typedef struct lrat_checker lrat_checker;
+
+struct lrat_checker {
+  const char *path;
+  int **clauses;
+  size_t size_clauses;
+  uint64_t last;
+  signed char *values;
+  int max_var;
+  int *trail;
+  size_t size_trail;
+  size_t capacity_trail;
+  int *lits;
+  size_t size_lits;
+  size_t capacity_lits;
+  int64_t *hints;
+  size_t size_hints;
+  size_t capacity_hints;
+  file file;
+  int saved;
+  bool binary;
+};
+
+#define ENLARGE(P, SIZE, CAPACITY) \
+  do { \
+    if ((SIZE) < (CAPACITY)) \
+      break; \
+    (CAPACITY) = (CAPACITY) ? 2 * (CAPACITY) : 16; \
+    (P) = realloc ((P), (CAPACITY) * sizeof *(P)); \
+    if (!(P)) \
+      FATAL ("out-of-memory in LRAT checker"); \
+  } while (0)
+
+static void import_variable (lrat_checker *checker, int lit) {
+  const int idx = abs (lit);
+  if (idx <= checker->max_var)
+    return;
+  checker->values = realloc (checker->values, 2 * (idx + 1));
+  if (!checker->values)
+    FATAL ("out-of-memory in LRAT checker");
+  memset (checker->values + 2 * (checker->max_var + 1), 0,
+          2 * (idx - checker->max_var));
+  checker->max_var = idx;
+}
+
+static signed char checker_value (lrat_checker *checker, int lit) {
+  const int idx = abs (lit);
+  assert (idx <= checker->max_var);
+  return checker->values[2 * idx + (lit < 0)];
+}
+
+static void assign (lrat_checker *checker, int lit) {
+  const int idx = abs (lit);
+  checker->values[2 * idx + (lit < 0)] = 1;
+  checker->values[2 * idx + (lit > 0)] = -1;
+  ENLARGE (checker->trail, checker->size_trail, checker->capacity_trail);
+  checker->trail[checker->size_trail++] = lit;
+}
+
+static void backtrack (lrat_checker *checker, size_t level) {
+  while (checker->size_trail > level) {
+    const int idx = abs (checker->trail[--checker->size_trail]);
+    checker->values[2 * idx] = checker->values[2 * idx + 1] = 0;
+  }
+}
+
+static void add_clause (lrat_checker *checker, uint64_t id) {
+  if (id <= checker->last)
+    FATAL ("non-increasing clause identifier %" PRIu64 " in '%s'", id,
+           checker->path);
+  checker->last = id;
+  while (checker->size_clauses <= id) {
+    const size_t old_size = checker->size_clauses;
+    const size_t new_size = old_size ? 2 * old_size : 1024;
+    checker->clauses =
+        realloc (checker->clauses, new_size * sizeof *checker->clauses);
+    if (!checker->clauses)
+      FATAL ("out-of-memory in LRAT checker");
+    memset (checker->clauses + old_size, 0,
+            (new_size - old_size) * sizeof *checker->clauses);
+    checker->size_clauses = new_size;
+  }
+  int *c = malloc ((checker->size_lits + 1) * sizeof *c);
+  if (!c)
+    FATAL ("out-of-memory in LRAT checker");
+  memcpy (c, checker->lits, checker->size_lits * sizeof *c);
+  c[checker->size_lits] = 0;
+  checker->clauses[id] = c;
+}
+
+static int *checker_clause (lrat_checker *checker, int64_t id) {
+  if (id <= 0 || (uint64_t) id >= checker->size_clauses ||
+      !checker->clauses[id])
+    FATAL ("hint %" PRId64 " in '%s' refers to missing clause", id,
+           checker->path);
+  return checker->clauses[id];
+}
+
+// Returns '1' on conflict, '0' if the hint became unit and '-1' otherwise.
+
+static int propagate_hint (lrat_checker *checker, int64_t id) {
+  int unit = 0;
+  for (const int *p = checker_clause (checker, id); *p; p++) {
+    const signed char tmp = checker_value (checker, *p);
+    if (tmp > 0)
+      return -1;
+    if (tmp < 0)
+      continue;
+    if (unit && unit != *p)
+      return -1;
+    unit = *p;
+  }
+  if (!unit)
+    return 1;
+  assign (checker, unit);
+  return 0;
+}
+
+static bool check_lemma (lrat_checker *checker) {
+  const size_t size = checker->size_lits;
+  const int *lits = checker->lits;
+  for (size_t i = 0; i != size; i++) {
+    import_variable (checker, lits[i]);
+    if (!checker_value (checker, lits[i]))
+      assign (checker, -lits[i]);
+  }
+  const int64_t *hints = checker->hints;
+  const size_t size_hints = checker->size_hints;
+  for (size_t i = 0; i != size_hints; i++) {
+    if (hints[i] < 0)
+      FATAL ("unexpected RAT hint %" PRId64 " in '%s'", hints[i],
+             checker->path);
+    const int res = propagate_hint (checker, hints[i]);
+    if (res > 0)
+      return i + 1 == size_hints;
+    if (res < 0)
+      return false;
+  }
+  return false;
+}
+
+static int next_char (lrat_checker *checker) {
+  const int res = checker->saved;
+  if (res == EOF)
+    return kissat_getc (&checker->file);
+  checker->saved = EOF;
+  return res;
+}
+
+static bool read_integer (lrat_checker *checker, int64_t *res) {
+  int ch;
+  do
+    ch = next_char (checker);
+  while (ch == ' ' || ch == '\n');
+  if (ch == EOF)
+    return false;
+  bool sign = (ch == '-');
+  if (sign)
+    ch = next_char (checker);
+  if (!isdigit (ch))
+    FATAL ("expected digit in '%s'", checker->path);
+  int64_t tmp = ch - '0';
+  while (isdigit (ch = next_char (checker)))
+    tmp = 10 * tmp + (ch - '0');
+  *res = sign ? -tmp : tmp;
+  return true;
+}
+
+static uint64_t read_unsigned (lrat_checker *checker) {
+  uint64_t res = 0;
+  unsigned shift = 0;
+  int ch;
+  do {
+    ch = kissat_getc (&checker->file);
+    if (ch == EOF)
+      FATAL ("unexpected end-of-file in '%s'", checker->path);
+    res |= (uint64_t) (ch & 0x7f) << shift;
+    shift += 7;
+  } while (ch & 0x80);
+  return res;
+}
+
+static int64_t read_binary (lrat_checker *checker) {
+  const uint64_t tmp = read_unsigned (checker);
+  const int64_t res = tmp / 2;
+  return (tmp & 1) ? -res : res;
+}
+
+static int64_t read_number (lrat_checker *checker) {
+  int64_t res;
+  if (checker->binary)
+    return read_binary (checker);
+  if (!read_integer (checker, &res))
+    FATAL ("unexpected end-of-file in '%s'", checker->path);
+  return res;
+}
+
+static void read_lits (lrat_checker *checker) {
+  checker->size_lits = 0;
+  for (int64_t lit; (lit = read_number (checker));) {
+    ENLARGE (checker->lits, checker->size_lits, checker->capacity_lits);
+    checker->lits[checker->size_lits++] = lit;
+  }
+}
+
+static void read_hints (lrat_checker *checker) {
+  checker->size_hints = 0;
+  for (int64_t hint; (hint = read_number (checker));) {
+    ENLARGE (checker->hints, checker->size_hints, checker->capacity_hints);
+    checker->hints[checker->size_hints++] = hint;
+  }
+}
+
+static void delete_clause (lrat_checker *checker, int64_t id) {
+  checker_clause (checker, id);
+  free (checker->clauses[id]);
+  checker->clauses[id] = 0;
+}
+
+// Returns 'true' if the empty clause was derived.
+
+static bool check_proof (lrat_checker *checker) {
+  bool empty = false;
+  for (;;) {
+    uint64_t id = 0;
+    int type = 'a';
+    if (checker->binary) {
+      type = kissat_getc (&checker->file);
+      if (type == EOF)
+        break;
+      if (type == 'a')
+        id = read_unsigned (checker) / 2;
+      else if (type != 'd')
+        FATAL ("invalid binary line type in '%s'", checker->path);
+    } else {
+      int64_t tmp;
+      if (!read_integer (checker, &tmp))
+        break;
+      id = tmp;
+      int ch;
+      while ((ch = next_char (checker)) == ' ')
+        ;
+      if (ch == 'd')
+        type = 'd';
+      else
+        checker->saved = ch;
+    }
+    if (type == 'd') {
+      read_hints (checker);
+      for (size_t i = 0; i != checker->size_hints; i++)
+        delete_clause (checker, checker->hints[i]);
+      continue;
+    }
+    read_lits (checker);
+    read_hints (checker);
+    const bool checked = check_lemma (checker);
+    backtrack (checker, 0);
+    if (!checked)
+      FATAL ("failed to check lemma %" PRIu64 " in '%s'", id,
+             checker->path);
+    add_clause (checker, id);
+    if (!checker->size_lits)
+      empty = true;
+  }
+  return empty;
+}
+
+static void read_cnf (lrat_checker *checker, const char *path) {
+  FILE *file = fopen (path, "r");
+  if (!file)
+    FATAL ("could not read '%s'", path);
+  int ch;
+  uint64_t id = 0;
+  while ((ch = getc (file)) != EOF) {
+    if (ch == 'c' || ch == 'p') {
+      while ((ch = getc (file)) != '\n' && ch != EOF)
+        ;
+      continue;
+    }
+    ungetc (ch, file);
+    int lit;
+    checker->size_lits = 0;
+    while (fscanf (file, "%d", &lit) == 1 && lit) {
+      ENLARGE (checker->lits, checker->size_lits, checker->capacity_lits);
+      checker->lits[checker->size_lits++] = lit;
+      import_variable (checker, lit);
+    }
+    if (!feof (file))
+      add_clause (checker, ++id);
+    while ((ch = getc (file)) != '\n' && ch != EOF)
+      ;
+  }
+  fclose (file);
+}
+
+static void check_lrat (int expected, const char *cnf, const char *path,
+                        bool binary) {
+  lrat_checker checker;
+  memset (&checker, 0, sizeof checker);
+  checker.path = path;
+  checker.max_var = -1;
+  checker.binary = binary;
+  checker.saved = EOF;
+  import_variable (&checker, 0);
+  read_cnf (&checker, cnf);
+  if (!kissat_open_to_read_file (&checker.file, path))
+    FATAL ("could not read '%s'", path);
+  const bool empty = check_proof (&checker);
+  kissat_close_file (&checker.file);
+  if (expected == 20 && !empty)
+    FATAL ("missing empty clause in '%s'", path);
+  for (size_t i = 0; i != checker.size_clauses; i++)
+    free (checker.clauses[i]);
+  free (checker.clauses);
+  free (checker.values);
+  free (checker.trail);
+  free (checker.lits);
+  free (checker.hints);
+}
+
+static void write_lrat (int expected, const char *cnf, const char *path,
+                        bool binary) {
+  kissat *solver = kissat_init ();
+  tissat_init_solver (solver);
+  kissat_set_option (solver, "lrat", 1);
+  file proof;
+  if (!kissat_open_to_write_file (&proof, path))
+    FATAL ("could not open '%s' for writing", path);
+  kissat_init_proof (solver, &proof, binary);
+  file input;
+  if (!kissat_open_to_read_file (&input, cnf))
+    FATAL ("could not open '%s' for reading", cnf);
+  uint64_t lineno;
+  int max_var;
+  const char *error = kissat_parse_dimacs (solver, NORMAL_PARSING, &input,
+                                           &lineno, &max_var, 0);
+  kissat_close_file (&input);
+  if (error)
+    FATAL ("unexpected parse error in '%s': %s", cnf, error);
+  const int res = kissat_solve (solver);
+  if (res != expected)
+    FATAL ("solving '%s' returned '%d' but expected '%d'", cnf, res,
+           expected);
+  kissat_release_proof (solver);
+  kissat_close_file (&proof);
+  kissat_release (solver);
+}
+
+static void test_lrat_check (void) {
+  unsigned count = 0;
+#define CNF(EXPECTED, NAME, BIG) \
+  do { \
+    if (BIG) \
+      break; \
+    const char *cnf = "../test/cnf/" #NAME ".cnf"; \
+    const char *path = #NAME ".lrat"; \
+    const bool binary = count++ & 1; \
+    write_lrat (EXPECTED, cnf, path, binary); \
+    check_lrat (EXPECTED, cnf, path, binary); \
+    tissat_verbose ("checked %s LRAT proof of '%s'", \
+                    binary ? "binary" : "non-binary", cnf); \
+  } while (0);
+  CNFS
+#undef CNF
+}
+
+void tissat_schedule_lrat (void) {
+  if (tissat_found_test_directory)
+    SCHEDULE_FUNCTION (test_lrat_check);
+}
+
+#else
+int tissat_lrat_do_avoid_warning;
+#endif
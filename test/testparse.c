@@ -5,6 +5,38 @@
 
 #include "test.h"
 
+static const char *parse_file (unsigned strict, const char *path,
+                               bool parallel, uint64_t *lineno_ptr,
+                               int *max_var_ptr, int **literals_ptr,
+                               size_t *size_ptr) {
+  kissat *solver = kissat_init ();
+  tissat_init_solver (solver);
+  if (parallel) {
+    kissat_set_option (solver, "parsechunk", 0);
+    kissat_set_option (solver, "parsethreads", 3);
+  }
+  file file;
+  if (!kissat_open_to_read_file (&file, path))
+    FATAL ("could not open '%s' for reading", path);
+  ints literals;
+  INIT_STACK (literals);
+  const char *error = kissat_parse_dimacs (solver, strict, &file,
+                                           lineno_ptr, max_var_ptr,
+                                           &literals);
+  kissat_close_file (&file);
+  const size_t size = SIZE_STACK (literals);
+  int *copy = malloc ((size + 1) * sizeof *copy);
+  if (!copy)
+    FATAL ("out-of-memory copying literals");
+  if (size)
+    memcpy (copy, BEGIN_STACK (literals), size * sizeof *copy);
+  RELEASE_STACK (literals);
+  kissat_release (solver);
+  *literals_ptr = copy;
+  *size_ptr = size;
+  return error;
+}
+
 static bool test_parse (bool expect_parse_error, unsigned strict,
                         const char *path) {
   const char *type;
@@ -22,15 +54,12 @@ static bool test_parse (bool expect_parse_error, unsigned strict,
   }
   tissat_verbose ("Parsing %svalid '%s' in '%s' mode.",
                   expect_parse_error ? "in" : "", path, type);
-  kissat *solver = kissat_init ();
-  tissat_init_solver (solver);
-  file file;
-  if (!kissat_open_to_read_file (&file, path))
-    FATAL ("could not open '%s' for reading", path);
   uint64_t lineno;
   int max_var;
-  const char *error =
-      kissat_parse_dimacs (solver, strict, &file, &lineno, &max_var);
+  int *literals;
+  size_t size;
+  const char *error = parse_file (strict, path, false, &lineno, &max_var,
+                                  &literals, &size);
   if (expect_parse_error) {
     if (!error)
       FATAL ("%s parsing '%s' succeeded unexpectedly", type, path);
@@ -40,8 +69,28 @@ static bool test_parse (bool expect_parse_error, unsigned strict,
            lineno, error);
     tissat_verbose ("found maximum variable '%d' in '%s'", max_var, path);
   }
-  kissat_close_file (&file);
-  kissat_release (solver);
+  uint64_t parallel_lineno;
+  int parallel_max_var;
+  int *parallel_literals;
+  size_t parallel_size;
+  const char *parallel_error =
+      parse_file (strict, path, true, &parallel_lineno, &parallel_max_var,
+                  &parallel_literals, &parallel_size);
+  if (!error != !parallel_error ||
+      (error && strcmp (error, parallel_error)))
+    FATAL ("parallel %s parsing of '%s' yields '%s' instead of '%s'", type,
+           path, parallel_error ? parallel_error : "no error",
+           error ? error : "no error");
+  if (lineno != parallel_lineno)
+    FATAL ("parallel %s parsing of '%s' reports line %" PRIu64
+           " instead of %" PRIu64,
+           type, path, parallel_lineno, lineno);
+  if (size != parallel_size ||
+      memcmp (literals, parallel_literals, size * sizeof *literals))
+    FATAL ("parallel %s parsing of '%s' yields different literals", type,
+           path);
+  free (parallel_literals);
+  free (literals);
   return false;
 }
 
@@ -146,9 +195,22 @@ static void test_parse_coverage (void) {
 #undef PARSE
 }
 
+static void test_parse_parallel (void) {
+  const char *paths[] = {
+      "../test/cnf/add128.cnf",
+      "../test/cnf/hard.cnf",
+      "../test/cnf/prime841.cnf",
+  };
+  for (unsigned strict = 0; strict <= 2; strict++)
+    for (size_t i = 0; i != sizeof paths / sizeof *paths; i++)
+      test_parse (false, strict, paths[i]);
+}
+
 void tissat_schedule_parse (void) {
   if (tissat_found_test_directory)
     SCHEDULE_FUNCTION (test_parse_errors);
   if (tissat_found_test_directory)
     SCHEDULE_FUNCTION (test_parse_coverage);
+  if (tissat_found_test_directory)
+    SCHEDULE_FUNCTION (test_parse_parallel);
 }
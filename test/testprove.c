@@ -1,6 +1,10 @@
 #ifndef NPROOFS
 
 #include "../src/file.h"
+#include "../src/parse.h"
+#include "../src/proof.h"
+
+#include <inttypes.h>
 
 #include "test.h"
 #include "testcnfs.h"
@@ -36,6 +40,24 @@ static unsigned compressed;
 
 static unsigned scheduled;
 
+static const char *compressed_suffix (unsigned i) {
+  static const char *suffixes[] = {
+#ifdef KISSAT_HAS_BZIP2
+      ".bz2",
+#endif
+#ifdef KISSAT_HAS_ZLIB
+      ".gz",
+#endif
+#ifdef KISSAT_HAS_LZMA
+      ".lzma",
+      ".xz",
+#endif
+      "",
+  };
+  const unsigned size = sizeof suffixes / sizeof *suffixes;
+  return suffixes[i % size];
+}
+
 static void schedule_prove_job_with_option (int expected, const char *opt,
                                             const char *cnf,
                                             const char *name) {
@@ -150,7 +172,81 @@ static void schedule_prove_job (int expected, const char *cnf,
   }
 }
 
+static void write_proof_and_solve (int expected, const char *cnf,
+                                   const char *path, bool binary,
+                                   bool thread) {
+  kissat *solver = kissat_init ();
+  tissat_init_solver (solver);
+  kissat_set_option (solver, "proofthread", thread);
+  file proof;
+  if (!kissat_open_to_write_file (&proof, path))
+    FATAL ("could not open '%s' for writing", path);
+  kissat_init_proof (solver, &proof, binary);
+  file input;
+  if (!kissat_open_to_read_file (&input, cnf))
+    FATAL ("could not open '%s' for reading", cnf);
+  uint64_t lineno;
+  int max_var;
+  const char *error = kissat_parse_dimacs (solver, NORMAL_PARSING, &input,
+                                           &lineno, &max_var, 0);
+  kissat_close_file (&input);
+  if (error)
+    FATAL ("unexpected parse error in '%s': %s", cnf, error);
+  const int res = kissat_solve (solver);
+  if (res != expected)
+    FATAL ("solving '%s' returned '%d' but expected '%d'", cnf, res,
+           expected);
+  kissat_release_proof (solver);
+  kissat_close_file (&proof);
+  kissat_release (solver);
+}
+
+static void compare_proofs (const char *a, const char *b) {
+  file f, g;
+  if (!kissat_open_to_read_file (&f, a))
+    FATAL ("could not open '%s' for reading", a);
+  if (!kissat_open_to_read_file (&g, b))
+    FATAL ("could not open '%s' for reading", b);
+  int ch;
+  do
+    if ((ch = kissat_getc (&f)) != kissat_getc (&g))
+      FATAL ("proofs '%s' and '%s' differ at byte %" PRIu64, a, b,
+             f.bytes);
+  while (ch != EOF);
+  kissat_close_file (&g);
+  kissat_close_file (&f);
+}
+
+static void test_prove_thread (void) {
+  unsigned count = 0;
+#define CNF(EXPECTED, NAME, BIG) \
+  do { \
+    if (BIG) \
+      break; \
+    const char *cnf = "../test/cnf/" #NAME ".cnf"; \
+    const bool binary = count & 1; \
+    const char *suffix = ""; \
+    if (count % 4 == 2) \
+      suffix = compressed_suffix (count / 4); \
+    char synchronous[64], threaded[64]; \
+    sprintf (synchronous, "%s.synchronous%s", #NAME, suffix); \
+    sprintf (threaded, "%s.threaded%s", #NAME, suffix); \
+    write_proof_and_solve (EXPECTED, cnf, synchronous, binary, false); \
+    write_proof_and_solve (EXPECTED, cnf, threaded, binary, true); \
+    compare_proofs (synchronous, threaded); \
+    tissat_verbose ("synchronous and threaded %s proofs of '%s' match", \
+                    binary ? "binary" : "non-binary", cnf); \
+    count++; \
+  } while (0);
+  CNFS
+#undef CNF
+}
+
 void tissat_schedule_prove (void) {
+  if (tissat_found_test_directory)
+    SCHEDULE_FUNCTION (test_prove_thread);
+  if (!tissat_found_drabt && !tissat_found_drat_trim)
+    return;
 #ifdef KISSAT_COMPRESSED
   init_compression ();
 #endif
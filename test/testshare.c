@@ -0,0 +1,122 @@
+#include "../src/parse.h"
+
+#include "test.h"
+
+struct clauses {
+  size_t size, capacity, next;
+  int *lits;
+  unsigned learned, max_size, max_glue;
+};
+
+typedef struct clauses clauses;
+
+static void push_literal (clauses *clauses, int lit) {
+  if (clauses->size == clauses->capacity) {
+    clauses->capacity = clauses->capacity ? 2 * clauses->capacity : 1024;
+    clauses->lits =
+        realloc (clauses->lits, clauses->capacity * sizeof (int));
+    if (!clauses->lits)
+      FATAL ("out-of-memory reallocating learned clauses");
+  }
+  clauses->lits[clauses->size++] = lit;
+}
+
+static void learn_clause (void *state, unsigned glue, int *clause) {
+  clauses *clauses = state;
+  unsigned size = 0;
+  for (const int *p = clause; *p; p++)
+    size++;
+  if (!size)
+    FATAL ("learned empty clause");
+  if (size > clauses->max_size)
+    FATAL ("learned clause of size %u exceeds limit %u", size,
+           clauses->max_size);
+  if (size > 2 && glue > clauses->max_glue)
+    FATAL ("learned clause with glue %u exceeds limit %u", glue,
+           clauses->max_glue);
+  push_literal (clauses, (int) glue);
+  for (const int *p = clause; *p; p++)
+    push_literal (clauses, *p);
+  push_literal (clauses, 0);
+  clauses->learned++;
+}
+
+static int *import_clause (void *state, unsigned *glue_ptr) {
+  clauses *clauses = state;
+  if (clauses->next == clauses->size)
+    return 0;
+  *glue_ptr = clauses->lits[clauses->next++];
+  int *res = clauses->lits + clauses->next;
+  while (clauses->lits[clauses->next++])
+    ;
+  return res;
+}
+
+static kissat *parse_cnf (const char *cnf) {
+  kissat *solver = kissat_init ();
+  tissat_init_solver (solver);
+  file file;
+  if (!kissat_open_to_read_file (&file, cnf))
+    FATAL ("could not read '%s'", cnf);
+  uint64_t lineno;
+  int max_var;
+  const char *error = kissat_parse_dimacs (solver, RELAXED_PARSING, &file,
+                                           &lineno, &max_var, 0);
+  if (error)
+    FATAL ("unexpected parse error: %s", error);
+  kissat_close_file (&file);
+  return solver;
+}
+
+static void solve_and_check (kissat *solver, int expected) {
+  const int res = kissat_solve (solver);
+  if (res != expected)
+    FATAL ("solver returned '%d' but expected '%d'", res, expected);
+}
+
+static void test_share_learn_and_import (void) {
+  const char *cnf = "../test/cnf/add16.cnf";
+  clauses clauses;
+  memset (&clauses, 0, sizeof clauses);
+  clauses.max_size = 12;
+  clauses.max_glue = 4;
+  kissat *solver = parse_cnf (cnf);
+  kissat_set_learn (solver, &clauses, clauses.max_size, clauses.max_glue,
+                    learn_clause);
+  solve_and_check (solver, 20);
+  const uint64_t exported = solver->statistics.exported;
+  kissat_release (solver);
+  if (!clauses.learned)
+    FATAL ("no clauses learned");
+  if (exported != clauses.learned)
+    FATAL ("exported %" PRIu64 " clauses but learned %u", exported,
+           clauses.learned);
+  tissat_verbose ("learned %u clauses", clauses.learned);
+  struct clauses imports;
+  memset (&imports, 0, sizeof imports);
+  push_literal (&imports, 0);
+  push_literal (&imports, 1);
+  push_literal (&imports, 1000);
+  push_literal (&imports, 0);
+  for (size_t i = 0; i != clauses.size; i++)
+    push_literal (&imports, clauses.lits[i]);
+  free (clauses.lits);
+  solver = parse_cnf (cnf);
+  kissat_set_import (solver, &imports, import_clause);
+  solve_and_check (solver, 20);
+  const uint64_t imported = solver->statistics.imported;
+  const uint64_t skipped = solver->statistics.imported_skipped;
+  kissat_release (solver);
+  tissat_verbose ("imported %" PRIu64 " and skipped %" PRIu64 " clauses",
+                  imported, skipped);
+  if (!imported)
+    FATAL ("no clauses imported");
+  if (!skipped)
+    FATAL ("clause with unused variable not skipped");
+  free (imports.lits);
+}
+
+void tissat_schedule_share (void) {
+  if (tissat_found_test_directory)
+    SCHEDULE_FUNCTION (test_share_learn_and_import);
+}
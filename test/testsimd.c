@@ -0,0 +1,78 @@
+#include "../src/simd.h"
+
+#include "test.h"
+
+#define NUM_VARS 64
+#define MAX_SIZE 40
+
+static void test_simd_find_non_false (void) {
+  const bool simd = kissat_simd_supported ();
+  printf ("vectorized search %s\n", simd ? "supported" : "not supported");
+  value values[2 * NUM_VARS + VALUES_PADDING];
+  unsigned lits[MAX_SIZE];
+  srand (42);
+  for (unsigned round = 0; round < 1000; round++) {
+    memset (values, 0, sizeof values);
+    for (unsigned idx = 0; idx < NUM_VARS; idx++) {
+      const int r = rand () % 8;
+      if (r == 7)
+        continue;
+      const value value = (r == 6) ? 1 : -1;
+      values[2 * idx] = value;
+      values[2 * idx + 1] = -value;
+    }
+    const unsigned size = rand () % (MAX_SIZE + 1);
+    for (unsigned i = 0; i < size; i++)
+      lits[i] = rand () % (2 * NUM_VARS);
+    unsigned *const end = lits + size;
+    for (unsigned *begin = lits; begin <= end; begin++) {
+      unsigned *expected = begin;
+      while (expected != end && values[*expected] < 0)
+        expected++;
+      unsigned *scalar = kissat_find_non_false (false, values, begin, end);
+      if (scalar != expected)
+        FATAL ("scalar search returned position %zu instead of %zu",
+               (size_t) (scalar - lits), (size_t) (expected - lits));
+      unsigned *vector = kissat_find_non_false (simd, values, begin, end);
+      if (vector != expected)
+        FATAL ("vectorized search returned position %zu instead of %zu",
+               (size_t) (vector - lits), (size_t) (expected - lits));
+    }
+  }
+}
+
+#define NUM_CLAUSES 1000
+#define MAX_OCCURRENCES 100
+
+static void test_simd_count_critical (void) {
+  const bool simd = kissat_simd_supported ();
+  unsigned counts[NUM_CLAUSES];
+  unsigned refs[MAX_OCCURRENCES];
+  srand (42);
+  for (unsigned round = 0; round < 1000; round++) {
+    for (unsigned i = 0; i < NUM_CLAUSES; i++)
+      counts[i] = rand () % 4;
+    const unsigned size = rand () % (MAX_OCCURRENCES + 1);
+    for (unsigned i = 0; i < size; i++)
+      refs[i] = rand () % NUM_CLAUSES;
+    const unsigned *const end = refs + size;
+    for (const unsigned *begin = refs; begin <= end; begin++) {
+      unsigned expected = 0;
+      for (const unsigned *p = begin; p != end; p++)
+        expected += (counts[*p] == 1);
+      const unsigned scalar =
+          kissat_count_critical (false, counts, begin, end);
+      if (scalar != expected)
+        FATAL ("scalar count %u instead of %u", scalar, expected);
+      const unsigned vector =
+          kissat_count_critical (simd, counts, begin, end);
+      if (vector != expected)
+        FATAL ("vectorized count %u instead of %u", vector, expected);
+    }
+  }
+}
+
+void tissat_schedule_simd (void) {
+  SCHEDULE_FUNCTION (test_simd_find_non_false);
+  SCHEDULE_FUNCTION (test_simd_count_critical);
+}
@@ -8,6 +8,10 @@ bool test_sizes (void) {
   printf ("sizeof (clause) = %zu\n", sizeof (clause));
   printf ("SIZE_OF_CLAUSE_HEADER = %zu\n", SIZE_OF_CLAUSE_HEADER);
   assert (SIZE_OF_CLAUSE_HEADER == sizeof (unsigned));
+  printf ("sizeof (assigned) = %zu\n", sizeof (assigned));
+  assert (sizeof (assigned) == 3 * sizeof (unsigned));
+  printf ("sizeof (analysis) = %zu\n", sizeof (analysis));
+  assert (sizeof (analysis) == 1);
   printf ("sizeof (flags) = %zu\n", sizeof (flags));
   assert (sizeof (flags) == 1);
   printf ("sizeof (value) = %zu\n", sizeof (value));
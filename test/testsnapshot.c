@@ -0,0 +1,213 @@
+#include "../src/file.h"
+#include "../src/internal.h"
+#include "../src/parse.h"
+#include "../src/snapshot.h"
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test.h"
+#include "testcnfs.h"
+
+static void write_snapshot (const char *cnf, const char *path,
+                            int *max_var_ptr) {
+  kissat *solver = kissat_init ();
+  tissat_init_solver (solver);
+  file file;
+  if (!kissat_open_to_read_file (&file, cnf))
+    FATAL ("could not open '%s' for reading", cnf);
+  uint64_t lineno;
+  const char *error = kissat_parse_dimacs (solver, NORMAL_PARSING, &file,
+                                           &lineno, max_var_ptr, 0);
+  kissat_close_file (&file);
+  if (error)
+    FATAL ("unexpected parse error in '%s': %s", cnf, error);
+  if (!kissat_write_snapshot (solver, *max_var_ptr, path))
+    FATAL ("could not write snapshot '%s'", path);
+  kissat_release (solver);
+}
+
+static void check_model (kissat *solver, ints *literals) {
+  bool satisfied = false;
+  for (all_stack (int, lit, *literals))
+    if (!lit) {
+      if (!satisfied)
+        FATAL ("snapshot model does not satisfy clause");
+      satisfied = false;
+    } else if (kissat_value (solver, lit) == lit)
+      satisfied = true;
+}
+
+static void test_snapshot_round_trip (int expected, const char *cnf,
+                                      const char *name) {
+  char path[64];
+  sprintf (path, "%s.snapshot", name);
+  int written_max_var;
+  write_snapshot (cnf, path, &written_max_var);
+  kissat *solver = kissat_init ();
+  tissat_init_solver (solver);
+  ints literals;
+  INIT_STACK (literals);
+  int read_max_var;
+  const char *error =
+      kissat_read_snapshot (solver, path, &read_max_var, &literals);
+  if (error)
+    FATAL ("unexpected error reading snapshot '%s': %s", path, error);
+  if (read_max_var != written_max_var)
+    FATAL ("snapshot '%s' maximum variable %d instead of %d", path,
+           read_max_var, written_max_var);
+  const int res = kissat_solve (solver);
+  if (res != expected)
+    FATAL ("solving snapshot of '%s' returned '%d' but expected '%d'", cnf,
+           res, expected);
+  if (res == 10)
+    check_model (solver, &literals);
+  RELEASE_STACK (literals);
+  kissat_release (solver);
+  tissat_verbose ("solved snapshot '%s' of '%s' with result '%d'", path,
+                  cnf, res);
+}
+
+static void test_snapshot_round_trips (void) {
+#define CNF(EXPECTED, NAME, BIG) \
+  if (!BIG) \
+    test_snapshot_round_trip (EXPECTED, "../test/cnf/" #NAME ".cnf", #NAME);
+  CNFS
+#undef CNF
+}
+
+// Allocator filling new memory with a given byte, which makes the content
+// of uninitialized memory, e.g., padding in the arena, differ between runs.
+
+static unsigned char garbage;
+
+static void *garbage_allocate (void *state, size_t bytes) {
+  (void) state;
+  void *res = malloc (bytes);
+  if (res)
+    memset (res, garbage, bytes);
+  return res;
+}
+
+static void *garbage_reallocate (void *state, void *ptr, size_t old_bytes,
+                                 size_t new_bytes) {
+  (void) state;
+  unsigned char *res = realloc (ptr, new_bytes);
+  if (res && new_bytes > old_bytes)
+    memset (res + old_bytes, garbage, new_bytes - old_bytes);
+  return res;
+}
+
+static void garbage_deallocate (void *state, void *ptr, size_t bytes) {
+  (void) state;
+  (void) bytes;
+  free (ptr);
+}
+
+static void test_snapshot_deterministic (void) {
+  const char *cnf = "../test/cnf/add8.cnf";
+  const char *paths[2] = {"snapshot.garbage0", "snapshot.garbage1"};
+  int max_var;
+  for (unsigned i = 0; i != 2; i++) {
+    garbage = i ? 0xff : 0;
+    kissat_set_allocator (0, garbage_allocate, garbage_reallocate,
+                          garbage_deallocate);
+    write_snapshot (cnf, paths[i], &max_var);
+    kissat_set_allocator (0, 0, 0, 0);
+  }
+  FILE *files[2];
+  for (unsigned i = 0; i != 2; i++)
+    if (!(files[i] = fopen (paths[i], "rb")))
+      FATAL ("could not open '%s' for reading", paths[i]);
+  for (long offset = 0;; offset++) {
+    const int ch = getc (files[0]);
+    if (ch != getc (files[1]))
+      FATAL ("snapshots '%s' and '%s' differ at offset %ld", paths[0],
+             paths[1], offset);
+    if (ch == EOF)
+      break;
+  }
+  for (unsigned i = 0; i != 2; i++)
+    fclose (files[i]);
+}
+
+static void expect_snapshot_error (const char *path) {
+  kissat *solver = kissat_init ();
+  tissat_init_solver (solver);
+  int max_var;
+  const char *error = kissat_read_snapshot (solver, path, &max_var, 0);
+  if (!error)
+    FATAL ("reading invalid snapshot '%s' succeeded", path);
+  tissat_verbose ("reading '%s' failed as expected: %s", path, error);
+  kissat_release (solver);
+}
+
+static void test_snapshot_invalid (void) {
+  const char *complete = "snapshot.complete";
+  const char *truncated = "snapshot.truncated";
+  int max_var;
+  write_snapshot ("../test/cnf/add8.cnf", complete, &max_var);
+  FILE *src = fopen (complete, "rb");
+  FILE *dst = fopen (truncated, "wb");
+  if (!src || !dst)
+    FATAL ("could not copy '%s' to '%s'", complete, truncated);
+  fseek (src, 0, SEEK_END);
+  const long size = ftell (src);
+  rewind (src);
+  for (long i = 0; i + 1 < size; i++)
+    fputc (fgetc (src), dst);
+  fclose (src);
+  fclose (dst);
+  expect_snapshot_error (truncated);
+  expect_snapshot_error ("../test/cnf/add8.cnf");
+  expect_snapshot_error ("../test/file/non-existing");
+}
+
+// The single large clause '1 2 3' is stored last in the snapshot, thus
+// its literals can be patched at a fixed offset from the end of the file.
+
+static void write_corrupted_snapshot (const char *path, bool negate) {
+  kissat *solver = kissat_init ();
+  tissat_init_solver (solver);
+  for (int lit = 1; lit <= 3; lit++)
+    kissat_add (solver, lit);
+  kissat_add (solver, 0);
+  if (!kissat_write_snapshot (solver, 3, path))
+    FATAL ("could not write snapshot '%s'", path);
+  kissat_release (solver);
+  const long offset =
+      (long) (kissat_bytes_of_clause (3) - offsetof (clause, lits));
+  FILE *file = fopen (path, "r+b");
+  if (!file)
+    FATAL ("could not open '%s' for patching", path);
+  unsigned lits[2];
+  if (fseek (file, -offset, SEEK_END) ||
+      fread (lits, sizeof *lits, 2, file) != 2)
+    FATAL ("could not read clause literals in '%s'", path);
+  if (lits[0] != LIT (0) || lits[1] != LIT (1))
+    FATAL ("unexpected clause literals in '%s'", path);
+  lits[1] = negate ? NOT (lits[0]) : lits[0];
+  if (fseek (file, -offset, SEEK_END) ||
+      fwrite (lits, sizeof *lits, 2, file) != 2)
+    FATAL ("could not patch clause literals in '%s'", path);
+  fclose (file);
+}
+
+static void test_snapshot_corrupted (void) {
+  const char *duplicated = "snapshot.duplicated";
+  const char *complementary = "snapshot.complementary";
+  write_corrupted_snapshot (duplicated, false);
+  write_corrupted_snapshot (complementary, true);
+  expect_snapshot_error (duplicated);
+  expect_snapshot_error (complementary);
+}
+
+void tissat_schedule_snapshot (void) {
+  if (!tissat_found_test_directory)
+    return;
+  SCHEDULE_FUNCTION (test_snapshot_round_trips);
+  SCHEDULE_FUNCTION (test_snapshot_deterministic);
+  SCHEDULE_FUNCTION (test_snapshot_invalid);
+  SCHEDULE_FUNCTION (test_snapshot_corrupted);
+}
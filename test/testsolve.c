@@ -23,11 +23,17 @@ static void schedule_solve_job_with_option (int expected, const char *opt,
 static const char *simps[] = {
     "",
 #ifndef NOPTIONS
+    "--compactlim=0 --compactorder --reduceinit=10 ",
+    "--congruencethreads=3 ",
     "--eliminateinit=0 ",
+    "--eliminateinit=0 --eliminatethreads=3 ",
     "--probeinit=0 ",
+    "--probeinit=0 --no-implications ",
+    "--probeinit=0 --sweepthreads=3 ",
     "--reduceinit=10 --rephaseinit=10 --rephaseint=10 ",
     "--incremental ",
     "--walkinitially ",
+    "--walkinitially --walkthreads=4 ",
 #endif
 };
 
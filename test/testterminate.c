@@ -34,7 +34,7 @@ static void test_terminate (int bit, const char *name, int probeinit,
   uint64_t lineno;
   int max_var;
   const char *error = kissat_parse_dimacs (solver, RELAXED_PARSING, &file,
-                                           &lineno, &max_var);
+                                           &lineno, &max_var, 0);
   if (error)
     FATAL ("unexpected parse error: %s", error);
   (void) error;
@@ -0,0 +1,101 @@
+#ifndef NOPTIONS
+
+#include "../src/internal.h"
+#include "../src/parse.h"
+
+#include <inttypes.h>
+
+#include "test.h"
+
+// Concurrent simplifications should produce the same result independent
+// of the number of threads.  This is checked by comparing statistics of
+// runs with a conflict limit, which also depend on the simplified formula.
+
+static void solve_with_threads (const char *path, const char *init,
+                                const char *option, unsigned threads,
+                                statistics *res) {
+  kissat *solver = kissat_init ();
+  tissat_init_solver (solver);
+  if (init)
+    kissat_set_option (solver, init, 0);
+  kissat_set_option (solver, option, threads);
+  if (kissat_get_option (solver, option) != (int) threads)
+    FATAL ("could not set '--%s=%u'", option, threads);
+  file file;
+  if (!kissat_open_to_read_file (&file, path))
+    FATAL ("could not read '%s'", path);
+  uint64_t lineno;
+  int max_var;
+  const char *error = kissat_parse_dimacs (solver, RELAXED_PARSING, &file,
+                                           &lineno, &max_var, 0);
+  if (error)
+    FATAL ("unexpected parse error in '%s': %s", path, error);
+  kissat_close_file (&file);
+  kissat_set_conflict_limit (solver, 2000);
+  (void) kissat_solve (solver);
+  *res = solver->statistics;
+  kissat_release (solver);
+}
+
+#define COMPARE(NAME) \
+  do { \
+    if (expected.NAME != actual.NAME) \
+      FATAL ("'%s' with '--%s=%u' on '%s' is %" PRIu64 \
+             " but %" PRIu64 " with '--%s=%u'", \
+             #NAME, option, other, path, actual.NAME, expected.NAME, \
+             option, threads); \
+  } while (0)
+
+static void compare_threads (const char *path, const char *init,
+                             const char *option, unsigned threads) {
+  statistics expected;
+  solve_with_threads (path, init, option, threads, &expected);
+  for (unsigned other = threads + 1; other <= 2 * threads + 4; other++) {
+    statistics actual;
+    solve_with_threads (path, init, option, other, &actual);
+    COMPARE (conflicts);
+    COMPARE (decisions);
+    COMPARE (propagations);
+    COMPARE (clauses_irredundant);
+    COMPARE (eliminated);
+    COMPARE (eliminate_resolutions);
+    COMPARE (congruent);
+    COMPARE (congruent_gates);
+    COMPARE (congruent_matched);
+  }
+}
+
+// Sequential elimination schedules one variable after the other, while
+// concurrent elimination resolves batches of candidates, thus results are
+// compared with the smallest number of threads resolving concurrently.
+
+static void test_threads_eliminate (void) {
+  const char *paths[] = {"../test/cnf/add32.cnf",
+                         "../test/cnf/prime2209.cnf",
+                         "../test/cnf/sqrt63001.cnf"};
+  for (unsigned i = 0; i < sizeof paths / sizeof *paths; i++)
+    compare_threads (paths[i], "eliminateinit", "eliminatethreads", 2);
+}
+
+// Concurrent gate extraction only saves gates, which are then added in the
+// original order of the candidates, thus even has the same result as
+// sequential extraction.
+
+static void test_threads_congruence (void) {
+  const char *paths[] = {"../test/cnf/miter1.cnf",
+                         "../test/cnf/prime2209.cnf",
+                         "../test/cnf/add64.cnf"};
+  for (unsigned i = 0; i < sizeof paths / sizeof *paths; i++)
+    compare_threads (paths[i], 0, "congruencethreads", 1);
+}
+
+#endif
+
+void tissat_schedule_threads (void) {
+#ifndef NOPTIONS
+  if (!tissat_found_test_directory)
+    return;
+  SCHEDULE_FUNCTION (test_threads_eliminate);
+  SCHEDULE_FUNCTION (test_threads_congruence);
+#endif
+}
@@ -49,12 +49,23 @@ void tissat_schedule_usage (void) {
     APP (20, "../test/cnf/add8.cnf --eliminateinit=0 --no-ifthenelse");
     APP (20, "../test/cnf/add8.cnf --eliminateinit=0 --no-equivalences");
     APP (20, "../test/cnf/add8.cnf --eliminateinit=0 --no-ands");
+    APP (20, "../test/cnf/add8.cnf --eliminateinit=0 --eliminatethreads=4");
+    APP (20, "../test/cnf/add8.cnf --eliminateinit=0 --eliminatethreads=4 "
+             "--no-extract");
+    APP (20, "../test/cnf/add32.cnf --congruencethreads=4");
+    APP (20, "../test/cnf/add32.cnf --congruencethreads=4 "
+             "--no-congruenceands");
+    APP (20, "../test/cnf/add8.cnf --probeinit=0 --sweepthreads=4 "
+             "--sweepcomplete");
+    APP (20, "../test/cnf/add128.cnf --hugepages --numa");
 
 #ifndef QUIET
     APP (0, "--walkinitially --conflicts=3000 --probeinit=0 "
             "--eliminateinit=0 ../test/cnf/hard.cnf --profile=4");
     APP (0, "../test/cnf/hard.cnf --walkinitially -v -v -v "
             "--colors --conflicts=1e4");
+    APP (0, "../test/cnf/hard.cnf --walkinitially --walkthreads=3 "
+            "-v -v -v --conflicts=1e4");
 #endif
 
     APP (0, "--decisions=10 ../test/cnf/hard.cnf --no-reduce");
@@ -92,6 +103,16 @@ void tissat_schedule_usage (void) {
     APP (0, "--decisions=8e3 ../test/cnf/hard.cnf" LIMITED_OPTIONS);
     APP (0, "--conflicts=7e3 --decisions=7e3 "
             "../test/cnf/hard.cnf" LIMITED_OPTIONS);
+    APP (0, "--threads=3 --conflicts=2e3 ../test/cnf/hard.cnf");
+    APP (0, "--memory-limit=1 --conflicts=1e4 ../test/cnf/hard.cnf");
+    APP (20, "--memory-limit=1000 ../test/cnf/add8.cnf");
+#ifndef NOPTIONS
+    APP (0, "--memory-limit=10 --memorypressure=1 --conflicts=5e3 "
+            "../test/cnf/hard.cnf");
+#endif
+    APP (10, "--threads=4 ../test/cnf/sqrt10609.cnf");
+    APP (20, "--threads=2 ../test/cnf/add8.cnf");
+    APP (20, "--threads=8 ../test/cnf/add32.cnf");
   }
 
   APP (1, "--help -n");
@@ -124,6 +145,9 @@ void tissat_schedule_usage (void) {
   APP (1, "--invalid");
   APP (1, "-X");
 
+  APP (1, "--threads=0");
+  APP (1, "--threads=2 --threads=3");
+
   APP (1, "three command-line arguments");
   APP (1, "/dev/null /dev/null /dev/null");
 